@@ -102,6 +102,15 @@ enum class ALXRPassthroughMode : uint32_t {
     TypeCount,
 };
 
+enum class ALXRVideoReprojectionMode : uint32_t {
+    None = 0,
+    // warps the video frame to the latest head orientation.
+    Rotational,
+    // also corrects head translation, assuming the scene lies on a plane 2m away (no depth).
+    Positional,
+    TypeCount,
+};
+
 struct ALXRSystemProperties
 {
     char         systemName[256];
@@ -125,6 +134,35 @@ struct ALXRVersion {
     uint32_t patch;
 };
 
+enum class ALXRThreadRole : uint32_t {
+    Network,
+    Reassembly,
+    Decode,
+    Upload,
+    Render,
+    Tracking, // engine tracking sampler (alxr_start_tracking_sampler).
+    FramePacing, // xrWaitFrame thread of the pipelined frame mode.
+    TypeCount
+};
+
+enum class ALXRSchedPolicy : uint32_t {
+    Default, // leave the OS default, or use the realtime profile if ALXRDecoderConfig::realtimePriority is set.
+    Nice,
+    Fifo,
+    RoundRobin
+};
+
+struct ALXRThreadSchedParams {
+    ALXRSchedPolicy policy;
+    int32_t         priority;      // 1-99 for Fifo/RoundRobin, niceness (-20..19) for Nice.
+    uint64_t        cpuAffinityMask; // 0 = unchanged, bit N = CPU N.
+    bool            exclusiveCpus; // other roles without an explicit mask avoid these CPUs.
+};
+
+struct ALXRThreadSchedConfig {
+    ALXRThreadSchedParams roles[(uint32_t)ALXRThreadRole::TypeCount];
+};
+
 typedef struct ALXRClientCtx
 {
     void (*inputSend)(const TrackingInfo* data);
@@ -161,6 +199,28 @@ typedef struct ALXRClientCtx
     // In the absence of native support, will attempt to simulate a headless session.
     // Caution: May not be compatible with all runtimes and could lead to unexpected behavior.
     bool simulateHeadless;
+    // Runs xrWaitFrame for the next frame on a frame pacing thread while the current frame is
+    // still being rendered/submitted, instead of serially on the render thread.
+    bool pipelinedFrames;
+    // Reprojects the video frame from the pose it was rendered with by the server to
+    // freshly located views at display time, in the video shaders (Vulkan only).
+    ALXRVideoReprojectionMode videoReprojection;
+    // Draws the video frame with one compute dispatch writing the swapchain images as storage images,
+    // skipping the render pass & depth buffer, where the runtime and device support it (Vulkan only,
+    // not used with passthrough modes).
+    bool videoComputePass;
+    // Decoded frames are buffered up to this many frames deep (2-4, at most 2 on Android) and presented by
+    // matching their tracking timestamp to display times with an adaptive delay (Vulkan only), 0 disables (the default).
+    // Only worth it when arrival jitter is around a frame interval, see benchmarks/video_jitter_sim.
+    uint32_t videoJitterBufferDepth;
+    // Headless session frame (tracking poll) rate in Hz independent of the stream's refresh rate,
+    // e.g. 500-1000 for tracking only sessions, 0 uses the refresh rate.
+    float headlessFrameRate;
+
+    ALXRThreadSchedConfig threadScheduling;
+    // Directory the Vulkan pipeline cache is kept in across runs (e.g. the app's cache dir on Android),
+    // nullptr or empty uses the user's cache directory on desktop and disables it on Android.
+    const char* pipelineCacheDir;
 
 #ifdef XR_USE_PLATFORM_ANDROID
     void* applicationVM;
@@ -194,6 +254,135 @@ struct ALXRDecoderConfig
     uint32_t      cpuThreadCount; // only used for software decoding.
     bool          enableFEC;
     bool          realtimePriority;
+    // Forward each slice to the decoder as soon as it has arrived, requires FEC
+    // and a decoder that accepts partial frames (see IDecoderPlugin::IsSliceInputSupported).
+    bool          sliceStreaming;
+};
+
+struct ALXRDecoderPacketStats
+{
+    uint64_t packetsQueued;
+    uint64_t packetsDropped;
+    uint64_t packetAllocations; // number of heap allocated packets.
+    uint64_t bufferAllocations; // number of heap allocated payload buffers.
+    uint64_t bytesCopied;
+    uint64_t framesDecoded;
+    uint64_t framesSkipped; // decoded but never uploaded, superseded by a newer frame.
+};
+
+struct ALXRReplayOptions
+{
+    const char*     capturePath;
+    ALXRDecoderType decoderType;
+    bool            maxSpeed; // ignore the capture timestamps and feed packets as fast as the pipeline accepts them.
+};
+
+// Stage times are in microseconds.
+struct ALXRReplayStageTimes
+{
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+struct ALXRReplayStats
+{
+    uint64_t packetsReplayed;
+    uint64_t framesInCapture;
+    uint64_t framesUploaded;
+    uint64_t framesDropped;  // frames in the capture which never reached the upload stage.
+    uint64_t shardsDropped;  // reassembly queue overflow.
+    ALXRDecoderPacketStats decoderStats;
+    ALXRReplayStageTimes fec;    // per shard, FEC/reassembly.
+    ALXRReplayStageTimes decode; // per frame, reassembled -> upload started.
+    ALXRReplayStageTimes upload; // per frame, decoded frame -> video texture.
+    uint64_t durationUs;
+};
+
+enum class ALXRLatencyStage : uint32_t {
+    Network, // first shard received -> frame complete.
+    Decode,  // decoder input -> decoder output.
+    Upload,  // decoder output -> video texture updated.
+    Render,  // video texture updated -> xrEndFrame.
+    Total,   // first shard received -> xrEndFrame.
+    TypeCount
+};
+
+// Times are in microseconds, within ~3% of the recorded values.
+struct ALXRLatencyPercentiles
+{
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t max;
+    uint64_t count;
+};
+
+struct ALXRLatencyReport
+{
+    ALXRLatencyPercentiles lastSecond[(uint32_t)ALXRLatencyStage::TypeCount];
+    ALXRLatencyPercentiles sinceReset[(uint32_t)ALXRLatencyStage::TypeCount]; // since the stream (re)started.
+};
+
+struct ALXRTrackingSamplerConfig
+{
+    uint32_t samplesPerFrame; // tracking samples per display refresh (1-8).
+    bool     clientsidePrediction;
+};
+
+struct ALXRTrackingSamplerStats
+{
+    uint64_t samples;
+    uint64_t targetIntervalUs;
+    ALXRLatencyPercentiles interval; // between consecutive samples.
+    ALXRLatencyPercentiles jitter;   // |interval - targetIntervalUs|
+};
+
+struct ALXRFramePacingStats
+{
+    uint64_t frames;
+    uint64_t missedFrames;           // display periods without a new frame.
+    ALXRLatencyPercentiles wait;     // render thread blocked waiting for the next frame.
+    ALXRLatencyPercentiles interval; // between consecutive xrEndFrame calls.
+    bool     isPipelined;            // xrWaitFrame runs on the frame pacing thread.
+};
+
+struct ALXRVideoJitterStats
+{
+    uint64_t frames;        // decoded frames queued.
+    uint64_t presented;     // frames selected for display.
+    uint64_t holds;         // display frames which repeated the previous video frame.
+    uint64_t skips;         // frames dropped without being presented, lateFrames included.
+    uint64_t lateFrames;    // frames which arrived after a newer frame was presented.
+    uint64_t targetDelayUs; // current buffering delay.
+    uint32_t depth;         // frames currently queued.
+    uint32_t maxDepth;
+};
+
+struct ALXRClockSyncStats
+{
+    int64_t  offsetUs;       // server - client clock.
+    double   driftPpm;
+    uint64_t uncertaintyUs;  // +/- bound of offsetUs.
+    uint64_t minRttUs;
+    uint32_t sampleCount;
+    uint64_t rejectedSamples;
+};
+
+enum class ALXRTraceFormat : uint32_t {
+    ChromeJson,    // chrome://tracing, ui.perfetto.dev
+    PerfettoProto  // perfetto protobuf trace
+};
+
+struct ALXRFrameTraceConfig
+{
+    bool            enabled;
+    // frames slower than this from first shard received to xrEndFrame trigger a dump of
+    // the trace to spikeDumpDir (at most one every 5s), 0 disables.
+    uint32_t        spikeThresholdUs;
+    ALXRTraceFormat spikeDumpFormat;
+    const char*     spikeDumpDir;
 };
 
 struct ALXRStreamConfig {
@@ -17,6 +17,9 @@
 #include <type_traits>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <span>
+#include <utility>
 
 #include "alxr_engine.h"
 #include "alxr_facial_eye_tracking_packet.h"
@@ -26,6 +29,13 @@
 #include "latency_manager.h"
 #include "decoder_thread.h"
 #include "foveation.h"
+#include "stream_capture.h"
+#include "thread_scheduling.h"
+#include "frame_trace.h"
+#include "tracking_sampler.h"
+#include "frame_pipeline.h"
+#include "video_jitter_buffer.h"
+#include "rcu_ptr.h"
 
 #if defined(XR_USE_PLATFORM_WIN32) && defined(XR_EXPORT_HIGH_PERF_GPU_SELECTION_SYMBOLS)
 #pragma message("Enabling Symbols to select high-perf GPUs first")
@@ -39,6 +49,42 @@ extern "C" {
 }
 #endif
 
+namespace {
+namespace ThreadScheduling = ALXR::ThreadScheduling;
+
+inline ThreadScheduling::Params FromALXR(const ALXRThreadSchedParams& params) {
+    return {
+        .policy = static_cast<ThreadScheduling::Policy>(params.policy),
+        .priority = params.priority,
+        .cpuMask = params.cpuAffinityMask,
+        .exclusiveCpus = params.exclusiveCpus
+    };
+}
+
+inline ALXRThreadSchedParams ToALXR(const ThreadScheduling::Params& params) {
+    return {
+        .policy = static_cast<ALXRSchedPolicy>(params.policy),
+        .priority = params.priority,
+        .cpuAffinityMask = params.cpuMask,
+        .exclusiveCpus = params.exclusiveCpus
+    };
+}
+
+inline ALXRLatencyPercentiles ToALXR(const ALXR::LatencyHistogram::Percentiles& percentiles) {
+    return {
+        .p50 = percentiles.p50,
+        .p90 = percentiles.p90,
+        .p99 = percentiles.p99,
+        .max = percentiles.max,
+        .count = percentiles.count
+    };
+}
+
+void LogThreadScheduling(const char* message) {
+    Log::Write(Log::Level::Info, message);
+}
+}
+
 constexpr inline const ALXREyeInfo EyeInfoZero {
     .eyeFov = { {0,0,0,0}, {0,0,0,0} },
     .ipd = 0.0f
@@ -50,8 +96,18 @@ using ClientCtxPtr = std::shared_ptr<const ALXRClientCtx>;
 ClientCtxPtr      gClientCtx{ nullptr };
 IOpenXrProgramPtr gProgram{ nullptr };
 XrDecoderThread   gDecoderThread{};
-std::mutex        gRenderMutex{};
+XrTrackingSampler gTrackingSampler{};
+// Held while sampling, OpenXrProgram::m_trackingFrames has a single writer and the host
+// (alxr_on_tracking_update) and sampler threads can overlap while the sampler starts/stops.
+std::mutex        gTrackingMutex{};
+// Guarded by gTrackingMutex.
 ALXREyeInfo       gLastEyeInfo = EyeInfoZero;
+// Set by alxr_set_stream_config, the next sample resends the view config.
+std::atomic<bool> gResendEyeInfo{ false };
+// internally synchronized, only opened/closed by the host thread.
+ALXR::StreamCapture::Writer gStreamCapture{};
+// Shard ring slot handed out by alxr_begin_receive until alxr_commit_receive, network thread only.
+std::span<std::uint8_t> gReceiveBuffer{};
 
 namespace ALXRStrings {
     constexpr inline const char* const HeadPath         = "/user/head";
@@ -103,6 +159,16 @@ bool alxr_init(const ALXRClientCtx* rCtx, /*[out]*/ ALXRSystemProperties* system
         if (ctx.verbose)
             Log::SetLevel(Log::Level::Verbose);
         
+        static_assert(std::size_t(ALXRThreadRole::TypeCount) == ThreadScheduling::RoleCount);
+        ThreadScheduling::Config schedConfig{};
+        for (std::size_t roleIdx = 0; roleIdx < schedConfig.size(); ++roleIdx)
+            schedConfig[roleIdx] = FromALXR(ctx.threadScheduling.roles[roleIdx]);
+        ThreadScheduling::SetConfig(schedConfig);
+        ThreadScheduling::SetLogOutput(&LogThreadScheduling);
+        // alxr_init & alxr_process_frame are called from the render thread,
+        // the realtime defaults are only known at alxr_set_stream_config and picked up by alxr_process_frame.
+        ThreadScheduling::ApplyRole(ThreadScheduling::Role::Render);
+
         LatencyManager::Instance().Init(LatencyManager::CallbackCtx {
             .sendFn = ctx.inputSend,
             .timeSyncSendFn = ctx.timeSyncSend,
@@ -132,6 +198,13 @@ bool alxr_init(const ALXRClientCtx* rCtx, /*[out]*/ ALXRSystemProperties* system
         options->firmwareVersion = { fmVersion.major, fmVersion.minor, fmVersion.patch };
         options->TrackingServerPortNo = static_cast<std::uint16_t>(ctx.trackingServerPortNo);
         options->SimulateHeadless = ctx.simulateHeadless;
+        options->PipelinedFrames = ctx.pipelinedFrames;
+        options->VideoReprojection = ctx.videoReprojection;
+        options->VideoComputePass = ctx.videoComputePass;
+        options->VideoJitterBufferDepth = ctx.videoJitterBufferDepth;
+        options->HeadlessFrameRate = ctx.headlessFrameRate;
+        if (ctx.pipelineCacheDir != nullptr)
+            options->PipelineCacheDir = ctx.pipelineCacheDir;
         options->PassthroughMode = ctx.passthroughMode;
         if (options->GraphicsPlugin.empty())
             options->GraphicsPlugin = graphics_api_str(ctx.graphicsApi);
@@ -209,13 +282,17 @@ void alxr_destroy() {
         return;
     }
     Log::Write(Log::Level::Info, "openxrShutdown: Shuttingdown");
+    alxr_stop_tracking_sampler();
+    // the decoder thread uploads into the video textures, it is joined before they are cleared.
+    alxr_stop_decoder_thread();
     if (const auto programPtr = gProgram) {
         if (const auto graphicsPtr = programPtr->GetGraphicsPlugin()) {
-            std::scoped_lock lk(gRenderMutex);
+            programPtr->SetRenderMode(IOpenXrProgram::RenderMode::Lobby);
+            xrconcurrency::render_rcu_domain().synchronize();
             graphicsPtr->ClearVideoTextures();
         }
     }
-    alxr_stop_decoder_thread();
+    alxr_stop_stream_capture();
     gProgram.reset();
     gClientCtx.reset();
 }
@@ -230,13 +307,14 @@ void alxr_process_frame(bool* exitRenderLoop /*= non-null */, bool* requestResta
     assert(exitRenderLoop != nullptr && requestRestart != nullptr);
     assert(gProgram != nullptr);
 
+    ThreadScheduling::RefreshCurrentThread();
     gProgram->PollEvents(exitRenderLoop, requestRestart);
     if (*exitRenderLoop || !gProgram->IsSessionRunning())
         return;
     
     //gProgram->PollActions();
     {
-        std::scoped_lock lk(gRenderMutex);
+        const xrconcurrency::rcu_read_guard frameGuard{ xrconcurrency::render_rcu_domain() };
         gProgram->RenderFrame();
     }
 }
@@ -252,7 +330,7 @@ void alxr_process_frame2(ALXRProcessFrameResult* frameResult) {
             return;
 
         {
-            std::scoped_lock lk(gRenderMutex);
+            const xrconcurrency::rcu_read_guard frameGuard{ xrconcurrency::render_rcu_domain() };
             gProgram->RenderFrame();
         }
 
@@ -285,8 +363,11 @@ void alxr_set_stream_config(const ALXRStreamConfig config)
     alxr_stop_decoder_thread();
     if (const auto graphicsPtr = programPtr->GetGraphicsPlugin()) {
         const auto& rc = config.renderConfig;
-        std::scoped_lock lk(gRenderMutex);
+        // The render thread never waits on reconfiguration: frames started after the switch to lobby mode
+        // do not touch the video textures, wait out the one in flight (if any) before clearing them.
+        // New swapchains are published by CreateSwapchains, the old ones retired once no frame uses them.
         programPtr->SetRenderMode(IOpenXrProgram::RenderMode::Lobby);
+        xrconcurrency::render_rcu_domain().synchronize();
         graphicsPtr->ClearVideoTextures();
         
         ALXR::FoveatedDecodeParams fdParams{};
@@ -296,7 +377,10 @@ void alxr_set_stream_config(const ALXRStreamConfig config)
         programPtr->CreateSwapchains(rc.eyeWidth, rc.eyeHeight);
     }
 
-    gLastEyeInfo = EyeInfoZero;
+    gResendEyeInfo.store(true, std::memory_order_release);
+
+    if (gStreamCapture.IsOpen())
+        gStreamCapture.WriteDecoderConfig(config.decoderConfig);
 
 #ifndef XR_DISABLE_DECODER_THREAD
     if (!programPtr->IsHeadlessSession()) {
@@ -381,7 +465,7 @@ inline void LogViewConfig(const ALXREyeInfo& newEyeInfo)
         newEyeInfo.ipd * 1000.0f, lEyeFovStr.c_str(), rEyeFovStr.c_str()));
 }
 
-void alxr_on_tracking_update(const bool clientsidePrediction)
+inline void SampleTracking(const bool clientsidePrediction, const bool checkViewConfig)
 {
     const auto clientCtx = gClientCtx;
     if (clientCtx == nullptr)
@@ -390,16 +474,21 @@ void alxr_on_tracking_update(const bool clientsidePrediction)
     if (xrProgram == nullptr || !xrProgram->IsSessionRunning())
         return;
 
-    ALXREyeInfo newEyeInfo{};
-    if (!gProgram->GetEyeInfo(newEyeInfo))
-        return;
-    if (std::abs(newEyeInfo.ipd - gLastEyeInfo.ipd) > 0.01f ||
-        std::abs(newEyeInfo.eyeFov[0].left - gLastEyeInfo.eyeFov[0].left) > 0.01f ||
-        std::abs(newEyeInfo.eyeFov[1].left - gLastEyeInfo.eyeFov[1].left) > 0.01f)
-    {
-        gLastEyeInfo = newEyeInfo;
-        gClientCtx->viewsConfigSend(&newEyeInfo);
-        LogViewConfig(newEyeInfo);
+    std::scoped_lock trackingLock(gTrackingMutex);
+    if (gResendEyeInfo.exchange(false, std::memory_order_acquire))
+        gLastEyeInfo = EyeInfoZero;
+    if (checkViewConfig) {
+        ALXREyeInfo newEyeInfo{};
+        if (!xrProgram->GetEyeInfo(newEyeInfo))
+            return;
+        if (std::abs(newEyeInfo.ipd - gLastEyeInfo.ipd) > 0.01f ||
+            std::abs(newEyeInfo.eyeFov[0].left - gLastEyeInfo.eyeFov[0].left) > 0.01f ||
+            std::abs(newEyeInfo.eyeFov[1].left - gLastEyeInfo.eyeFov[1].left) > 0.01f)
+        {
+            gLastEyeInfo = newEyeInfo;
+            clientCtx->viewsConfigSend(&newEyeInfo);
+            LogViewConfig(newEyeInfo);
+        }
     }
 
     xrProgram->PollActions();
@@ -410,27 +499,117 @@ void alxr_on_tracking_update(const bool clientsidePrediction)
     clientCtx->inputSend(&newInfo);
 }
 
+void alxr_on_tracking_update(const bool clientsidePrediction)
+{
+    // the sampler thread owns tracking while it runs, SampleTracking serializes the hand-over.
+    if (gTrackingSampler.IsRunning())
+        return;
+    SampleTracking(clientsidePrediction, true);
+}
+
+bool alxr_start_tracking_sampler(const ALXRTrackingSamplerConfig* config)
+{
+    const auto programPtr = gProgram;
+    if (config == nullptr || programPtr == nullptr)
+        return false;
+    gTrackingSampler.Stop();
+    gTrackingSampler.Start({
+        .programPtr = programPtr,
+        // the view config only changes with the display, poses are sent on every tick.
+        .sampleFn = [clientsidePrediction = config->clientsidePrediction](const bool isFrameStart) {
+            SampleTracking(clientsidePrediction, isFrameStart);
+        },
+        .samplesPerFrame = config->samplesPerFrame
+    });
+    return gTrackingSampler.IsRunning();
+}
+
+void alxr_stop_tracking_sampler()
+{
+    gTrackingSampler.Stop();
+}
+
+bool alxr_get_tracking_sampler_stats(ALXRTrackingSamplerStats* stats)
+{
+    if (stats == nullptr)
+        return false;
+    const auto samplerStats = gTrackingSampler.GetStats();
+    *stats = {
+        .samples = samplerStats.samples,
+        .targetIntervalUs = samplerStats.targetIntervalUs,
+        .interval = ToALXR(samplerStats.interval),
+        .jitter = ToALXR(samplerStats.jitter)
+    };
+    return samplerStats.samples > 0;
+}
+
 void alxr_on_receive(const unsigned char* packet, unsigned int packetSize)
 {
     const auto programPtr = gProgram;
     if (programPtr == nullptr)
         return;
+    // picks up the realtime defaults for a network thread registered with alxr_set_current_thread_role.
+    ThreadScheduling::RefreshCurrentThread();
     const std::uint32_t type = *reinterpret_cast<const uint32_t*>(packet);
     switch (type) {
         case ALVR_PACKET_TYPE_VIDEO_FRAME: {
 #ifndef XR_DISABLE_DECODER_THREAD
             assert(packetSize >= sizeof(VideoFrame));
             const auto& header = *reinterpret_cast<const VideoFrame*>(packet);
+            if (gStreamCapture.IsOpen())
+                gStreamCapture.WriteVideoPacket(header, { packet + sizeof(VideoFrame), packetSize - sizeof(VideoFrame) });
             gDecoderThread.QueuePacket(header, packetSize);
 #endif
         } break;        
         case ALVR_PACKET_TYPE_TIME_SYNC: {
             assert(packetSize >= sizeof(TimeSync));
+            if (gStreamCapture.IsOpen())
+                gStreamCapture.WriteTimeSync(*(const TimeSync*)packet);
             LatencyManager::Instance().OnTimeSyncRecieved(*(TimeSync*)packet);
         } break;
     }
 }
 
+unsigned char* alxr_begin_receive(unsigned int maxPacketSize)
+{
+#ifdef XR_DISABLE_DECODER_THREAD
+    (void)maxPacketSize;
+    return nullptr;
+#else
+    if (gProgram == nullptr || !gReceiveBuffer.empty())
+        return nullptr;
+    gReceiveBuffer = gDecoderThread.BeginReceive(maxPacketSize);
+    return gReceiveBuffer.empty() ? nullptr : gReceiveBuffer.data();
+#endif
+}
+
+void alxr_commit_receive(unsigned int packetSize)
+{
+#ifdef XR_DISABLE_DECODER_THREAD
+    (void)packetSize;
+#else
+    const std::span<std::uint8_t> buffer = std::exchange(gReceiveBuffer, {});
+    if (buffer.empty())
+        return;
+    assert(packetSize <= buffer.size());
+    const bool isVideoFrame = packetSize >= sizeof(VideoFrame) &&
+        *reinterpret_cast<const std::uint32_t*>(buffer.data()) == ALVR_PACKET_TYPE_VIDEO_FRAME;
+    if (!isVideoFrame) {
+        // the slot stays valid until it is given back.
+        if (packetSize >= sizeof(std::uint32_t))
+            alxr_on_receive(buffer.data(), packetSize);
+        gDecoderThread.CommitReceive(0);
+        return;
+    }
+    ThreadScheduling::RefreshCurrentThread();
+    if (gStreamCapture.IsOpen()) {
+        const auto& header = *reinterpret_cast<const VideoFrame*>(buffer.data());
+        gStreamCapture.WriteVideoPacket(header, { buffer.data() + sizeof(VideoFrame), packetSize - sizeof(VideoFrame) });
+    }
+    gDecoderThread.CommitReceive(packetSize);
+#endif
+}
+
 void alxr_on_haptics_feedback(unsigned long long path, float duration_s, float frequency, float amplitude)
 {
     if (const auto programPtr = gProgram) {
@@ -452,7 +631,10 @@ void alxr_on_video_packet(const VideoFrame* headerPtr, const unsigned char* pack
 #else
     if (const auto programPtr = gProgram) {
         assert(headerPtr != nullptr);
+        ThreadScheduling::RefreshCurrentThread();
         const auto& header = *headerPtr;
+        if (gStreamCapture.IsOpen())
+            gStreamCapture.WriteVideoPacket(header, { packet, static_cast<std::size_t>(packetSize) });
         gDecoderThread.QueuePacket(header, XrDecoderThread::VideoPacket{
             packet,
             static_cast<std::size_t>(packetSize)
@@ -464,10 +646,165 @@ void alxr_on_video_packet(const VideoFrame* headerPtr, const unsigned char* pack
 void alxr_on_time_sync(const TimeSync* packet) {
     if (const auto programPtr = gProgram) {
         assert(packet != nullptr);
+        if (gStreamCapture.IsOpen())
+            gStreamCapture.WriteTimeSync(*packet);
         LatencyManager::Instance().OnTimeSyncRecieved(*packet);
     }
 }
 
+bool alxr_get_decoder_packet_stats(ALXRDecoderPacketStats* stats)
+{
+#ifdef XR_DISABLE_DECODER_THREAD
+    (void)stats;
+    return false;
+#else
+    if (stats == nullptr)
+        return false;
+    return gDecoderThread.GetPacketStats(*stats);
+#endif
+}
+
+bool alxr_start_stream_capture(const char* path)
+{
+    const auto programPtr = gProgram;
+    if (path == nullptr || programPtr == nullptr)
+        return false;
+    if (!gStreamCapture.Open(path))
+        return false;
+    // a replay must start from a decodable frame with the active decoder config.
+    ALXRStreamConfig streamConfig{};
+    if (programPtr->GetStreamConfig(streamConfig))
+        gStreamCapture.WriteDecoderConfig(streamConfig.decoderConfig);
+    if (const auto clientCtx = gClientCtx) {
+        clientCtx->setWaitingNextIDR(true);
+        clientCtx->requestIDR();
+    }
+    return true;
+}
+
+void alxr_stop_stream_capture()
+{
+    gStreamCapture.Close();
+}
+
+bool alxr_set_current_thread_role(ALXRThreadRole role, ALXRThreadSchedParams* granted)
+{
+    if (role >= ALXRThreadRole::TypeCount)
+        return false;
+    const auto grantedParams = ThreadScheduling::ApplyRole(static_cast<ThreadScheduling::Role>(role));
+    if (granted)
+        *granted = ToALXR(grantedParams);
+    return true;
+}
+
+bool alxr_get_thread_sched_report(ALXRThreadRole role, ALXRThreadSchedParams* granted)
+{
+    if (role >= ALXRThreadRole::TypeCount || granted == nullptr)
+        return false;
+    ThreadScheduling::Params grantedParams{};
+    if (!ThreadScheduling::GetGranted(static_cast<ThreadScheduling::Role>(role), grantedParams))
+        return false;
+    *granted = ToALXR(grantedParams);
+    return true;
+}
+
+bool alxr_get_latency_report(ALXRLatencyReport* report)
+{
+    if (report == nullptr)
+        return false;
+    static_assert(LatencyManager::LatencyStageCount == static_cast<std::size_t>(ALXRLatencyStage::TypeCount));
+    const auto latencyReport = LatencyManager::Instance().GetLatencyReport();
+    for (std::size_t idx = 0; idx < LatencyManager::LatencyStageCount; ++idx) {
+        report->lastSecond[idx] = ToALXR(latencyReport.lastSecond[idx]);
+        report->sinceReset[idx] = ToALXR(latencyReport.sinceReset[idx]);
+    }
+    return true;
+}
+
+bool alxr_get_clock_sync_stats(ALXRClockSyncStats* stats)
+{
+    if (stats == nullptr)
+        return false;
+    const auto clockSyncStats = LatencyManager::Instance().GetClockSyncStats();
+    const auto& estimate = clockSyncStats.estimate;
+    *stats = {
+        .offsetUs = estimate.offsetUs,
+        .driftPpm = estimate.driftPpm,
+        .uncertaintyUs = estimate.uncertaintyUs,
+        .minRttUs = estimate.minRttUs,
+        .sampleCount = estimate.sampleCount,
+        .rejectedSamples = clockSyncStats.rejectedSamples
+    };
+    return estimate.isValid;
+}
+
+bool alxr_get_frame_pacing_stats(ALXRFramePacingStats* stats)
+{
+    const auto programPtr = gProgram;
+    if (stats == nullptr || programPtr == nullptr)
+        return false;
+    ALXR::FramePacingStats pacingStats{};
+    if (!programPtr->GetFramePacingStats(pacingStats))
+        return false;
+    *stats = {
+        .frames = pacingStats.frames,
+        .missedFrames = pacingStats.missedFrames,
+        .wait = ToALXR(pacingStats.wait),
+        .interval = ToALXR(pacingStats.interval),
+        .isPipelined = pacingStats.isPipelined
+    };
+    return true;
+}
+
+bool alxr_get_video_jitter_stats(ALXRVideoJitterStats* stats)
+{
+    const auto programPtr = gProgram;
+    if (stats == nullptr || programPtr == nullptr)
+        return false;
+    const auto graphicsPtr = programPtr->GetGraphicsPlugin();
+    ALXR::VideoJitterStats jitterStats{};
+    if (graphicsPtr == nullptr || !graphicsPtr->GetVideoJitterStats(jitterStats))
+        return false;
+    *stats = {
+        .frames = jitterStats.pushed,
+        .presented = jitterStats.presented,
+        .holds = jitterStats.holds,
+        .skips = jitterStats.skips,
+        .lateFrames = jitterStats.lateFrames,
+        .targetDelayUs = jitterStats.targetDelayUs,
+        .depth = jitterStats.depth,
+        .maxDepth = jitterStats.maxDepth
+    };
+    return true;
+}
+
+void alxr_set_frame_trace_config(const ALXRFrameTraceConfig* config)
+{
+    if (config == nullptr) {
+        ALXR::FrameTrace::SetConfig({});
+        return;
+    }
+    ALXR::FrameTrace::SetConfig({
+        .enabled = config->enabled,
+        .spikeThresholdUs = config->spikeThresholdUs,
+        .spikeDumpDir = config->spikeDumpDir ? config->spikeDumpDir : "",
+        .spikeDumpFormat = static_cast<ALXR::FrameTrace::Format>(config->spikeDumpFormat)
+    });
+    Log::Write(Log::Level::Info, Fmt("Frame trace %s, spike threshold: %uus",
+        config->enabled ? "enabled" : "disabled", config->spikeThresholdUs));
+}
+
+bool alxr_dump_frame_trace(const char* path, ALXRTraceFormat format)
+{
+    if (path == nullptr)
+        return false;
+    if (!ALXR::FrameTrace::Dump(path, static_cast<ALXR::FrameTrace::Format>(format))) {
+        Log::Write(Log::Level::Error, Fmt("Failed to write frame trace to %s", path));
+        return false;
+    }
+    return true;
+}
+
 void alxr_set_log_custom_output(ALXRLogOptions options, ALXRLogOutputFn outputFn) {
     static_assert(
         std::is_same<
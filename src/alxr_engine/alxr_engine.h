@@ -27,7 +27,17 @@ DLLEXPORT void alxr_set_stream_config(const ALXRStreamConfig config);
 DLLEXPORT ALXRGuardianData alxr_get_guardian_data();
 
 DLLEXPORT void alxr_on_receive(const unsigned char* packet, unsigned int packetSize);
+// In place alternative to alxr_on_receive which saves copying video packets: receive the next datagram
+// straight into the returned buffer and hand it over with alxr_commit_receive from the same thread,
+// a size of 0 cancels. Returns null if no buffer is available, receive as usual then.
+DLLEXPORT unsigned char* alxr_begin_receive(unsigned int maxPacketSize);
+DLLEXPORT void alxr_commit_receive(unsigned int packetSize);
 DLLEXPORT void alxr_on_tracking_update(const bool clientsidePrediction);
+// Samples tracking on an engine thread phase-locked to the display instead, alxr_on_tracking_update
+// calls are ignored while it is running.
+DLLEXPORT bool alxr_start_tracking_sampler(const ALXRTrackingSamplerConfig* config);
+DLLEXPORT void alxr_stop_tracking_sampler();
+DLLEXPORT bool alxr_get_tracking_sampler_stats(/*[out]*/ ALXRTrackingSamplerStats* stats);
 DLLEXPORT void alxr_on_haptics_feedback(unsigned long long path, float duration_s, float frequency, float amplitude);
 DLLEXPORT void alxr_on_server_disconnect();
 DLLEXPORT void alxr_on_pause();
@@ -35,6 +45,37 @@ DLLEXPORT void alxr_on_resume();
 DLLEXPORT void alxr_on_video_packet(const VideoFrame* header, const unsigned char* packet, unsigned int packetSize);
 DLLEXPORT void alxr_on_time_sync(const TimeSync* packet);
 
+DLLEXPORT bool alxr_get_decoder_packet_stats(ALXRDecoderPacketStats* stats);
+
+// Records the video/time-sync stream (from the next IDR) to an append-only capture file for offline replay.
+DLLEXPORT bool alxr_start_stream_capture(const char* path);
+DLLEXPORT void alxr_stop_stream_capture();
+// Feeds a capture through the decoder thread and the headless graphics plugin, no OpenXR runtime or server required.
+DLLEXPORT bool alxr_replay_stream_capture(const ALXRReplayOptions* options, /*[out]*/ ALXRReplayStats* stats);
+
+// Applies the scheduling configured for role (ALXRClientCtx::threadScheduling) to the calling thread,
+// e.g. for the client's network thread. granted receives what the OS actually granted.
+DLLEXPORT bool alxr_set_current_thread_role(ALXRThreadRole role, /*[out]*/ ALXRThreadSchedParams* granted);
+// Last scheduling granted to a thread of the given role, false if no thread has taken the role yet.
+DLLEXPORT bool alxr_get_thread_sched_report(ALXRThreadRole role, /*[out]*/ ALXRThreadSchedParams* granted);
+
+// Per stage latency percentiles of the video pipeline, e.g. for tail latency driven bitrate adaption.
+DLLEXPORT bool alxr_get_latency_report(/*[out]*/ ALXRLatencyReport* report);
+
+// Estimated server clock offset/drift (from TimeSync round trips), false until the first round trip.
+DLLEXPORT bool alxr_get_clock_sync_stats(/*[out]*/ ALXRClockSyncStats* stats);
+
+// Render loop pacing statistics (see ALXRClientCtx::pipelinedFrames), false until the first frame.
+DLLEXPORT bool alxr_get_frame_pacing_stats(/*[out]*/ ALXRFramePacingStats* stats);
+
+// Decoded frame jitter buffer statistics (see ALXRClientCtx::videoJitterBufferDepth), false if disabled.
+DLLEXPORT bool alxr_get_video_jitter_stats(/*[out]*/ ALXRVideoJitterStats* stats);
+
+// Per-frame timeline of the video pipeline (network -> reassembly -> decode -> upload -> render -> submit).
+DLLEXPORT void alxr_set_frame_trace_config(const ALXRFrameTraceConfig* config);
+// Writes the most recent events of every pipeline thread to path.
+DLLEXPORT bool alxr_dump_frame_trace(const char* path, ALXRTraceFormat format);
+
 DLLEXPORT void alxr_set_log_custom_output(ALXRLogOptions options, ALXRLogOutputFn outputFn);
 
 #ifdef __cplusplus
@@ -0,0 +1,228 @@
+// Feeds synthetic (or recorded) TimeSync round trips through ClockOffsetEstimator and compares
+// its offset error against the single sample estimate (server + RTT/2 - now) LatencyManager used before.
+//
+// Synthetic traces model a server clock with a fixed offset and drift, a symmetric base path delay,
+// exponential Wi-Fi jitter and occasional multi-millisecond spikes on one direction of the path.
+//
+// usage: alxr_clock_sync_sim [--scenario wifi|step|congested] [--duration-s N] [--interval-ms N]
+//                            [--drift-ppm X] [--seed N] [--max-p99-us N] [--trace file.csv]
+//
+// --trace replays recorded samples instead, one "clientSendUs,serverTimeUs,clientRecvUs" per line.
+// There is no ground truth for recorded traces, the spread of both estimates is reported instead.
+// Exits with 1 if the estimator's p99 error (synthetic) exceeds --max-p99-us, which defaults to the scenario's gate:
+// 1000us for wifi/step, 2000us for congested. With 1 sample/s and ~3ms of exponential jitter per direction
+// even the lowest RTT samples of a 64 sample window are off by several hundred us, so sub-ms p99 is not
+// reachable there without a longer window (which would slow down tracking the drift).
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "clock_sync.h"
+
+namespace {
+
+using ALXR::ClockOffsetEstimator;
+
+struct Options {
+    std::string   scenario = "wifi";
+    std::uint64_t durationS = 300;
+    std::uint64_t intervalMs = 1000;
+    double        driftPpm = 40.0;
+    std::uint32_t seed = 1;
+    double        maxP99Us = -1.0; // < 0 for the scenario's gate.
+    const char*   tracePath = nullptr;
+};
+
+struct RoundTrip {
+    std::uint64_t clientSendUs;
+    std::uint64_t serverTimeUs;
+    std::uint64_t clientRecvUs;
+    double        trueOffsetUs; // when the server handled the request, NAN for recorded traces.
+};
+
+struct Scenario {
+    double baseOneWayUs;
+    double jitterMeanUs;    // exponential, per direction.
+    double spikeProbability;
+    double spikeMaxUs;      // uniform up to, on one direction only.
+    double stepAtS;         // server clock step, < 0 for none.
+    double stepUs;
+    double maxP99Us;        // default --max-p99-us.
+};
+
+Scenario GetScenario(const std::string& name) {
+    if (name == "step")
+        return { .baseOneWayUs = 1500, .jitterMeanUs = 500, .spikeProbability = 0.05, .spikeMaxUs = 40000, .stepAtS = 150, .stepUs = 50000, .maxP99Us = 1000 };
+    if (name == "congested")
+        return { .baseOneWayUs = 4000, .jitterMeanUs = 3000, .spikeProbability = 0.25, .spikeMaxUs = 80000, .stepAtS = -1, .stepUs = 0, .maxP99Us = 2000 };
+    return { .baseOneWayUs = 1500, .jitterMeanUs = 500, .spikeProbability = 0.05, .spikeMaxUs = 40000, .stepAtS = -1, .stepUs = 0, .maxP99Us = 1000 };
+}
+
+std::vector<RoundTrip> GenerateTrace(const Options& options) {
+    const Scenario scenario = GetScenario(options.scenario);
+    std::mt19937_64 rng{ options.seed };
+    std::exponential_distribution<double> jitter{ 1.0 / scenario.jitterMeanUs };
+    std::uniform_real_distribution<double> unit{ 0.0, 1.0 };
+
+    constexpr const double InitialOffsetUs = 1.7e12; // server on the unix epoch, client on boot time.
+    constexpr const std::uint64_t ClientStartUs = 5'000'000;
+    const auto trueOffset = [&](const double clientUs) {
+        const double elapsedS = (clientUs - ClientStartUs) * 1e-6;
+        const double step = scenario.stepAtS >= 0 && elapsedS >= scenario.stepAtS ? scenario.stepUs : 0;
+        return InitialOffsetUs + options.driftPpm * 1e-6 * (clientUs - ClientStartUs) + step;
+    };
+    const auto oneWay = [&]() {
+        double delayUs = scenario.baseOneWayUs + jitter(rng);
+        if (unit(rng) < scenario.spikeProbability)
+            delayUs += unit(rng) * scenario.spikeMaxUs;
+        return delayUs;
+    };
+
+    std::vector<RoundTrip> trace;
+    const std::uint64_t count = options.durationS * 1000 / options.intervalMs;
+    for (std::uint64_t idx = 0; idx < count; ++idx) {
+        const double sendUs = ClientStartUs + static_cast<double>(idx * options.intervalMs * 1000);
+        const double serverRecvClientUs = sendUs + oneWay();
+        const double recvUs = serverRecvClientUs + oneWay();
+        trace.push_back({
+            .clientSendUs = static_cast<std::uint64_t>(sendUs),
+            .serverTimeUs = static_cast<std::uint64_t>(serverRecvClientUs + trueOffset(serverRecvClientUs)),
+            .clientRecvUs = static_cast<std::uint64_t>(recvUs),
+            .trueOffsetUs = trueOffset(serverRecvClientUs)
+        });
+    }
+    return trace;
+}
+
+std::vector<RoundTrip> LoadTrace(const char* path) {
+    std::vector<RoundTrip> trace;
+    std::FILE* const file = std::fopen(path, "r");
+    if (file == nullptr)
+        return trace;
+    unsigned long long send = 0, server = 0, recv = 0;
+    char line[256];
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::sscanf(line, "%llu,%llu,%llu", &send, &server, &recv) == 3)
+            trace.push_back({ .clientSendUs = send, .serverTimeUs = server, .clientRecvUs = recv, .trueOffsetUs = NAN });
+    }
+    std::fclose(file);
+    return trace;
+}
+
+struct ErrorStats {
+    double p50Us, p99Us, maxUs;
+};
+
+ErrorStats ToStats(std::vector<double> errors) {
+    if (errors.empty())
+        return { 0, 0, 0 };
+    std::sort(errors.begin(), errors.end());
+    return {
+        errors[errors.size() / 2],
+        errors[std::min(errors.size() - 1, errors.size() * 99 / 100)],
+        errors.back()
+    };
+}
+
+double StdDev(const std::vector<double>& values) {
+    if (values.size() < 2)
+        return 0;
+    double mean = 0, sq = 0;
+    for (const double v : values) mean += v;
+    mean /= static_cast<double>(values.size());
+    for (const double v : values) sq += (v - mean) * (v - mean);
+    return std::sqrt(sq / static_cast<double>(values.size() - 1));
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--scenario") == 0)         options.scenario = value;
+        else if (std::strcmp(name, "--duration-s") == 0)  options.durationS = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(name, "--interval-ms") == 0) options.intervalMs = std::max<std::uint64_t>(1, std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(name, "--drift-ppm") == 0)   options.driftPpm = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--seed") == 0)        options.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(name, "--max-p99-us") == 0)  options.maxP99Us = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--trace") == 0)       options.tracePath = value;
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    const bool isRecorded = options.tracePath != nullptr;
+    const auto trace = isRecorded ? LoadTrace(options.tracePath) : GenerateTrace(options);
+    if (trace.empty()) {
+        std::fprintf(stderr, "no samples\n");
+        return EXIT_FAILURE;
+    }
+
+    // errors are only counted once the estimator had time to converge (again, after a clock step).
+    constexpr const std::uint64_t ConvergenceUs = 20'000'000;
+    const Scenario scenario = GetScenario(options.scenario);
+    const std::uint64_t startUs = trace.front().clientSendUs;
+    const auto isConverging = [&](const std::uint64_t clientUs) {
+        if (clientUs - startUs < ConvergenceUs)
+            return true;
+        if (scenario.stepAtS < 0 || isRecorded)
+            return false;
+        const double stepUs = startUs + scenario.stepAtS * 1e6;
+        return clientUs >= stepUs && clientUs - stepUs < ConvergenceUs;
+    };
+
+    ClockOffsetEstimator estimator{};
+    std::vector<double> naiveErrors, filteredErrors, naiveOffsets, filteredOffsets;
+    std::size_t restarts = 0;
+    for (const auto& rt : trace) {
+        const std::uint64_t rttUs = rt.clientRecvUs - rt.clientSendUs;
+        const double naiveOffset = static_cast<double>(rt.serverTimeUs) + rttUs / 2.0 - static_cast<double>(rt.clientRecvUs);
+        if (estimator.AddSample(rt.clientSendUs, rt.serverTimeUs, rt.clientRecvUs) == ClockOffsetEstimator::SampleResult::Restarted)
+            ++restarts;
+        const double filteredOffset = static_cast<double>(estimator.OffsetAt(rt.clientRecvUs));
+        if (isConverging(rt.clientRecvUs))
+            continue;
+        if (isRecorded) {
+            naiveOffsets.push_back(naiveOffset);
+            filteredOffsets.push_back(filteredOffset);
+        } else {
+            naiveErrors.push_back(std::abs(naiveOffset - rt.trueOffsetUs));
+            filteredErrors.push_back(std::abs(filteredOffset - rt.trueOffsetUs));
+        }
+    }
+
+    const auto estimate = estimator.GetEstimate(trace.back().clientRecvUs);
+    std::printf("samples=%zu rejected=%llu restarts=%zu drift=%.2fppm uncertainty=%lluus min-rtt=%lluus\n",
+        trace.size(), static_cast<unsigned long long>(estimator.RejectedCount()), restarts, estimate.driftPpm,
+        static_cast<unsigned long long>(estimate.uncertaintyUs), static_cast<unsigned long long>(estimate.minRttUs));
+
+    if (isRecorded) {
+        std::printf("%-10s %14s\n", "estimator", "offset sd us");
+        std::printf("%-10s %14.1f\n", "naive", StdDev(naiveOffsets));
+        std::printf("%-10s %14.1f\n", "filtered", StdDev(filteredOffsets));
+        return EXIT_SUCCESS;
+    }
+
+    const auto naive = ToStats(naiveErrors);
+    const auto filtered = ToStats(filteredErrors);
+    std::printf("scenario=%s duration=%llus interval=%llums drift=%.1fppm\n", options.scenario.c_str(),
+        static_cast<unsigned long long>(options.durationS), static_cast<unsigned long long>(options.intervalMs), options.driftPpm);
+    std::printf("%-10s %12s %12s %12s\n", "estimator", "p50 err us", "p99 err us", "max err us");
+    std::printf("%-10s %12.1f %12.1f %12.1f\n", "naive", naive.p50Us, naive.p99Us, naive.maxUs);
+    std::printf("%-10s %12.1f %12.1f %12.1f\n", "filtered", filtered.p50Us, filtered.p99Us, filtered.maxUs);
+    const double maxP99Us = options.maxP99Us < 0 ? scenario.maxP99Us : options.maxP99Us;
+    if (filtered.p99Us > maxP99Us) {
+        std::printf("FAIL: p99 offset error %.1fus exceeds %.1fus\n", filtered.p99Us, maxP99Us);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+// Inter-frame jitter and rate drift of ALXR::DeadlinePacer vs the relative sleep_for loop headless sessions
+// used before, at tracking-only rates. With --check (the default on Linux) the pacer's results are asserted
+// against the given bounds and the exit code is non-zero if any rate exceeds them.
+//
+// Jitter is the wake-up time minus the deadline the loop was scheduled for (the previous wake-up + period for
+// sleep_for), over the frames which did not skip a deadline. Skipped deadlines are counted separately and
+// gated on their share of the frames, a skip would otherwise show up as a whole period of jitter.
+//
+// usage: alxr_deadline_pacer_bench [--rates 500,1000] [--frames N] [--spin-us N]
+//                                  [--max-p99-jitter-us X] [--max-drift-ppm X] [--max-missed-pct X] [--check 0|1]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "deadline_pacer.h"
+
+namespace {
+
+using Clock = ALXR::DeadlinePacer::Clock;
+
+struct Options {
+    std::vector<double> rates{ 500.0, 1000.0 };
+    std::size_t   frames = 5000;
+    std::uint64_t spinUs = static_cast<std::uint64_t>(ALXR::DeadlinePacer::DefaultSpinTail.count());
+    double        maxP99JitterUs = 100.0;
+    double        maxDriftPpm = 200.0;
+    double        maxMissedPct = 2.0;
+#ifdef __linux__
+    bool          check = true;
+#else
+    bool          check = false;
+#endif
+};
+
+struct Result {
+    double p50JitterUs, p99JitterUs, maxJitterUs; // |wake - scheduled deadline|, frames which skipped excluded.
+    double driftPpm;                              // phase error over the run, skipped deadlines excluded.
+    std::uint64_t missed;
+    double missedPct;                             // skipped deadlines per frame.
+};
+
+struct Wakeup {
+    Clock::time_point wakeTime;
+    Clock::time_point deadline;
+    bool              skipped;
+};
+
+Result Summarize(const std::vector<Wakeup>& wakeups, const double rate, const std::uint64_t missed) {
+    const double periodUs = 1e6 / rate;
+    std::vector<double> jitterUs;
+    jitterUs.reserve(wakeups.size());
+    for (std::size_t idx = 1; idx < wakeups.size(); ++idx) {
+        if (!wakeups[idx].skipped)
+            jitterUs.push_back(std::abs(std::chrono::duration<double, std::micro>(wakeups[idx].wakeTime - wakeups[idx].deadline).count()));
+    }
+    if (jitterUs.empty())
+        jitterUs.push_back(0);
+    std::sort(jitterUs.begin(), jitterUs.end());
+    const double elapsedUs = std::chrono::duration<double, std::micro>(wakeups.back().wakeTime - wakeups.front().wakeTime).count();
+    const double expectedUs = periodUs * static_cast<double>(wakeups.size() - 1 + missed);
+    return {
+        .p50JitterUs = jitterUs[jitterUs.size() / 2],
+        .p99JitterUs = jitterUs[std::min(jitterUs.size() - 1, jitterUs.size() * 99 / 100)],
+        .maxJitterUs = jitterUs.back(),
+        .driftPpm = (elapsedUs - expectedUs) / expectedUs * 1e6,
+        .missed = missed,
+        .missedPct = 100.0 * static_cast<double>(missed) / static_cast<double>(wakeups.size())
+    };
+}
+
+// what OpenXrProgram::HeadlessWaitFrame did: sleep for the remainder of the period since the last wake-up.
+Result RunRelativeSleep(const double rate, const std::size_t frames) {
+    const auto period = std::chrono::duration<double>(1.0 / rate);
+    std::vector<Wakeup> wakeups;
+    wakeups.reserve(frames);
+    auto lastFrameTime = Clock::now();
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+        const auto deadline = lastFrameTime + std::chrono::duration_cast<Clock::duration>(period);
+        const auto elapsed = Clock::now() - lastFrameTime;
+        if (elapsed < period)
+            std::this_thread::sleep_for(period - elapsed);
+        lastFrameTime = Clock::now();
+        wakeups.push_back({ .wakeTime = lastFrameTime, .deadline = deadline, .skipped = false });
+    }
+    return Summarize(wakeups, rate, 0);
+}
+
+Result RunDeadlinePacer(const double rate, const std::size_t frames, const std::uint64_t spinUs) {
+    ALXR::DeadlinePacer pacer{ std::chrono::microseconds(spinUs) };
+    pacer.SetRate(rate);
+    std::vector<Wakeup> wakeups;
+    wakeups.reserve(frames);
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+        const std::uint64_t missedBefore = pacer.MissedDeadlines();
+        const auto deadline = pacer.Wait();
+        const auto wakeTime = Clock::now();
+        // a wake-up past the next deadline is the miss, the pacer only counts it on the following Wait.
+        const bool skipped = pacer.MissedDeadlines() != missedBefore || wakeTime - deadline >= pacer.Period();
+        wakeups.push_back({ .wakeTime = wakeTime, .deadline = deadline, .skipped = skipped });
+    }
+    return Summarize(wakeups, rate, pacer.MissedDeadlines());
+}
+
+void Print(const char* name, const double rate, const Result& result) {
+    std::printf("%-10s %8.0f %10.1f %10.1f %10.1f %10.1f %8llu %9.2f\n", name, rate,
+        result.p50JitterUs, result.p99JitterUs, result.maxJitterUs, result.driftPpm,
+        static_cast<unsigned long long>(result.missed), result.missedPct);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--rates") == 0) {
+            options.rates.clear();
+            for (const char* itr = value; *itr != '\0';) {
+                char* end = nullptr;
+                const double rate = std::strtod(itr, &end);
+                if (end == itr)
+                    break;
+                if (rate > 0)
+                    options.rates.push_back(rate);
+                itr = (*end == ',') ? end + 1 : end;
+            }
+        }
+        else if (std::strcmp(name, "--frames") == 0)            options.frames = std::max<std::size_t>(2, std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(name, "--spin-us") == 0)           options.spinUs = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(name, "--max-p99-jitter-us") == 0) options.maxP99JitterUs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--max-drift-ppm") == 0)     options.maxDriftPpm = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--max-missed-pct") == 0)    options.maxMissedPct = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--check") == 0)             options.check = std::atoi(value) != 0;
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    std::printf("frames=%zu spin=%lluus\n", options.frames, static_cast<unsigned long long>(options.spinUs));
+    std::printf("%-10s %8s %10s %10s %10s %10s %8s %9s\n", "pacer", "hz", "p50 us", "p99 us", "max us", "drift ppm", "missed", "missed %");
+    bool isWithinBounds = true;
+    for (const double rate : options.rates) {
+        Print("sleep_for", rate, RunRelativeSleep(rate, options.frames));
+        const auto result = RunDeadlinePacer(rate, options.frames, options.spinUs);
+        Print("deadline", rate, result);
+        if (options.check &&
+            (result.p99JitterUs > options.maxP99JitterUs || std::abs(result.driftPpm) > options.maxDriftPpm ||
+             result.missedPct > options.maxMissedPct)) {
+            std::printf("FAILED: %.0fHz p99 jitter %.1fus (max %.1fus), drift %.1fppm (max %.1fppm), missed %.2f%% (max %.2f%%)\n", rate,
+                result.p99JitterUs, options.maxP99JitterUs, result.driftPpm, options.maxDriftPpm,
+                result.missedPct, options.maxMissedPct);
+            isWithinBounds = false;
+        }
+    }
+    return isWithinBounds ? EXIT_SUCCESS : EXIT_FAILURE;
+}
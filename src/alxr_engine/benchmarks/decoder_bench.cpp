@@ -0,0 +1,392 @@
+// End-to-end decoder benchmark without hardware or a server: encodes synthetic stereo side-by-side content
+// (optionally at the foveated encode size) with libavcodec, packetizes it into VideoFrame shards the same way
+// the server does (optional FEC and simulated packet loss) and replays it through the decoder thread,
+// CreateDecoderPlugin() and the headless graphics plugin, see alxr_replay_stream_capture.
+//
+// Reports p50/p99/p999 FEC, decode and upload latency and process CPU usage during the replay.
+//
+// usage: alxr_decoder_bench [--eye-width=N] [--eye-height=N] [--fps=N] [--frames=N] [--bitrate-mbps=N]
+//                           [--codec=h264|hevc] [--slices=N] [--slice-streaming] [--foveation]
+//                           [--fec=percent] [--loss=percent] [--link-mbps=N] [--seed=N]
+//                           [--decoder=cpu|vaapi|nvdec|cuvid] [--decoder-threads=N] [--max-speed]
+//                           [--capture=path] [--max-decode-p99-ms=N]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/opt.h>
+#include <libavutil/frame.h>
+#include <libavcodec/avcodec.h>
+#include "reedsolomon/rs.h"
+}
+
+#include "alxr_engine.h"
+#include "foveation.h"
+#include "stream_capture.h"
+
+namespace {
+
+struct BenchOptions {
+    std::uint32_t eyeWidth = 1024;
+    std::uint32_t eyeHeight = 1024;
+    std::uint32_t fps = 72;
+    std::uint32_t frames = 600;
+    double        bitrateMbps = 30;
+    ALXRCodecType codecType = ALXRCodecType::H264_CODEC;
+    std::uint32_t slices = 1;
+    bool          sliceStreaming = false;
+    bool          foveation = false;
+    std::uint32_t fecPercentage = 0;
+    double        lossPercentage = 0;
+    double        linkMbps = 1000;
+    std::uint32_t seed = 1;
+    ALXRDecoderType decoderType = ALXRDecoderType::CPU;
+    std::uint32_t decoderThreads = 4;
+    bool          maxSpeed = false;
+    std::string   capturePath{};
+    double        maxDecodeP99Ms = 0;
+};
+
+bool ParseArgs(const int argc, char* argv[], BenchOptions& opts) {
+    const auto value = [](const std::string_view arg, const std::string_view name, std::string_view& out) {
+        if (!arg.starts_with(name))
+            return false;
+        out = arg.substr(name.size());
+        return true;
+    };
+    const auto toUInt = [](const std::string_view s) { return static_cast<std::uint32_t>(std::strtoul(std::string(s).c_str(), nullptr, 10)); };
+    const auto toDouble = [](const std::string_view s) { return std::strtod(std::string(s).c_str(), nullptr); };
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{ argv[i] };
+        std::string_view v{};
+        if (value(arg, "--eye-width=", v))             opts.eyeWidth = toUInt(v);
+        else if (value(arg, "--eye-height=", v))       opts.eyeHeight = toUInt(v);
+        else if (value(arg, "--fps=", v))              opts.fps = std::max(1u, toUInt(v));
+        else if (value(arg, "--frames=", v))           opts.frames = toUInt(v);
+        else if (value(arg, "--bitrate-mbps=", v))     opts.bitrateMbps = toDouble(v);
+        else if (value(arg, "--slices=", v))           opts.slices = std::max(1u, toUInt(v));
+        else if (value(arg, "--fec=", v))              opts.fecPercentage = toUInt(v);
+        else if (value(arg, "--loss=", v))             opts.lossPercentage = toDouble(v);
+        else if (value(arg, "--link-mbps=", v))        opts.linkMbps = toDouble(v);
+        else if (value(arg, "--seed=", v))             opts.seed = toUInt(v);
+        else if (value(arg, "--decoder-threads=", v))  opts.decoderThreads = toUInt(v);
+        else if (value(arg, "--capture=", v))          opts.capturePath = v;
+        else if (value(arg, "--max-decode-p99-ms=", v)) opts.maxDecodeP99Ms = toDouble(v);
+        else if (arg == "--slice-streaming")           opts.sliceStreaming = true;
+        else if (arg == "--foveation")                 opts.foveation = true;
+        else if (arg == "--max-speed")                 opts.maxSpeed = true;
+        else if (value(arg, "--codec=", v)) {
+            if (v == "h264")      opts.codecType = ALXRCodecType::H264_CODEC;
+            else if (v == "hevc") opts.codecType = ALXRCodecType::HEVC_CODEC;
+            else return false;
+        }
+        else if (value(arg, "--decoder=", v)) {
+            if (v == "cpu")        opts.decoderType = ALXRDecoderType::CPU;
+            else if (v == "vaapi") opts.decoderType = ALXRDecoderType::VAAPI;
+            else if (v == "nvdec") opts.decoderType = ALXRDecoderType::NVDEC;
+            else if (v == "cuvid") opts.decoderType = ALXRDecoderType::CUVID;
+            else return false;
+        }
+        else {
+            std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return opts.eyeWidth > 0 && opts.eyeHeight > 0 && opts.frames > 0;
+}
+
+// Per-eye size the server encodes at, foveated encoding shrinks the periphery by the edge ratio.
+void GetEncodeEyeSize(const BenchOptions& opts, std::uint32_t& width, std::uint32_t& height) {
+    width = opts.eyeWidth;
+    height = opts.eyeHeight;
+    if (!opts.foveation)
+        return;
+    // ALVR's default foveation settings.
+    const ALXRRenderConfig rc {
+        .eyeWidth = opts.eyeWidth,
+        .eyeHeight = opts.eyeHeight,
+        .refreshRate = float(opts.fps),
+        .foveationCenterSizeX = 0.4f,
+        .foveationCenterSizeY = 0.35f,
+        .foveationCenterShiftX = 0.4f,
+        .foveationCenterShiftY = 0.1f,
+        .foveationEdgeRatioX = 4.0f,
+        .foveationEdgeRatioY = 5.0f,
+        .enableFoveation = true
+    };
+    const auto fdp = ALXR::MakeFoveatedDecodeParams(rc);
+    const float scaleX = fdp.centerSize.x + (1.0f - fdp.centerSize.x) / fdp.edgeRatio.x;
+    const float scaleY = fdp.centerSize.y + (1.0f - fdp.centerSize.y) / fdp.edgeRatio.y;
+    width  = static_cast<std::uint32_t>(std::ceil(scaleX * opts.eyeWidth / 32.f)) * 32;
+    height = static_cast<std::uint32_t>(std::ceil(scaleY * opts.eyeHeight / 32.f)) * 32;
+}
+
+// Moving gradients and a moving block per eye with a small horizontal disparity between the eyes,
+// enough motion and detail that the encoder produces a realistic mix of intra/inter blocks.
+void FillSyntheticFrame(AVFrame& frame, const std::uint32_t eyeWidth, const std::uint32_t frameIndex) {
+    const int t = static_cast<int>(frameIndex);
+    const int blockSize = std::max(16, frame.height / 6);
+    const int blockY = (t * 3) % std::max(1, frame.height - blockSize);
+    for (int y = 0; y < frame.height; ++y) {
+        std::uint8_t* const row = frame.data[0] + y * frame.linesize[0];
+        for (int x = 0; x < frame.width; ++x) {
+            const int eye = x / static_cast<int>(eyeWidth);
+            const int ex = x % static_cast<int>(eyeWidth) + eye * 8; // disparity
+            const int blockX = (t * 5) % std::max(1, static_cast<int>(eyeWidth) - blockSize);
+            const bool inBlock = ex >= blockX && ex < blockX + blockSize && y >= blockY && y < blockY + blockSize;
+            row[x] = inBlock ? 235 : static_cast<std::uint8_t>(((ex + t * 2) ^ (y + t)) & 0x7F) + 32;
+        }
+    }
+    for (int plane = 1; plane < 3; ++plane) {
+        for (int y = 0; y < frame.height / 2; ++y) {
+            std::uint8_t* const row = frame.data[plane] + y * frame.linesize[plane];
+            for (int x = 0; x < frame.width / 2; ++x)
+                row[x] = static_cast<std::uint8_t>(128 + ((x + y * plane + t) & 0x1F) - 16);
+        }
+    }
+}
+
+using EncodedFrame = std::vector<std::uint8_t>;
+
+bool EncodeFrames(const BenchOptions& opts, const std::uint32_t eyeWidth, const std::uint32_t eyeHeight, std::vector<EncodedFrame>& encodedFrames) {
+    const AVCodecID codecId = opts.codecType == ALXRCodecType::HEVC_CODEC ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264;
+    const AVCodec* const codec = avcodec_find_encoder(codecId);
+    if (codec == nullptr) {
+        std::fprintf(stderr, "no %s encoder available in this libavcodec build\n", avcodec_get_name(codecId));
+        return false;
+    }
+    AVCodecContext* codecCtx = avcodec_alloc_context3(codec);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    const auto cleanup = [&]() {
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codecCtx);
+    };
+
+    const auto bitrate = static_cast<std::int64_t>(opts.bitrateMbps * 1000000.0);
+    codecCtx->width = static_cast<int>(eyeWidth * 2);
+    codecCtx->height = static_cast<int>(eyeHeight);
+    codecCtx->pix_fmt = AV_PIX_FMT_YUV420P;
+    codecCtx->time_base = AVRational{ 1, static_cast<int>(opts.fps) };
+    codecCtx->framerate = AVRational{ static_cast<int>(opts.fps), 1 };
+    codecCtx->bit_rate = bitrate;
+    codecCtx->rc_max_rate = bitrate;
+    // single frame VBV like the server, keeps frame sizes close to bitrate / fps.
+    codecCtx->rc_buffer_size = static_cast<int>(bitrate / opts.fps);
+    // one IDR at the start, the server only sends further IDRs on request.
+    codecCtx->gop_size = static_cast<int>(opts.frames);
+    codecCtx->max_b_frames = 0;
+    codecCtx->slices = static_cast<int>(opts.slices);
+    av_opt_set(codecCtx->priv_data, "preset", "ultrafast", 0);
+    av_opt_set(codecCtx->priv_data, "tune", "zerolatency", 0);
+    if (avcodec_open2(codecCtx, codec, nullptr) < 0) {
+        std::fprintf(stderr, "failed to open %s encoder\n", codec->name);
+        cleanup();
+        return false;
+    }
+
+    frame->width = codecCtx->width;
+    frame->height = codecCtx->height;
+    frame->format = codecCtx->pix_fmt;
+    if (av_frame_get_buffer(frame, 0) < 0) {
+        cleanup();
+        return false;
+    }
+
+    const auto receivePackets = [&]() {
+        while (avcodec_receive_packet(codecCtx, packet) == 0) {
+            encodedFrames.emplace_back(packet->data, packet->data + packet->size);
+            av_packet_unref(packet);
+        }
+    };
+    encodedFrames.reserve(opts.frames);
+    for (std::uint32_t frameIndex = 0; frameIndex < opts.frames; ++frameIndex) {
+        if (av_frame_make_writable(frame) < 0)
+            break;
+        FillSyntheticFrame(*frame, eyeWidth, frameIndex);
+        frame->pts = frameIndex;
+        if (avcodec_send_frame(codecCtx, frame) < 0)
+            break;
+        receivePackets();
+    }
+    avcodec_send_frame(codecCtx, nullptr);
+    receivePackets();
+    std::printf("encoder: %s %ux%u, %zu frames\n", codec->name, codecCtx->width, codecCtx->height, encodedFrames.size());
+    cleanup();
+    return !encodedFrames.empty();
+}
+
+// Splits an encoded frame into VideoFrame packets as the server does, with FEC the frame is padded into
+// blocks of shardPackets * ALVR_MAX_VIDEO_BUFFER_SIZE and parity shards follow the data shards.
+class Packetizer {
+    std::vector<std::uint8_t>   m_shardBuffer{};
+    std::vector<unsigned char*> m_shards{};
+    std::uint32_t               m_packetCounter = 0;
+
+public:
+    template < typename EmitFn >
+    void Packetize(const EncodedFrame& frame, const std::uint64_t frameIndex, const std::uint32_t fecPercentage, EmitFn&& emit) {
+        VideoFrame header{};
+        header.type = ALVR_PACKET_TYPE_VIDEO_FRAME;
+        header.trackingFrameIndex = frameIndex;
+        header.videoFrameIndex = frameIndex;
+        header.frameByteSize = static_cast<std::uint32_t>(frame.size());
+        header.fecPercentage = static_cast<std::uint16_t>(fecPercentage);
+
+        if (fecPercentage == 0) {
+            header.packetCounter = m_packetCounter++;
+            header.fecIndex = 0;
+            emit(header, std::span<const std::uint8_t>{ frame });
+            return;
+        }
+
+        const int frameSize = static_cast<int>(frame.size());
+        const int shardPackets = CalculateFECShardPackets(frameSize, static_cast<int>(fecPercentage));
+        const int blockSize = shardPackets * ALVR_MAX_VIDEO_BUFFER_SIZE;
+        const int dataShards = (frameSize + blockSize - 1) / blockSize;
+        const int parityShards = CalculateParityShards(dataShards, static_cast<int>(fecPercentage));
+        const int totalShards = dataShards + parityShards;
+
+        m_shardBuffer.assign(std::size_t(totalShards) * blockSize, 0);
+        std::memcpy(m_shardBuffer.data(), frame.data(), frame.size());
+        m_shards.resize(totalShards);
+        for (int i = 0; i < totalShards; ++i)
+            m_shards[i] = m_shardBuffer.data() + std::size_t(i) * blockSize;
+        reed_solomon* const rs = reed_solomon_new(dataShards, parityShards);
+        reed_solomon_encode(rs, m_shards.data(), totalShards, blockSize);
+        reed_solomon_release(rs);
+
+        int dataRemain = frameSize;
+        for (int shard = 0; shard < totalShards; ++shard) {
+            for (int packet = 0; packet < shardPackets; ++packet) {
+                const int packetIndex = shard * shardPackets + packet;
+                int copyLength = ALVR_MAX_VIDEO_BUFFER_SIZE;
+                if (shard < dataShards) {
+                    if (dataRemain <= 0)
+                        continue;
+                    copyLength = std::min(copyLength, dataRemain);
+                    dataRemain -= copyLength;
+                }
+                header.packetCounter = m_packetCounter++;
+                header.fecIndex = static_cast<std::uint32_t>(packetIndex);
+                emit(header, std::span<const std::uint8_t>{ m_shardBuffer.data() + std::size_t(packetIndex) * ALVR_MAX_VIDEO_BUFFER_SIZE, std::size_t(copyLength) });
+            }
+        }
+    }
+};
+
+void PrintStage(const char* name, const ALXRReplayStageTimes& t) {
+    std::printf("%-8s %10.3f %10.3f %10.3f %10.3f\n", name, t.p50 / 1000.0, t.p99 / 1000.0, t.p999 / 1000.0, t.max / 1000.0);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts{};
+    if (!ParseArgs(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: see the header of decoder_bench.cpp\n");
+        return EXIT_FAILURE;
+    }
+
+    std::uint32_t eyeWidth = 0, eyeHeight = 0;
+    GetEncodeEyeSize(opts, eyeWidth, eyeHeight);
+    std::printf("eye %ux%u%s -> encoded eye %ux%u, %u fps, %.1f Mbps, slices=%u, fec=%u%%, loss=%.2f%%\n",
+        opts.eyeWidth, opts.eyeHeight, opts.foveation ? " (foveated)" : "", eyeWidth, eyeHeight,
+        opts.fps, opts.bitrateMbps, opts.slices, opts.fecPercentage, opts.lossPercentage);
+
+    std::vector<EncodedFrame> encodedFrames{};
+    if (!EncodeFrames(opts, eyeWidth, eyeHeight, encodedFrames))
+        return EXIT_FAILURE;
+
+    const bool isTempCapture = opts.capturePath.empty();
+    if (isTempCapture)
+        opts.capturePath = (std::filesystem::temp_directory_path() / "alxr_decoder_bench.alxrcap").string();
+
+    const ALXRDecoderConfig decoderConfig {
+        .codecType = opts.codecType,
+        .cpuThreadCount = opts.decoderThreads,
+        .enableFEC = opts.fecPercentage > 0,
+        .realtimePriority = false,
+        .sliceStreaming = opts.sliceStreaming
+    };
+    std::size_t packetsSent = 0, packetsLost = 0, bytesEncoded = 0;
+    {
+        reed_solomon_init();
+        ALXR::StreamCapture::Writer writer{};
+        if (!writer.Open(opts.capturePath))
+            return EXIT_FAILURE;
+        writer.WriteDecoderConfig(decoderConfig, 0);
+
+        std::mt19937 rng{ opts.seed };
+        std::uniform_real_distribution<double> lossDist{ 0.0, 100.0 };
+        Packetizer packetizer{};
+        const double usPerByte = 8.0 / opts.linkMbps;
+        for (std::size_t frameIndex = 0; frameIndex < encodedFrames.size(); ++frameIndex) {
+            const auto& frame = encodedFrames[frameIndex];
+            bytesEncoded += frame.size();
+            // packets of a frame arrive back to back at the link rate.
+            double timestampUs = frameIndex * 1000000.0 / opts.fps;
+            packetizer.Packetize(frame, frameIndex + 1, opts.fecPercentage, [&](const VideoFrame& header, const std::span<const std::uint8_t> payload) {
+                timestampUs += (sizeof(VideoFrame) + payload.size()) * usPerByte;
+                ++packetsSent;
+                if (lossDist(rng) < opts.lossPercentage) {
+                    ++packetsLost;
+                    return;
+                }
+                writer.WriteVideoPacket(header, payload, static_cast<std::uint64_t>(timestampUs));
+            });
+        }
+    }
+    std::printf("stream: %.2f Mbps actual, %zu packets, %zu lost\n",
+        bytesEncoded * 8.0 * opts.fps / encodedFrames.size() / 1000000.0, packetsSent, packetsLost);
+
+    const ALXRReplayOptions replayOptions {
+        .capturePath = opts.capturePath.c_str(),
+        .decoderType = opts.decoderType,
+        .maxSpeed = opts.maxSpeed
+    };
+    ALXRReplayStats stats{};
+    const std::clock_t cpuStart = std::clock();
+    const bool replayed = alxr_replay_stream_capture(&replayOptions, &stats);
+    const double cpuSecs = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    if (isTempCapture) {
+        std::error_code ec{};
+        std::filesystem::remove(opts.capturePath, ec);
+    }
+    if (!replayed) {
+        std::fprintf(stderr, "replay failed\n");
+        return EXIT_FAILURE;
+    }
+
+    const double secs = stats.durationUs / 1e6;
+    std::printf("decoded %llu/%llu frames in %.2fs, cpu %.1f%% of one core\n",
+        (unsigned long long)stats.framesUploaded, (unsigned long long)stats.framesInCapture,
+        secs, secs > 0 ? cpuSecs / secs * 100.0 : 0.0);
+    std::printf("%-8s %10s %10s %10s %10s\n", "stage", "p50 ms", "p99 ms", "p999 ms", "max ms");
+    PrintStage("fec", stats.fec);
+    PrintStage("decode", stats.decode);
+    PrintStage("upload", stats.upload);
+    std::printf("drops: frames=%llu shards=%llu decoder-packets=%llu decoder-skipped=%llu\n",
+        (unsigned long long)stats.framesDropped, (unsigned long long)stats.shardsDropped,
+        (unsigned long long)stats.decoderStats.packetsDropped, (unsigned long long)stats.decoderStats.framesSkipped);
+
+    if (stats.framesUploaded == 0)
+        return EXIT_FAILURE;
+    if (opts.maxDecodeP99Ms > 0 && stats.decode.p99 / 1000.0 > opts.maxDecodeP99Ms) {
+        std::fprintf(stderr, "decode p99 %.3f ms exceeds %.3f ms\n", stats.decode.p99 / 1000.0, opts.maxDecodeP99Ms);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+// Measures GF(2^8) Reed-Solomon throughput (MB/s) of the fec_simd kernels for
+// parity generation and recovery across shard counts and loss rates.
+//
+// usage: alxr_fec_bench [shard-size-bytes] [iterations]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "fec_simd.h"
+
+namespace {
+
+using namespace ALXR;
+using Shard = std::vector<std::uint8_t>;
+using Matrix = std::vector<std::uint8_t>; // row-major
+
+// Cauchy encoding rows, any k rows of [I; C] are invertible.
+Matrix MakeCauchyMatrix(const std::size_t dataShards, const std::size_t parityShards) {
+    Matrix m(parityShards * dataShards);
+    for (std::size_t r = 0; r < parityShards; ++r) {
+        for (std::size_t c = 0; c < dataShards; ++c) {
+            const auto x = static_cast<std::uint8_t>(dataShards + r);
+            const auto y = static_cast<std::uint8_t>(c);
+            m[r * dataShards + c] = GF256::Inv(x ^ y);
+        }
+    }
+    return m;
+}
+
+bool Invert(Matrix m, const std::size_t n, Matrix& out) {
+    out.assign(n * n, 0);
+    for (std::size_t i = 0; i < n; ++i)
+        out[i * n + i] = 1;
+    for (std::size_t col = 0; col < n; ++col) {
+        std::size_t pivot = col;
+        while (pivot < n && m[pivot * n + col] == 0)
+            ++pivot;
+        if (pivot == n)
+            return false;
+        if (pivot != col) {
+            std::swap_ranges(m.begin() + pivot * n, m.begin() + pivot * n + n, m.begin() + col * n);
+            std::swap_ranges(out.begin() + pivot * n, out.begin() + pivot * n + n, out.begin() + col * n);
+        }
+        const std::uint8_t scale = GF256::Inv(m[col * n + col]);
+        GF256::MulRegion(&m[col * n], &m[col * n], scale, n);
+        GF256::MulRegion(&out[col * n], &out[col * n], scale, n);
+        for (std::size_t row = 0; row < n; ++row) {
+            const std::uint8_t f = m[row * n + col];
+            if (row == col || f == 0)
+                continue;
+            GF256::MulAddRegion(&m[row * n], &m[col * n], f, n);
+            GF256::MulAddRegion(&out[row * n], &out[col * n], f, n);
+        }
+    }
+    return true;
+}
+
+void Encode(const Matrix& cauchy, const std::vector<Shard>& data, std::vector<Shard>& parity) {
+    const std::size_t k = data.size();
+    for (std::size_t r = 0; r < parity.size(); ++r) {
+        auto& p = parity[r];
+        std::fill(p.begin(), p.end(), std::uint8_t(0));
+        for (std::size_t c = 0; c < k; ++c)
+            GF256::MulAddRegion(p.data(), data[c].data(), cauchy[r * k + c], p.size());
+    }
+}
+
+// Rebuilds the lost data shards from the surviving data + parity shards.
+bool Recover
+(
+    const Matrix& cauchy,
+    std::vector<Shard>& data,
+    const std::vector<Shard>& parity,
+    const std::vector<bool>& lost
+) {
+    const std::size_t k = data.size();
+    std::vector<std::size_t> lostIdx;
+    for (std::size_t i = 0; i < k; ++i)
+        if (lost[i]) lostIdx.push_back(i);
+    if (lostIdx.empty())
+        return true;
+    if (lostIdx.size() > parity.size())
+        return false;
+
+    // decode matrix rows: identity for surviving data shards followed by parity rows.
+    Matrix sub(k * k, 0);
+    std::vector<const Shard*> inputs;
+    std::size_t row = 0, parityRow = 0;
+    for (std::size_t i = 0; i < k; ++i) {
+        if (lost[i])
+            continue;
+        sub[row * k + i] = 1;
+        inputs.push_back(&data[i]);
+        ++row;
+    }
+    for (; row < k; ++row, ++parityRow) {
+        std::copy_n(&cauchy[parityRow * k], k, &sub[row * k]);
+        inputs.push_back(&parity[parityRow]);
+    }
+    Matrix inv;
+    if (!Invert(sub, k, inv))
+        return false;
+    for (const auto li : lostIdx) {
+        auto& out = data[li];
+        std::fill(out.begin(), out.end(), std::uint8_t(0));
+        for (std::size_t c = 0; c < k; ++c)
+            GF256::MulAddRegion(out.data(), inputs[c]->data(), inv[li * k + c], out.size());
+    }
+    return true;
+}
+
+double ToMBps(const std::size_t bytes, const std::chrono::steady_clock::duration d) {
+    const double secs = std::chrono::duration<double>(d).count();
+    return secs > 0 ? (double(bytes) / (1024.0 * 1024.0)) / secs : 0.0;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t shardSize  = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1400;
+    const std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+    constexpr const std::size_t DataShardCounts[] = { 16, 32, 64, 128 };
+    constexpr const float ParityRatio = 0.2f;
+    constexpr const float LossRates[] = { 0.01f, 0.05f, 0.10f, 0.20f };
+    constexpr const GF256::KernelType Kernels[] = {
+        GF256::KernelType::Scalar, GF256::KernelType::SSSE3,
+        GF256::KernelType::AVX2,   GF256::KernelType::NEON
+    };
+
+    std::printf("shard-size=%zu bytes, iterations=%zu, parity-ratio=%.2f\n", shardSize, iterations, ParityRatio);
+    std::printf("%-8s %6s %6s %6s %14s %14s\n", "kernel", "data", "parity", "loss", "encode MB/s", "recover MB/s");
+
+    std::mt19937 rng{ 1234 };
+    int failures = 0;
+    for (const auto kt : Kernels) {
+        if (!GF256::SetActiveKernel(kt))
+            continue;
+        for (const auto k : DataShardCounts) {
+            const std::size_t m = std::max<std::size_t>(1, static_cast<std::size_t>(k * ParityRatio));
+            const Matrix cauchy = MakeCauchyMatrix(k, m);
+
+            std::vector<Shard> data(k, Shard(shardSize)), parity(m, Shard(shardSize));
+            for (auto& s : data)
+                for (auto& b : s) b = static_cast<std::uint8_t>(rng());
+            const auto original = data;
+
+            const auto encStart = std::chrono::steady_clock::now();
+            for (std::size_t it = 0; it < iterations; ++it)
+                Encode(cauchy, data, parity);
+            const auto encTime = std::chrono::steady_clock::now() - encStart;
+            const double encMBps = ToMBps(iterations * k * shardSize, encTime);
+
+            for (const float lossRate : LossRates) {
+                const std::size_t lostCount = std::min(m, std::max<std::size_t>(1, static_cast<std::size_t>(k * lossRate)));
+                std::chrono::steady_clock::duration recTime{};
+                for (std::size_t it = 0; it < iterations; ++it) {
+                    std::vector<bool> lost(k, false);
+                    for (std::size_t l = 0; l < lostCount;) {
+                        const std::size_t idx = rng() % k;
+                        if (!lost[idx]) { lost[idx] = true; ++l; }
+                    }
+                    for (std::size_t i = 0; i < k; ++i)
+                        if (lost[i]) std::fill(data[i].begin(), data[i].end(), std::uint8_t(0));
+
+                    const auto recStart = std::chrono::steady_clock::now();
+                    const bool ok = Recover(cauchy, data, parity, lost);
+                    recTime += std::chrono::steady_clock::now() - recStart;
+                    if (!ok || data != original) {
+                        ++failures;
+                        data = original;
+                    }
+                }
+                std::printf("%-8s %6zu %6zu %5.0f%% %14.1f %14.1f\n",
+                    GF256::ToString(kt), k, m, lossRate * 100.0f, encMBps,
+                    ToMBps(iterations * k * shardSize, recTime));
+            }
+        }
+    }
+    if (failures != 0)
+        std::printf("recovery mismatches: %d\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,220 @@
+// Serial (xrWaitFrame -> xrBeginFrame -> render -> xrEndFrame on one thread) vs pipelined
+// (ALXR::FramePipeline, xrWaitFrame on a pacing thread) render loops against a mock OpenXR runtime.
+//
+// The mock runtime follows the xrWaitFrame rules: a wait blocks until the previously waited frame has
+// been begun, then until the start of the next display period which is not already in the past, and
+// returns the display time at the end of that period. Frame rendering is modelled as CPU recording
+// time on the render thread plus GPU time on a single queue, with 2 swapchain images the render thread
+// also blocks on the GPU finishing frame N-2 before recording frame N.
+// A frame is shown at the first vsync (>= its predicted display time) after its GPU work completed.
+//
+// usage: alxr_frame_pacing_bench [--hz N] [--cpu-ms X] [--gpu-ms X] [--spike-ms X] [--spike-prob X]
+//                                [--duration-s N] [--seed N]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <algorithm>
+
+#include "frame_pipeline.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    double        hz = 90.0;
+    double        cpuMs = 6.0;
+    double        gpuMs = 8.0;
+    double        spikeMs = 6.0;   // extra CPU time, uniform up to.
+    double        spikeProb = 0.1;
+    std::uint64_t durationS = 5;
+    std::uint32_t seed = 1;
+};
+
+// subset of XrFrameState.
+struct FrameState {
+    std::int64_t predictedDisplayTime;
+    std::int64_t predictedDisplayPeriod;
+};
+
+class MockRuntime {
+public:
+    explicit MockRuntime(const std::int64_t periodNs)
+    : m_periodNs(periodNs), m_epoch(Clock::now()) {}
+
+    std::int64_t NowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_epoch).count();
+    }
+
+    bool WaitFrame(FrameState& frameState) {
+        std::int64_t displayTime = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frameBegun.wait(lock, [this]() { return !m_isWaitedFrameOpen; });
+            const std::int64_t now = NowNs();
+            // next period starting now or later, never the same display time twice.
+            displayTime = ((now + m_periodNs + m_periodNs - 1) / m_periodNs) * m_periodNs;
+            displayTime = std::max(displayTime, m_lastDisplayTime + m_periodNs);
+            m_lastDisplayTime = displayTime;
+            m_isWaitedFrameOpen = true;
+        }
+        std::this_thread::sleep_until(m_epoch + std::chrono::nanoseconds(displayTime - m_periodNs));
+        frameState = { .predictedDisplayTime = displayTime, .predictedDisplayPeriod = m_periodNs };
+        return true;
+    }
+
+    void BeginFrame() {
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            m_isWaitedFrameOpen = false;
+        }
+        m_frameBegun.notify_all();
+    }
+
+    // Render thread: blocks until the swapchain image of frame N-2 is free again.
+    void AcquireSwapchainImage() {
+        const std::int64_t freeAt = m_gpuDone[m_frameCount % 2];
+        const std::int64_t now = NowNs();
+        if (freeAt > now)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(freeAt - now));
+    }
+
+    void EndFrame(const FrameState& frameState, const std::int64_t gpuNs) {
+        const std::int64_t gpuStart = std::max(NowNs(), m_gpuBusyUntil);
+        m_gpuBusyUntil = gpuStart + gpuNs;
+        m_gpuDone[m_frameCount % 2] = m_gpuBusyUntil;
+        ++m_frameCount;
+        if (m_gpuBusyUntil <= frameState.predictedDisplayTime)
+            ++m_onTimeFrames;
+        const std::int64_t shownAt = std::max(frameState.predictedDisplayTime,
+            ((m_gpuBusyUntil + m_periodNs - 1) / m_periodNs) * m_periodNs);
+        m_shownVsyncs.insert(shownAt / m_periodNs);
+    }
+
+    std::uint64_t FrameCount() const { return m_frameCount; }
+    std::uint64_t OnTimeFrames() const { return m_onTimeFrames; }
+    // vsyncs between the first and last frame shown which repeated the previous frame.
+    std::uint64_t RepeatedVsyncs() const {
+        if (m_shownVsyncs.empty())
+            return 0;
+        const std::uint64_t span = static_cast<std::uint64_t>(*m_shownVsyncs.rbegin() - *m_shownVsyncs.begin() + 1);
+        return span - m_shownVsyncs.size();
+    }
+
+private:
+    const std::int64_t       m_periodNs;
+    const Clock::time_point  m_epoch;
+    std::mutex               m_mutex{};
+    std::condition_variable  m_frameBegun{};
+    bool                     m_isWaitedFrameOpen = false;
+    std::int64_t             m_lastDisplayTime = 0;
+    // render thread only.
+    std::int64_t             m_gpuBusyUntil = 0;
+    std::int64_t             m_gpuDone[2]{ 0, 0 };
+    std::uint64_t            m_frameCount = 0;
+    std::uint64_t            m_onTimeFrames = 0;
+    std::set<std::int64_t>   m_shownVsyncs{};
+};
+
+struct Result {
+    ALXR::FramePacingStats pacing;
+    std::uint64_t frames;
+    std::uint64_t onTimeFrames;
+    std::uint64_t repeatedVsyncs;
+    double        seconds;
+};
+
+Result Run(const Options& options, const bool isPipelined) {
+    using namespace std::literals::chrono_literals;
+    const std::int64_t periodNs = static_cast<std::int64_t>(1e9 / options.hz);
+    MockRuntime runtime{ periodNs };
+    ALXR::FramePipeline<FrameState> pipeline{};
+    ALXR::FramePacingMonitor monitor{};
+    std::mt19937_64 rng{ options.seed };
+    std::uniform_real_distribution<double> unit{ 0.0, 1.0 };
+
+    if (isPipelined)
+        pipeline.Start([&runtime](FrameState& frameState) { return runtime.WaitFrame(frameState); });
+
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::seconds(options.durationS);
+    while (Clock::now() < end) {
+        const auto waitStart = Clock::now();
+        FrameState frameState;
+        if (!(isPipelined ? pipeline.Acquire(frameState, 100ms) : runtime.WaitFrame(frameState)))
+            continue;
+        const auto waitUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - waitStart).count();
+        runtime.BeginFrame();
+
+        runtime.AcquireSwapchainImage();
+        double cpuMs = options.cpuMs;
+        if (unit(rng) < options.spikeProb)
+            cpuMs += unit(rng) * options.spikeMs;
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(cpuMs));
+        runtime.EndFrame(frameState, static_cast<std::int64_t>(options.gpuMs * 1e6));
+
+        const auto nowUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        monitor.OnFrame(static_cast<std::uint64_t>(waitUs), frameState.predictedDisplayTime,
+            frameState.predictedDisplayPeriod, static_cast<std::uint64_t>(nowUs));
+    }
+    pipeline.Stop([&runtime](const FrameState& frameState) {
+        runtime.BeginFrame();
+        runtime.EndFrame(frameState, 0);
+    });
+    return {
+        .pacing = monitor.Collect(isPipelined),
+        .frames = runtime.FrameCount(),
+        .onTimeFrames = runtime.OnTimeFrames(),
+        .repeatedVsyncs = runtime.RepeatedVsyncs(),
+        .seconds = std::chrono::duration<double>(Clock::now() - start).count()
+    };
+}
+
+void Print(const char* name, const Result& result) {
+    const auto& pacing = result.pacing;
+    std::printf("%-10s %8.1f %8.1f%% %9llu %9llu | %8llu %8llu | %9llu %9llu %9llu\n", name,
+        static_cast<double>(result.frames) / result.seconds,
+        result.frames ? 100.0 * static_cast<double>(result.onTimeFrames) / static_cast<double>(result.frames) : 0.0,
+        static_cast<unsigned long long>(result.repeatedVsyncs),
+        static_cast<unsigned long long>(pacing.missedFrames),
+        static_cast<unsigned long long>(pacing.wait.p50), static_cast<unsigned long long>(pacing.wait.p99),
+        static_cast<unsigned long long>(pacing.interval.p50), static_cast<unsigned long long>(pacing.interval.p99),
+        static_cast<unsigned long long>(pacing.interval.max));
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--hz") == 0)              options.hz = std::max(1.0, std::strtod(value, nullptr));
+        else if (std::strcmp(name, "--cpu-ms") == 0)     options.cpuMs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--gpu-ms") == 0)     options.gpuMs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--spike-ms") == 0)   options.spikeMs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--spike-prob") == 0) options.spikeProb = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--duration-s") == 0) options.durationS = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(name, "--seed") == 0)       options.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    std::printf("hz=%.1f cpu=%.1fms gpu=%.1fms spike=+%.1fms@%.0f%% duration=%llus\n", options.hz, options.cpuMs,
+        options.gpuMs, options.spikeMs, options.spikeProb * 100.0, static_cast<unsigned long long>(options.durationS));
+    std::printf("%-10s %8s %9s %9s %9s | %8s %8s | %9s %9s %9s\n", "loop", "fps", "on-time",
+        "repeated", "skipped", "wait p50", "wait p99", "intvl p50", "intvl p99", "intvl max");
+    Print("serial", Run(options, false));
+    Print("pipelined", Run(options, true));
+    return EXIT_SUCCESS;
+}
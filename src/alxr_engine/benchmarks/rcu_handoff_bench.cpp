@@ -0,0 +1,173 @@
+// Render state handoff: a render loop which reads a state object every frame while another thread keeps
+// replacing it, guarded by std::mutex (as alxr_process_frame/alxr_set_stream_config were) vs
+// xrconcurrency::rcu_ptr. Reports how long frames stall on reconfiguration and how long writers wait for
+// the grace period, and checks that no frame ever sees a retired object.
+//
+// usage: alxr_rcu_handoff_bench [--seconds N] [--frame-us N] [--rebuild-us N] [--reconfig-ms N]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "rcu_ptr.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    double        seconds = 3.0;
+    std::uint64_t frameUs = 2000;    // render work per frame.
+    std::uint64_t rebuildUs = 20000; // building new state (swapchains, textures).
+    std::uint64_t reconfigMs = 50;   // interval between reconfigurations.
+};
+
+constexpr const std::uint64_t LiveTag = 0x5AFEC0DE5AFEC0DEull;
+
+struct RenderState {
+    std::atomic<std::uint64_t> tag{ LiveTag };
+    std::vector<std::uint32_t> images;
+    ~RenderState() { tag.store(0); }
+};
+
+std::unique_ptr<RenderState> BuildState(const std::uint64_t rebuildUs) {
+    auto state = std::make_unique<RenderState>();
+    state->images.assign(3, 1);
+    std::this_thread::sleep_for(std::chrono::microseconds(rebuildUs));
+    return state;
+}
+
+void BusyFor(const std::uint64_t us) {
+    const auto end = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < end) {}
+}
+
+struct Result {
+    std::uint64_t frames = 0, reconfigs = 0, retiredSeen = 0;
+    double maxFrameStallUs = 0, p99FrameStallUs = 0; // time spent entering the frame's critical section.
+    double maxWriterWaitUs = 0;
+};
+
+double Percentile(std::vector<double>& values, const double p) {
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<std::size_t>(values.size() * p))];
+}
+
+Result RunMutex(const Options& options) {
+    std::mutex renderMutex;
+    std::unique_ptr<RenderState> state = BuildState(0);
+    std::atomic<bool> isRunning{ true };
+    Result result{};
+    std::vector<double> stalls;
+
+    std::thread writer([&]() {
+        while (isRunning.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.reconfigMs));
+            const auto start = Clock::now();
+            std::scoped_lock lock(renderMutex);
+            state.reset();
+            state = BuildState(options.rebuildUs);
+            result.maxWriterWaitUs = std::max(result.maxWriterWaitUs,
+                std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            ++result.reconfigs;
+        }
+    });
+    const auto end = Clock::now() + std::chrono::duration<double>(options.seconds);
+    while (Clock::now() < end) {
+        const auto start = Clock::now();
+        std::scoped_lock lock(renderMutex);
+        stalls.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        if (state->tag.load() != LiveTag)
+            ++result.retiredSeen;
+        BusyFor(options.frameUs);
+        ++result.frames;
+    }
+    isRunning.store(false);
+    writer.join();
+    result.maxFrameStallUs = stalls.empty() ? 0 : *std::max_element(stalls.begin(), stalls.end());
+    result.p99FrameStallUs = Percentile(stalls, 0.99);
+    return result;
+}
+
+Result RunRcu(const Options& options) {
+    xrconcurrency::rcu_domain domain{};
+    xrconcurrency::rcu_ptr<RenderState> state{};
+    state.exchange(BuildState(0), domain);
+    std::atomic<bool> isRunning{ true };
+    Result result{};
+    std::vector<double> stalls;
+
+    std::thread writer([&]() {
+        while (isRunning.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.reconfigMs));
+            auto newState = BuildState(options.rebuildUs);
+            const auto start = Clock::now();
+            state.exchange(std::move(newState), domain); // the retired state is destroyed here.
+            result.maxWriterWaitUs = std::max(result.maxWriterWaitUs,
+                std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            ++result.reconfigs;
+        }
+    });
+    const auto end = Clock::now() + std::chrono::duration<double>(options.seconds);
+    while (Clock::now() < end) {
+        const auto start = Clock::now();
+        const xrconcurrency::rcu_read_guard frameGuard{ domain };
+        const RenderState* const frameState = state.load();
+        stalls.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        if (frameState->tag.load() != LiveTag)
+            ++result.retiredSeen;
+        BusyFor(options.frameUs);
+        // still the state the frame started with, it must not have been retired meanwhile.
+        if (frameState->tag.load() != LiveTag)
+            ++result.retiredSeen;
+        ++result.frames;
+    }
+    isRunning.store(false);
+    writer.join();
+    result.maxFrameStallUs = stalls.empty() ? 0 : *std::max_element(stalls.begin(), stalls.end());
+    result.p99FrameStallUs = Percentile(stalls, 0.99);
+    return result;
+}
+
+void Print(const char* name, const Result& result) {
+    std::printf("%-6s %8llu %9llu %14.1f %14.1f %15.1f %8llu\n", name,
+        static_cast<unsigned long long>(result.frames), static_cast<unsigned long long>(result.reconfigs),
+        result.p99FrameStallUs, result.maxFrameStallUs, result.maxWriterWaitUs,
+        static_cast<unsigned long long>(result.retiredSeen));
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--seconds") == 0)          options.seconds = std::max(0.1, std::strtod(value, nullptr));
+        else if (std::strcmp(name, "--frame-us") == 0)    options.frameUs = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(name, "--rebuild-us") == 0)  options.rebuildUs = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(name, "--reconfig-ms") == 0) options.reconfigMs = std::max<std::uint64_t>(1, std::strtoull(value, nullptr, 10));
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    std::printf("seconds=%.1f frame=%lluus rebuild=%lluus reconfig every %llums\n", options.seconds,
+        static_cast<unsigned long long>(options.frameUs), static_cast<unsigned long long>(options.rebuildUs),
+        static_cast<unsigned long long>(options.reconfigMs));
+    std::printf("%-6s %8s %9s %14s %14s %15s %8s\n", "guard", "frames", "reconfigs", "p99 stall us", "max stall us", "max writer us", "retired");
+    Print("mutex", RunMutex(options));
+    const Result rcuResult = RunRcu(options);
+    Print("rcu", rcuResult);
+    return rcuResult.retiredSeen == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
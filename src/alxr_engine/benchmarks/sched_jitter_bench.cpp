@@ -0,0 +1,93 @@
+// Measures wake-up jitter of a periodic thread (like the reassembly/decode threads waiting on packets)
+// while every core is busy with synthetic CPU load, at the default scheduling and with the
+// policy granted by thread_scheduling.
+//
+// usage: alxr_sched_jitter_bench [fifo|rr|nice|default] [priority] [period-us] [iterations] [load-threads]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "thread_scheduling.h"
+
+namespace {
+
+using namespace ALXR::ThreadScheduling;
+using Clock = std::chrono::steady_clock;
+
+struct JitterStats {
+    double p50Us, p99Us, maxUs;
+};
+
+JitterStats MeasureJitter(const Role role, const std::chrono::microseconds period, const std::size_t iterations, Params& granted) {
+    std::vector<double> latenessUs;
+    latenessUs.reserve(iterations);
+    std::thread periodic{ [&]() {
+        granted = ApplyToCurrentThread(role);
+        auto wakeTime = Clock::now() + period;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            std::this_thread::sleep_until(wakeTime);
+            latenessUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - wakeTime).count());
+            wakeTime += period;
+        }
+    }};
+    periodic.join();
+    std::sort(latenessUs.begin(), latenessUs.end());
+    return {
+        latenessUs[latenessUs.size() / 2],
+        latenessUs[std::min(latenessUs.size() - 1, latenessUs.size() * 99 / 100)],
+        latenessUs.back()
+    };
+}
+
+Policy ParsePolicy(const char* name) {
+    if (std::strcmp(name, "fifo") == 0) return Policy::Fifo;
+    if (std::strcmp(name, "rr") == 0)   return Policy::RoundRobin;
+    if (std::strcmp(name, "nice") == 0) return Policy::Nice;
+    return Policy::Default;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Policy policy = argc > 1 ? ParsePolicy(argv[1]) : Policy::Fifo;
+    const int priority = argc > 2 ? std::atoi(argv[2]) : (policy == Policy::Nice ? -10 : 10);
+    const std::chrono::microseconds period{ argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000 };
+    const std::size_t iterations = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 2000;
+    const std::size_t loadThreads = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::atomic<bool> isLoadRunning{ true };
+    std::vector<std::thread> load;
+    for (std::size_t i = 0; i < loadThreads; ++i) {
+        load.emplace_back([&isLoadRunning]() {
+            volatile std::uint64_t x = 0;
+            while (isLoadRunning.load(std::memory_order_relaxed))
+                x = x * 6364136223846793005ull + 1;
+        });
+    }
+
+    std::printf("period=%lldus iterations=%zu load-threads=%zu\n", static_cast<long long>(period.count()), iterations, loadThreads);
+    std::printf("%-28s %10s %10s %10s\n", "granted", "p50 us", "p99 us", "max us");
+
+    Config config{};
+    SetConfig(config);
+    Params granted{};
+    const auto baseline = MeasureJitter(Role::Reassembly, period, iterations, granted);
+    std::printf("%-28s %10.1f %10.1f %10.1f\n", ToString(granted).c_str(), baseline.p50Us, baseline.p99Us, baseline.maxUs);
+
+    config[static_cast<std::size_t>(Role::Reassembly)] = { .policy = policy, .priority = priority };
+    SetConfig(config);
+    const auto scheduled = MeasureJitter(Role::Reassembly, period, iterations, granted);
+    std::printf("%-28s %10.1f %10.1f %10.1f\n", ToString(granted).c_str(), scheduled.p50Us, scheduled.p99Us, scheduled.maxUs);
+    if (granted.policy != policy)
+        std::printf("requested %s/%d was not granted (needs CAP_SYS_NICE or RLIMIT_RTPRIO for realtime policies)\n", ToString(policy), priority);
+
+    isLoadRunning = false;
+    for (auto& t : load)
+        t.join();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+// Replays packet orderings through SliceStreamer and checks what reaches the decoder and when a
+// frame is reported broken, the report is what makes XrDecoderThread::ProcessPacket discard the
+// decoder's output for that frame and flag a FEC failure (packet loss report, the server sends an IDR).
+//
+// usage: alxr_slice_streamer_check
+//
+// Exits with 1 if any scenario fails.
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "slice_streamer.h"
+
+namespace {
+
+constexpr const std::size_t PacketStride = ALVR_MAX_VIDEO_BUFFER_SIZE;
+
+struct Frame {
+    std::uint64_t videoFrameIndex;
+    std::uint64_t trackingFrameIndex;
+    std::vector<std::uint8_t> bytes;
+};
+
+// one NAL per packet stride so every in-order packet completes the previous NAL.
+Frame MakeFrame(const std::uint64_t videoFrameIndex, const std::size_t nalCount) {
+    Frame frame{ videoFrameIndex, videoFrameIndex * 10, {} };
+    frame.bytes.resize(nalCount * PacketStride);
+    for (std::size_t nal = 0; nal < nalCount; ++nal) {
+        std::uint8_t* const p = frame.bytes.data() + nal * PacketStride;
+        std::fill(p, p + PacketStride, static_cast<std::uint8_t>(videoFrameIndex + nal + 1));
+        p[0] = p[1] = p[2] = 0; p[3] = 1; // 4 byte start code
+    }
+    return frame;
+}
+
+VideoFrame MakeHeader(const Frame& frame, const std::size_t fecIndex) {
+    VideoFrame header{};
+    header.videoFrameIndex = frame.videoFrameIndex;
+    header.trackingFrameIndex = frame.trackingFrameIndex;
+    header.frameByteSize = static_cast<std::uint32_t>(frame.bytes.size());
+    header.fecIndex = static_cast<std::uint32_t>(fecIndex);
+    return header;
+}
+
+struct Harness {
+    SliceStreamer streamer;
+    std::vector<std::uint8_t> forwarded;
+    std::vector<std::uint64_t> forwardedTrackingIndices;
+    std::vector<std::uint64_t> brokenFrames;
+
+    void Forward(const ConstPacketType& nal, const std::uint64_t trackingFrameIndex) {
+        forwarded.insert(forwarded.end(), nal.begin(), nal.end());
+        forwardedTrackingIndices.push_back(trackingFrameIndex);
+    }
+    void Broken(const std::uint64_t trackingFrameIndex) { brokenFrames.push_back(trackingFrameIndex); }
+
+    void AddPacket(const Frame& frame, const std::size_t fecIndex) {
+        const ConstPacketType payload{ frame.bytes.data() + fecIndex * PacketStride, PacketStride };
+        streamer.AddPacket(MakeHeader(frame, fecIndex), payload,
+            [this](const ConstPacketType& nal, const std::uint64_t idx) { Forward(nal, idx); },
+            [this](const std::uint64_t idx) { Broken(idx); });
+    }
+    void CompleteFrame(const Frame& frame) {
+        streamer.CompleteFrame(MakeHeader(frame, 0), frame.bytes,
+            [this](const ConstPacketType& nal, const std::uint64_t idx) { Forward(nal, idx); },
+            [this](const std::uint64_t idx) { Broken(idx); });
+    }
+    void Reset() {
+        forwarded.clear();
+        forwardedTrackingIndices.clear();
+        brokenFrames.clear();
+    }
+};
+
+bool Check(const char* scenario, const bool condition, const char* what) {
+    if (!condition)
+        std::printf("FAIL %s: %s\n", scenario, what);
+    return condition;
+}
+
+bool EqualBytes(const std::vector<std::uint8_t>& forwarded, const std::vector<std::uint8_t>& expected) {
+    return forwarded.size() == expected.size() && std::equal(forwarded.begin(), forwarded.end(), expected.begin());
+}
+
+// every packet in order, the whole frame reaches the decoder before FEC reports it complete.
+bool InOrderFrame() {
+    constexpr const char* Name = "in-order";
+    Harness h;
+    const Frame frame = MakeFrame(1, 4);
+    for (std::size_t i = 0; i < 4; ++i)
+        h.AddPacket(frame, i);
+    bool ok = Check(Name, EqualBytes(h.forwarded, frame.bytes), "whole frame forwarded before FEC completes");
+    h.CompleteFrame(frame);
+    ok &= Check(Name, EqualBytes(h.forwarded, frame.bytes), "forwarded bytes equal the frame, without duplicates");
+    ok &= Check(Name, std::all_of(h.forwardedTrackingIndices.begin(), h.forwardedTrackingIndices.end(),
+        [&](const std::uint64_t idx) { return idx == frame.trackingFrameIndex; }), "NALs tagged with the frame's tracking index");
+    h.AddPacket(MakeFrame(2, 2), 0);
+    ok &= Check(Name, h.brokenFrames.empty(), "complete frame not reported broken");
+    return ok;
+}
+
+// a gap at packet 1 which FEC recovers, NALs past the gap wait for CompleteFrame.
+bool RecoveredGap() {
+    constexpr const char* Name = "recovered-gap";
+    Harness h;
+    const Frame frame = MakeFrame(1, 4);
+    h.AddPacket(frame, 0);
+    h.AddPacket(frame, 2);
+    h.AddPacket(frame, 3);
+    bool ok = Check(Name, h.forwarded.empty(), "nothing forwarded past a gap");
+    h.CompleteFrame(frame);
+    ok &= Check(Name, EqualBytes(h.forwarded, frame.bytes), "forwarded bytes equal the frame");
+    h.AddPacket(MakeFrame(2, 2), 0);
+    ok &= Check(Name, h.brokenFrames.empty(), "recovered frame not reported broken");
+    return ok;
+}
+
+// FEC never completes frame 1 after two of its NALs went to the decoder, the next frame starting reports it.
+bool AbandonedPartialFrame() {
+    constexpr const char* Name = "abandoned-partial";
+    Harness h;
+    const Frame frame = MakeFrame(1, 4);
+    h.AddPacket(frame, 0);
+    h.AddPacket(frame, 1);
+    h.AddPacket(frame, 3);
+    bool ok = Check(Name, h.forwarded.size() == PacketStride, "first NAL forwarded");
+    ok &= Check(Name, h.brokenFrames.empty(), "no report while the frame may still complete");
+    const Frame next = MakeFrame(2, 2);
+    h.AddPacket(next, 0);
+    ok &= Check(Name, h.brokenFrames.size() == 1 && h.brokenFrames[0] == frame.trackingFrameIndex,
+        "abandoned frame reported once with its tracking index");
+    h.AddPacket(next, 1);
+    h.CompleteFrame(next);
+    ok &= Check(Name, h.brokenFrames.size() == 1, "following complete frame not reported");
+    return ok;
+}
+
+// frame 1 lost its first packet so nothing reached the decoder, abandoning it is left to FEC's own report.
+bool AbandonedUnforwardedFrame() {
+    constexpr const char* Name = "abandoned-unforwarded";
+    Harness h;
+    const Frame frame = MakeFrame(1, 3);
+    h.AddPacket(frame, 1);
+    h.AddPacket(frame, 2);
+    h.AddPacket(MakeFrame(2, 2), 0);
+    return Check(Name, h.brokenFrames.empty(), "frame the decoder never saw not reported");
+}
+
+// packets of an abandoned frame arriving after the next frame started must not be forwarded or restart it.
+bool LatePackets() {
+    constexpr const char* Name = "late-packets";
+    Harness h;
+    const Frame frame = MakeFrame(5, 3);
+    const Frame next = MakeFrame(6, 3);
+    h.AddPacket(frame, 0);
+    h.AddPacket(frame, 1);
+    h.AddPacket(next, 0);
+    h.Reset();
+    h.AddPacket(frame, 2);
+    h.CompleteFrame(frame);
+    bool ok = Check(Name, h.forwarded.empty(), "late packets and completion of an older frame dropped");
+    ok &= Check(Name, h.brokenFrames.empty(), "late packets do not report the current frame");
+    h.AddPacket(next, 1);
+    h.AddPacket(next, 2);
+    h.CompleteFrame(next);
+    ok &= Check(Name, EqualBytes(h.forwarded, next.bytes), "current frame unaffected");
+    return ok;
+}
+
+// a far older index is the server restarting its frame count, it starts a new frame.
+bool ServerRestart() {
+    constexpr const char* Name = "server-restart";
+    Harness h;
+    const Frame frame = MakeFrame(100, 2);
+    h.AddPacket(frame, 0);
+    h.AddPacket(frame, 1);
+    h.CompleteFrame(frame);
+    h.Reset();
+    const Frame restarted = MakeFrame(0, 2);
+    h.AddPacket(restarted, 0);
+    h.AddPacket(restarted, 1);
+    h.CompleteFrame(restarted);
+    return Check(Name, EqualBytes(h.forwarded, restarted.bytes), "restarted frame index forwarded");
+}
+
+} // namespace
+
+int main() {
+    struct Scenario { const char* name; bool (*run)(); };
+    constexpr const Scenario Scenarios[] = {
+        { "in-order", InOrderFrame },
+        { "recovered-gap", RecoveredGap },
+        { "abandoned-partial", AbandonedPartialFrame },
+        { "abandoned-unforwarded", AbandonedUnforwardedFrame },
+        { "late-packets", LatePackets },
+        { "server-restart", ServerRestart },
+    };
+    int failures = 0;
+    for (const auto& scenario : Scenarios) {
+        const bool ok = scenario.run();
+        std::printf("%-22s %s\n", scenario.name, ok ? "ok" : "FAILED");
+        failures += ok ? 0 : 1;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,82 @@
+// Replays a stream capture (see alxr_start_stream_capture) through the decoder thread and the
+// headless graphics plugin and reports per-stage timings and drops, no headset or server required.
+//
+// usage: alxr_stream_replay <capture-file> [--max-speed] [--decoder=cpu|vaapi|nvdec|cuvid]
+//
+// Only the cpu decoder uploads frames into the headless plugin, hw decoders still report decode/FEC stats.
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "alxr_engine.h"
+
+namespace {
+
+bool ParseDecoderType(const std::string_view name, ALXRDecoderType& decoderType) {
+    constexpr const struct { std::string_view name; ALXRDecoderType type; } DecoderTypes[] = {
+        { "cpu",   ALXRDecoderType::CPU },
+        { "vaapi", ALXRDecoderType::VAAPI },
+        { "nvdec", ALXRDecoderType::NVDEC },
+        { "cuvid", ALXRDecoderType::CUVID },
+        { "d3d11", ALXRDecoderType::D311VA },
+    };
+    for (const auto& dt : DecoderTypes) {
+        if (dt.name == name) {
+            decoderType = dt.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PrintStage(const char* name, const ALXRReplayStageTimes& t) {
+    std::printf("%-8s %10.3f %10.3f %10.3f %10.3f\n", name, t.p50 / 1000.0, t.p99 / 1000.0, t.p999 / 1000.0, t.max / 1000.0);
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <capture-file> [--max-speed] [--decoder=cpu|vaapi|nvdec|cuvid|d3d11]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ALXRReplayOptions options{
+        .capturePath = argv[1],
+        .decoderType = ALXRDecoderType::CPU,
+        .maxSpeed = false
+    };
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--max-speed")
+            options.maxSpeed = true;
+        else if (arg.starts_with("--decoder=") && ParseDecoderType(arg.substr(std::strlen("--decoder=")), options.decoderType))
+            continue;
+        else {
+            std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    ALXRReplayStats stats{};
+    if (!alxr_replay_stream_capture(&options, &stats)) {
+        std::fprintf(stderr, "failed to replay %s\n", options.capturePath);
+        return EXIT_FAILURE;
+    }
+
+    const double secs = stats.durationUs / 1e6;
+    std::printf("replayed %llu packets, %llu frames in %.2fs (%.1f fps uploaded)\n",
+        (unsigned long long)stats.packetsReplayed, (unsigned long long)stats.framesInCapture,
+        secs, secs > 0 ? stats.framesUploaded / secs : 0.0);
+    std::printf("%-8s %10s %10s %10s %10s\n", "stage", "p50 ms", "p99 ms", "p999 ms", "max ms");
+    PrintStage("fec", stats.fec);
+    PrintStage("decode", stats.decode);
+    PrintStage("upload", stats.upload);
+    std::printf("frames: uploaded=%llu dropped=%llu decoder-skipped=%llu\n",
+        (unsigned long long)stats.framesUploaded, (unsigned long long)stats.framesDropped,
+        (unsigned long long)stats.decoderStats.framesSkipped);
+    std::printf("drops: shards=%llu decoder-packets=%llu\n",
+        (unsigned long long)stats.shardsDropped, (unsigned long long)stats.decoderStats.packetsDropped);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+// Contention benchmark of the tracking frame lookup: one writer inserting tracking frames (like
+// OpenXrProgram::GetTrackingInfo) and reader threads looking up recent timestamps (like GetPredicatedViews),
+// std::map under a std::shared_mutex (previous implementation) vs xrconcurrency::seqlock_ring.
+//
+// usage: alxr_tracking_ring_bench [readers] [duration-ms] [writer-period-us]
+//   writer-period-us = 0 inserts back to back (worst case contention).
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "seqlock_ring.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// same size/layout class as OpenXrProgram::TrackingFrame (2x XrView + XrTime).
+struct TrackingFrame {
+    struct View {
+        std::uint32_t type;
+        const void*   next;
+        float         pose[7];
+        float         fov[4];
+    };
+    std::array<View, 2> views;
+    std::int64_t        displayTime;
+};
+
+constexpr const std::size_t Capacity = 2048;
+constexpr const std::uint64_t FramePeriodNs = 2'777'778; // 360Hz
+
+class MapStore {
+    std::map<std::uint64_t, TrackingFrame> m_map{};
+    mutable std::shared_mutex m_mutex{};
+public:
+    inline void insert(const std::uint64_t key, const TrackingFrame& frame) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_map[key] = frame;
+        if (m_map.size() > 360 * 3)
+            m_map.erase(m_map.begin());
+    }
+    inline bool find(const std::uint64_t key, TrackingFrame& frame) const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        const auto itr = m_map.find(key);
+        if (itr == m_map.end())
+            return false;
+        frame = itr->second;
+        return true;
+    }
+};
+
+class RingStore {
+    xrconcurrency::seqlock_ring<TrackingFrame, Capacity> m_ring{};
+public:
+    inline void insert(const std::uint64_t key, const TrackingFrame& frame) { m_ring.insert(key, frame); }
+    inline bool find(const std::uint64_t key, TrackingFrame& frame) const { return m_ring.find(key, frame); }
+};
+
+struct Result {
+    double readP50Ns, readP99Ns, readMaxNs;
+    double writeP50Ns, writeP99Ns, writeMaxNs;
+    double lookupsPerSec;
+    double hitRate;
+    bool   isConsistent;
+};
+
+double Percentile(std::vector<double>& values, const double p) {
+    if (values.empty())
+        return 0;
+    const std::size_t idx = std::min(values.size() - 1, static_cast<std::size_t>(values.size() * p));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+template < typename Store >
+Result Run(const std::size_t readerCount, const std::chrono::milliseconds duration, const std::chrono::microseconds writerPeriod) {
+    static Store store{};
+    std::atomic<std::uint64_t> latestKey{ 0 };
+    std::atomic<bool> isRunning{ true };
+    std::atomic<bool> isConsistent{ true };
+
+    std::vector<double> writeNs;
+    std::thread writer{ [&]() {
+        std::uint64_t key = FramePeriodNs;
+        auto nextWrite = Clock::now();
+        while (isRunning.load(std::memory_order_relaxed)) {
+            TrackingFrame frame{};
+            frame.displayTime = static_cast<std::int64_t>(key);
+            for (auto& view : frame.views)
+                view.pose[0] = static_cast<float>(key & 0xFFFF);
+            const auto start = Clock::now();
+            store.insert(key, frame);
+            writeNs.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            latestKey.store(key, std::memory_order_release);
+            key += FramePeriodNs;
+            if (writerPeriod.count() > 0) {
+                nextWrite += writerPeriod;
+                std::this_thread::sleep_until(nextWrite);
+            }
+        }
+    }};
+
+    std::vector<std::vector<double>> readNs(readerCount);
+    std::vector<std::uint64_t> hits(readerCount, 0);
+    std::vector<std::thread> readers;
+    for (std::size_t readerIdx = 0; readerIdx < readerCount; ++readerIdx) {
+        readers.emplace_back([&, readerIdx]() {
+            auto& samples = readNs[readerIdx];
+            std::uint64_t lookup = 0;
+            while (isRunning.load(std::memory_order_relaxed)) {
+                const std::uint64_t newest = latestKey.load(std::memory_order_acquire);
+                if (newest == 0)
+                    continue;
+                // a video frame rendered a few frames after its tracking sample was sent.
+                const std::uint64_t age = (lookup++ % 64) * FramePeriodNs;
+                const std::uint64_t key = newest > age ? newest - age : newest;
+                TrackingFrame frame;
+                const auto start = Clock::now();
+                const bool found = store.find(key, frame);
+                samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+                if (found) {
+                    ++hits[readerIdx];
+                    if (frame.displayTime != static_cast<std::int64_t>(key) ||
+                        frame.views[1].pose[0] != static_cast<float>(key & 0xFFFF))
+                        isConsistent = false;
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(duration);
+    isRunning = false;
+    writer.join();
+    for (auto& reader : readers)
+        reader.join();
+
+    std::vector<double> allReads;
+    std::uint64_t totalHits = 0;
+    for (std::size_t readerIdx = 0; readerIdx < readerCount; ++readerIdx) {
+        allReads.insert(allReads.end(), readNs[readerIdx].begin(), readNs[readerIdx].end());
+        totalHits += hits[readerIdx];
+    }
+    const double seconds = std::chrono::duration<double>(duration).count();
+    Result result{
+        .readP50Ns = Percentile(allReads, 0.50),
+        .readP99Ns = Percentile(allReads, 0.99),
+        .readMaxNs = allReads.empty() ? 0 : *std::max_element(allReads.begin(), allReads.end()),
+        .writeP50Ns = Percentile(writeNs, 0.50),
+        .writeP99Ns = Percentile(writeNs, 0.99),
+        .writeMaxNs = writeNs.empty() ? 0 : *std::max_element(writeNs.begin(), writeNs.end()),
+        .lookupsPerSec = static_cast<double>(allReads.size()) / seconds,
+        .hitRate = allReads.empty() ? 0 : static_cast<double>(totalHits) / static_cast<double>(allReads.size()),
+        .isConsistent = isConsistent.load()
+    };
+    return result;
+}
+
+void Print(const char* name, const Result& result) {
+    std::printf("%-14s %9.0f %9.0f %10.0f | %9.0f %9.0f %10.0f | %12.0f %7.2f%%%s\n", name,
+        result.readP50Ns, result.readP99Ns, result.readMaxNs,
+        result.writeP50Ns, result.writeP99Ns, result.writeMaxNs,
+        result.lookupsPerSec, result.hitRate * 100.0, result.isConsistent ? "" : " TORN READ");
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t readers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2;
+    const std::chrono::milliseconds duration{ argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000 };
+    const std::chrono::microseconds writerPeriod{ argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0 };
+
+    std::printf("readers=%zu duration=%lldms writer-period=%lldus\n", readers,
+        static_cast<long long>(duration.count()), static_cast<long long>(writerPeriod.count()));
+    std::printf("%-14s %9s %9s %10s | %9s %9s %10s | %12s %8s\n", "store",
+        "read p50", "read p99", "read max", "write p50", "write p99", "write max", "lookups/s", "hits");
+    Print("map+shared_mtx", Run<MapStore>(readers, duration, writerPeriod));
+    const auto ringResult = Run<RingStore>(readers, duration, writerPeriod);
+    Print("seqlock_ring", ringResult);
+    return ringResult.isConsistent ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,209 @@
+// Newest frame (what BeginVideoView did) vs ALXR::VideoJitterBuffer frame selection, in simulated time.
+//
+// The server renders a frame every 1/fps for the display time the client predicted, frames arrive at the client
+// (decoded) at that display time + a base lateness (the part of the pipeline latency the prediction missed) +
+// network/decoder jitter: gaussian noise plus occasional stalls after which the held up frames arrive in a burst.
+// The render loop selects a frame `lead` before each vsync of the display.
+//
+// usage: alxr_video_jitter_sim [--scenario wifi|steady] [--hz N] [--fps N] [--lateness-ms X] [--jitter-ms X]
+//                              [--stall-ms X] [--stall-prob X] [--depth N] [--frames N] [--seed N]
+//
+// Scenarios set the arrival model, the other options override it:
+//   wifi   (default) frames arrive ~5ms ahead of their display time with 4ms of jitter, about the frame
+//          interval, and 1% of 25ms stalls. The buffer has ~25% fewer holds and uneven steps than "newest"
+//          at the same p50 latency, at the cost of a longer p99 wait.
+//   steady frames arrive ~8ms ahead with 3ms of jitter, "newest" rarely misses a frame and the buffer
+//          gains nothing. Why the buffer is disabled by default (ALXRClientCtx::videoJitterBufferDepth = 0).
+// "wait" is vsync - arrival of each newly presented frame, measured the same way for both selections.
+// Exits with 1 if the wifi scenario's buffer does not reduce holds and uneven steps.
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "video_jitter_buffer.h"
+
+namespace {
+
+struct Options {
+    const char*   scenario = "wifi";
+    double        hz = 90.0;
+    double        fps = 90.0;
+    double        latenessMs = -5.0; // < 0, frames usually arrive ahead of their display time.
+    double        jitterMs = 4.0;
+    double        stallMs = 25.0;
+    double        stallProb = 0.01;
+    std::uint32_t depth = 3;
+    std::uint64_t frames = 20000;
+    std::uint32_t seed = 1;
+};
+
+using JitterBuffer = ALXR::VideoJitterBuffer<7>;
+
+struct Arrival {
+    std::uint64_t frameTimeNs;
+    std::uint64_t arrivalNs;
+};
+
+std::vector<Arrival> MakeArrivals(const Options& options) {
+    std::mt19937_64 rng{ options.seed };
+    std::normal_distribution<double> jitter{ 0.0, options.jitterMs * 1e6 };
+    std::uniform_real_distribution<double> unit{ 0.0, 1.0 };
+    const double frameNs = 1e9 / options.fps;
+    const double startNs = 1e9; // keeps every time positive.
+    std::vector<Arrival> arrivals;
+    arrivals.reserve(options.frames);
+    double stalledUntilNs = 0;
+    for (std::uint64_t frame = 0; frame < options.frames; ++frame) {
+        const double frameTimeNs = startNs + frame * frameNs;
+        double arrivalNs = frameTimeNs + options.latenessMs * 1e6 + std::abs(jitter(rng));
+        if (unit(rng) < options.stallProb)
+            stalledUntilNs = arrivalNs + options.stallMs * 1e6;
+        arrivalNs = std::max(arrivalNs, stalledUntilNs);
+        arrivals.push_back({ static_cast<std::uint64_t>(frameTimeNs), static_cast<std::uint64_t>(arrivalNs) });
+    }
+    // a frame is only decoded after the previous one.
+    for (std::size_t idx = 1; idx < arrivals.size(); ++idx)
+        arrivals[idx].arrivalNs = std::max(arrivals[idx].arrivalNs, arrivals[idx - 1].arrivalNs);
+    return arrivals;
+}
+
+struct Result {
+    ALXR::VideoJitterStats stats;
+    std::uint64_t displayFrames;
+    std::uint64_t unevenSteps;   // display frames which did not advance by the expected number of frames.
+    double        latencyP50Ms;  // vsync - presented frame's display time.
+    double        latencyP99Ms;
+    double        waitP50Ms;     // vsync - arrival of each newly presented frame, the same measure for both selections.
+    double        waitP99Ms;
+};
+
+double Percentile(std::vector<double>& values, const std::size_t percent) {
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (values.size() * percent) / 100)];
+}
+
+Result Run(const Options& options, const std::vector<Arrival>& arrivals, const bool isJitterBuffered) {
+    JitterBuffer buffer{};
+    buffer.Reset({ .depth = isJitterBuffered ? options.depth : JitterBuffer::MaxDepth, .noSkip = false });
+    std::vector<Arrival> slotArrivals(7, Arrival{ 0, 0 });
+
+    const double displayNs = 1e9 / options.hz;
+    const double frameNs = 1e9 / options.fps;
+    const double leadNs = displayNs; // frame selected one display period before its vsync.
+    const double expectedStep = frameNs > 0 ? displayNs / frameNs : 1.0;
+
+    std::size_t next = 0;
+    std::uint64_t lastFrameTimeNs = 0;
+    Result result{};
+    std::vector<double> latencies, waits;
+    const double endNs = static_cast<double>(arrivals.back().arrivalNs);
+    for (std::uint64_t vsync = 1; ; ++vsync) {
+        const double displayTimeNs = arrivals.front().frameTimeNs + vsync * displayNs;
+        const double nowNs = displayTimeNs - leadNs;
+        if (nowNs > endNs)
+            break;
+        for (; next < arrivals.size() && arrivals[next].arrivalNs <= nowNs; ++next) {
+            const std::size_t slot = buffer.AcquireWriteSlot();
+            slotArrivals[slot] = arrivals[next];
+            buffer.Push(slot, arrivals[next].frameTimeNs, arrivals[next].arrivalNs);
+        }
+        const std::size_t slot = buffer.Select(isJitterBuffered ? static_cast<std::uint64_t>(displayTimeNs) : 0,
+            static_cast<std::uint64_t>(nowNs));
+        if (slot == JitterBuffer::InvalidSlot)
+            continue;
+        ++result.displayFrames;
+        const std::uint64_t frameTimeNs = slotArrivals[slot].frameTimeNs;
+        latencies.push_back((displayTimeNs - static_cast<double>(frameTimeNs)) / 1e6);
+        if (frameTimeNs != lastFrameTimeNs)
+            waits.push_back((displayTimeNs - static_cast<double>(slotArrivals[slot].arrivalNs)) / 1e6);
+        if (lastFrameTimeNs != 0) {
+            const double step = (static_cast<double>(frameTimeNs) - lastFrameTimeNs) / frameNs;
+            // at display rates above the frame rate steps alternate between floor and ceil of the ratio.
+            if (step < std::floor(expectedStep) - 0.5 || step > std::ceil(expectedStep) + 0.5)
+                ++result.unevenSteps;
+        }
+        lastFrameTimeNs = frameTimeNs;
+    }
+    result.stats = buffer.GetStats();
+    result.latencyP50Ms = Percentile(latencies, 50);
+    result.latencyP99Ms = Percentile(latencies, 99);
+    result.waitP50Ms = Percentile(waits, 50);
+    result.waitP99Ms = Percentile(waits, 99);
+    return result;
+}
+
+// the buffer's target delay only applies to the jitter selection, "newest" never looks at it.
+void Print(const char* name, const Result& result, const bool isJitterBuffered) {
+    const auto& stats = result.stats;
+    char targetDelay[16] = "-";
+    if (isJitterBuffered)
+        std::snprintf(targetDelay, sizeof(targetDelay), "%.2f", stats.targetDelayUs / 1000.0);
+    std::printf("%-8s %9llu %9llu %9llu %9llu %9llu | %8.2f %8.2f | %8.2f %8.2f | %9s\n", name,
+        static_cast<unsigned long long>(result.displayFrames),
+        static_cast<unsigned long long>(stats.presented),
+        static_cast<unsigned long long>(stats.holds),
+        static_cast<unsigned long long>(stats.skips),
+        static_cast<unsigned long long>(result.unevenSteps),
+        result.latencyP50Ms, result.latencyP99Ms,
+        result.waitP50Ms, result.waitP99Ms,
+        targetDelay);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--scenario") != 0)
+            continue;
+        if (std::strcmp(argv[i + 1], "steady") == 0) {
+            options.scenario = "steady";
+            options.latenessMs = -8.0;
+            options.jitterMs = 3.0;
+        } else if (std::strcmp(argv[i + 1], "wifi") != 0)
+            std::fprintf(stderr, "unknown scenario %s\n", argv[i + 1]);
+    }
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--scenario") == 0)         continue;
+        else if (std::strcmp(name, "--hz") == 0)               options.hz = std::max(1.0, std::strtod(value, nullptr));
+        else if (std::strcmp(name, "--fps") == 0)         options.fps = std::max(1.0, std::strtod(value, nullptr));
+        else if (std::strcmp(name, "--lateness-ms") == 0) options.latenessMs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--jitter-ms") == 0)   options.jitterMs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--stall-ms") == 0)    options.stallMs = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--stall-prob") == 0)  options.stallProb = std::strtod(value, nullptr);
+        else if (std::strcmp(name, "--depth") == 0)       options.depth = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(name, "--frames") == 0)      options.frames = std::max<std::uint64_t>(1, std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(name, "--seed") == 0)        options.seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    options.depth = std::clamp<std::uint32_t>(options.depth, 1, JitterBuffer::MaxDepth);
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    std::printf("scenario=%s hz=%.1f fps=%.1f lateness=%.1fms jitter=%.1fms stall=%.1fms@%.1f%% depth=%u frames=%llu\n",
+        options.scenario, options.hz, options.fps, options.latenessMs, options.jitterMs, options.stallMs, options.stallProb * 100.0,
+        options.depth, static_cast<unsigned long long>(options.frames));
+    std::printf("%-8s %9s %9s %9s %9s %9s | %8s %8s | %8s %8s | %9s\n", "select", "displayed", "presented",
+        "holds", "skips", "uneven", "lat p50", "lat p99", "wait p50", "wait p99", "target ms");
+    const auto arrivals = MakeArrivals(options);
+    const Result newest = Run(options, arrivals, false);
+    const Result buffered = Run(options, arrivals, true);
+    Print("newest", newest, false);
+    Print("jitter", buffered, true);
+    if (std::strcmp(options.scenario, "wifi") == 0 &&
+        (buffered.stats.holds >= newest.stats.holds || buffered.unevenSteps >= newest.unevenSteps)) {
+        std::printf("FAIL: the jitter buffer does not reduce holds and uneven steps in the wifi scenario\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,357 @@
+// CPU side frame time of the Vulkan plugin's command recording: one command buffer waited on, reset,
+// recorded and submitted per view (what RenderViewImpl did) vs a ring of frame slots where both views
+// are recorded into one submission and the CPU only waits on a slot's fence when reusing it (see
+// VulkanGraphicsPlugin::BeginFrameCommands/SubmitViews). Each view clears its eye image a number of
+// times as GPU work, --cpu-us simulates the rest of the render thread's frame (xrWaitFrame, tracking).
+// Runs headless on any Vulkan 1.1 device, e.g. lavapipe: VK_ICD_FILENAMES=.../lvp_icd.x86_64.json
+//
+// usage: alxr_vk_frames_in_flight_bench [--frames N] [--size N] [--clears N] [--cpu-us N]
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#define BENCH_VK(cmd)                                                                   \
+    do {                                                                                \
+        const VkResult res = (cmd);                                                     \
+        if (res != VK_SUCCESS) {                                                        \
+            std::fprintf(stderr, "%s failed: %d (%s:%d)\n", #cmd, res, __FILE__, __LINE__); \
+            std::exit(EXIT_FAILURE);                                                    \
+        }                                                                               \
+    } while (0)
+
+struct Options {
+    std::size_t   frames = 500;
+    std::uint32_t size = 1024;   // eye image width/height.
+    std::uint32_t clears = 8;    // vkCmdClearColorImage per view.
+    std::uint64_t cpuUs = 2000;  // other render thread work per frame.
+};
+
+constexpr const std::size_t ViewCount = 2;
+constexpr const std::size_t FramesInFlight = 2;
+
+struct Device {
+    VkInstance       instance{ VK_NULL_HANDLE };
+    VkPhysicalDevice physicalDevice{ VK_NULL_HANDLE };
+    VkDevice         device{ VK_NULL_HANDLE };
+    VkQueue          queue{ VK_NULL_HANDLE };
+    std::uint32_t    queueFamilyIndex = 0;
+    char             name[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE]{};
+
+    // like the swapchain images the views render to, frame slot x view.
+    std::array<std::array<VkImage, ViewCount>, FramesInFlight>        images{};
+    std::array<std::array<VkDeviceMemory, ViewCount>, FramesInFlight> memories{};
+
+    void Create(const std::uint32_t size) {
+        constexpr const VkApplicationInfo appInfo{
+            .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+            .pApplicationName = "alxr_vk_frames_in_flight_bench",
+            .apiVersion = VK_API_VERSION_1_1
+        };
+        const VkInstanceCreateInfo instanceInfo{
+            .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+            .pApplicationInfo = &appInfo
+        };
+        BENCH_VK(vkCreateInstance(&instanceInfo, nullptr, &instance));
+
+        std::uint32_t deviceCount = 0;
+        BENCH_VK(vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr));
+        if (deviceCount == 0) {
+            std::fprintf(stderr, "no Vulkan device found\n");
+            std::exit(EXIT_FAILURE);
+        }
+        std::vector<VkPhysicalDevice> physicalDevices(deviceCount);
+        BENCH_VK(vkEnumeratePhysicalDevices(instance, &deviceCount, physicalDevices.data()));
+        physicalDevice = physicalDevices[0];
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        std::memcpy(name, properties.deviceName, sizeof(name));
+
+        std::uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+        const auto family = std::find_if(families.begin(), families.end(), [](const VkQueueFamilyProperties& props) {
+            return (props.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+        });
+        if (family == families.end()) {
+            std::fprintf(stderr, "no graphics queue found\n");
+            std::exit(EXIT_FAILURE);
+        }
+        queueFamilyIndex = static_cast<std::uint32_t>(family - families.begin());
+
+        constexpr const float queuePriority = 1.0f;
+        const VkDeviceQueueCreateInfo queueInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = queueFamilyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority
+        };
+        const VkDeviceCreateInfo deviceInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .queueCreateInfoCount = 1,
+            .pQueueCreateInfos = &queueInfo
+        };
+        BENCH_VK(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device));
+        vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+
+        VkPhysicalDeviceMemoryProperties memProps{};
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
+        for (std::size_t slot = 0; slot < FramesInFlight; ++slot) {
+            for (std::size_t view = 0; view < ViewCount; ++view) {
+                const VkImageCreateInfo imageInfo{
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                    .imageType = VK_IMAGE_TYPE_2D,
+                    .format = VK_FORMAT_R8G8B8A8_UNORM,
+                    .extent = { size, size, 1 },
+                    .mipLevels = 1,
+                    .arrayLayers = 1,
+                    .samples = VK_SAMPLE_COUNT_1_BIT,
+                    .tiling = VK_IMAGE_TILING_OPTIMAL,
+                    .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                    .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+                };
+                VkImage& image = images[slot][view];
+                BENCH_VK(vkCreateImage(device, &imageInfo, nullptr, &image));
+                VkMemoryRequirements memReqs{};
+                vkGetImageMemoryRequirements(device, image, &memReqs);
+                std::uint32_t memTypeIndex = 0;
+                while (memTypeIndex < memProps.memoryTypeCount &&
+                       ((memReqs.memoryTypeBits & (1u << memTypeIndex)) == 0 ||
+                        (memProps.memoryTypes[memTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == 0))
+                    ++memTypeIndex;
+                if (memTypeIndex == memProps.memoryTypeCount) {
+                    std::fprintf(stderr, "no device local memory type for the eye images\n");
+                    std::exit(EXIT_FAILURE);
+                }
+                const VkMemoryAllocateInfo allocInfo{
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                    .allocationSize = memReqs.size,
+                    .memoryTypeIndex = memTypeIndex
+                };
+                BENCH_VK(vkAllocateMemory(device, &allocInfo, nullptr, &memories[slot][view]));
+                BENCH_VK(vkBindImageMemory(device, image, memories[slot][view], 0));
+            }
+        }
+    }
+
+    void Destroy() {
+        vkDeviceWaitIdle(device);
+        for (std::size_t slot = 0; slot < FramesInFlight; ++slot) {
+            for (std::size_t view = 0; view < ViewCount; ++view) {
+                vkDestroyImage(device, images[slot][view], nullptr);
+                vkFreeMemory(device, memories[slot][view], nullptr);
+            }
+        }
+        vkDestroyDevice(device, nullptr);
+        vkDestroyInstance(instance, nullptr);
+    }
+};
+
+struct FrameCommands {
+    VkCommandPool   pool{ VK_NULL_HANDLE };
+    VkCommandBuffer buf{ VK_NULL_HANDLE };
+    VkFence         fence{ VK_NULL_HANDLE };
+    bool            isSubmitted = false;
+
+    void Create(const Device& dev) {
+        const VkCommandPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            .queueFamilyIndex = dev.queueFamilyIndex
+        };
+        BENCH_VK(vkCreateCommandPool(dev.device, &poolInfo, nullptr, &pool));
+        const VkCommandBufferAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1
+        };
+        BENCH_VK(vkAllocateCommandBuffers(dev.device, &allocInfo, &buf));
+        constexpr const VkFenceCreateInfo fenceInfo{ .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+        BENCH_VK(vkCreateFence(dev.device, &fenceInfo, nullptr, &fence));
+    }
+
+    void Destroy(const Device& dev) {
+        vkDestroyFence(dev.device, fence, nullptr);
+        vkFreeCommandBuffers(dev.device, pool, 1, &buf);
+        vkDestroyCommandPool(dev.device, pool, nullptr);
+    }
+
+    // Returns the time the CPU spent blocked on the fence.
+    Clock::duration WaitAndBegin(const Device& dev) {
+        Clock::duration blocked{ 0 };
+        if (isSubmitted) {
+            const auto start = Clock::now();
+            BENCH_VK(vkWaitForFences(dev.device, 1, &fence, VK_TRUE, UINT64_MAX));
+            blocked = Clock::now() - start;
+            BENCH_VK(vkResetFences(dev.device, 1, &fence));
+            isSubmitted = false;
+        }
+        BENCH_VK(vkResetCommandBuffer(buf, 0));
+        constexpr const VkCommandBufferBeginInfo beginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        };
+        BENCH_VK(vkBeginCommandBuffer(buf, &beginInfo));
+        return blocked;
+    }
+
+    void EndAndSubmit(const Device& dev) {
+        BENCH_VK(vkEndCommandBuffer(buf));
+        const VkSubmitInfo submitInfo{
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &buf
+        };
+        BENCH_VK(vkQueueSubmit(dev.queue, 1, &submitInfo, fence));
+        isSubmitted = true;
+    }
+};
+
+// the view's render pass: the eye image is transitioned and cleared clears times.
+void RecordView(const VkCommandBuffer buf, const VkImage image, const std::uint32_t clears, const std::size_t frame) {
+    constexpr const VkImageSubresourceRange range{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1
+    };
+    const VkImageMemoryBarrier toTransferDst{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = range
+    };
+    vkCmdPipelineBarrier(buf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        0, nullptr, 0, nullptr, 1, &toTransferDst);
+    for (std::uint32_t clear = 0; clear < clears; ++clear) {
+        const float value = static_cast<float>((frame + clear) % 255) / 255.0f;
+        const VkClearColorValue color{ .float32 = { value, value, value, 1.0f } };
+        vkCmdClearColorImage(buf, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+    }
+}
+
+void BusyFor(const std::uint64_t us) {
+    const auto end = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < end) {}
+}
+
+struct Result {
+    double avgFrameUs, p99FrameUs; // CPU time from the first view's recording to the frame's last submit.
+    double avgBlockedUs;           // of which spent waiting on fences.
+    double totalMs;
+};
+
+Result Summarize(std::vector<double>& frameUs, const double blockedUs, const Clock::duration total) {
+    double sum = 0;
+    for (const double us : frameUs)
+        sum += us;
+    std::sort(frameUs.begin(), frameUs.end());
+    return {
+        .avgFrameUs = sum / frameUs.size(),
+        .p99FrameUs = frameUs[std::min(frameUs.size() - 1, frameUs.size() * 99 / 100)],
+        .avgBlockedUs = blockedUs / frameUs.size(),
+        .totalMs = std::chrono::duration<double, std::milli>(total).count()
+    };
+}
+
+// RenderViewImpl before frames in flight: wait for the previous view, then record and submit this one.
+Result RunPerViewSubmit(const Device& dev, const Options& options) {
+    FrameCommands commands{};
+    commands.Create(dev);
+    std::vector<double> frameUs;
+    frameUs.reserve(options.frames);
+    double blockedUs = 0;
+    const auto runStart = Clock::now();
+    for (std::size_t frame = 0; frame < options.frames; ++frame) {
+        BusyFor(options.cpuUs);
+        const auto frameStart = Clock::now();
+        for (std::size_t view = 0; view < ViewCount; ++view) {
+            blockedUs += std::chrono::duration<double, std::micro>(commands.WaitAndBegin(dev)).count();
+            RecordView(commands.buf, dev.images[frame % FramesInFlight][view], options.clears, frame);
+            commands.EndAndSubmit(dev);
+        }
+        frameUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count());
+    }
+    BENCH_VK(vkQueueWaitIdle(dev.queue));
+    const auto total = Clock::now() - runStart;
+    commands.Destroy(dev);
+    return Summarize(frameUs, blockedUs, total);
+}
+
+// BeginFrameCommands/SubmitViews: both views in one submission, a slot's fence is waited on when reused.
+Result RunFramesInFlight(const Device& dev, const Options& options) {
+    std::array<FrameCommands, FramesInFlight> frameCommands{};
+    for (auto& commands : frameCommands)
+        commands.Create(dev);
+    std::vector<double> frameUs;
+    frameUs.reserve(options.frames);
+    double blockedUs = 0;
+    const auto runStart = Clock::now();
+    for (std::size_t frame = 0; frame < options.frames; ++frame) {
+        BusyFor(options.cpuUs);
+        const auto frameStart = Clock::now();
+        FrameCommands& commands = frameCommands[frame % FramesInFlight];
+        blockedUs += std::chrono::duration<double, std::micro>(commands.WaitAndBegin(dev)).count();
+        for (std::size_t view = 0; view < ViewCount; ++view)
+            RecordView(commands.buf, dev.images[frame % FramesInFlight][view], options.clears, frame);
+        commands.EndAndSubmit(dev);
+        frameUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count());
+    }
+    BENCH_VK(vkQueueWaitIdle(dev.queue));
+    const auto total = Clock::now() - runStart;
+    for (auto& commands : frameCommands)
+        commands.Destroy(dev);
+    return Summarize(frameUs, blockedUs, total);
+}
+
+void Print(const char* name, const Result& result) {
+    std::printf("%-16s %14.1f %14.1f %14.1f %10.1f\n", name,
+        result.avgFrameUs, result.p99FrameUs, result.avgBlockedUs, result.totalMs);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--frames") == 0)      options.frames = std::max<std::size_t>(1, std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(name, "--size") == 0)   options.size = std::max<std::uint32_t>(16, static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10)));
+        else if (std::strcmp(name, "--clears") == 0) options.clears = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(name, "--cpu-us") == 0) options.cpuUs = std::strtoull(value, nullptr, 10);
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    Device dev{};
+    dev.Create(options.size);
+    std::printf("device: %s, frames=%zu eye=%ux%u clears/view=%u cpu=%lluus\n", dev.name, options.frames,
+        options.size, options.size, options.clears, static_cast<unsigned long long>(options.cpuUs));
+    std::printf("%-16s %14s %14s %14s %10s\n", "recording", "avg frame us", "p99 frame us", "avg blocked us", "total ms");
+    Print("per-view submit", RunPerViewSubmit(dev, options));
+    Print("frames in flight", RunFramesInFlight(dev, options));
+    dev.Destroy();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,465 @@
+// Cold vs warm pipeline creation with the Vulkan plugin's persistent pipeline cache (pipeline_cache_file.h).
+// Every run creates a fresh device and builds a set of graphics pipelines from the lobby shaders over
+// different render states, like the plugin does at startup and stream start:
+//   none - no VkPipelineCache
+//   cold - empty cache, saved to disk afterwards as on shutdown
+//   warm - cache loaded from that file
+// Runs headless on any Vulkan 1.1 device, e.g. lavapipe: VK_ICD_FILENAMES=.../lvp_icd.x86_64.json.
+// Mesa drivers also keep their own shader disk cache, set MESA_SHADER_CACHE_DISABLE=true to measure
+// the VkPipelineCache alone. Drivers may keep state per process as well, --phase runs one phase so
+// cold and warm can be measured in separate processes: --phase cold, then --phase warm.
+// SwiftShader only shares shaders between pipelines of the same cache object and saves just the 32 byte
+// header, so there none is slower than cold and cold and warm match.
+//
+// Also checks the file round trip on the device: the warm phase must load what the cold phase saved,
+// and a corrupted file or one from another driver version must be rejected.
+//
+// usage: alxr_vk_pipeline_cache_bench [--cache-dir DIR] [--runs N] [--phase all|none|cold|warm]
+//
+// Exits with 1 if a round trip check fails.
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <array>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#include <vulkan/vulkan.h>
+
+#include "pipeline_cache_file.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#define BENCH_VK(cmd)                                                                       \
+    do {                                                                                    \
+        const VkResult res = (cmd);                                                         \
+        if (res != VK_SUCCESS) {                                                            \
+            std::fprintf(stderr, "%s failed: %d (%s:%d)\n", #cmd, res, __FILE__, __LINE__); \
+            std::exit(EXIT_FAILURE);                                                        \
+        }                                                                                   \
+    } while (0)
+
+constexpr const std::uint32_t LobbyVertSpv[] =
+#include "vulkan_shaders/precompiled/lobby_vert.spv"
+;
+constexpr const std::uint32_t LobbyFragSpv[] =
+#include "vulkan_shaders/precompiled/lobby_frag.spv"
+;
+
+struct Options {
+    std::string cacheDir = (std::filesystem::temp_directory_path() / "alxr_vk_pipeline_cache_bench").string();
+    std::size_t runs = 3;
+    std::string phase = "all";
+};
+
+// render states the pipelines are built for, each combination is a separately compiled pipeline.
+constexpr const std::array<VkFormat, 3> ColorFormats{ VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM };
+constexpr const std::array<VkBool32, 2> BlendEnables{ VK_FALSE, VK_TRUE };
+constexpr const std::array<VkCullModeFlags, 2> CullModes{ VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_NONE };
+
+struct Device {
+    VkInstance       instance{ VK_NULL_HANDLE };
+    VkPhysicalDevice physicalDevice{ VK_NULL_HANDLE };
+    VkDevice         device{ VK_NULL_HANDLE };
+    ALXR::PipelineCacheKey key{};
+    char             name[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE]{};
+
+    void Create() {
+        constexpr const VkApplicationInfo appInfo{
+            .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+            .pApplicationName = "alxr_vk_pipeline_cache_bench",
+            .apiVersion = VK_API_VERSION_1_1
+        };
+        const VkInstanceCreateInfo instanceInfo{
+            .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+            .pApplicationInfo = &appInfo
+        };
+        BENCH_VK(vkCreateInstance(&instanceInfo, nullptr, &instance));
+        std::uint32_t deviceCount = 1;
+        const VkResult res = vkEnumeratePhysicalDevices(instance, &deviceCount, &physicalDevice);
+        if ((res != VK_SUCCESS && res != VK_INCOMPLETE) || deviceCount == 0) {
+            std::fprintf(stderr, "no Vulkan device found\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        VkPhysicalDeviceIDProperties idProps{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES };
+        VkPhysicalDeviceProperties2 props2{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &idProps };
+        vkGetPhysicalDeviceProperties2(physicalDevice, &props2);
+        const VkPhysicalDeviceProperties& props = props2.properties;
+        std::memcpy(name, props.deviceName, sizeof(name));
+        std::memcpy(key.deviceUUID.data(), idProps.deviceUUID, VK_UUID_SIZE);
+        std::memcpy(key.pipelineCacheUUID.data(), props.pipelineCacheUUID, VK_UUID_SIZE);
+        key.vendorID = props.vendorID;
+        key.deviceID = props.deviceID;
+        key.driverVersion = props.driverVersion;
+
+        std::uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+        const auto family = std::find_if(families.begin(), families.end(), [](const VkQueueFamilyProperties& familyProps) {
+            return (familyProps.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+        });
+        if (family == families.end()) {
+            std::fprintf(stderr, "no graphics queue found\n");
+            std::exit(EXIT_FAILURE);
+        }
+        constexpr const float queuePriority = 1.0f;
+        const VkDeviceQueueCreateInfo queueInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = static_cast<std::uint32_t>(family - families.begin()),
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority
+        };
+        const VkDeviceCreateInfo deviceInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .queueCreateInfoCount = 1,
+            .pQueueCreateInfos = &queueInfo
+        };
+        BENCH_VK(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device));
+    }
+
+    void Destroy() {
+        vkDestroyDevice(device, nullptr);
+        vkDestroyInstance(instance, nullptr);
+    }
+};
+
+VkShaderModule CreateShaderModule(const VkDevice device, const std::uint32_t* code, const std::size_t size) {
+    const VkShaderModuleCreateInfo moduleInfo{
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = size,
+        .pCode = code
+    };
+    VkShaderModule module{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateShaderModule(device, &moduleInfo, nullptr, &module));
+    return module;
+}
+
+VkRenderPass CreateRenderPass(const VkDevice device, const VkFormat colorFormat) {
+    const std::array<VkAttachmentDescription, 2> attachments{ {
+        {
+            .format = colorFormat,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+        },
+        {
+            .format = VK_FORMAT_D32_SFLOAT,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        }
+    } };
+    constexpr const VkAttachmentReference colorRef{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    constexpr const VkAttachmentReference depthRef{ 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+    const VkSubpassDescription subpass{
+        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colorRef,
+        .pDepthStencilAttachment = &depthRef
+    };
+    const VkRenderPassCreateInfo passInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .attachmentCount = static_cast<std::uint32_t>(attachments.size()),
+        .pAttachments = attachments.data(),
+        .subpassCount = 1,
+        .pSubpasses = &subpass
+    };
+    VkRenderPass renderPass{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateRenderPass(device, &passInfo, nullptr, &renderPass));
+    return renderPass;
+}
+
+// The lobby pipeline of Pipeline::Create with the given variations.
+VkPipeline CreatePipeline
+(
+    const VkDevice device, const VkPipelineCache pipelineCache, const VkPipelineLayout layout,
+    const VkRenderPass renderPass, const std::array<VkPipelineShaderStageCreateInfo, 2>& stages,
+    const VkBool32 blendEnable, const VkCullModeFlags cullMode
+)
+{
+    constexpr const VkVertexInputBindingDescription binding{ 0, 24, VK_VERTEX_INPUT_RATE_VERTEX };
+    constexpr const std::array<VkVertexInputAttributeDescription, 2> attributes{ {
+        { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 },
+        { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, 12 }
+    } };
+    const VkPipelineVertexInputStateCreateInfo vi{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount = 1,
+        .pVertexBindingDescriptions = &binding,
+        .vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributes.size()),
+        .pVertexAttributeDescriptions = attributes.data()
+    };
+    constexpr const VkPipelineInputAssemblyStateCreateInfo ia{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+    };
+    const VkPipelineRasterizationStateCreateInfo rs{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode = cullMode,
+        .frontFace = VK_FRONT_FACE_CLOCKWISE,
+        .lineWidth = 1.0f
+    };
+    const VkPipelineColorBlendAttachmentState attachState{
+        .blendEnable = blendEnable,
+        .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+        .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+        .colorBlendOp = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .alphaBlendOp = VK_BLEND_OP_ADD,
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+    };
+    const VkPipelineColorBlendStateCreateInfo cb{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .attachmentCount = 1,
+        .pAttachments = &attachState
+    };
+    constexpr const VkViewport viewport{ 0.0f, 0.0f, 1024.0f, 1024.0f, 0.0f, 1.0f };
+    constexpr const VkRect2D scissor{ { 0, 0 }, { 1024, 1024 } };
+    const VkPipelineViewportStateCreateInfo vp{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
+        .pViewports = &viewport,
+        .scissorCount = 1,
+        .pScissors = &scissor
+    };
+    constexpr const VkPipelineDepthStencilStateCreateInfo ds{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable = VK_TRUE,
+        .depthWriteEnable = VK_TRUE,
+        .depthCompareOp = VK_COMPARE_OP_LESS,
+        .maxDepthBounds = 1.0f
+    };
+    constexpr const VkPipelineMultisampleStateCreateInfo ms{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+    };
+    const VkGraphicsPipelineCreateInfo pipeInfo{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = static_cast<std::uint32_t>(stages.size()),
+        .pStages = stages.data(),
+        .pVertexInputState = &vi,
+        .pInputAssemblyState = &ia,
+        .pViewportState = &vp,
+        .pRasterizationState = &rs,
+        .pMultisampleState = &ms,
+        .pDepthStencilState = &ds,
+        .pColorBlendState = &cb,
+        .layout = layout,
+        .renderPass = renderPass,
+        .subpass = 0
+    };
+    VkPipeline pipeline{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipeInfo, nullptr, &pipeline));
+    return pipeline;
+}
+
+enum class CacheMode { None, Cold, Warm };
+
+struct Result {
+    double createMs;    // all pipelines.
+    double loadMs;      // reading the cache file + vkCreatePipelineCache.
+    double saveMs;      // vkGetPipelineCacheData + writing the file.
+    std::size_t pipelines, cacheBytes;
+    std::size_t loadedBytes; // cache data accepted from the file.
+};
+
+Result Run(const CacheMode mode, const std::string& cachePath, const Device& dev) {
+    Result result{};
+    const VkDevice device = dev.device;
+
+    VkPipelineCache pipelineCache{ VK_NULL_HANDLE };
+    if (mode != CacheMode::None) {
+        const auto loadStart = Clock::now();
+        const std::vector<std::uint8_t> initialData = mode == CacheMode::Warm ?
+            ALXR::LoadPipelineCache(cachePath, dev.key) : std::vector<std::uint8_t>{};
+        if (mode == CacheMode::Warm && initialData.empty())
+            std::fprintf(stderr, "warm run: no valid cache in %s\n", cachePath.c_str());
+        result.loadedBytes = initialData.size();
+        const VkPipelineCacheCreateInfo cacheInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = initialData.size(),
+            .pInitialData = initialData.empty() ? nullptr : initialData.data()
+        };
+        BENCH_VK(vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache));
+        result.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - loadStart).count();
+    }
+
+    const VkShaderModule vertModule = CreateShaderModule(device, LobbyVertSpv, sizeof(LobbyVertSpv));
+    const VkShaderModule fragModule = CreateShaderModule(device, LobbyFragSpv, sizeof(LobbyFragSpv));
+    const std::array<VkPipelineShaderStageCreateInfo, 2> stages{ {
+        { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_VERTEX_BIT, .module = vertModule, .pName = "main" },
+        { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_FRAGMENT_BIT, .module = fragModule, .pName = "main" }
+    } };
+    constexpr const VkPushConstantRange pushConstantRange{ VK_SHADER_STAGE_VERTEX_BIT, 0, 4 * 4 * sizeof(float) };
+    const VkPipelineLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    VkPipelineLayout layout{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layout));
+
+    std::vector<VkRenderPass> renderPasses;
+    for (const VkFormat colorFormat : ColorFormats)
+        renderPasses.push_back(CreateRenderPass(device, colorFormat));
+
+    std::vector<VkPipeline> pipelines;
+    const auto createStart = Clock::now();
+    for (const VkRenderPass renderPass : renderPasses) {
+        for (const VkBool32 blendEnable : BlendEnables) {
+            for (const VkCullModeFlags cullMode : CullModes)
+                pipelines.push_back(CreatePipeline(device, pipelineCache, layout, renderPass, stages, blendEnable, cullMode));
+        }
+    }
+    result.createMs = std::chrono::duration<double, std::milli>(Clock::now() - createStart).count();
+    result.pipelines = pipelines.size();
+
+    if (mode == CacheMode::Cold) {
+        const auto saveStart = Clock::now();
+        std::size_t size = 0;
+        BENCH_VK(vkGetPipelineCacheData(device, pipelineCache, &size, nullptr));
+        std::vector<std::uint8_t> data(size);
+        BENCH_VK(vkGetPipelineCacheData(device, pipelineCache, &size, data.data()));
+        if (!ALXR::SavePipelineCache(cachePath, dev.key, data.data(), size))
+            std::fprintf(stderr, "failed to write %s\n", cachePath.c_str());
+        result.saveMs = std::chrono::duration<double, std::milli>(Clock::now() - saveStart).count();
+        result.cacheBytes = size;
+    }
+
+    for (const VkPipeline pipeline : pipelines)
+        vkDestroyPipeline(device, pipeline, nullptr);
+    for (const VkRenderPass renderPass : renderPasses)
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    vkDestroyPipelineLayout(device, layout, nullptr);
+    vkDestroyShaderModule(device, fragModule, nullptr);
+    vkDestroyShaderModule(device, vertModule, nullptr);
+    if (pipelineCache != VK_NULL_HANDLE)
+        vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    return result;
+}
+
+void Print(const char* name, const Result& result) {
+    std::printf("%-6s %10zu %12.2f %10.2f %10.2f %12zu\n", name, result.pipelines,
+        result.createMs, result.loadMs, result.saveMs, result.cacheBytes);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--cache-dir") == 0) options.cacheDir = value;
+        else if (std::strcmp(name, "--runs") == 0) options.runs = std::max<std::size_t>(1, std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(name, "--phase") == 0) options.phase = value;
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+
+// A file saved for key must load back whole, and be rejected once a byte of it changes or the driver is updated.
+bool CheckRejects(const std::string& cachePath, const ALXR::PipelineCacheKey& key) {
+    bool ok = true;
+    const std::vector<std::uint8_t> data = ALXR::LoadPipelineCache(cachePath, key);
+    if (data.empty()) {
+        std::printf("FAIL: %s does not load back\n", cachePath.c_str());
+        return false;
+    }
+    ALXR::PipelineCacheKey newerDriver = key;
+    ++newerDriver.driverVersion;
+    if (!ALXR::LoadPipelineCache(cachePath, newerDriver).empty()) {
+        std::printf("FAIL: cache accepted for another driver version\n");
+        ok = false;
+    }
+
+    const std::string corruptPath = cachePath + ".corrupt";
+    std::error_code ec;
+    std::filesystem::copy_file(cachePath, corruptPath, std::filesystem::copy_options::overwrite_existing, ec);
+    if (std::FILE* const file = ec ? nullptr : std::fopen(corruptPath.c_str(), "r+b")) {
+        // the last byte of the driver's data, within its header if the driver saves nothing else.
+        std::fseek(file, -1, SEEK_END);
+        const int last = std::fgetc(file);
+        std::fseek(file, -1, SEEK_END);
+        std::fputc(last ^ 0xFF, file);
+        std::fclose(file);
+        if (!ALXR::LoadPipelineCache(corruptPath, key).empty()) {
+            std::printf("FAIL: corrupted cache accepted\n");
+            ok = false;
+        }
+    } else {
+        std::printf("FAIL: could not copy %s\n", cachePath.c_str());
+        ok = false;
+    }
+    std::filesystem::remove(corruptPath, ec);
+    return ok;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    const bool isAll = options.phase == "all";
+    const auto hasPhase = [&](const char* name) { return isAll || options.phase == name; };
+    if (!isAll && !hasPhase("none") && !hasPhase("cold") && !hasPhase("warm")) {
+        std::fprintf(stderr, "unknown phase %s\n", options.phase.c_str());
+        return EXIT_FAILURE;
+    }
+
+    bool isWarmFaster = true;
+    bool isRoundTripOk = true;
+    bool isHeaderPrinted = false;
+    for (std::size_t run = 0; run < options.runs; ++run) {
+        // a fresh device per phase, drivers keep in memory caches per device.
+        const auto runPhase = [&](const CacheMode mode, const char* name) {
+            Device dev{};
+            dev.Create();
+            const std::string cachePath = ALXR::PipelineCachePath(options.cacheDir, dev.key);
+            if (!isHeaderPrinted) {
+                std::printf("device: %s, cache: %s\n", dev.name, cachePath.c_str());
+                std::printf("%-6s %10s %12s %10s %10s %12s\n", "cache", "pipelines", "create ms", "load ms", "save ms", "cache bytes");
+                isHeaderPrinted = true;
+            }
+            const Result result = Run(mode, cachePath, dev);
+            if (mode == CacheMode::Cold)
+                isRoundTripOk = CheckRejects(cachePath, dev.key) && isRoundTripOk;
+            dev.Destroy();
+            Print(name, result);
+            return result;
+        };
+        if (hasPhase("none"))
+            runPhase(CacheMode::None, "none");
+        Result cold{};
+        if (hasPhase("cold"))
+            cold = runPhase(CacheMode::Cold, "cold");
+        if (hasPhase("warm")) {
+            const Result warm = runPhase(CacheMode::Warm, "warm");
+            if (warm.loadedBytes == 0) {
+                std::printf("FAIL: warm run loaded no cache data\n");
+                isRoundTripOk = false;
+            } else if (isAll && warm.loadedBytes != cold.cacheBytes) {
+                std::printf("FAIL: warm run loaded %zu bytes, the cold run saved %zu\n", warm.loadedBytes, cold.cacheBytes);
+                isRoundTripOk = false;
+            }
+            isWarmFaster = isWarmFaster && (!isAll || (warm.createMs + warm.loadMs) < cold.createMs);
+        }
+    }
+    if (!isWarmFaster)
+        std::printf("warm start was not faster than cold in every run\n");
+    return isRoundTripOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
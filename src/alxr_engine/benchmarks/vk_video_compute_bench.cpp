@@ -0,0 +1,855 @@
+// GPU time of the Vulkan plugin's video pass drawing a side-by-side video frame into both layers of a
+// multiview eye image:
+//   raster  - render pass with color & depth attachments, full screen triangle (videoStream_vert/frag)
+//   compute - one dispatch writing the eye image as a storage image, no render pass or depth (videoStream_comp)
+// Both sample the frame through the same combined image sampler, a YCbCr conversion sampler of an NV12
+// texture where the device supports it (RGBA8 otherwise), with the plugin's sRGB linearize on.
+// Uses the engine's compiled multiview SPIR-V, so it is only built with BUILD_ALXR_VIDEO_COMPUTE_PASS.
+// Runs headless on any Vulkan 1.1 device with multiview & shaderStorageImageWriteWithoutFormat,
+// e.g. lavapipe: VK_ICD_FILENAMES=.../lvp_icd.x86_64.json
+//
+// usage: alxr_vk_video_compute_bench [--frames N] [--width N] [--height N] [--fov-decode 0|1]
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#include <vulkan/vulkan.h>
+
+// glslangValidator doesn't wrap its output in brackets if you don't have it define the whole array.
+#if defined(USE_GLSLANGVALIDATOR)
+#define SPV_PREFIX {
+#define SPV_SUFFIX }
+#else
+#define SPV_PREFIX
+#define SPV_SUFFIX
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#define BENCH_VK(cmd)                                                                       \
+    do {                                                                                    \
+        const VkResult res = (cmd);                                                         \
+        if (res != VK_SUCCESS) {                                                            \
+            std::fprintf(stderr, "%s failed: %d (%s:%d)\n", #cmd, res, __FILE__, __LINE__); \
+            std::exit(EXIT_FAILURE);                                                        \
+        }                                                                                   \
+    } while (0)
+
+constexpr const std::uint32_t VideoVertSpv[] = SPV_PREFIX
+#include "shaders/multiview/videoStream_vert.spv"
+SPV_SUFFIX;
+constexpr const std::uint32_t VideoFragSpv[] = SPV_PREFIX
+#include "shaders/multiview/videoStream_frag.spv"
+SPV_SUFFIX;
+constexpr const std::uint32_t VideoCompSpv[] = SPV_PREFIX
+#include "shaders/multiview/videoStream_comp.spv"
+SPV_SUFFIX;
+constexpr const std::uint32_t FovDecodeVideoFragSpv[] = SPV_PREFIX
+#include "shaders/multiview/fovDecode/videoStream_frag.spv"
+SPV_SUFFIX;
+constexpr const std::uint32_t FovDecodeVideoCompSpv[] = SPV_PREFIX
+#include "shaders/multiview/fovDecode/videoStream_comp.spv"
+SPV_SUFFIX;
+
+struct Options {
+    std::size_t   frames = 300;
+    std::uint32_t width = 1832;   // eye image width, the video frame is side by side.
+    std::uint32_t height = 1920;
+    bool          fovDecode = false;
+};
+
+constexpr const std::uint32_t ViewCount = 2;
+constexpr const VkFormat EyeFormat = VK_FORMAT_R8G8B8A8_UNORM;
+constexpr const VkFormat DepthFormat = VK_FORMAT_D32_SFLOAT;
+
+// push_constant block of videoStream_vert/comp.glsl (std140): 2 mat3 (3 vec4 columns) + view index.
+struct alignas(16) VideoStreamPushConstants {
+    std::array<std::array<float, 12>, ViewCount> videoReprojection;
+    std::uint32_t viewID;
+};
+constexpr const std::uint32_t VideoStreamPushConstantsSize =
+    static_cast<std::uint32_t>(offsetof(VideoStreamPushConstants, viewID) + sizeof(std::uint32_t));
+
+// ALXR::MakeIdentityVideoReprojection, eye local (u, v up) -> the eye's half of the frame (v down).
+constexpr const VideoStreamPushConstants IdentityPushConstants{
+    .videoReprojection {{
+        { 0.5f, 0.0f, 0.0f, 0.0f,   0.0f, -1.0f, 0.0f, 0.0f,   0.0f, 1.0f, 1.0f, 0.0f },
+        { 0.5f, 0.0f, 0.0f, 0.0f,   0.0f, -1.0f, 0.0f, 0.0f,   0.5f, 1.0f, 1.0f, 0.0f }
+    }},
+    .viewID = 0
+};
+
+// constant_id 8 & 9 of the video shaders, the foveation decode parameters keep their defaults.
+struct SpecializationData {
+    VkBool32 enableSRGBLinearize;
+    VkBool32 sRGBSwapchain;
+};
+constexpr const SpecializationData SpecializationConst{ .enableSRGBLinearize = VK_TRUE, .sRGBSwapchain = VK_FALSE };
+constexpr const std::array<VkSpecializationMapEntry, 2> SpecializationEntries{ {
+    { 8, offsetof(SpecializationData, enableSRGBLinearize), sizeof(VkBool32) },
+    { 9, offsetof(SpecializationData, sRGBSwapchain), sizeof(VkBool32) }
+} };
+constexpr const VkSpecializationInfo SpecializationInfo{
+    .mapEntryCount = static_cast<std::uint32_t>(SpecializationEntries.size()),
+    .pMapEntries = SpecializationEntries.data(),
+    .dataSize = sizeof(SpecializationConst),
+    .pData = &SpecializationConst
+};
+
+struct Device {
+    VkInstance       instance{ VK_NULL_HANDLE };
+    VkPhysicalDevice physicalDevice{ VK_NULL_HANDLE };
+    VkDevice         device{ VK_NULL_HANDLE };
+    VkQueue          queue{ VK_NULL_HANDLE };
+    std::uint32_t    queueFamilyIndex = 0;
+    float            timestampPeriod = 1.0f;
+    bool             isYcbcrSupported = false;
+    char             name[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE]{};
+
+    void Create() {
+        constexpr const VkApplicationInfo appInfo{
+            .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+            .pApplicationName = "alxr_vk_video_compute_bench",
+            .apiVersion = VK_API_VERSION_1_1
+        };
+        const VkInstanceCreateInfo instanceInfo{
+            .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+            .pApplicationInfo = &appInfo
+        };
+        BENCH_VK(vkCreateInstance(&instanceInfo, nullptr, &instance));
+
+        std::uint32_t deviceCount = 0;
+        BENCH_VK(vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr));
+        if (deviceCount == 0) {
+            std::fprintf(stderr, "no Vulkan device found\n");
+            std::exit(EXIT_FAILURE);
+        }
+        std::vector<VkPhysicalDevice> physicalDevices(deviceCount);
+        BENCH_VK(vkEnumeratePhysicalDevices(instance, &deviceCount, physicalDevices.data()));
+        physicalDevice = physicalDevices[0];
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        std::memcpy(name, properties.deviceName, sizeof(name));
+        timestampPeriod = properties.limits.timestampPeriod;
+
+        VkPhysicalDeviceMultiviewFeatures multiviewFeatures{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES };
+        VkPhysicalDeviceSamplerYcbcrConversionFeatures ycbcrFeatures{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SAMPLER_YCBCR_CONVERSION_FEATURES,
+            .pNext = &multiviewFeatures
+        };
+        VkPhysicalDeviceFeatures2 features2{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &ycbcrFeatures };
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+        if (!multiviewFeatures.multiview || !features2.features.shaderStorageImageWriteWithoutFormat) {
+            std::fprintf(stderr, "device lacks multiview or shaderStorageImageWriteWithoutFormat\n");
+            std::exit(EXIT_FAILURE);
+        }
+        isYcbcrSupported = ycbcrFeatures.samplerYcbcrConversion == VK_TRUE;
+
+        std::uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+        // the plugin renders & dispatches on its graphics queue.
+        constexpr const VkQueueFlags RequiredFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+        const auto family = std::find_if(families.begin(), families.end(), [](const VkQueueFamilyProperties& familyProps) {
+            return (familyProps.queueFlags & RequiredFlags) == RequiredFlags && familyProps.timestampValidBits > 0;
+        });
+        if (family == families.end()) {
+            std::fprintf(stderr, "no graphics & compute queue with timestamps found\n");
+            std::exit(EXIT_FAILURE);
+        }
+        queueFamilyIndex = static_cast<std::uint32_t>(family - families.begin());
+
+        constexpr const float queuePriority = 1.0f;
+        const VkDeviceQueueCreateInfo queueInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = queueFamilyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority
+        };
+        VkPhysicalDeviceMultiviewFeatures enabledMultiview{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES,
+            .multiview = VK_TRUE
+        };
+        VkPhysicalDeviceSamplerYcbcrConversionFeatures enabledYcbcr{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SAMPLER_YCBCR_CONVERSION_FEATURES,
+            .pNext = &enabledMultiview,
+            .samplerYcbcrConversion = isYcbcrSupported ? VK_TRUE : VK_FALSE
+        };
+        const VkPhysicalDeviceFeatures2 enabledFeatures{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &enabledYcbcr,
+            .features { .shaderStorageImageWriteWithoutFormat = VK_TRUE }
+        };
+        const VkDeviceCreateInfo deviceInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .pNext = &enabledFeatures,
+            .queueCreateInfoCount = 1,
+            .pQueueCreateInfos = &queueInfo
+        };
+        BENCH_VK(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device));
+        vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+    }
+
+    VkDeviceMemory AllocateImageMemory(const VkImage image) const {
+        VkMemoryRequirements requirements{};
+        vkGetImageMemoryRequirements(device, image, &requirements);
+        VkPhysicalDeviceMemoryProperties memProps{};
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
+        std::uint32_t typeIndex = 0;
+        while (typeIndex < memProps.memoryTypeCount &&
+               ((requirements.memoryTypeBits & (1u << typeIndex)) == 0 ||
+                (memProps.memoryTypes[typeIndex].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == 0))
+            ++typeIndex;
+        if (typeIndex == memProps.memoryTypeCount) {
+            std::fprintf(stderr, "no device local memory type for an image\n");
+            std::exit(EXIT_FAILURE);
+        }
+        const VkMemoryAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = typeIndex
+        };
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        BENCH_VK(vkAllocateMemory(device, &allocInfo, nullptr, &memory));
+        BENCH_VK(vkBindImageMemory(device, image, memory, 0));
+        return memory;
+    }
+
+    void Destroy() {
+        vkDestroyDevice(device, nullptr);
+        vkDestroyInstance(instance, nullptr);
+    }
+};
+
+struct Image {
+    VkImage        image{ VK_NULL_HANDLE };
+    VkDeviceMemory memory{ VK_NULL_HANDLE };
+    VkImageView    view{ VK_NULL_HANDLE };
+
+    void Create(const Device& dev, const VkFormat format, const VkExtent2D size, const std::uint32_t layers,
+                const VkImageUsageFlags usage, const VkImageAspectFlags aspect, const void* viewNext = nullptr) {
+        const VkImageCreateInfo imageInfo{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = format,
+            .extent = { size.width, size.height, 1 },
+            .mipLevels = 1,
+            .arrayLayers = layers,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+        BENCH_VK(vkCreateImage(dev.device, &imageInfo, nullptr, &image));
+        memory = dev.AllocateImageMemory(image);
+        const VkImageViewCreateInfo viewInfo{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = viewNext,
+            .image = image,
+            .viewType = layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+            .format = format,
+            .subresourceRange = { aspect, 0, 1, 0, layers }
+        };
+        BENCH_VK(vkCreateImageView(dev.device, &viewInfo, nullptr, &view));
+    }
+
+    void Destroy(const VkDevice device) {
+        vkDestroyImageView(device, view, nullptr);
+        vkDestroyImage(device, image, nullptr);
+        vkFreeMemory(device, memory, nullptr);
+    }
+};
+
+VkShaderModule CreateShaderModule(const VkDevice device, const std::uint32_t* code, const std::size_t size) {
+    const VkShaderModuleCreateInfo moduleInfo{
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = size,
+        .pCode = code
+    };
+    VkShaderModule module{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateShaderModule(device, &moduleInfo, nullptr, &module));
+    return module;
+}
+
+void ImageBarrier
+(
+    const VkCommandBuffer cmdBuffer, const VkImage image, const VkImageAspectFlags aspect,
+    const VkImageLayout oldLayout, const VkImageLayout newLayout,
+    const VkAccessFlags srcAccess, const VkAccessFlags dstAccess,
+    const VkPipelineStageFlags srcStage, const VkPipelineStageFlags dstStage
+)
+{
+    const VkImageMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = srcAccess,
+        .dstAccessMask = dstAccess,
+        .oldLayout = oldLayout,
+        .newLayout = newLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = { aspect, 0, 1, 0, VK_REMAINING_ARRAY_LAYERS }
+    };
+    vkCmdPipelineBarrier(cmdBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// Video texture & sampler, the plugin's video stream layout (set 0) and both passes' pipelines.
+struct VideoPasses {
+    VkSamplerYcbcrConversion conversion{ VK_NULL_HANDLE };
+    VkSampler                sampler{ VK_NULL_HANDLE };
+    Image                    videoTexture{};
+    Image                    eyeImage{};   // ViewCount layers, color attachment & storage.
+    Image                    depthImage{}; // raster only.
+    VkDescriptorSetLayout    videoSetLayout{ VK_NULL_HANDLE };
+    VkDescriptorSetLayout    storageSetLayout{ VK_NULL_HANDLE };
+    VkDescriptorPool         descriptorPool{ VK_NULL_HANDLE };
+    VkDescriptorSet          videoSet{ VK_NULL_HANDLE };
+    VkDescriptorSet          storageSet{ VK_NULL_HANDLE };
+    VkRenderPass             renderPass{ VK_NULL_HANDLE };
+    VkFramebuffer            framebuffer{ VK_NULL_HANDLE };
+    VkPipelineLayout         rasterLayout{ VK_NULL_HANDLE };
+    VkPipelineLayout         computeLayout{ VK_NULL_HANDLE };
+    VkPipeline               rasterPipeline{ VK_NULL_HANDLE };
+    VkPipeline               computePipeline{ VK_NULL_HANDLE };
+    VkExtent2D               eyeSize{};
+    VkFormat                 videoFormat{ VK_FORMAT_UNDEFINED };
+
+    void CreateVideoTexture(const Device& dev) {
+        const VkDevice device = dev.device;
+        const VkExtent2D videoSize{ eyeSize.width * ViewCount, eyeSize.height };
+
+        VkFormatProperties nv12Props{};
+        vkGetPhysicalDeviceFormatProperties(dev.physicalDevice, VK_FORMAT_G8_B8R8_2PLANE_420_UNORM, &nv12Props);
+        const VkFormatFeatureFlags nv12Features = nv12Props.optimalTilingFeatures;
+        videoFormat = dev.isYcbcrSupported && (nv12Features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0 ?
+            VK_FORMAT_G8_B8R8_2PLANE_420_UNORM : VK_FORMAT_R8G8B8A8_UNORM;
+
+        VkSamplerYcbcrConversionInfo conversionInfo{ .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO };
+        VkFilter filter = VK_FILTER_LINEAR;
+        if (videoFormat == VK_FORMAT_G8_B8R8_2PLANE_420_UNORM) {
+            // PipelineLayout::CreateVideoStreamLayout's conversion.
+            filter = (nv12Features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_YCBCR_CONVERSION_LINEAR_FILTER_BIT) != 0 ?
+                VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+            const VkSamplerYcbcrConversionCreateInfo conversionCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_CREATE_INFO,
+                .format = videoFormat,
+                .ycbcrModel = VK_SAMPLER_YCBCR_MODEL_CONVERSION_YCBCR_709,
+                .ycbcrRange = VK_SAMPLER_YCBCR_RANGE_ITU_NARROW,
+                .components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                                VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY },
+                .xChromaOffset = VK_CHROMA_LOCATION_MIDPOINT,
+                .yChromaOffset = VK_CHROMA_LOCATION_MIDPOINT,
+                .chromaFilter = filter,
+                .forceExplicitReconstruction = VK_FALSE
+            };
+            BENCH_VK(vkCreateSamplerYcbcrConversion(device, &conversionCreateInfo, nullptr, &conversion));
+            conversionInfo.conversion = conversion;
+        }
+        const VkSamplerCreateInfo samplerInfo{
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .pNext = conversion != VK_NULL_HANDLE ? &conversionInfo : nullptr,
+            .magFilter = filter,
+            .minFilter = filter,
+            .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+            .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .maxAnisotropy = 1.0f,
+            .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK
+        };
+        BENCH_VK(vkCreateSampler(device, &samplerInfo, nullptr, &sampler));
+        // contents are left undefined, the sampling cost does not depend on them.
+        videoTexture.Create(dev, videoFormat, videoSize, 1, VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
+                            conversion != VK_NULL_HANDLE ? &conversionInfo : nullptr);
+    }
+
+    void CreateDescriptorSets(const VkDevice device) {
+        const VkDescriptorSetLayoutBinding videoBinding{
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+            .pImmutableSamplers = &sampler
+        };
+        const VkDescriptorSetLayoutCreateInfo videoLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &videoBinding
+        };
+        BENCH_VK(vkCreateDescriptorSetLayout(device, &videoLayoutInfo, nullptr, &videoSetLayout));
+        constexpr const VkDescriptorSetLayoutBinding storageBinding{
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        };
+        const VkDescriptorSetLayoutCreateInfo storageLayoutInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &storageBinding
+        };
+        BENCH_VK(vkCreateDescriptorSetLayout(device, &storageLayoutInfo, nullptr, &storageSetLayout));
+
+        // YCbCr conversion samplers may take more than one descriptor, plenty for either format.
+        constexpr const std::array<VkDescriptorPoolSize, 2> poolSizes{ {
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 }
+        } };
+        const VkDescriptorPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets = 2,
+            .poolSizeCount = static_cast<std::uint32_t>(poolSizes.size()),
+            .pPoolSizes = poolSizes.data()
+        };
+        BENCH_VK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool));
+        const std::array<VkDescriptorSetLayout, 2> setLayouts{ videoSetLayout, storageSetLayout };
+        std::array<VkDescriptorSet, 2> sets{};
+        const VkDescriptorSetAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = descriptorPool,
+            .descriptorSetCount = static_cast<std::uint32_t>(setLayouts.size()),
+            .pSetLayouts = setLayouts.data()
+        };
+        BENCH_VK(vkAllocateDescriptorSets(device, &allocInfo, sets.data()));
+        videoSet = sets[0];
+        storageSet = sets[1];
+
+        const VkDescriptorImageInfo videoImageInfo{ VK_NULL_HANDLE, videoTexture.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+        const VkDescriptorImageInfo storageImageInfo{ VK_NULL_HANDLE, eyeImage.view, VK_IMAGE_LAYOUT_GENERAL };
+        const std::array<VkWriteDescriptorSet, 2> writes{ {
+            {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = videoSet,
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &videoImageInfo
+            },
+            {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = storageSet,
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .pImageInfo = &storageImageInfo
+            }
+        } };
+        vkUpdateDescriptorSets(device, static_cast<std::uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    // RenderPass::Create for a multiview swapchain.
+    void CreateRenderPass(const VkDevice device) {
+        const std::array<VkAttachmentDescription, 2> attachments{ {
+            {
+                .format = EyeFormat,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+                .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+            },
+            {
+                .format = DepthFormat,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+                .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+            }
+        } };
+        constexpr const VkAttachmentReference colorRef{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+        constexpr const VkAttachmentReference depthRef{ 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+        const VkSubpassDescription subpass{
+            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorRef,
+            .pDepthStencilAttachment = &depthRef
+        };
+        constexpr const VkSubpassDependency dependency{
+            .srcSubpass = VK_SUBPASS_EXTERNAL,
+            .dstSubpass = 0,
+            .srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .srcAccessMask = VK_ACCESS_MEMORY_READ_BIT,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT
+        };
+        constexpr const std::uint32_t viewMask = 0b11;
+        const VkRenderPassMultiviewCreateInfo multiviewInfo{
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO,
+            .subpassCount = 1,
+            .pViewMasks = &viewMask,
+            .correlationMaskCount = 1,
+            .pCorrelationMasks = &viewMask
+        };
+        const VkRenderPassCreateInfo passInfo{
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .pNext = &multiviewInfo,
+            .attachmentCount = static_cast<std::uint32_t>(attachments.size()),
+            .pAttachments = attachments.data(),
+            .subpassCount = 1,
+            .pSubpasses = &subpass,
+            .dependencyCount = 1,
+            .pDependencies = &dependency
+        };
+        BENCH_VK(vkCreateRenderPass(device, &passInfo, nullptr, &renderPass));
+
+        const std::array<VkImageView, 2> views{ eyeImage.view, depthImage.view };
+        const VkFramebufferCreateInfo framebufferInfo{
+            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .renderPass = renderPass,
+            .attachmentCount = static_cast<std::uint32_t>(views.size()),
+            .pAttachments = views.data(),
+            .width = eyeSize.width,
+            .height = eyeSize.height,
+            .layers = 1
+        };
+        BENCH_VK(vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffer));
+    }
+
+    VkPipelineLayout CreatePipelineLayout
+    (
+        const VkDevice device, const std::uint32_t setLayoutCount, const VkShaderStageFlags pushConstantStages
+    ) const
+    {
+        const std::array<VkDescriptorSetLayout, 2> setLayouts{ videoSetLayout, storageSetLayout };
+        const VkPushConstantRange pushConstantRange{ pushConstantStages, 0, VideoStreamPushConstantsSize };
+        const VkPipelineLayoutCreateInfo layoutInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = setLayoutCount,
+            .pSetLayouts = setLayouts.data(),
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange
+        };
+        VkPipelineLayout layout{ VK_NULL_HANDLE };
+        BENCH_VK(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layout));
+        return layout;
+    }
+
+    // Pipeline::Create for the video stream shaders.
+    void CreateRasterPipeline(const VkDevice device, const VkShaderModule vertModule, const VkShaderModule fragModule) {
+        rasterLayout = CreatePipelineLayout(device, 1, VK_SHADER_STAGE_VERTEX_BIT);
+        const std::array<VkPipelineShaderStageCreateInfo, 2> stages{ {
+            { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_VERTEX_BIT, .module = vertModule, .pName = "main" },
+            { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_FRAGMENT_BIT, .module = fragModule, .pName = "main",
+              .pSpecializationInfo = &SpecializationInfo }
+        } };
+        constexpr const VkPipelineVertexInputStateCreateInfo vi{ .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+        constexpr const VkPipelineInputAssemblyStateCreateInfo ia{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+            .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+        };
+        constexpr const VkPipelineRasterizationStateCreateInfo rs{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+            .polygonMode = VK_POLYGON_MODE_FILL,
+            .cullMode = VK_CULL_MODE_BACK_BIT,
+            .frontFace = VK_FRONT_FACE_CLOCKWISE,
+            .lineWidth = 1.0f
+        };
+        constexpr const VkPipelineColorBlendAttachmentState attachState{
+            .blendEnable = VK_FALSE,
+            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        };
+        const VkPipelineColorBlendStateCreateInfo cb{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+            .attachmentCount = 1,
+            .pAttachments = &attachState
+        };
+        const VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(eyeSize.width), static_cast<float>(eyeSize.height), 0.0f, 1.0f };
+        const VkRect2D scissor{ { 0, 0 }, eyeSize };
+        const VkPipelineViewportStateCreateInfo vp{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+            .viewportCount = 1,
+            .pViewports = &viewport,
+            .scissorCount = 1,
+            .pScissors = &scissor
+        };
+        constexpr const VkPipelineDepthStencilStateCreateInfo ds{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .depthTestEnable = VK_TRUE,
+            .depthWriteEnable = VK_TRUE,
+            .depthCompareOp = VK_COMPARE_OP_LESS,
+            .maxDepthBounds = 1.0f
+        };
+        constexpr const VkPipelineMultisampleStateCreateInfo ms{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+            .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+        };
+        const VkGraphicsPipelineCreateInfo pipeInfo{
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .stageCount = static_cast<std::uint32_t>(stages.size()),
+            .pStages = stages.data(),
+            .pVertexInputState = &vi,
+            .pInputAssemblyState = &ia,
+            .pViewportState = &vp,
+            .pRasterizationState = &rs,
+            .pMultisampleState = &ms,
+            .pDepthStencilState = &ds,
+            .pColorBlendState = &cb,
+            .layout = rasterLayout,
+            .renderPass = renderPass,
+            .subpass = 0
+        };
+        BENCH_VK(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &rasterPipeline));
+    }
+
+    // ComputePipeline::Create.
+    void CreateComputePipeline(const VkDevice device, const VkShaderModule compModule) {
+        computeLayout = CreatePipelineLayout(device, 2, VK_SHADER_STAGE_COMPUTE_BIT);
+        const VkComputePipelineCreateInfo pipeInfo{
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .stage = { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                       .module = compModule, .pName = "main", .pSpecializationInfo = &SpecializationInfo },
+            .layout = computeLayout,
+            .basePipelineIndex = -1
+        };
+        BENCH_VK(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &computePipeline));
+    }
+
+    void Create(const Device& dev, const Options& options) {
+        const VkDevice device = dev.device;
+        eyeSize = { options.width, options.height };
+
+        VkFormatProperties eyeProps{};
+        vkGetPhysicalDeviceFormatProperties(dev.physicalDevice, EyeFormat, &eyeProps);
+        if ((eyeProps.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) == 0) {
+            std::fprintf(stderr, "eye image format does not support storage\n");
+            std::exit(EXIT_FAILURE);
+        }
+        CreateVideoTexture(dev);
+        eyeImage.Create(dev, EyeFormat, eyeSize, ViewCount,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+        depthImage.Create(dev, DepthFormat, eyeSize, ViewCount,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+        CreateDescriptorSets(device);
+        CreateRenderPass(device);
+
+        const VkShaderModule vertModule = CreateShaderModule(device, VideoVertSpv, sizeof(VideoVertSpv));
+        const VkShaderModule fragModule = options.fovDecode ?
+            CreateShaderModule(device, FovDecodeVideoFragSpv, sizeof(FovDecodeVideoFragSpv)) :
+            CreateShaderModule(device, VideoFragSpv, sizeof(VideoFragSpv));
+        const VkShaderModule compModule = options.fovDecode ?
+            CreateShaderModule(device, FovDecodeVideoCompSpv, sizeof(FovDecodeVideoCompSpv)) :
+            CreateShaderModule(device, VideoCompSpv, sizeof(VideoCompSpv));
+        CreateRasterPipeline(device, vertModule, fragModule);
+        CreateComputePipeline(device, compModule);
+        vkDestroyShaderModule(device, compModule, nullptr);
+        vkDestroyShaderModule(device, fragModule, nullptr);
+        vkDestroyShaderModule(device, vertModule, nullptr);
+    }
+
+    // RenderVideoMultiView's render pass.
+    void RecordRaster(const VkCommandBuffer cmdBuffer) const {
+        const std::array<VkClearValue, 2> clearValues{ {
+            { .color { .float32 = { 0.0f, 0.0f, 0.0f, 0.0f } } },
+            { .depthStencil = { 1.0f, 0 } }
+        } };
+        const VkRenderPassBeginInfo beginInfo{
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = renderPass,
+            .framebuffer = framebuffer,
+            .renderArea = { { 0, 0 }, eyeSize },
+            .clearValueCount = static_cast<std::uint32_t>(clearValues.size()),
+            .pClearValues = clearValues.data()
+        };
+        vkCmdBeginRenderPass(cmdBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, rasterPipeline);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, rasterLayout, 0, 1, &videoSet, 0, nullptr);
+        vkCmdPushConstants(cmdBuffer, rasterLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, VideoStreamPushConstantsSize, &IdentityPushConstants);
+        vkCmdDraw(cmdBuffer, 3, 1, 0, 0);
+        vkCmdEndRenderPass(cmdBuffer);
+    }
+
+    // VulkanGraphicsPlugin::RecordVideoComputePass.
+    void RecordCompute(const VkCommandBuffer cmdBuffer) const {
+        ImageBarrier(cmdBuffer, eyeImage.image, VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, 0, VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        const std::array<VkDescriptorSet, 2> sets{ videoSet, storageSet };
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computeLayout, 0,
+            static_cast<std::uint32_t>(sets.size()), sets.data(), 0, nullptr);
+        vkCmdPushConstants(cmdBuffer, computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, VideoStreamPushConstantsSize, &IdentityPushConstants);
+        constexpr const std::uint32_t GroupSize = 8;
+        vkCmdDispatch(cmdBuffer, (eyeSize.width + GroupSize - 1) / GroupSize, (eyeSize.height + GroupSize - 1) / GroupSize, ViewCount);
+        ImageBarrier(cmdBuffer, eyeImage.image, VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, 0,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    }
+
+    void Destroy(const VkDevice device) {
+        vkDestroyPipeline(device, computePipeline, nullptr);
+        vkDestroyPipeline(device, rasterPipeline, nullptr);
+        vkDestroyPipelineLayout(device, computeLayout, nullptr);
+        vkDestroyPipelineLayout(device, rasterLayout, nullptr);
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+        vkDestroyRenderPass(device, renderPass, nullptr);
+        vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+        vkDestroyDescriptorSetLayout(device, storageSetLayout, nullptr);
+        vkDestroyDescriptorSetLayout(device, videoSetLayout, nullptr);
+        depthImage.Destroy(device);
+        eyeImage.Destroy(device);
+        videoTexture.Destroy(device);
+        vkDestroySampler(device, sampler, nullptr);
+        if (conversion != VK_NULL_HANDLE)
+            vkDestroySamplerYcbcrConversion(device, conversion, nullptr);
+    }
+};
+
+enum class PassMode { Raster, Compute };
+
+struct Result {
+    double gpuMeanMs, gpuP50Ms, gpuP99Ms; // timestamps around the pass.
+    double frameMeanMs;                   // submit to fence signaled.
+};
+
+double Percentile(std::vector<double> samples, const double p) {
+    std::sort(samples.begin(), samples.end());
+    const std::size_t index = std::min(samples.size() - 1, static_cast<std::size_t>(p * static_cast<double>(samples.size())));
+    return samples[index];
+}
+
+Result Run(const PassMode mode, const Options& options, const Device& dev, const VideoPasses& passes) {
+    const VkDevice device = dev.device;
+    const VkCommandPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = dev.queueFamilyIndex
+    };
+    VkCommandPool pool{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateCommandPool(device, &poolInfo, nullptr, &pool));
+    const VkCommandBufferAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    VkCommandBuffer cmdBuffer{ VK_NULL_HANDLE };
+    BENCH_VK(vkAllocateCommandBuffers(device, &allocInfo, &cmdBuffer));
+    constexpr const VkFenceCreateInfo fenceInfo{ .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateFence(device, &fenceInfo, nullptr, &fence));
+    const VkQueryPoolCreateInfo queryInfo{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = 2
+    };
+    VkQueryPool queryPool{ VK_NULL_HANDLE };
+    BENCH_VK(vkCreateQueryPool(device, &queryInfo, nullptr, &queryPool));
+
+    std::vector<double> gpuMs;
+    gpuMs.reserve(options.frames);
+    double frameMsSum = 0.0;
+    // the first frames warm up the driver (shader compiles, memory residency).
+    constexpr const std::size_t WarmupFrames = 10;
+    for (std::size_t frame = 0; frame < options.frames + WarmupFrames; ++frame) {
+        constexpr const VkCommandBufferBeginInfo beginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        };
+        BENCH_VK(vkBeginCommandBuffer(cmdBuffer, &beginInfo));
+        if (frame == 0) {
+            ImageBarrier(cmdBuffer, passes.videoTexture.image, VK_IMAGE_ASPECT_COLOR_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        }
+        vkCmdResetQueryPool(cmdBuffer, queryPool, 0, 2);
+        vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+        if (mode == PassMode::Raster)
+            passes.RecordRaster(cmdBuffer);
+        else
+            passes.RecordCompute(cmdBuffer);
+        vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+        BENCH_VK(vkEndCommandBuffer(cmdBuffer));
+
+        const VkSubmitInfo submitInfo{
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &cmdBuffer
+        };
+        const auto submitStart = Clock::now();
+        BENCH_VK(vkQueueSubmit(dev.queue, 1, &submitInfo, fence));
+        BENCH_VK(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX));
+        const double frameMs = std::chrono::duration<double, std::milli>(Clock::now() - submitStart).count();
+        BENCH_VK(vkResetFences(device, 1, &fence));
+        BENCH_VK(vkResetCommandBuffer(cmdBuffer, 0));
+
+        std::array<std::uint64_t, 2> timestamps{};
+        BENCH_VK(vkGetQueryPoolResults(device, queryPool, 0, 2, sizeof(timestamps), timestamps.data(),
+            sizeof(std::uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+        if (frame < WarmupFrames)
+            continue;
+        gpuMs.push_back(static_cast<double>(timestamps[1] - timestamps[0]) * dev.timestampPeriod * 1e-6);
+        frameMsSum += frameMs;
+    }
+
+    vkDestroyQueryPool(device, queryPool, nullptr);
+    vkDestroyFence(device, fence, nullptr);
+    vkDestroyCommandPool(device, pool, nullptr);
+
+    double gpuMsSum = 0.0;
+    for (const double ms : gpuMs)
+        gpuMsSum += ms;
+    return {
+        .gpuMeanMs = gpuMsSum / static_cast<double>(gpuMs.size()),
+        .gpuP50Ms = Percentile(gpuMs, 0.50),
+        .gpuP99Ms = Percentile(gpuMs, 0.99),
+        .frameMeanMs = frameMsSum / static_cast<double>(gpuMs.size())
+    };
+}
+
+void Print(const char* name, const Result& result) {
+    std::printf("%-8s %12.3f %12.3f %12.3f %14.3f\n", name, result.gpuMeanMs, result.gpuP50Ms, result.gpuP99Ms, result.frameMeanMs);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options{};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* const name = argv[i];
+        const char* const value = argv[i + 1];
+        if (std::strcmp(name, "--frames") == 0) options.frames = std::max<std::size_t>(1, std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(name, "--width") == 0) options.width = std::max(1u, static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10)));
+        else if (std::strcmp(name, "--height") == 0) options.height = std::max(1u, static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10)));
+        else if (std::strcmp(name, "--fov-decode") == 0) options.fovDecode = std::strtoul(value, nullptr, 10) != 0;
+        else std::fprintf(stderr, "unknown option %s\n", name);
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const Options options = ParseOptions(argc, argv);
+    Device dev{};
+    dev.Create();
+    VideoPasses passes{};
+    passes.Create(dev, options);
+    std::printf("device: %s, eye %ux%u x%u, video %s%s, %zu frames\n", dev.name, options.width, options.height, ViewCount,
+        passes.videoFormat == VK_FORMAT_G8_B8R8_2PLANE_420_UNORM ? "NV12" : "RGBA8",
+        options.fovDecode ? " (foveated)" : "", options.frames);
+    std::printf("%-8s %12s %12s %12s %14s\n", "pass", "gpu mean ms", "gpu p50 ms", "gpu p99 ms", "frame mean ms");
+
+    const Result raster = Run(PassMode::Raster, options, dev, passes);
+    Print("raster", raster);
+    const Result compute = Run(PassMode::Compute, options, dev, passes);
+    Print("compute", compute);
+    std::printf("compute/raster gpu time: %.2f\n", compute.gpuMeanMs / raster.gpuMeanMs);
+
+    BENCH_VK(vkDeviceWaitIdle(dev.device));
+    passes.Destroy(dev.device);
+    dev.Destroy();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include "clock_sync.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ALXR {
+namespace {
+    // residual slack on top of a sample's own RTT/2 bound before it counts as an outlier.
+    constexpr const double OutlierSlackUs = 1000.0;
+    constexpr const double OutlierResidualScale = 4.0;
+    // fit samples: RTT excess over the window minimum within max(floor, sigmas * sd of the candidates' excess).
+    constexpr const double RttExcessFloorUs = 500.0;
+    constexpr const double RttExcessSigmas = 4.0;
+}
+
+ClockOffsetEstimator::SampleResult ClockOffsetEstimator::AddSample
+(
+    const std::uint64_t clientSendUs,
+    const std::uint64_t serverTimeUs,
+    const std::uint64_t clientRecvUs
+)
+{
+    if (clientRecvUs < clientSendUs)
+        return SampleResult::Invalid;
+    const std::uint64_t rttUs = clientRecvUs - clientSendUs;
+    const Sample sample {
+        .clientTimeUs = clientSendUs + rttUs / 2,
+        .offsetUs = static_cast<std::int64_t>(serverTimeUs) - static_cast<std::int64_t>(clientSendUs + rttUs / 2),
+        .rttUs = rttUs
+    };
+
+    SampleResult result = SampleResult::Accepted;
+    if (m_isValid) {
+        // the true offset lies within +/- RTT/2 of the sample, it must overlap the model's bound.
+        const double error = std::abs(static_cast<double>(sample.offsetUs - ModelOffset(sample.clientTimeUs)));
+        const double bound = static_cast<double>(rttUs) / 2.0 + static_cast<double>(m_minRttUs) / 2.0 +
+            std::max(OutlierSlackUs, OutlierResidualScale * m_residualUs);
+        if (error > bound) {
+            ++m_rejectedCount;
+            if (++m_consecutiveRejects < StepDetectCount)
+                return SampleResult::RejectedOutlier;
+            Reset();
+            result = SampleResult::Restarted;
+        }
+    }
+    m_consecutiveRejects = 0;
+
+    m_samples[m_nextSample] = sample;
+    m_nextSample = (m_nextSample + 1) % WindowSize;
+    m_sampleCount = std::min(m_sampleCount + 1, WindowSize);
+    Refit();
+    return result;
+}
+
+void ClockOffsetEstimator::Refit()
+{
+    // fixed size scratch, called for every TimeSync.
+    std::array<Sample, WindowSize> best{};
+    std::copy_n(m_samples.begin(), m_sampleCount, best.begin());
+    const std::size_t candidateCount = std::min(m_sampleCount, std::max(MinFitSamples, m_sampleCount / FitFraction));
+    std::partial_sort(best.begin(), best.begin() + candidateCount, best.begin() + m_sampleCount, [](const Sample& lhs, const Sample& rhs) {
+        return lhs.rttUs < rhs.rttUs;
+    });
+    m_minRttUs = best.front().rttUs;
+
+    // an offset sample is off by at most half its RTT excess over the path's minimum, candidates whose
+    // excess is well above the spread of the best RTTs only add noise.
+    double meanExcess = 0;
+    for (std::size_t idx = 0; idx < candidateCount; ++idx)
+        meanExcess += static_cast<double>(best[idx].rttUs - m_minRttUs);
+    meanExcess /= static_cast<double>(candidateCount);
+    double excessVar = 0;
+    for (std::size_t idx = 0; idx < candidateCount; ++idx) {
+        const double d = static_cast<double>(best[idx].rttUs - m_minRttUs) - meanExcess;
+        excessVar += d * d;
+    }
+    const double excessSigma = std::sqrt(excessVar / static_cast<double>(candidateCount));
+    const double maxExcessUs = std::max(RttExcessFloorUs, RttExcessSigmas * excessSigma);
+    std::size_t fitCount = MinFitSamples;
+    while (fitCount < candidateCount && static_cast<double>(best[fitCount].rttUs - m_minRttUs) <= maxExcessUs)
+        ++fitCount;
+    fitCount = std::min(fitCount, candidateCount);
+
+    // relative to the newest sample so predictions only extrapolate a little.
+    const std::size_t newest = (m_nextSample + WindowSize - 1) % WindowSize;
+    m_refTimeUs = m_samples[newest].clientTimeUs;
+    const auto relTime = [this](const Sample& sample) {
+        return static_cast<double>(static_cast<std::int64_t>(sample.clientTimeUs - m_refTimeUs));
+    };
+    // inverse variance weights, the error bound grows linearly with the RTT excess.
+    const auto weight = [this](const Sample& sample) {
+        const double excess = static_cast<double>(sample.rttUs - m_minRttUs) / RttExcessFloorUs;
+        return 1.0 / ((1.0 + excess) * (1.0 + excess));
+    };
+
+    double sumW = 0, meanT = 0, meanO = 0;
+    for (std::size_t idx = 0; idx < fitCount; ++idx) {
+        const double w = weight(best[idx]);
+        sumW  += w;
+        meanT += w * relTime(best[idx]);
+        meanO += w * static_cast<double>(best[idx].offsetUs);
+    }
+    meanT /= sumW;
+    meanO /= sumW;
+
+    double varT = 0, covTO = 0;
+    double minT = relTime(best.front()), maxT = minT;
+    for (std::size_t idx = 0; idx < fitCount; ++idx) {
+        const Sample& sample = best[idx];
+        const double w = weight(sample);
+        const double dt = relTime(sample) - meanT;
+        varT  += w * dt * dt;
+        covTO += w * dt * (static_cast<double>(sample.offsetUs) - meanO);
+        minT = std::min(minT, relTime(sample));
+        maxT = std::max(maxT, relTime(sample));
+    }
+    double slope = 0;
+    if (fitCount >= MinFitSamples && maxT - minT >= static_cast<double>(MinDriftSpanUs) && varT > 0)
+        slope = std::clamp(covTO / varT, -MaxDriftPpm * 1e-6, MaxDriftPpm * 1e-6);
+
+    m_driftPpm = slope * 1e6;
+    m_offsetUs = meanO - slope * meanT;
+
+    double residualSq = 0;
+    for (std::size_t idx = 0; idx < fitCount; ++idx) {
+        const Sample& sample = best[idx];
+        const double residual = static_cast<double>(sample.offsetUs) - (m_offsetUs + slope * relTime(sample));
+        residualSq += weight(sample) * residual * residual;
+    }
+    m_residualUs = std::sqrt(residualSq / sumW);
+    m_isValid = true;
+}
+
+std::int64_t ClockOffsetEstimator::ModelOffset(const std::uint64_t clientTimeUs) const
+{
+    const double dt = static_cast<double>(static_cast<std::int64_t>(clientTimeUs - m_refTimeUs));
+    return static_cast<std::int64_t>(std::llround(m_offsetUs + m_driftPpm * 1e-6 * dt));
+}
+
+std::int64_t ClockOffsetEstimator::OffsetAt(const std::uint64_t clientTimeUs) const
+{
+    return m_isValid ? ModelOffset(clientTimeUs) : 0;
+}
+
+ClockOffsetEstimator::Estimate ClockOffsetEstimator::GetEstimate(const std::uint64_t clientTimeUs) const
+{
+    if (!m_isValid)
+        return { .offsetUs = 0, .driftPpm = 0, .uncertaintyUs = 0, .minRttUs = 0, .sampleCount = 0, .isValid = false };
+    return {
+        .offsetUs = ModelOffset(clientTimeUs),
+        .driftPpm = m_driftPpm,
+        .uncertaintyUs = m_minRttUs / 2 + static_cast<std::uint64_t>(std::ceil(m_residualUs)),
+        .minRttUs = m_minRttUs,
+        .sampleCount = static_cast<std::uint32_t>(m_sampleCount),
+        .isValid = true
+    };
+}
+
+void ClockOffsetEstimator::Reset()
+{
+    m_sampleCount = 0;
+    m_nextSample = 0;
+    m_consecutiveRejects = 0;
+    m_isValid = false;
+    m_refTimeUs = 0;
+    m_offsetUs = m_driftPpm = m_residualUs = 0;
+    m_minRttUs = 0;
+}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef ALXR_CLOCK_SYNC_H
+#define ALXR_CLOCK_SYNC_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace ALXR {
+
+// NTP style estimate of the server - client clock offset from TimeSync round trips.
+//
+// A single round trip only bounds the offset to +/- RTT/2, so a Wi-Fi spike in either direction moves
+// a naive estimate by milliseconds. Instead the last WindowSize samples are kept, and the offset is
+// a linear (offset + drift) fit through the samples with the lowest RTTs of the window, weighted by how
+// close their RTT is to the window's minimum (a sample's error is bounded by half its RTT excess). New samples whose
+// offset interval does not overlap the current model are rejected, unless enough of them arrive in a row
+// to indicate that one of the clocks stepped, in which case the estimator starts over.
+class ClockOffsetEstimator {
+public:
+    constexpr static const std::size_t WindowSize = 64;
+    // samples with the lowest RTT considered for the fit (at least MinFitSamples).
+    constexpr static const std::size_t FitFraction = 4;
+    constexpr static const std::size_t MinFitSamples = 4;
+    // the drift is only estimated once the fitted samples span this much time.
+    constexpr static const std::uint64_t MinDriftSpanUs = 10'000'000;
+    constexpr static const double MaxDriftPpm = 500.0;
+    constexpr static const std::uint32_t StepDetectCount = 4;
+
+    enum class SampleResult {
+        Accepted,
+        Invalid,         // receive time before send time.
+        RejectedOutlier, // offset interval does not overlap the model.
+        Restarted        // consecutive outliers, the estimator was reset to the new offset.
+    };
+
+    struct Estimate {
+        std::int64_t  offsetUs;      // server - client at the time of the query.
+        double        driftPpm;      // rate of change of offsetUs.
+        std::uint64_t uncertaintyUs; // offset error bound (half the best RTT plus fit residual).
+        std::uint64_t minRttUs;      // lowest RTT in the window.
+        std::uint32_t sampleCount;
+        bool          isValid;
+    };
+
+    // clientSendUs/clientRecvUs are client times the request was sent/the reply was received,
+    // serverTimeUs is the server time the request was handled.
+    SampleResult AddSample(const std::uint64_t clientSendUs, const std::uint64_t serverTimeUs, const std::uint64_t clientRecvUs);
+
+    Estimate GetEstimate(const std::uint64_t clientTimeUs) const;
+    std::int64_t OffsetAt(const std::uint64_t clientTimeUs) const;
+
+    inline std::uint64_t RejectedCount() const { return m_rejectedCount; }
+    void Reset();
+
+private:
+    struct Sample {
+        std::uint64_t clientTimeUs; // midpoint of the round trip.
+        std::int64_t  offsetUs;
+        std::uint64_t rttUs;
+    };
+    void Refit();
+    std::int64_t ModelOffset(const std::uint64_t clientTimeUs) const;
+
+    std::array<Sample, WindowSize> m_samples{};
+    std::size_t   m_sampleCount = 0;
+    std::size_t   m_nextSample = 0;
+    std::uint32_t m_consecutiveRejects = 0;
+    std::uint64_t m_rejectedCount = 0;
+
+    // model: offset(t) = m_offsetUs + m_driftPpm * 1e-6 * (t - m_refTimeUs)
+    bool          m_isValid = false;
+    std::uint64_t m_refTimeUs = 0;
+    double        m_offsetUs = 0;
+    double        m_driftPpm = 0;
+    double        m_residualUs = 0;
+    std::uint64_t m_minRttUs = 0;
+};
+}
+#endif
@@ -18,7 +18,7 @@ struct CudaSharedTexture
     std::array<cudaArray_t, 2> planeArrays{};
 };
 
-std::array<CudaSharedTexture, 2> m_videoTexturesCuda{};
+std::array<CudaSharedTexture, VideoTexCount> m_videoTexturesCuda{};
 
 cudaStream_t videoBufferStream = nullptr;//{};
 cudaExternalSemaphore_t m_texCopyExtSemaphore{};
@@ -278,7 +278,7 @@ virtual void CreateVideoTexturesCUDA(const std::size_t width, const std::size_t
         GetLumaFormat(pixelFmt),
         GetChromaFormat(pixelFmt)
     };
-    for (std::size_t texIndex = 0; texIndex < m_videoTextures.size(); ++texIndex)
+    for (std::size_t texIndex = 0; texIndex < VideoTexSlotCount(); ++texIndex)
     {
         auto& vidTex = m_videoTextures[texIndex];
         auto& newSharedTex = m_videoTexturesCuda[texIndex];
@@ -318,7 +318,7 @@ virtual void CreateVideoTexturesCUDA(const std::size_t width, const std::size_t
 
         for (std::size_t planeIndex = 0; planeIndex < newSharedTex.planeArrays.size(); ++planeIndex)
         {
-            auto texMemory = vidTex.texture.texMemory[planeIndex];
+            const auto texMemory = vidTex.texture.texMemory[planeIndex].memory;
             const auto totalImageMemSize = vidTex.texture.totalImageMemSizes[planeIndex];
             auto& externalMemory = newSharedTex.m_externalMemoryList[planeIndex];
 
@@ -374,7 +374,7 @@ virtual void CreateVideoTexturesCUDA(const std::size_t width, const std::size_t
 virtual void UpdateVideoTextureCUDA(const YUVBuffer& yuvBuffer) override
 {
     //assert(false);
-    const std::size_t freeIndex = m_currentVideoTex.load();
+    const std::size_t freeIndex = AcquireVideoTexture();
     const auto& videoTex = m_videoTexturesCuda[freeIndex];
     /*const*/ auto& newSharedTex = m_videoTextures[freeIndex];
 
@@ -403,7 +403,6 @@ virtual void UpdateVideoTextureCUDA(const YUVBuffer& yuvBuffer) override
     newSharedTex.frameIndex = yuvBuffer.frameIndex;
 
     //CudaVkSemaphoreSignal(m_texCopy, m_texCopyExtSemaphore, videoBufferStream);
-    m_currentVideoTex.store((freeIndex + 1) % m_videoTextures.size());
-    m_renderTex.store(freeIndex);
+    PublishVideoTexture(freeIndex);
 }
 #endif
@@ -0,0 +1,118 @@
+#include "deadline_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <ctime>
+#endif
+#ifdef __linux__
+    #include <sys/prctl.h>
+#endif
+
+namespace ALXR {
+namespace {
+
+    inline void CpuRelax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+#ifndef _WIN32
+    // steady_clock is CLOCK_MONOTONIC with libstdc++ and libc++ on Linux/Android.
+    void SleepUntilMonotonic(const DeadlinePacer::Clock::time_point deadline) {
+        using namespace std::chrono;
+        const auto sinceEpoch = duration_cast<nanoseconds>(deadline.time_since_epoch()).count();
+        if (sinceEpoch <= 0)
+            return;
+        const timespec ts {
+            .tv_sec  = static_cast<time_t>(sinceEpoch / 1000000000),
+            .tv_nsec = static_cast<long>(sinceEpoch % 1000000000)
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+    }
+#endif
+}
+
+void DeadlinePacer::SetRate(const double rateHz)
+{
+    const double newRate = std::clamp(std::isfinite(rateHz) ? rateHz : MinRate, MinRate, MaxRate);
+    if (newRate == m_rateHz)
+        return;
+    if (m_isStarted) {
+        m_origin = DeadlineAt(m_index);
+        m_index = 0;
+    }
+    m_rateHz = newRate;
+    m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / newRate));
+}
+
+void DeadlinePacer::Reset()
+{
+    m_origin = Clock::now();
+    m_index = 0;
+    m_missedDeadlines = 0;
+    m_isStarted = true;
+}
+
+DeadlinePacer::Clock::time_point DeadlinePacer::DeadlineAt(const std::uint64_t index) const
+{
+    // from the origin each time rather than accumulating a rounded period.
+    const double offsetNs = std::round(static_cast<double>(index) * 1e9 / m_rateHz);
+    return m_origin + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(static_cast<std::int64_t>(offsetNs)));
+}
+
+DeadlinePacer::Clock::time_point DeadlinePacer::Wait()
+{
+    if (m_rateHz <= 0.0)
+        SetRate(MinRate);
+    if (!m_isStarted)
+        Reset();
+
+    auto deadline = DeadlineAt(++m_index);
+    const auto now = Clock::now();
+    if (now >= deadline) {
+        const auto behind = static_cast<std::uint64_t>((now - deadline) / m_period);
+        if (behind > 0) {
+            m_index += behind;
+            m_missedDeadlines += behind;
+            deadline = DeadlineAt(m_index);
+        }
+        return deadline;
+    }
+    SleepUntil(deadline);
+    return deadline;
+}
+
+void DeadlinePacer::SleepUntil(const Clock::time_point deadline)
+{
+    if (!m_isThreadSetup) {
+#ifdef __linux__
+        // the default 50us slack would be added to every wake-up.
+        prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+        m_isThreadSetup = true;
+    }
+    const auto coarseDeadline = deadline - m_spinTail;
+    if (Clock::now() < coarseDeadline) {
+#ifdef _WIN32
+        std::this_thread::sleep_until(coarseDeadline);
+#else
+        SleepUntilMonotonic(coarseDeadline);
+#endif
+    }
+    while (Clock::now() < deadline)
+        CpuRelax();
+}
+}
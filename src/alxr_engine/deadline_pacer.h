@@ -0,0 +1,57 @@
+#pragma once
+#ifndef ALXR_DEADLINE_PACER_H
+#define ALXR_DEADLINE_PACER_H
+
+#include <cstdint>
+#include <chrono>
+
+namespace ALXR {
+
+    // Periodic wake-ups on an absolute deadline grid (origin + n * period) for loops without a runtime frame
+    // wait, e.g. headless sessions. Deadlines never depend on when the caller woke up, so oversleeping or a
+    // slow iteration does not accumulate drift, and iterations which overran a whole period skip the missed
+    // deadlines instead of running a burst to catch up.
+    //
+    // On POSIX the coarse sleep is clock_nanosleep(TIMER_ABSTIME) (with 1ns timer slack on Linux) up to
+    // spinTail before the deadline, the rest is spun to absorb the scheduler's wake-up latency.
+    class DeadlinePacer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        constexpr static const std::chrono::microseconds DefaultSpinTail{ 100 };
+        constexpr static const double MinRate = 1.0;
+        constexpr static const double MaxRate = 2000.0;
+
+        explicit DeadlinePacer(const std::chrono::nanoseconds spinTail = DefaultSpinTail)
+        : m_spinTail(spinTail) {}
+
+        // Deadline rate in Hz (clamped to MinRate-MaxRate), a different rate restarts the grid from the
+        // last deadline. Only call from the thread calling Wait.
+        void SetRate(const double rateHz);
+        inline double Rate() const { return m_rateHz; }
+        inline Clock::duration Period() const { return m_period; }
+
+        // Blocks until the next deadline and returns it, returns at once (skipping the deadlines which
+        // already passed) if the caller is late.
+        Clock::time_point Wait();
+
+        // Restarts the grid from now, the next deadline is a period away.
+        void Reset();
+
+        inline std::uint64_t MissedDeadlines() const { return m_missedDeadlines; }
+
+    private:
+        Clock::time_point DeadlineAt(const std::uint64_t index) const;
+        void SleepUntil(const Clock::time_point deadline);
+
+        std::chrono::nanoseconds m_spinTail;
+        double            m_rateHz = 0.0;
+        Clock::duration   m_period{ 0 };
+        Clock::time_point m_origin{};
+        std::uint64_t     m_index = 0;
+        std::uint64_t     m_missedDeadlines = 0;
+        bool              m_isStarted = false;
+        bool              m_isThreadSetup = false;
+    };
+}
+#endif
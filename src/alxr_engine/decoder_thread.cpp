@@ -1,32 +1,184 @@
+#include "pch.h"
+#include "common.h"
 #include "decoder_thread.h"
+#include <cstring>
 #include "logger.h"
 #include "decoderplugin.h"
 #include "latency_manager.h"
+#include "timing.h"
+#include "thread_scheduling.h"
+#include "fec_simd.h"
+
+namespace {
+	struct ActiveCallGuard {
+		std::atomic<std::uint32_t>& count;
+		inline ~ActiveCallGuard() { --count; }
+	};
+}
 
 bool XrDecoderThread::QueuePacket(const VideoFrame& header, const XrDecoderThread::VideoPacket& packet)
+{
+	++m_activeQueueCalls;
+	const ActiveCallGuard activeCallGuard{ m_activeQueueCalls };
+	// packets are dropped while stopping, never processed inline next to the reassembly thread.
+	if (!m_isAcceptingPackets)
+		return false;
+
+	// Without a reassembly thread (decoder thread disabled) process inline.
+	// There must only be one network thread calling QueuePacket at a time.
+	const auto& shardRing = m_shardRing;
+	if (shardRing == nullptr) {
+		LatencyManager::Instance().OnVideoPacketArrived(header, GetSteadyTimestampUs(), GetSystemTimestampUs());
+		std::uint64_t decoderQueueTimeUs = 0;
+		return ProcessPacket(header, packet, decoderQueueTimeUs);
+	}
+
+	VideoShard* const shard = shardRing->begin_push();
+	if (shard == nullptr) {
+		// ring is full, FEC may still be able to recover this shard.
+		LatencyManager::Instance().OnShardDropped();
+		return false;
+	}
+	shard->header = header;
+	shard->buffer.assign(packet.begin(), packet.end());
+	shard->payloadOffset = 0;
+	shard->payloadSize = packet.size();
+	shard->arrivalTimeUs = GetSteadyTimestampUs();
+	shard->arrivalSystemTimeUs = GetSystemTimestampUs();
+	shardRing->commit_push();
+	return true;
+}
+
+std::span<std::uint8_t> XrDecoderThread::BeginReceive(const std::size_t maxPacketSize)
+{
+	// held until CommitReceive, Stop waits for the slot to be handed over.
+	++m_activeQueueCalls;
+	if (m_isAcceptingPackets && maxPacketSize >= sizeof(VideoFrame)) {
+		std::vector<std::uint8_t>* buffer = &m_inlineBuffer;
+		if (const auto& shardRing = m_shardRing) {
+			VideoShard* const shard = shardRing->begin_push();
+			buffer = shard != nullptr ? &shard->buffer : nullptr;
+		}
+		if (buffer != nullptr) {
+			if (buffer->size() < maxPacketSize)
+				buffer->resize(maxPacketSize);
+			return { buffer->data(), maxPacketSize };
+		}
+	}
+	--m_activeQueueCalls;
+	return {};
+}
+
+bool XrDecoderThread::CommitReceive(const std::size_t packetSize)
+{
+	const ActiveCallGuard activeCallGuard{ m_activeQueueCalls };
+	if (packetSize < sizeof(VideoFrame))
+		return false;
+
+	const auto& shardRing = m_shardRing;
+	if (shardRing == nullptr) {
+		assert(packetSize <= m_inlineBuffer.size());
+		VideoFrame header;
+		std::memcpy(&header, m_inlineBuffer.data(), sizeof(header));
+		LatencyManager::Instance().OnVideoPacketArrived(header, GetSteadyTimestampUs(), GetSystemTimestampUs());
+		std::uint64_t decoderQueueTimeUs = 0;
+		return ProcessPacket(header, { m_inlineBuffer.data() + sizeof(VideoFrame), packetSize - sizeof(VideoFrame) }, decoderQueueTimeUs);
+	}
+
+	// the slot BeginReceive returned, only this thread pushes.
+	VideoShard* const shard = shardRing->begin_push();
+	assert(shard != nullptr && packetSize <= shard->buffer.size());
+	std::memcpy(&shard->header, shard->buffer.data(), sizeof(VideoFrame));
+	shard->payloadOffset = sizeof(VideoFrame);
+	shard->payloadSize = packetSize - sizeof(VideoFrame);
+	shard->arrivalTimeUs = GetSteadyTimestampUs();
+	shard->arrivalSystemTimeUs = GetSystemTimestampUs();
+	shardRing->commit_push();
+	return true;
+}
+
+bool XrDecoderThread::ProcessPacket
+(
+	const VideoFrame& header,
+	const std::span<const std::uint8_t>& packet,
+	std::uint64_t& decoderQueueTimeUs
+)
 {
 	const auto decoderPlugin = m_decoderPlugin;
 	if (decoderPlugin == nullptr)
 		return false;
 	LatencyManager::Instance().OnPreVideoPacketRecieved(header);
 
+	const auto queueToDecoder = [&](const IDecoderPlugin::PacketType& nalPacket, const std::uint64_t trackingFrameIndex) {
+		const std::uint64_t queueStart = GetSteadyTimestampUs();
+		decoderPlugin->QueuePacket(nalPacket, trackingFrameIndex);
+		decoderQueueTimeUs += GetSteadyTimestampUs() - queueStart;
+	};
+
 	bool fecFailure = false, isComplete = true;
+	// the decoder already holds part of this frame, drop its output and report the loss so an IDR follows.
+	const auto onBrokenFrame = [&](const std::uint64_t trackingFrameIndex) {
+		decoderPlugin->DiscardFrame(trackingFrameIndex);
+		fecFailure = true;
+	};
 	if (const auto fecQueue = m_fecQueue) {
-		fecQueue->addVideoPacket(header, packet, fecFailure);
+		// slices which arrive in order go straight to the decoder, FEC only fills in the rest.
+		if (m_sliceStreamer)
+			m_sliceStreamer->AddPacket(header, packet, queueToDecoder, onBrokenFrame);
+		bool fecQueueFailure = false;
+		fecQueue->addVideoPacket(header, packet, fecQueueFailure);
+		fecFailure |= fecQueueFailure;
 		if (isComplete = fecQueue->reconstruct()) {
+			LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::FecDone, header.trackingFrameIndex);
 			const size_t frameBufferSize = fecQueue->getFrameByteSize();
 			const auto frameBufferPtr = reinterpret_cast<const std::uint8_t*>(fecQueue->getFrameBuffer());
-			decoderPlugin->QueuePacket({ frameBufferPtr, frameBufferSize }, header.trackingFrameIndex);
+			if (m_sliceStreamer)
+				m_sliceStreamer->CompleteFrame(header, { frameBufferPtr, frameBufferSize }, queueToDecoder, onBrokenFrame);
+			else
+				queueToDecoder({ frameBufferPtr, frameBufferSize }, header.trackingFrameIndex);
 			fecQueue->clearFecFailure();
 		}
 	} else { // then FEC is disabled
-		decoderPlugin->QueuePacket(packet, header.trackingFrameIndex);
+		LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::FecDone, header.trackingFrameIndex);
+		queueToDecoder(packet, header.trackingFrameIndex);
 	}
 
 	LatencyManager::Instance().OnPostVideoPacketRecieved(header, { isComplete, fecFailure });
 	return true;
 }
 
+void XrDecoderThread::ReassemblyLoop()
+{
+	using namespace std::literals::chrono_literals;
+	constexpr static const auto ShardWaitTimeout = 100ms;
+	auto& shardRing = *m_shardRing;
+	while (m_isReassemblyRunning) {
+		VideoShard* const shard = shardRing.wait_front(ShardWaitTimeout);
+		if (shard == nullptr)
+			continue;
+		LatencyManager::Instance().OnVideoPacketArrived(shard->header, shard->arrivalTimeUs, shard->arrivalSystemTimeUs);
+		const std::size_t queueDepth = shardRing.size_approx();
+		const std::uint64_t dequeueTime = GetSteadyTimestampUs();
+		std::uint64_t decoderQueueTimeUs = 0;
+		ProcessPacket(shard->header, shard->Payload(), decoderQueueTimeUs);
+		const std::uint64_t processTimeUs = GetSteadyTimestampUs() - dequeueTime;
+		const std::uint64_t queueWaitUs = dequeueTime - shard->arrivalTimeUs;
+		const VideoFrame header = shard->header;
+		shardRing.commit_pop();
+
+		const std::uint64_t fecTimeUs = processTimeUs > decoderQueueTimeUs ? processTimeUs - decoderQueueTimeUs : 0;
+		LatencyManager::Instance().OnReassemblyStage
+		(
+			queueDepth,
+			queueWaitUs,
+			fecTimeUs,
+			decoderQueueTimeUs
+		);
+		if (m_reassemblyObserver)
+			m_reassemblyObserver(header, fecTimeUs);
+	}
+}
+
 bool XrDecoderThread::QueuePacket(const VideoFrame& header, const std::size_t packetSize)
 {
 	assert(packetSize >= sizeof(VideoFrame));
@@ -35,8 +187,41 @@ bool XrDecoderThread::QueuePacket(const VideoFrame& header, const std::size_t pa
 	return QueuePacket(header, { frameBufferPtr, frameBufferSize });
 }
 
+std::size_t XrDecoderThread::ReassemblyQueueDepth() const
+{
+	const auto shardRing = m_shardRing;
+	return shardRing ? shardRing->size_approx() : 0;
+}
+
+std::size_t XrDecoderThread::ReassemblyQueueCapacity() const
+{
+	const auto shardRing = m_shardRing;
+	return shardRing ? shardRing->capacity() : 0;
+}
+
+bool XrDecoderThread::GetPacketStats(ALXRDecoderPacketStats& stats) const
+{
+	const auto decoderPlugin = m_decoderPlugin;
+	if (decoderPlugin == nullptr)
+		return false;
+	return decoderPlugin->GetPacketStats(stats);
+}
+
 void XrDecoderThread::Stop()
 {
+	// stop network ingestion first, once no QueuePacket call is in flight the reassembly thread
+	// is the only one left touching FEC/slice streaming state.
+	m_isAcceptingPackets = false;
+	while (m_activeQueueCalls.load() != 0)
+		std::this_thread::yield();
+
+	Log::Write(Log::Level::Info, "shutting down reassembly thread");
+	m_isReassemblyRunning = false;
+	if (m_reassemblyThread.joinable()) {
+		Log::Write(Log::Level::Info, "Waiting for reassembly thread to shutdown...");
+		m_reassemblyThread.join();
+	}
+
 	Log::Write(Log::Level::Info, "shutting down decoder thread");
 	m_isRuningToken = false;
 	if (m_decoderThread.joinable()) {
@@ -44,6 +229,18 @@ void XrDecoderThread::Stop()
 		m_decoderThread.join();
 	}
 	m_fecQueue.reset();
+	m_sliceStreamer.reset();
+	m_shardRing.reset();
+	m_reassemblyObserver = {};
+
+	ALXRDecoderPacketStats packetStats{};
+	if (GetPacketStats(packetStats)) {
+		Log::Write(Log::Level::Info, Fmt("Decoder packet stats: queued=%llu dropped=%llu packet-allocs=%llu buffer-allocs=%llu bytes-copied=%llu frames-decoded=%llu frames-skipped=%llu",
+			(unsigned long long)packetStats.packetsQueued, (unsigned long long)packetStats.packetsDropped,
+			(unsigned long long)packetStats.packetAllocations, (unsigned long long)packetStats.bufferAllocations,
+			(unsigned long long)packetStats.bytesCopied, (unsigned long long)packetStats.framesDecoded,
+			(unsigned long long)packetStats.framesSkipped));
+	}
 
 	Log::Write(Log::Level::Info, "m_decoderPlugin destroying");
 	m_decoderPlugin.reset();
@@ -60,7 +257,20 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 	Log::Write(Log::Level::Info, "Starting decoder thread.");
 	m_fecQueue = ctx.decoderConfig.enableFEC ?
 		std::make_shared<FECQueue>() : nullptr;
+	if (m_fecQueue)
+		Log::Write(Log::Level::Info, Fmt("FEC GF(2^8) kernel: %s", ALXR::GF256::ToString(ALXR::GF256::ActiveKernel())));
 	m_decoderPlugin = CreateDecoderPlugin();
+	m_sliceStreamer.reset();
+	if (ctx.decoderConfig.sliceStreaming) {
+		if (m_fecQueue && m_decoderPlugin->IsSliceInputSupported(ctx.decoderConfig.codecType)) {
+			m_sliceStreamer = std::make_unique<SliceStreamer>();
+			Log::Write(Log::Level::Info, "Slice streaming enabled.");
+		} else {
+			Log::Write(Log::Level::Warning, "Slice streaming requested but requires FEC and a decoder/codec which accepts partial frames, falling back to whole frames.");
+		}
+	}
+	m_reassemblyObserver = ctx.reassemblyObserver;
+	ALXR::ThreadScheduling::SetRealtimeDefaults(ctx.decoderConfig.realtimePriority);
 	LatencyManager::Instance().ResetAll();
 #ifdef XR_USE_PLATFORM_WIN32
 	auto decoderType = ALXRDecoderType::D311VA;
@@ -80,6 +290,8 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 	{
 		[=, startCtx = ctx]()
 		{
+			// before the decoder is created so its worker threads inherit the policy.
+			ALXR::ThreadScheduling::ApplyRole(ALXR::ThreadScheduling::Role::Decode);
 			OptionMap optionMap{};
 #ifdef XR_USE_PLATFORM_ANDROID
 			//// Exynos
@@ -103,5 +315,17 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 		}
 	};
 	Log::Write(Log::Level::Info, "Decoder Thread started.");
+
+	// Network callbacks only push raw shards from here on, FEC/sequence tracking
+	// runs on the reassembly thread so recovery never stalls socket reads.
+	m_shardRing = std::make_shared<ShardRing>(ShardRingCapacity);
+	m_isReassemblyRunning = true;
+	m_reassemblyThread = std::thread{ [this]() {
+		ALXR::ThreadScheduling::ApplyRole(ALXR::ThreadScheduling::Role::Reassembly);
+		ReassemblyLoop();
+		Log::Write(Log::Level::Info, "Reassembly thread exiting.");
+	}};
+	Log::Write(Log::Level::Info, "Reassembly Thread started.");
 #endif
+	m_isAcceptingPackets = true;
 }
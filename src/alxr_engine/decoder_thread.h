@@ -2,26 +2,78 @@
 #ifndef ALXR_DECODER_THREAD_H
 #define ALXR_DECODER_THREAD_H
 
+#include <cstdint>
+#include <vector>
+#include <span>
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <functional>
 
 #include "alxr_ctypes.h"
 #include "ALVR-common/packet_types.h"
 #include "fec.h"
+#include "spsc_ring.h"
+#include "slice_streamer.h"
 
 struct IDecoderPlugin;
 struct IOpenXrProgram;
 
 class XrDecoderThread {
+public:
+	// Called on the reassembly thread once a shard has been through FEC/reassembly,
+	// fecTimeUs excludes the time spent handing the frame to the decoder.
+	using ReassemblyObserver = std::function<void(const VideoFrame& /*header*/, const std::uint64_t /*fecTimeUs*/)>;
+
+private:
 	using DecoderPluginPtr = std::shared_ptr<IDecoderPlugin>;
 	using FECQueuePtr = std::shared_ptr<FECQueue>;
 	using CodecType = std::atomic<ALVR_CODEC>;
 
+	// Raw video shard as received by the network thread, slots are reused so
+	// the buffer keeps its capacity between packets. Shards received in place (BeginReceive)
+	// hold the whole datagram, payloadOffset skips its VideoFrame header.
+	struct VideoShard {
+		VideoFrame header;
+		std::vector<std::uint8_t> buffer;
+		std::size_t payloadOffset;
+		std::size_t payloadSize;
+		// taken on the network thread, the reassembly thread reports the arrival with them.
+		std::uint64_t arrivalTimeUs;       // steady clock
+		std::uint64_t arrivalSystemTimeUs; // system clock, for the server clock offset.
+
+		inline std::span<const std::uint8_t> Payload() const {
+			return { buffer.data() + payloadOffset, payloadSize };
+		}
+	};
+	using ShardRing = xrconcurrency::spsc_ring<VideoShard>;
+	using ShardRingPtr = std::shared_ptr<ShardRing>;
+	using SliceStreamerPtr = std::unique_ptr<SliceStreamer>;
+	constexpr static const std::size_t ShardRingCapacity = 2048;
+
 	DecoderPluginPtr  m_decoderPlugin{ nullptr };
 	FECQueuePtr		  m_fecQueue{ nullptr };
+	ShardRingPtr	  m_shardRing{ nullptr };
+	SliceStreamerPtr  m_sliceStreamer{ nullptr };
+	ReassemblyObserver m_reassemblyObserver{};
 	std::atomic<bool> m_isRuningToken{ false };
+	std::atomic<bool> m_isReassemblyRunning{ false };
+	// Cleared first by Stop, QueuePacket calls already past the check are counted so
+	// Stop can wait for the network thread to leave before tearing anything down.
+	std::atomic<bool> m_isAcceptingPackets{ false };
+	std::atomic<std::uint32_t> m_activeQueueCalls{ 0 };
+	// BeginReceive's buffer when there is no reassembly thread, network thread only.
+	std::vector<std::uint8_t> m_inlineBuffer{};
 	std::thread		  m_decoderThread;
+	std::thread		  m_reassemblyThread;
+
+	bool ProcessPacket
+	(
+		const VideoFrame& header,
+		const std::span<const std::uint8_t>& packet,
+		std::uint64_t& decoderQueueTimeUs
+	);
+	void ReassemblyLoop();
 
 public:
 
@@ -44,12 +96,28 @@ public:
 		ALXRDecoderConfig decoderConfig;
 		IOpenXrProgramPtr programPtr;
 		ALXRClientCtxPtr  clientCtx;
+		ReassemblyObserver reassemblyObserver{};
 	};
 	void Start(const StartCtx& ctx);
 	void Stop();
 	bool QueuePacket(const VideoFrame& header, const std::size_t packetSize);
 
+	// Copies the packet, for callers which only lend their receive buffer.
 	using VideoPacket = FECQueue::VideoPacket;
 	bool QueuePacket(const VideoFrame& header, const VideoPacket& packet);
+
+	// In place alternative to QueuePacket: the network thread receives a whole datagram (VideoFrame
+	// header + payload) straight into the returned shard ring slot and hands it over with CommitReceive,
+	// nothing is copied before FEC. Empty if no packet can be taken right now (ring full, stopping).
+	// Every non-empty BeginReceive must be followed by a CommitReceive from the same thread, a size
+	// smaller than a VideoFrame header cancels it.
+	std::span<std::uint8_t> BeginReceive(const std::size_t maxPacketSize);
+	bool CommitReceive(const std::size_t packetSize);
+
+	bool GetPacketStats(ALXRDecoderPacketStats& stats) const;
+
+	// Number of shards waiting for the reassembly thread, 0 when it is not running.
+	std::size_t ReassemblyQueueDepth() const;
+	std::size_t ReassemblyQueueCapacity() const;
 };
 #endif
@@ -88,6 +88,16 @@ struct IDecoderPlugin {
     };
     virtual bool Run(const RunCtx& /*ctx*/, shared_bool& /*isRunningToken*/) = 0;
 
+    // True if QueuePacket accepts individual NAL units/slices of a frame rather than only whole frames.
+    virtual bool IsSliceInputSupported(const ALXRCodecType /*codecType*/) const { return false; }
+
+    // Part of this frame was already queued (slice input) but the rest was lost, the plugin must
+    // not present the decoder's output for it. May be called from a thread other than Run's.
+    virtual void DiscardFrame(const std::uint64_t /*trackingFrameIndex*/) {}
+
+    // Packet queue allocation counters, plugins without a pooled packet path return false.
+    virtual bool GetPacketStats(ALXRDecoderPacketStats& /*stats*/) const { return false; }
+
     constexpr inline IDecoderPlugin() noexcept = default;
     inline virtual ~IDecoderPlugin() = default;
 	IDecoderPlugin(const IDecoderPlugin&) noexcept = delete;
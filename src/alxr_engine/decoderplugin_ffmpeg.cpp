@@ -11,11 +11,13 @@
 #include <chrono>
 #include <mutex>
 
+#include <readerwriterqueue.h>
 #include <readerwritercircularbuffer.h>
 
 extern "C" {
 #include <libavutil/log.h>
 #include <libavutil/avutil.h>
+#include <libavutil/buffer.h>
 #include <libavutil/opt.h>
 #include <libavutil/pixfmt.h>
 #include <libavutil/pixdesc.h>
@@ -80,6 +82,7 @@ struct AVPacketDeleter{
     }
 };
 using AVPacketPtr = std::unique_ptr<AVPacket, AVPacketDeleter>;
+using AVFramePtr = make_av_ptr_type2<AVFrame, av_frame_free>;
 struct NALPacket
 {
     AVPacketPtr data;
@@ -94,6 +97,133 @@ struct NALPacket
     constexpr inline NALPacket& operator=(const NALPacket&) noexcept = delete;
 };
 
+// Recycles AVPackets and their payload buffers between the network thread (producer)
+// and the decoder thread (consumer) so that queuing a packet does not hit the heap
+// once the arena has warmed up. Payloads live in an AVBufferPool, av_packet_unref on
+// the decoder side hands the buffer straight back to the pool.
+struct AVPacketArena
+{
+    constexpr static const std::size_t MinBufferSize = 64 * 1024;
+    constexpr static const std::size_t MaxFreePackets = 512;
+
+    inline AVPacketArena() : m_freePackets(MaxFreePackets) {}
+    inline AVPacketArena(const AVPacketArena&) = delete;
+    inline AVPacketArena(AVPacketArena&&) = delete;
+    inline AVPacketArena& operator=(const AVPacketArena&) = delete;
+    inline AVPacketArena& operator=(AVPacketArena&&) = delete;
+
+    inline ~AVPacketArena()
+    {
+        AVPacket* pkt = nullptr;
+        while (m_freePackets.try_dequeue(pkt))
+            av_packet_free(&pkt);
+        // outstanding buffers keep the pool alive until they are returned.
+        av_buffer_pool_uninit(&m_bufferPool);
+    }
+
+    // Called from the producer thread only.
+    AVPacketPtr Acquire(const IDecoderPlugin::PacketType& payload)
+    {
+        const std::size_t payloadSize = payload.size();
+        AVBufferRef* buffer = GetBuffer(payloadSize);
+        if (buffer == nullptr)
+            return nullptr;
+
+        AVPacket* pkt = nullptr;
+        if (!m_freePackets.try_dequeue(pkt)) {
+            pkt = av_packet_alloc();
+            if (pkt == nullptr) {
+                av_buffer_unref(&buffer);
+                return nullptr;
+            }
+            ++m_stats.packetAllocations;
+        }
+        std::memcpy(buffer->data, payload.data(), payloadSize);
+        std::memset(buffer->data + payloadSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+        pkt->buf  = buffer;
+        pkt->data = buffer->data;
+        pkt->size = static_cast<int>(payloadSize);
+        ++m_stats.packetsQueued;
+        m_stats.bytesCopied += payloadSize;
+        return AVPacketPtr{ pkt };
+    }
+
+    // Called from the consumer thread only, m_freePackets is single producer.
+    void Release(AVPacketPtr&& pktPtr)
+    {
+        AVPacket* pkt = pktPtr.release();
+        if (pkt == nullptr)
+            return;
+        av_packet_unref(pkt);
+        if (!m_freePackets.try_enqueue(pkt))
+            av_packet_free(&pkt);
+    }
+
+    // Called from the producer thread for packets that were never queued, they are freed rather
+    // than recycled so the producer never enqueues into m_freePackets.
+    void Discard(AVPacketPtr&& pktPtr)
+    {
+        ++m_stats.packetsDropped;
+        pktPtr.reset();
+    }
+
+    inline void CountDropped() { ++m_stats.packetsDropped; }
+
+    void GetStats(ALXRDecoderPacketStats& stats) const
+    {
+        stats = {
+            .packetsQueued     = m_stats.packetsQueued.load(std::memory_order_relaxed),
+            .packetsDropped    = m_stats.packetsDropped.load(std::memory_order_relaxed),
+            .packetAllocations = m_stats.packetAllocations.load(std::memory_order_relaxed),
+            .bufferAllocations = m_stats.bufferAllocations.load(std::memory_order_relaxed),
+            .bytesCopied       = m_stats.bytesCopied.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    AVBufferRef* GetBuffer(const std::size_t payloadSize)
+    {
+        const std::size_t requiredSize = payloadSize + AV_INPUT_BUFFER_PADDING_SIZE;
+        if (m_bufferPool == nullptr || requiredSize > m_bufferSize) {
+            // Grow in powers of two so that a few large IDR frames early in a stream
+            // settle the pool size quickly, old buffers are freed once returned.
+            std::size_t newSize = std::max(m_bufferSize, MinBufferSize);
+            while (newSize < requiredSize)
+                newSize *= 2;
+            av_buffer_pool_uninit(&m_bufferPool);
+            m_bufferPool = av_buffer_pool_init2(newSize, this, &AVPacketArena::AllocBuffer, nullptr);
+            if (m_bufferPool == nullptr) {
+                m_bufferSize = 0;
+                return nullptr;
+            }
+            m_bufferSize = newSize;
+            Log::Write(Log::Level::Verbose, Fmt("AVPacketArena: packet buffer size set to %zu bytes", newSize));
+        }
+        return av_buffer_pool_get(m_bufferPool);
+    }
+
+    static AVBufferRef* AllocBuffer(void* opaque, const std::size_t size)
+    {
+        auto& self = *reinterpret_cast<AVPacketArena*>(opaque);
+        ++self.m_stats.bufferAllocations;
+        return av_buffer_alloc(size);
+    }
+
+    using FreePacketQueue = moodycamel::ReaderWriterQueue<AVPacket*>;
+    FreePacketQueue m_freePackets;
+    AVBufferPool*   m_bufferPool = nullptr;
+    std::size_t     m_bufferSize = 0;
+
+    struct Stats {
+        std::atomic<std::uint64_t> packetsQueued{ 0 };
+        std::atomic<std::uint64_t> packetsDropped{ 0 };
+        std::atomic<std::uint64_t> packetAllocations{ 0 };
+        std::atomic<std::uint64_t> bufferAllocations{ 0 };
+        std::atomic<std::uint64_t> bytesCopied{ 0 };
+    };
+    Stats m_stats{};
+};
+
 inline auto AverrorToCodeStr(const int errnum)
 {
     thread_local char buf[AV_ERROR_MAX_STRING_SIZE];
@@ -238,6 +368,11 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
     using IOpenXrProgramPtr = std::shared_ptr<IOpenXrProgram>;
     using ALXRClientCtxPtr  = std::shared_ptr<const ALXRClientCtx>;
 
+    AVPacketArena        m_packetArena{};
+    std::atomic<std::uint64_t> m_framesDecoded{ 0 };
+    std::atomic<std::uint64_t> m_framesSkipped{ 0 };
+    // Direct mapped by tracking frame index, set by DiscardFrame on the reassembly thread.
+    std::array<std::atomic<std::uint64_t>, 16> m_discardedFrames{};
     AVPacketQueue/*Ptr*/ m_avPacketQueue;
     AVPixelFormat        m_hwPixFmt = AV_PIX_FMT_NONE;
     
@@ -246,6 +381,8 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
     FFMPEGDecoderPlugin()
     : m_avPacketQueue(360) //std::make_shared<AVPacketQueue>(360))
     {
+        for (auto& discardedFrame : m_discardedFrames)
+            discardedFrame.store(std::uint64_t(-1), std::memory_order_relaxed);
         static std::once_flag reg_devices_once{};
         std::call_once(reg_devices_once, []()
         {
@@ -266,24 +403,49 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
         const std::uint64_t trackingFrameIndex
     ) override
     {
-        if (const auto pkt = av_packet_alloc()) {
-            const std::size_t packetSize = newPacketData.size();
-            if (const auto pktBuffer = static_cast<std::uint8_t*>(av_malloc(packetSize))) {
-                std::memcpy(pktBuffer, newPacketData.data(), packetSize);
-                if (av_packet_from_data(pkt, pktBuffer, static_cast<int>(packetSize)) == 0) {
-                    using namespace std::literals::chrono_literals;
-                    constexpr static const auto QueueWaitTimeout = 500ms;
-                    m_avPacketQueue.wait_enqueue_timed({ pkt, trackingFrameIndex }, QueueWaitTimeout);
-                } else av_free(pktBuffer);
-            }
+        auto pkt = m_packetArena.Acquire(newPacketData);
+        if (pkt == nullptr) {
+            m_packetArena.CountDropped();
+            return false;
         }
+        using namespace std::literals::chrono_literals;
+        constexpr static const auto QueueWaitTimeout = 500ms;
+        NALPacket nalPacket{ pkt.release(), trackingFrameIndex };
+        if (!m_avPacketQueue.wait_enqueue_timed(std::move(nalPacket), QueueWaitTimeout)) {
+            m_packetArena.Discard(std::move(nalPacket.data));
+            return false;
+        }
+        return true;
+    }
+
+    // libavcodec's H.264 decoder can assemble a picture from slices split across packets (AV_CODEC_FLAG2_CHUNKS),
+    // the HEVC decoder treats every packet as a complete access unit.
+    virtual bool IsSliceInputSupported(const ALXRCodecType codecType) const override
+    {
+        return codecType == ALXRCodecType::H264_CODEC;
+    }
+
+    virtual void DiscardFrame(const std::uint64_t trackingFrameIndex) override
+    {
+        m_discardedFrames[trackingFrameIndex % m_discardedFrames.size()].store(trackingFrameIndex, std::memory_order_release);
+    }
+
+    inline bool IsDiscardedFrame(const std::uint64_t trackingFrameIndex) const
+    {
+        return m_discardedFrames[trackingFrameIndex % m_discardedFrames.size()].load(std::memory_order_acquire) == trackingFrameIndex;
+    }
+
+    virtual bool GetPacketStats(ALXRDecoderPacketStats& stats) const override
+    {
+        m_packetArena.GetStats(stats);
+        stats.framesDecoded = m_framesDecoded.load(std::memory_order_relaxed);
+        stats.framesSkipped = m_framesSkipped.load(std::memory_order_relaxed);
         return true;
     }
 
     virtual bool Run(const IDecoderPlugin::RunCtx& ctx, IDecoderPlugin::shared_bool& isRunningToken) override
     {
         using AVCodecContextPtr = make_av_ptr_type2<AVCodecContext, avcodec_free_context>;
-        using AVFramePtr = make_av_ptr_type2<AVFrame, av_frame_free>;
         using AVBufferRefPtr = make_av_ptr_type2<AVBufferRef, av_buffer_unref>;
 
         if (!isRunningToken) {
@@ -363,6 +525,14 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
         else {
             codecCtx->thread_count = std::max(1u, ctx.config.cpuThreadCount);
         }
+        if (ctx.config.sliceStreaming && IsSliceInputSupported(ctx.config.codecType)) {
+            // slices are queued as they arrive, decode them as they come in and keep
+            // threading within a picture (frame threading would add frames of delay).
+            codecCtx->flags  |= AV_CODEC_FLAG_LOW_DELAY;
+            codecCtx->flags2 |= AV_CODEC_FLAG2_CHUNKS;
+            codecCtx->thread_type = FF_THREAD_SLICE;
+            Log::Write(Log::Level::Info, "Decoder slice streaming enabled (AV_CODEC_FLAG2_CHUNKS, slice threading).");
+        }
         Log::Write(Log::Level::Info, Fmt("Decoder thread count: %d", codecCtx->thread_count));
 
         AVBufferRefPtr hw_device_ctx{ nullptr };
@@ -408,8 +578,11 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
         }
 
         const AVFramePtr swFrame{ av_frame_alloc() };
-        const AVFramePtr hwFrame{ av_frame_alloc() };
-        if (swFrame == nullptr || hwFrame == nullptr) {
+        DecodedFrames decodedFrames{
+            .latest  = AVFramePtr{ av_frame_alloc() },
+            .scratch = AVFramePtr{ av_frame_alloc() }
+        };
+        if (swFrame == nullptr || decodedFrames.latest == nullptr || decodedFrames.scratch == nullptr) {
             Log::Write(Log::Level::Error, "Failed to allocate avFrames.");
             return false;
         }
@@ -427,25 +600,28 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
             if (!m_avPacketQueue.wait_dequeue_timed(nalPacket, QueueWaitTimeout))
                 continue;
 
-            assert(nalPacket.data != nullptr);
-            const auto& pkt = nalPacket.data;
-
-            using namespace std::chrono;
-            using ClockType = XrSteadyClock;
-            static_assert(ClockType::is_steady);
-            using microseconds64 = duration<std::uint64_t, std::chrono::seconds::period>;
-            pkt->pts = duration_cast<microseconds64>(ClockType::now().time_since_epoch()).count();
-
-            LatencyCollector::Instance().decoderInput(nalPacket.frameIndex);
-            const auto result = decode_packet(pkt.get(), codecCtx.get(), hwFrame.get());
-            LatencyCollector::Instance().decoderOutput(nalPacket.frameIndex);
-            //av_packet_unref(pkt.get());
-            if (result < 0)
-            {
-                LogLibAV(Log::Level::Warning, result, "Failed to decode packet");
+            // Feed every packet that has already queued up and fully drain the codec after each one,
+            // when behind only the newest decoded frame gets uploaded, older outputs are skipped.
+            decodedFrames.hasLatest = false;
+            do {
+                assert(nalPacket.data != nullptr);
+                const auto& pkt = nalPacket.data;
+                // carried through to AVFrame::pts so outputs map back to their tracking frame.
+                pkt->pts = static_cast<std::int64_t>(nalPacket.frameIndex);
+
+                LatencyCollector::Instance().decoderInput(nalPacket.frameIndex);
+                LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::DecoderInput, nalPacket.frameIndex);
+                const auto result = decode_packet(pkt.get(), codecCtx.get(), decodedFrames);
+                m_packetArena.Release(std::move(nalPacket.data));
+                if (result < 0)
+                    LogLibAV(Log::Level::Warning, result, "Failed to decode packet");
+            } while (isRunningToken && m_avPacketQueue.try_dequeue(nalPacket));
+
+            if (!decodedFrames.hasLatest)
                 continue;
-            }
 
+            const auto& hwFrame = decodedFrames.latest;
+            const std::uint64_t frameIndex = static_cast<std::uint64_t>(hwFrame->pts);
             const auto& avFrame = [&/*, isBTS = isBufferInteropSupported*/]() -> const AVFramePtr& {
                 if (isBufferInteropSupported || type == AV_HWDEVICE_TYPE_NONE)
                     return hwFrame;
@@ -486,7 +662,7 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
                     .pitch = static_cast<std::size_t>(avFrame->linesize[1]),
                     .height = uvHeight
                 },
-                .frameIndex = nalPacket.frameIndex
+                .frameIndex = frameIndex
             };
             if (planeCount > 2) {
                 buffer.chroma2 = {
@@ -496,124 +672,61 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
                 };
             }
             std::invoke(UpdateVideoTextures, graphicsPluginPtr, buffer);
+            LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::UploadDone, buffer.frameIndex);
         }
         return true;
     }
 
-#if 1
-    inline int decode_packet(AVPacket* pPacket, AVCodecContext* pCodecContext, AVFrame* hwFrame)
-    {
-        int response = avcodec_send_packet(pCodecContext, pPacket);
-        if (response < 0)
-            return response;
+    struct DecodedFrames {
+        AVFramePtr latest;
+        AVFramePtr scratch;
+        bool hasLatest = false;
+    };
 
-        while (response >= 0)
-        {
-            response = avcodec_receive_frame(pCodecContext, hwFrame);
-            if (response == AVERROR(EAGAIN) || response == AVERROR_EOF) {
-                break;
-            }
-            else if (response < 0) {
-                return response;
-            }
-            if (response >= 0)
-            {
-#if 0
-                //pFrame = hwFrame;
-                size_t planeCount = 0;
-                for (; planeCount < AV_NUM_DATA_POINTERS; ++planeCount) {
-                    if (hwFrame->data[planeCount] == nullptr)
-                        break;
-                }
-                Log::Write(Log::Level::Info, Fmt(
-                    "Frame %d (type=%c, size=%d bytes, format=%d, planes=%zu, pitch1=%d,pitch2=%d width=%d, height=%d) pts %d key_frame %d [DTS %d]",
-                    pCodecContext->frame_number,
-                    av_get_picture_type_char(hwFrame->pict_type),
-                    hwFrame->pkt_size,
-                    pCodecContext->sw_pix_fmt, //pFrame->format,
-                    planeCount,
-                    hwFrame->linesize[0], hwFrame->linesize[1],
-                    hwFrame->width,
-                    hwFrame->height,
-                    hwFrame->pts,
-                    hwFrame->key_frame,
-                    hwFrame->coded_picture_number
-                ));
-#endif
+    // Receives every frame the codec currently has ready, only the newest is kept in DecodedFrames::latest.
+    inline int receive_frames(AVCodecContext* pCodecContext, DecodedFrames& frames)
+    {
+        for (;;) {
+            const int response = avcodec_receive_frame(pCodecContext, frames.scratch.get());
+            if (response == AVERROR(EAGAIN) || response == AVERROR_EOF)
                 return 0;
+            if (response < 0)
+                return response;
+
+            const auto frameIndex = static_cast<std::uint64_t>(frames.scratch->pts);
+            LatencyCollector::Instance().decoderOutput(frameIndex);
+            LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::DecoderOutput, frameIndex);
+            ++m_framesDecoded;
+            // decoded from a truncated access unit, keep showing the previous frame.
+            if (IsDiscardedFrame(frameIndex)) {
+                ++m_framesSkipped;
+                continue;
             }
+            if (frames.hasLatest)
+                ++m_framesSkipped;
+            std::swap(frames.latest, frames.scratch);
+            frames.hasLatest = true;
         }
-        return -1;
     }
-#else
-    int decode_packet(AVPacket* packet, AVCodecContext* avctx, AVFrame* sw_frame, AVFrame* frame)
-    {
-        int ret = avcodec_send_packet(avctx, packet);
-        if (ret < 0) {
-            //fprintf(stderr, "Error during decoding\n");
-            return ret;
-        }
 
-        while (true) {
-            //if (!(frame = av_frame_alloc()) || !(sw_frame = av_frame_alloc())) {
-            //    fprintf(stderr, "Can not alloc frame\n");
-            //    ret = AVERROR(ENOMEM);
-            //    goto fail;
-            //}
-
-            ret = avcodec_receive_frame(avctx, frame);
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                //av_frame_free(&frame);
-                //av_frame_free(&sw_frame);
-                return ret;
-            }
-            else if (ret < 0) {
-                //fprintf(stderr, "Error while decoding\n");
-                goto fail;
-            }
-
-            if (frame->format == m_hwPixFmt) {
-                /* retrieve data from GPU to CPU */
-                if ((ret = av_hwframe_transfer_data(sw_frame, frame, 0)) < 0) {
-                    //fprintf(stderr, "Error transferring the data to system memory\n");
-                    goto fail;
-                }
-                //tmp_frame = sw_frame;
+    inline int decode_packet(AVPacket* pPacket, AVCodecContext* pCodecContext, DecodedFrames& frames)
+    {
+        // Send/receive state machine, on EAGAIN the codec's output must be drained
+        // before it can accept more input.
+        constexpr const std::size_t MaxSendAttempts = 8;
+        for (std::size_t attempt = 0; attempt < MaxSendAttempts; ++attempt) {
+            const int response = avcodec_send_packet(pCodecContext, pPacket);
+            if (response == AVERROR(EAGAIN)) {
+                if (const int recvResult = receive_frames(pCodecContext, frames); recvResult < 0)
+                    return recvResult;
+                continue;
             }
-            else
-                //tmp_frame = frame;
-
-            //size = av_image_get_buffer_size(tmp_frame->format, tmp_frame->width,
-            //    tmp_frame->height, 1);
-            //buffer = av_malloc(size);
-            //if (!buffer) {
-            //    fprintf(stderr, "Can not alloc buffer\n");
-            //    ret = AVERROR(ENOMEM);
-            //    goto fail;
-            //}
-            //ret = av_image_copy_to_buffer(buffer, size,
-            //    (const uint8_t* const*)tmp_frame->data,
-            //    (const int*)tmp_frame->linesize, tmp_frame->format,
-            //    tmp_frame->width, tmp_frame->height, 1);
-            //if (ret < 0) {
-            //    fprintf(stderr, "Can not copy image to buffer\n");
-            //    goto fail;
-            //}
-
-            //if ((ret = fwrite(buffer, 1, size, output_file)) < 0) {
-            //    fprintf(stderr, "Failed to dump raw data.\n");
-            //    goto fail;
-            //}
-
-            fail:
-            //av_frame_free(&frame);
-            //av_frame_free(&sw_frame);
-            //av_freep(&buffer);
-            if (ret < 0)
-                return ret;
+            if (response < 0)
+                return response;
+            return receive_frames(pCodecContext, frames);
         }
+        return AVERROR(EAGAIN);
     }
-#endif
 
     static AVPixelFormat get_hw_format(AVCodecContext* avctx, const AVPixelFormat* pix_fmts)
     {
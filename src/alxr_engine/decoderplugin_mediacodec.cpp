@@ -318,8 +318,12 @@ public:
                 const auto frameIndex = m_frameIndexMap.get(ptsUs);
                 if (frameIndex != FrameIndexMap::NullIndex) {
                     LatencyCollector::Instance().decoderOutput(frameIndex);
+                    LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::DecoderOutput, frameIndex);
                 }
                 AMediaCodec_releaseOutputBuffer(codec.get(), outputBufferId, true);
+                // rendering to the surface is the upload, the image reader picks it up from here.
+                if (frameIndex != FrameIndexMap::NullIndex)
+                    LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::UploadDone, frameIndex);
             }
             else if (outputBufferId == AMEDIACODEC_INFO_OUTPUT_FORMAT_CHANGED)
             {
@@ -509,6 +513,7 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
                     const bool is_config_packet = packet.is_config(ctx.config.codecType);
                     if (!is_config_packet) {
                         LatencyCollector::Instance().decoderInput(packet.frameIndex);
+                        LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::DecoderInput, packet.frameIndex);
                     }
                     
                     std::size_t inBuffSize = 0;
@@ -0,0 +1,282 @@
+#include "fec_simd.h"
+
+#include <array>
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ALXR_GF256_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define ALXR_TARGET_SSSE3
+        #define ALXR_TARGET_AVX2
+    #else
+        #define ALXR_TARGET_SSSE3 __attribute__((target("ssse3")))
+        #define ALXR_TARGET_AVX2  __attribute__((target("avx2")))
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define ALXR_GF256_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace ALXR::GF256 {
+namespace {
+
+constexpr const unsigned FieldPoly = 0x11D;
+
+struct Tables {
+    std::array<std::uint8_t, 512> exp{};
+    std::array<std::uint8_t, 256> log{};
+    std::array<std::uint8_t, 256> inv{};
+    // mul[c][x] = c * x
+    std::array<std::array<std::uint8_t, 256>, 256> mul{};
+    // split nibble tables used by the shuffle based kernels:
+    //  lo[c][x] = c * x, hi[c][x] = c * (x << 4), x in [0,16)
+    alignas(16) std::array<std::array<std::uint8_t, 16>, 256> lo{};
+    alignas(16) std::array<std::array<std::uint8_t, 16>, 256> hi{};
+
+    Tables() {
+        unsigned x = 1;
+        for (unsigned i = 0; i < 255; ++i) {
+            exp[i] = static_cast<std::uint8_t>(x);
+            log[x] = static_cast<std::uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100)
+                x ^= FieldPoly;
+        }
+        for (unsigned i = 255; i < exp.size(); ++i)
+            exp[i] = exp[i - 255];
+
+        for (unsigned a = 0; a < 256; ++a) {
+            for (unsigned b = 0; b < 256; ++b) {
+                mul[a][b] = (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+            }
+            inv[a] = a == 0 ? 0 : exp[255 - log[a]];
+        }
+        for (unsigned c = 0; c < 256; ++c) {
+            for (unsigned n = 0; n < 16; ++n) {
+                lo[c][n] = mul[c][n];
+                hi[c][n] = mul[c][n << 4];
+            }
+        }
+    }
+};
+
+const Tables& GetTables() {
+    static const Tables tables{};
+    return tables;
+}
+
+template < const bool Accumulate >
+inline void RegionScalar(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size) {
+    const auto& row = GetTables().mul[c];
+    for (std::size_t i = 0; i < size; ++i) {
+        if constexpr (Accumulate)
+            dst[i] ^= row[src[i]];
+        else
+            dst[i] = row[src[i]];
+    }
+}
+
+#ifdef ALXR_GF256_X86
+template < const bool Accumulate >
+ALXR_TARGET_SSSE3 void RegionSSSE3(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size) {
+    const auto& t = GetTables();
+    const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(t.lo[c].data()));
+    const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(t.hi[c].data()));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i pl = _mm_shuffle_epi8(lo, _mm_and_si128(s, mask));
+        const __m128i ph = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+        __m128i r = _mm_xor_si128(pl, ph);
+        if constexpr (Accumulate)
+            r = _mm_xor_si128(r, _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+    }
+    RegionScalar<Accumulate>(dst + i, src + i, c, size - i);
+}
+
+template < const bool Accumulate >
+ALXR_TARGET_AVX2 void RegionAVX2(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size) {
+    const auto& t = GetTables();
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(t.lo[c].data())));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(t.hi[c].data())));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i pl = _mm256_shuffle_epi8(lo, _mm256_and_si256(s, mask));
+        const __m256i ph = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask));
+        __m256i r = _mm256_xor_si256(pl, ph);
+        if constexpr (Accumulate)
+            r = _mm256_xor_si256(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
+    }
+    RegionSSSE3<Accumulate>(dst + i, src + i, c, size - i);
+}
+
+bool CpuSupports(const KernelType kt) {
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool ssse3 = __builtin_cpu_supports("ssse3");
+    const bool avx2  = __builtin_cpu_supports("avx2");
+#endif
+    switch (kt) {
+    case KernelType::Scalar: return true;
+    case KernelType::SSSE3:  return ssse3;
+    case KernelType::AVX2:   return avx2;
+    default: return false;
+    }
+}
+#endif
+
+#ifdef ALXR_GF256_NEON
+template < const bool Accumulate >
+void RegionNEON(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size) {
+    const auto& t = GetTables();
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    std::size_t i = 0;
+#if defined(__aarch64__) || defined(_M_ARM64)
+    const uint8x16_t lo = vld1q_u8(t.lo[c].data());
+    const uint8x16_t hi = vld1q_u8(t.hi[c].data());
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t r = veorq_u8(vqtbl1q_u8(lo, vandq_u8(s, mask)), vqtbl1q_u8(hi, vshrq_n_u8(s, 4)));
+        if constexpr (Accumulate)
+            r = veorq_u8(r, vld1q_u8(dst + i));
+        vst1q_u8(dst + i, r);
+    }
+#else
+    const uint8x8x2_t lo = { { vld1_u8(t.lo[c].data()), vld1_u8(t.lo[c].data() + 8) } };
+    const uint8x8x2_t hi = { { vld1_u8(t.hi[c].data()), vld1_u8(t.hi[c].data() + 8) } };
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t s = vld1q_u8(src + i);
+        const uint8x16_t sl = vandq_u8(s, mask);
+        const uint8x16_t sh = vshrq_n_u8(s, 4);
+        uint8x16_t r = vcombine_u8
+        (
+            veor_u8(vtbl2_u8(lo, vget_low_u8(sl)),  vtbl2_u8(hi, vget_low_u8(sh))),
+            veor_u8(vtbl2_u8(lo, vget_high_u8(sl)), vtbl2_u8(hi, vget_high_u8(sh)))
+        );
+        if constexpr (Accumulate)
+            r = veorq_u8(r, vld1q_u8(dst + i));
+        vst1q_u8(dst + i, r);
+    }
+#endif
+    RegionScalar<Accumulate>(dst + i, src + i, c, size - i);
+}
+
+constexpr inline bool CpuSupports(const KernelType kt) {
+    return kt == KernelType::Scalar || kt == KernelType::NEON;
+}
+#endif
+
+#if !defined(ALXR_GF256_X86) && !defined(ALXR_GF256_NEON)
+constexpr inline bool CpuSupports(const KernelType kt) {
+    return kt == KernelType::Scalar;
+}
+#endif
+
+using RegionFn = void (*)(std::uint8_t*, const std::uint8_t*, const std::uint8_t, const std::size_t);
+struct Kernel {
+    KernelType type;
+    RegionFn   mulAdd;
+    RegionFn   mul;
+};
+
+constexpr inline Kernel MakeKernel(const KernelType kt) {
+    switch (kt) {
+#ifdef ALXR_GF256_X86
+    case KernelType::SSSE3: return { kt, &RegionSSSE3<true>, &RegionSSSE3<false> };
+    case KernelType::AVX2:  return { kt, &RegionAVX2<true>,  &RegionAVX2<false> };
+#endif
+#ifdef ALXR_GF256_NEON
+    case KernelType::NEON:  return { kt, &RegionNEON<true>,  &RegionNEON<false> };
+#endif
+    default: return { KernelType::Scalar, &RegionScalar<true>, &RegionScalar<false> };
+    }
+}
+
+Kernel SelectBestKernel() {
+    constexpr const KernelType Preferred[] = {
+        KernelType::AVX2, KernelType::SSSE3, KernelType::NEON
+    };
+    for (const auto kt : Preferred) {
+        if (CpuSupports(kt))
+            return MakeKernel(kt);
+    }
+    return MakeKernel(KernelType::Scalar);
+}
+
+std::atomic<const Kernel*> gActiveKernel{ nullptr };
+
+const Kernel& GetKernel() {
+    if (const auto k = gActiveKernel.load(std::memory_order_acquire))
+        return *k;
+    static const Kernel best = SelectBestKernel();
+    gActiveKernel.store(&best, std::memory_order_release);
+    return best;
+}
+} // namespace
+
+std::uint8_t Mul(const std::uint8_t a, const std::uint8_t b) {
+    return GetTables().mul[a][b];
+}
+
+std::uint8_t Inv(const std::uint8_t a) {
+    return GetTables().inv[a];
+}
+
+void MulAddRegion(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size) {
+    if (c == 0 || size == 0)
+        return;
+    if (c == 1) {
+        for (std::size_t i = 0; i < size; ++i)
+            dst[i] ^= src[i];
+        return;
+    }
+    GetKernel().mulAdd(dst, src, c, size);
+}
+
+void MulRegion(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size) {
+    GetKernel().mul(dst, src, c, size);
+}
+
+KernelType ActiveKernel() {
+    return GetKernel().type;
+}
+
+bool IsSupported(const KernelType kt) {
+    return CpuSupports(kt);
+}
+
+bool SetActiveKernel(const KernelType kt) {
+    if (!CpuSupports(kt))
+        return false;
+    static std::array<Kernel, std::size_t(KernelType::TypeCount)> kernels{};
+    auto& k = kernels[std::size_t(kt)];
+    k = MakeKernel(kt);
+    gActiveKernel.store(&k, std::memory_order_release);
+    return true;
+}
+} // namespace ALXR::GF256
+
+extern "C" void alxr_gf256_mul_add_region(unsigned char* dst, const unsigned char* src, unsigned char c, int size) {
+    if (size <= 0)
+        return;
+    ALXR::GF256::MulAddRegion(dst, src, c, static_cast<std::size_t>(size));
+}
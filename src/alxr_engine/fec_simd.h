@@ -0,0 +1,48 @@
+#pragma once
+#ifndef ALXR_FEC_SIMD_H
+#define ALXR_FEC_SIMD_H
+
+#include <cstdint>
+#include <cstddef>
+
+// GF(2^8) region kernels for Reed-Solomon parity generation/recovery,
+// uses the same field polynomial as ALVR's reedsolomon (x^8+x^4+x^3+x^2+1, 0x11D).
+namespace ALXR::GF256 {
+
+    enum class KernelType : std::uint32_t {
+        Scalar,
+        SSSE3,
+        AVX2,
+        NEON,
+        TypeCount
+    };
+
+    constexpr inline const char* ToString(const KernelType kt) {
+        switch (kt) {
+        case KernelType::Scalar: return "Scalar";
+        case KernelType::SSSE3:  return "SSSE3";
+        case KernelType::AVX2:   return "AVX2";
+        case KernelType::NEON:   return "NEON";
+        default: return "Unknown";
+        }
+    }
+
+    std::uint8_t Mul(const std::uint8_t a, const std::uint8_t b);
+    std::uint8_t Inv(const std::uint8_t a);
+
+    // dst[i] ^= c * src[i]
+    void MulAddRegion(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size);
+    // dst[i] = c * src[i]
+    void MulRegion(std::uint8_t* dst, const std::uint8_t* src, const std::uint8_t c, const std::size_t size);
+
+    // Best kernel supported by the running CPU, selected once on first use.
+    KernelType ActiveKernel();
+    bool IsSupported(const KernelType kt);
+    // Overrides the runtime selection (e.g. for benchmarking), fails if not supported by the CPU.
+    bool SetActiveKernel(const KernelType kt);
+}
+
+// C entry point, the reed-solomon code built into alvr_common forwards its addmul here (see CMakeLists.txt).
+extern "C" void alxr_gf256_mul_add_region(unsigned char* dst, const unsigned char* src, unsigned char c, int size);
+
+#endif
@@ -0,0 +1,173 @@
+#pragma once
+#ifndef ALXR_FRAME_PIPELINE_H
+#define ALXR_FRAME_PIPELINE_H
+
+#include <cstdint>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <type_traits>
+
+#include "spsc_ring.h"
+#include "latency_histogram.h"
+
+namespace ALXR
+{
+	// Pipelined frame loop: a pacing thread runs the blocking frame wait (xrWaitFrame) for frame N+1
+	// while the render thread is still recording/submitting frame N, waited frame states are handed
+	// over to the render thread through a lock-free ring.
+	//
+	// The runtime only lets the next wait return once the previous waited frame has been begun, so the
+	// pacing thread is never more than one frame ahead and every handed over frame must be begun
+	// (and ended) by the render thread, frames are never dropped.
+	template < typename FrameState >
+	class FramePipeline
+	{
+		static_assert(std::is_trivially_copyable_v<FrameState>);
+	public:
+		// Called on the pacing thread, false if the wait failed (e.g. session not running).
+		using WaitFn = std::function<bool(FrameState&)>;
+		// Called on the render thread for frames waited on but not acquired when stopping,
+		// must begin/end the frame so the runtime releases a wait blocked on it.
+		using DiscardFn = std::function<void(const FrameState&)>;
+
+		FramePipeline() = default;
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline& operator=(const FramePipeline&) = delete;
+		~FramePipeline() { assert(!IsRunning()); }
+
+		inline bool IsRunning() const { return m_isRunning.load(std::memory_order_relaxed); }
+
+		// threadInitFn runs once on the pacing thread before the first wait (scheduling, thread naming).
+		void Start(WaitFn waitFn, std::function<void()> threadInitFn = {})
+		{
+			if (IsRunning() || !waitFn)
+				return;
+			m_isExited = false;
+			m_isRunning = true;
+			m_thread = std::thread{ [this, waitFn = std::move(waitFn), threadInitFn = std::move(threadInitFn)]() {
+				using namespace std::literals::chrono_literals;
+				if (threadInitFn)
+					threadInitFn();
+				while (m_isRunning.load(std::memory_order_relaxed)) {
+					FrameState frameState;
+					if (!waitFn(frameState)) {
+						std::this_thread::sleep_for(1ms);
+						continue;
+					}
+					// a waited frame is always handed over, even when stopping, it still has to be begun.
+					FrameState* slot = nullptr;
+					while ((slot = m_frames.begin_push()) == nullptr)
+						std::this_thread::yield();
+					*slot = frameState;
+					m_frames.commit_push();
+				}
+				m_isExited.store(true, std::memory_order_release);
+			}};
+		}
+
+		// Render thread: next waited frame in wait order, false on timeout.
+		template < typename Rep, typename Period >
+		bool Acquire(FrameState& frameState, const std::chrono::duration<Rep, Period>& timeout)
+		{
+			FrameState* const slot = m_frames.wait_front(timeout);
+			if (slot == nullptr)
+				return false;
+			frameState = *slot;
+			m_frames.commit_pop();
+			return true;
+		}
+
+		// Render thread: stops the pacing thread, passing every frame still in flight to discardFn.
+		void Stop(const DiscardFn& discardFn)
+		{
+			using namespace std::literals::chrono_literals;
+			if (!m_isRunning.exchange(false))
+				return;
+			// the pacing thread may be blocked in a wait until the last frame it handed over is begun.
+			FrameState frameState;
+			while (!m_isExited.load(std::memory_order_acquire)) {
+				if (Acquire(frameState, 1ms) && discardFn)
+					discardFn(frameState);
+			}
+			if (m_thread.joinable())
+				m_thread.join();
+			while (Acquire(frameState, 0ms)) {
+				if (discardFn)
+					discardFn(frameState);
+			}
+		}
+
+	private:
+		// at most one frame is waiting to be begun, one spare slot for the wait racing an Acquire.
+		xrconcurrency::spsc_ring<FrameState> m_frames{ 2 };
+		std::atomic<bool> m_isRunning{ false };
+		std::atomic<bool> m_isExited{ true };
+		std::thread       m_thread;
+	};
+
+	struct FramePacingStats {
+		std::uint64_t frames;
+		// display periods without a new frame, from gaps in the predicted display times.
+		std::uint64_t missedFrames;
+		// time the render thread spent blocked waiting for its next frame to start.
+		LatencyHistogram::Percentiles wait;
+		// time between consecutive frame submissions.
+		LatencyHistogram::Percentiles interval;
+		bool isPipelined;
+	};
+
+	// Render loop pacing counters, recorded once per frame on the render thread and collected from any.
+	class FramePacingMonitor
+	{
+	public:
+		// displayTime/displayPeriod in nanoseconds (XrTime/XrDuration), nowUs on a steady clock.
+		inline void OnFrame(const std::uint64_t waitUs, const std::int64_t displayTime, const std::int64_t displayPeriod, const std::uint64_t nowUs)
+		{
+			m_wait.Record(waitUs);
+			if (m_lastSubmitUs != 0 && nowUs > m_lastSubmitUs)
+				m_interval.Record(nowUs - m_lastSubmitUs);
+			m_lastSubmitUs = nowUs;
+			if (m_lastDisplayTime != 0 && displayPeriod > 0 && displayTime > m_lastDisplayTime) {
+				const std::int64_t periods = (displayTime - m_lastDisplayTime + displayPeriod / 2) / displayPeriod;
+				if (periods > 1)
+					m_missedFrames.fetch_add(static_cast<std::uint64_t>(periods - 1), std::memory_order_relaxed);
+			}
+			m_lastDisplayTime = displayTime;
+			m_frames.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		inline FramePacingStats Collect(const bool isPipelined) const
+		{
+			return {
+				.frames = m_frames.load(std::memory_order_relaxed),
+				.missedFrames = m_missedFrames.load(std::memory_order_relaxed),
+				.wait = m_wait.Collect(),
+				.interval = m_interval.Collect(),
+				.isPipelined = isPipelined
+			};
+		}
+
+		// Render thread only.
+		inline void Reset()
+		{
+			m_frames = 0;
+			m_missedFrames = 0;
+			m_lastSubmitUs = 0;
+			m_lastDisplayTime = 0;
+			m_wait.Reset();
+			m_interval.Reset();
+		}
+
+	private:
+		std::atomic<std::uint64_t> m_frames{ 0 };
+		std::atomic<std::uint64_t> m_missedFrames{ 0 };
+		std::uint64_t    m_lastSubmitUs = 0;
+		std::int64_t     m_lastDisplayTime = 0;
+		LatencyHistogram m_wait{};
+		LatencyHistogram m_interval{};
+	};
+}
+#endif
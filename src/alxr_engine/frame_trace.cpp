@@ -0,0 +1,427 @@
+#include "frame_trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "timing.h"
+
+namespace ALXR::FrameTrace {
+namespace {
+
+    constexpr const std::size_t StageCount = static_cast<std::size_t>(Stage::Count);
+    constexpr const std::size_t RingCapacity = 8192; // per thread, power of 2.
+    constexpr const std::uint64_t SpikeDumpIntervalUs = 5'000'000;
+
+    // Single writer (the owning thread), slots are seqlocked so dumps can read them while they are being written.
+    struct alignas(64) ThreadRing {
+        struct Slot {
+            std::atomic<std::uint64_t> seq{ 0 }; // odd while being written.
+            std::atomic<std::uint64_t> frameIndex{ 0 };
+            std::atomic<std::uint64_t> timestampUs{ 0 };
+            std::atomic<std::uint32_t> stage{ 0 };
+        };
+        std::array<Slot, RingCapacity> slots{};
+        std::atomic<std::uint64_t> writeIndex{ 0 };
+        std::atomic<std::uint32_t> stageMask{ 0 }; // stages this thread has recorded, used to name it.
+        std::atomic<bool>          isRetired{ false };
+        std::uint32_t              threadId = 0;
+
+        inline void Write(const Stage stage, const std::uint64_t frameIndex, const std::uint64_t timestampUs) {
+            const std::uint64_t index = writeIndex.load(std::memory_order_relaxed);
+            Slot& slot = slots[index & (RingCapacity - 1)];
+            slot.seq.store(index * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.frameIndex.store(frameIndex, std::memory_order_relaxed);
+            slot.timestampUs.store(timestampUs, std::memory_order_relaxed);
+            slot.stage.store(static_cast<std::uint32_t>(stage), std::memory_order_relaxed);
+            slot.seq.store(index * 2 + 2, std::memory_order_release);
+            writeIndex.store(index + 1, std::memory_order_release);
+
+            const std::uint32_t stageBit = 1u << static_cast<std::uint32_t>(stage);
+            if ((stageMask.load(std::memory_order_relaxed) & stageBit) == 0)
+                stageMask.fetch_or(stageBit, std::memory_order_relaxed);
+        }
+    };
+    using ThreadRingPtr = std::shared_ptr<ThreadRing>;
+
+    struct Event {
+        std::uint64_t frameIndex;
+        std::uint64_t timestampUs;
+        Stage         stage;
+        std::uint32_t threadId;
+    };
+
+    struct Registry {
+        std::mutex                 mutex{};
+        std::vector<ThreadRingPtr> rings{};
+        Config                     config{};
+    };
+    Registry& GetRegistry() {
+        static Registry registry{};
+        return registry;
+    }
+
+    std::atomic<bool>          gEnabled{ false };
+    std::atomic<std::uint64_t> gSpikeThresholdUs{ 0 };
+    std::atomic<std::uint64_t> gLastSpikeDumpUs{ 0 };
+
+    // receivedFirst time of recent frames for spike detection at submit, direct mapped by frame index.
+    struct FirstArrival {
+        std::atomic<std::uint64_t> frameIndex{ std::uint64_t(-1) };
+        std::atomic<std::uint64_t> timestampUs{ 0 };
+    };
+    std::array<FirstArrival, 256> gFirstArrivals{};
+
+    // Rings are registered on a thread's first event and handed to a new thread once their owner exits,
+    // so threads which are restarted with every stream (decoder, reassembly) don't grow the registry.
+    struct LocalRingHandle {
+        ThreadRingPtr ring{ nullptr };
+        ~LocalRingHandle() {
+            if (ring)
+                ring->isRetired.store(true, std::memory_order_release);
+        }
+    };
+
+    ThreadRing& LocalRing() {
+        thread_local LocalRingHandle handle{};
+        if (handle.ring)
+            return *handle.ring;
+        auto& registry = GetRegistry();
+        std::scoped_lock lk(registry.mutex);
+        for (const auto& ring : registry.rings) {
+            bool isRetired = true;
+            if (ring->isRetired.compare_exchange_strong(isRetired, false)) {
+                ring->stageMask.store(0, std::memory_order_relaxed);
+                handle.ring = ring;
+                return *ring;
+            }
+        }
+        handle.ring = std::make_shared<ThreadRing>();
+        handle.ring->threadId = static_cast<std::uint32_t>(registry.rings.size() + 1);
+        registry.rings.push_back(handle.ring);
+        return *handle.ring;
+    }
+
+    std::vector<Event> Snapshot(std::vector<std::pair<std::uint32_t, std::uint32_t>>& threads) {
+        std::vector<ThreadRingPtr> rings;
+        {
+            auto& registry = GetRegistry();
+            std::scoped_lock lk(registry.mutex);
+            rings = registry.rings;
+        }
+        std::vector<Event> events;
+        for (const auto& ring : rings) {
+            threads.emplace_back(ring->threadId, ring->stageMask.load(std::memory_order_relaxed));
+            const std::uint64_t end = ring->writeIndex.load(std::memory_order_acquire);
+            const std::uint64_t begin = end > RingCapacity ? end - RingCapacity : 0;
+            for (std::uint64_t index = begin; index < end; ++index) {
+                const auto& slot = ring->slots[index & (RingCapacity - 1)];
+                const std::uint64_t seq = slot.seq.load(std::memory_order_acquire);
+                if (seq != index * 2 + 2)
+                    continue; // overwritten or being written.
+                const Event event{
+                    .frameIndex  = slot.frameIndex.load(std::memory_order_relaxed),
+                    .timestampUs = slot.timestampUs.load(std::memory_order_relaxed),
+                    .stage       = static_cast<Stage>(slot.stage.load(std::memory_order_relaxed)),
+                    .threadId    = ring->threadId
+                };
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) != seq)
+                    continue;
+                events.push_back(event);
+            }
+        }
+        std::sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) {
+            return lhs.timestampUs < rhs.timestampUs;
+        });
+        return events;
+    }
+
+    const char* ThreadName(const std::uint32_t stageMask) {
+        const auto has = [stageMask](const Stage stage) { return (stageMask & (1u << static_cast<std::uint32_t>(stage))) != 0; };
+        if (has(Stage::Submitted) || has(Stage::Rendered))
+            return "render";
+        if (has(Stage::DecoderInput) || has(Stage::DecoderOutput) || has(Stage::UploadDone))
+            return "decoder";
+        if (has(Stage::FecDone) || has(Stage::ReceivedLast))
+            return "reassembly";
+        if (has(Stage::ReceivedFirst))
+            return "network";
+        return "thread";
+    }
+
+    // Spans shown per frame, from the first occurrence of one stage to the first occurrence of the next.
+    struct Span {
+        const char* name;
+        Stage begin;
+        Stage end;
+    };
+    constexpr const std::array<Span, 7> Spans {
+        Span{ "frame",         Stage::ReceivedFirst, Stage::Submitted },
+        Span{ "reassembly",    Stage::ReceivedFirst, Stage::FecDone },
+        Span{ "decoder queue", Stage::FecDone,       Stage::DecoderInput },
+        Span{ "decode",        Stage::DecoderInput,  Stage::DecoderOutput },
+        Span{ "upload",        Stage::DecoderOutput, Stage::UploadDone },
+        Span{ "render",        Stage::UploadDone,    Stage::Rendered },
+        Span{ "submit",        Stage::Rendered,      Stage::Submitted },
+    };
+
+    using FrameStages = std::array<std::uint64_t, StageCount>; // 0 = not recorded.
+    std::vector<std::pair<std::uint64_t, FrameStages>> GroupFrames(const std::vector<Event>& events) {
+        std::unordered_map<std::uint64_t, std::size_t> frameSlots;
+        std::vector<std::pair<std::uint64_t, FrameStages>> frames;
+        for (const auto& event : events) {
+            const auto [itr, isNew] = frameSlots.try_emplace(event.frameIndex, frames.size());
+            if (isNew)
+                frames.emplace_back(event.frameIndex, FrameStages{});
+            auto& ts = frames[itr->second].second[static_cast<std::size_t>(event.stage)];
+            if (ts == 0)
+                ts = event.timestampUs;
+        }
+        return frames;
+    }
+
+    struct SpanEvent {
+        const char*   name;
+        std::uint64_t timestampUs;
+        bool          isEnd;
+    };
+    // Begin/end events of a frame's spans in nesting order. Spans starting at the same time begin longest first
+    // ("frame" encloses "reassembly"), a span is ended before the next one begins at or after its end.
+    std::vector<SpanEvent> FrameSpanEvents(const FrameStages& stages) {
+        struct Interval {
+            const char*   name;
+            std::uint64_t beginUs;
+            std::uint64_t endUs;
+        };
+        std::vector<Interval> intervals;
+        intervals.reserve(Spans.size());
+        for (const auto& span : Spans) {
+            const std::uint64_t beginUs = stages[static_cast<std::size_t>(span.begin)];
+            const std::uint64_t endUs = stages[static_cast<std::size_t>(span.end)];
+            if (beginUs == 0 || endUs < beginUs)
+                continue;
+            intervals.push_back({ span.name, beginUs, endUs });
+        }
+        std::stable_sort(intervals.begin(), intervals.end(), [](const Interval& lhs, const Interval& rhs) {
+            if (lhs.beginUs != rhs.beginUs)
+                return lhs.beginUs < rhs.beginUs;
+            return lhs.endUs > rhs.endUs;
+        });
+
+        std::vector<SpanEvent> spanEvents;
+        spanEvents.reserve(intervals.size() * 2);
+        std::vector<const Interval*> open;
+        for (const auto& interval : intervals) {
+            while (!open.empty() && open.back()->endUs <= interval.beginUs) {
+                spanEvents.push_back({ open.back()->name, open.back()->endUs, true });
+                open.pop_back();
+            }
+            spanEvents.push_back({ interval.name, interval.beginUs, false });
+            open.push_back(&interval);
+        }
+        for (auto itr = open.rbegin(); itr != open.rend(); ++itr)
+            spanEvents.push_back({ (*itr)->name, (*itr)->endUs, true });
+        return spanEvents;
+    }
+
+    std::string ToChromeJson(const std::vector<Event>& events, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& threads) {
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        char line[256];
+        bool isFirst = true;
+        const auto append = [&](const int len) {
+            if (!isFirst)
+                json += ",\n";
+            isFirst = false;
+            json.append(line, static_cast<std::size_t>(std::max(0, len)));
+        };
+        for (const auto& [threadId, stageMask] : threads) {
+            append(std::snprintf(line, sizeof(line),
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", threadId, ThreadName(stageMask)));
+        }
+        for (const auto& event : events) {
+            append(std::snprintf(line, sizeof(line),
+                "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"args\":{\"frame\":%llu}}",
+                ToString(event.stage), event.threadId, (unsigned long long)event.timestampUs, (unsigned long long)event.frameIndex));
+        }
+        // async spans, one row per frame.
+        for (const auto& [frameIndex, stages] : GroupFrames(events)) {
+            for (const auto& spanEvent : FrameSpanEvents(stages)) {
+                if (spanEvent.isEnd) {
+                    append(std::snprintf(line, sizeof(line),
+                        "{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"e\",\"id\":%llu,\"pid\":1,\"tid\":0,\"ts\":%llu}",
+                        spanEvent.name, (unsigned long long)frameIndex, (unsigned long long)spanEvent.timestampUs));
+                } else {
+                    append(std::snprintf(line, sizeof(line),
+                        "{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"b\",\"id\":%llu,\"pid\":1,\"tid\":0,\"ts\":%llu,\"args\":{\"frame\":%llu}}",
+                        spanEvent.name, (unsigned long long)frameIndex, (unsigned long long)spanEvent.timestampUs, (unsigned long long)frameIndex));
+                }
+            }
+        }
+        json += "\n]}\n";
+        return json;
+    }
+
+    // Minimal protobuf encoding of perfetto's Trace { repeated TracePacket packet = 1; }.
+    struct ProtoWriter {
+        std::string buffer{};
+
+        inline void Varint(std::uint64_t value) {
+            while (value >= 0x80) {
+                buffer += static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            buffer += static_cast<char>(value);
+        }
+        inline void Tag(const std::uint32_t field, const std::uint32_t wireType) { Varint((field << 3) | wireType); }
+        inline void UInt(const std::uint32_t field, const std::uint64_t value) { Tag(field, 0); Varint(value); }
+        inline void Bytes(const std::uint32_t field, const std::string& value) {
+            Tag(field, 2);
+            Varint(value.size());
+            buffer += value;
+        }
+    };
+
+    namespace Perfetto {
+        // TracePacket
+        constexpr const std::uint32_t PacketTimestamp = 8;
+        constexpr const std::uint32_t PacketSequenceId = 10;
+        constexpr const std::uint32_t PacketTrackEvent = 11;
+        constexpr const std::uint32_t PacketTrackDescriptor = 60;
+        // TrackDescriptor
+        constexpr const std::uint32_t TrackUuid = 1;
+        constexpr const std::uint32_t TrackName = 2;
+        // TrackEvent
+        constexpr const std::uint32_t EventType = 9;
+        constexpr const std::uint32_t EventTrackUuid = 11;
+        constexpr const std::uint32_t EventName = 23;
+        constexpr const std::uint64_t SliceBegin = 1, SliceEnd = 2, Instant = 3;
+        constexpr const std::uint64_t SequenceId = 1;
+        constexpr const std::uint64_t ThreadTrackBase = 1000;
+        constexpr const std::uint64_t FrameLaneBase = 2000;
+        // consecutive frames overlap in the pipeline, spread them over lanes so slices on a track nest.
+        constexpr const std::uint64_t FrameLaneCount = 8;
+    }
+
+    std::string ToPerfettoProto(const std::vector<Event>& events, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& threads) {
+        using namespace Perfetto;
+        ProtoWriter trace{};
+        const auto addPacket = [&](const ProtoWriter& packet) { trace.Bytes(1, packet.buffer); };
+        const auto addTrack = [&](const std::uint64_t uuid, const std::string& name) {
+            ProtoWriter descriptor{}, packet{};
+            descriptor.UInt(TrackUuid, uuid);
+            descriptor.Bytes(TrackName, name);
+            packet.Bytes(PacketTrackDescriptor, descriptor.buffer);
+            addPacket(packet);
+        };
+        const auto addEvent = [&](const std::uint64_t timestampUs, const std::uint64_t type, const std::uint64_t trackUuid, const std::string& name) {
+            ProtoWriter trackEvent{}, packet{};
+            trackEvent.UInt(EventType, type);
+            trackEvent.UInt(EventTrackUuid, trackUuid);
+            if (!name.empty())
+                trackEvent.Bytes(EventName, name);
+            packet.UInt(PacketTimestamp, timestampUs * 1000);
+            packet.UInt(PacketSequenceId, SequenceId);
+            packet.Bytes(PacketTrackEvent, trackEvent.buffer);
+            addPacket(packet);
+        };
+
+        for (const auto& [threadId, stageMask] : threads)
+            addTrack(ThreadTrackBase + threadId, std::string(ThreadName(stageMask)) + " " + std::to_string(threadId));
+        for (std::uint64_t lane = 0; lane < FrameLaneCount; ++lane)
+            addTrack(FrameLaneBase + lane, "frames " + std::to_string(lane));
+
+        for (const auto& event : events) {
+            addEvent(event.timestampUs, Instant, ThreadTrackBase + event.threadId,
+                std::string(ToString(event.stage)) + " #" + std::to_string(event.frameIndex));
+        }
+        for (const auto& [frameIndex, stages] : GroupFrames(events)) {
+            const std::uint64_t laneUuid = FrameLaneBase + frameIndex % FrameLaneCount;
+            // slice ends close the innermost open slice on the lane, so the events must be in nesting order.
+            for (const auto& spanEvent : FrameSpanEvents(stages)) {
+                if (spanEvent.isEnd)
+                    addEvent(spanEvent.timestampUs, SliceEnd, laneUuid, {});
+                else
+                    addEvent(spanEvent.timestampUs, SliceBegin, laneUuid, std::string(spanEvent.name) + " #" + std::to_string(frameIndex));
+            }
+        }
+        return std::move(trace.buffer);
+    }
+
+    void DumpOnSpike(const std::uint64_t nowUs) {
+        std::uint64_t lastDumpUs = gLastSpikeDumpUs.load(std::memory_order_relaxed);
+        if (lastDumpUs != 0 && nowUs - lastDumpUs < SpikeDumpIntervalUs)
+            return;
+        if (!gLastSpikeDumpUs.compare_exchange_strong(lastDumpUs, nowUs))
+            return;
+        Config config{};
+        {
+            auto& registry = GetRegistry();
+            std::scoped_lock lk(registry.mutex);
+            config = registry.config;
+        }
+        if (config.spikeDumpDir.empty())
+            return;
+        const char* const extension = config.spikeDumpFormat == Format::PerfettoProto ? "perfetto-trace" : "json";
+        const std::string path = config.spikeDumpDir + "/alxr_frame_trace_" + std::to_string(nowUs) + "." + extension;
+        // off the render thread, the rings keep being written while they are dumped.
+        std::thread{ [path, format = config.spikeDumpFormat]() { Dump(path, format); } }.detach();
+    }
+}
+
+void SetConfig(const Config& config) {
+    {
+        auto& registry = GetRegistry();
+        std::scoped_lock lk(registry.mutex);
+        registry.config = config;
+    }
+    gSpikeThresholdUs.store(config.spikeThresholdUs, std::memory_order_relaxed);
+    gEnabled.store(config.enabled, std::memory_order_release);
+}
+
+bool IsEnabled() { return gEnabled.load(std::memory_order_relaxed); }
+
+void Record(const Stage stage, const std::uint64_t trackingFrameIndex, const std::uint64_t timestampUs) {
+    if (!gEnabled.load(std::memory_order_relaxed) || stage >= Stage::Count)
+        return;
+    const std::uint64_t nowUs = timestampUs != 0 ? timestampUs : GetSteadyTimestampUs();
+    LocalRing().Write(stage, trackingFrameIndex, nowUs);
+
+    const std::uint64_t spikeThresholdUs = gSpikeThresholdUs.load(std::memory_order_relaxed);
+    if (spikeThresholdUs == 0)
+        return;
+    auto& firstArrival = gFirstArrivals[trackingFrameIndex % gFirstArrivals.size()];
+    if (stage == Stage::ReceivedFirst) {
+        firstArrival.frameIndex.store(std::uint64_t(-1), std::memory_order_relaxed);
+        firstArrival.timestampUs.store(nowUs, std::memory_order_relaxed);
+        firstArrival.frameIndex.store(trackingFrameIndex, std::memory_order_release);
+    } else if (stage == Stage::Submitted) {
+        if (firstArrival.frameIndex.load(std::memory_order_acquire) != trackingFrameIndex)
+            return;
+        const std::uint64_t firstUs = firstArrival.timestampUs.load(std::memory_order_relaxed);
+        if (nowUs > firstUs && nowUs - firstUs > spikeThresholdUs)
+            DumpOnSpike(nowUs);
+    }
+}
+
+bool Dump(const std::string& path, const Format format) {
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> threads;
+    const auto events = Snapshot(threads);
+    const std::string data = format == Format::PerfettoProto ?
+        ToPerfettoProto(events, threads) : ToChromeJson(events, threads);
+    std::FILE* const file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+    const bool isWritten = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    std::fclose(file);
+    return isWritten;
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef ALXR_FRAME_TRACE_H
+#define ALXR_FRAME_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Per-frame timeline of the video pipeline keyed by trackingFrameIndex, complements LatencyCollector's
+// rolling averages so a single slow frame can be traced back to the stage which caused it.
+//
+// Every thread records into its own fixed size ring (no locks or allocations after the first event
+// of a thread), older events are overwritten. Dumps read the rings concurrently with the writers.
+namespace ALXR::FrameTrace {
+
+    enum class Stage : std::uint32_t {
+        ReceivedFirst, // first shard of the frame arrived (network thread time, recorded by the reassembly stage).
+        ReceivedLast,  // frame complete after reassembly/FEC.
+        FecDone,       // frame reassembled and about to be handed to the decoder.
+        DecoderInput,
+        DecoderOutput,
+        UploadDone,    // decoded frame copied/bound to the video texture.
+        Rendered,      // frame composited into the projection layer (LatencyCollector::rendered2).
+        Submitted,     // xrEndFrame returned.
+        Count
+    };
+
+    constexpr inline const char* ToString(const Stage stage) {
+        switch (stage) {
+        case Stage::ReceivedFirst: return "receivedFirst";
+        case Stage::ReceivedLast:  return "receivedLast";
+        case Stage::FecDone:       return "fecDone";
+        case Stage::DecoderInput:  return "decoderInput";
+        case Stage::DecoderOutput: return "decoderOutput";
+        case Stage::UploadDone:    return "uploadDone";
+        case Stage::Rendered:      return "rendered2";
+        case Stage::Submitted:     return "submit";
+        default: return "unknown";
+        }
+    }
+
+    enum class Format : std::uint32_t {
+        ChromeJson,    // chrome://tracing / ui.perfetto.dev
+        PerfettoProto  // perfetto TracePacket protobuf
+    };
+
+    struct Config {
+        bool          enabled = false;
+        // a frame slower than this from receivedFirst to submit triggers a dump, 0 disables.
+        std::uint64_t spikeThresholdUs = 0;
+        std::string   spikeDumpDir{};
+        Format        spikeDumpFormat = Format::ChromeJson;
+    };
+    void SetConfig(const Config& config);
+    bool IsEnabled();
+
+    // timestampUs is the steady clock time of the event, 0 for now.
+    void Record(const Stage stage, const std::uint64_t trackingFrameIndex, const std::uint64_t timestampUs = 0);
+
+    // Writes every event currently held in the rings.
+    bool Dump(const std::string& path, const Format format);
+}
+#endif
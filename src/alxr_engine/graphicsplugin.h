@@ -10,6 +10,8 @@
 
 namespace ALXR {
     struct FoveatedDecodeParams;
+    struct VideoReprojection;
+    struct VideoJitterStats;
 }
 
 struct Cube {
@@ -44,6 +46,14 @@ constexpr inline std::size_t PlaneCount(const XrPixelFormat f) {
     }
 }
 
+// A swapchain image as the plugin is handed it for rendering: the slot the swapchain's image structs were
+// allocated into (see IGraphicsPlugin::AllocateSwapchainImageStructs) and the index returned by
+// xrAcquireSwapchainImage. Plugins keep their per swapchain and per image state in arrays indexed by these.
+struct SwapchainImageRef {
+    std::uint32_t slot;
+    std::uint32_t imageIndex;
+};
+
 // Wraps a graphics API so the main openxr program can be graphics API-independent.
 struct IGraphicsPlugin {
     virtual ~IGraphicsPlugin() = default;
@@ -57,26 +67,46 @@ struct IGraphicsPlugin {
     // Select the preferred swapchain format from the list of available formats.
     virtual int64_t SelectColorSwapchainFormat(const std::vector<int64_t>& runtimeFormats) const = 0;
 
+    // Usage flags color swapchains of swapchainFormat are created with besides sampled & color attachment
+    // (e.g. unordered access to write them from compute shaders). Swapchains are created without them if the
+    // runtime rejects them, AllocateSwapchainImageStructs gets the flags they were created with.
+    virtual XrSwapchainUsageFlags GetExtraSwapchainUsageFlags(const std::int64_t /*swapchainFormat*/) const { return 0; }
+
     // Get the graphics binding header for session creation.
     virtual const XrBaseInStructure* GetGraphicsBinding() const = 0;
 
-    // Allocate space for the swapchain image structures. These are different for each graphics API. The returned
-    // pointers are valid for the lifetime of the graphics plugin.
+    // Swapchains alive at once: one per view (2) for the swapchains being rendered to and as many for the
+    // ones replacing them.
+    constexpr static const std::uint32_t MaxSwapchainSlots = 4;
+
+    // Allocate space for the swapchain image structures into swapchainSlot (< MaxSwapchainSlots, picked by the
+    // caller among the unused ones). These are different for each graphics API. The returned pointers are valid
+    // until the slot is released or cleared.
+    //
+    // Swapchains are (re)created off the render thread while it keeps rendering with the previous ones, so
+    // allocating must not disturb the slots the render thread may be using. Release is only called once the
+    // render thread no longer uses the slot (after an rcu grace period, see rcu_ptr.h).
     virtual std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo) = 0;
+        const std::uint32_t swapchainSlot, uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo) = 0;
+
+    virtual void ReleaseSwapchainImageStructs(const std::uint32_t /*swapchainSlot*/) {}
 
+    // Only when the render thread is not rendering, e.g. on session teardown.
     virtual void ClearSwapchainImageStructs() {}
 
     // Render to a swapchain image for a projection view.
     virtual void RenderView
     (
         const XrCompositionLayerProjectionView& layerView,
-        const XrSwapchainImageBaseHeader* swapchainImage,
+        const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat,
         const PassthroughMode /*newMode*/,
         const std::vector<Cube>& cubes
     ) = 0;
 
+    // Steady clock time (the video frame index time base) the frame of the next BeginVideoView is displayed at,
+    // plugins buffering decoded frames select the frame rendered for it.
+    virtual void SetVideoDisplayTime(const std::uint64_t /*displayTimeNs*/) {}
     virtual void BeginVideoView() {}
     virtual void EndVideoView() {}
 
@@ -84,7 +114,7 @@ struct IGraphicsPlugin {
     (
         const std::uint32_t /*ViewID*/,
         const XrCompositionLayerProjectionView& /*layerView*/,
-        const XrSwapchainImageBaseHeader* /*swapchainImage*/,
+        const SwapchainImageRef& /*swapchainImage*/,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode /*newMode*/ = PassthroughMode::None
     ) {}
@@ -92,7 +122,7 @@ struct IGraphicsPlugin {
     virtual void RenderMultiView
     (
         const std::array<XrCompositionLayerProjectionView, 2>& /*layerViews*/,
-        const XrSwapchainImageBaseHeader* /*swapchainImage*/,
+        const SwapchainImageRef& /*swapchainImage*/,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode /*newMode*/,
         const std::vector<Cube>& /*cubes*/
@@ -101,11 +131,15 @@ struct IGraphicsPlugin {
     virtual void RenderVideoMultiView
     (
         const std::array<XrCompositionLayerProjectionView, 2>& /*layerViews*/,
-        const XrSwapchainImageBaseHeader* /*swapchainImage*/,
+        const SwapchainImageRef& /*swapchainImage*/,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode /*newMode*/ = PassthroughMode::None
     ) {}
 
+    // Submits the views rendered since the last call, called once per frame before the swapchain images are
+    // released. Plugins which submit each view as it is rendered need not implement it.
+    virtual void SubmitViews() {}
+
     virtual bool IsMultiViewEnabled() const { return false; }
 
     // Get recommended number of sub-data element samples in view (recommendedSwapchainSampleCount)
@@ -143,14 +177,26 @@ struct IGraphicsPlugin {
     virtual void UpdateVideoTextureMediaCodec(const YUVBuffer& /*yuvBuffer*/) {}
     virtual void UpdateVideoTextureVAAPI(const YUVBuffer& /*yuvBuffer*/) {}
 
+    // Notified after every CPU decoded frame upload with the frame index and time spent uploading,
+    // used by tooling (e.g. stream capture replay). Must be set before the decoder thread starts.
+    using VideoUploadObserver = std::function<void(const std::uint64_t /*frameIndex*/, const std::uint64_t /*uploadTimeUs*/)>;
+    virtual void SetVideoUploadObserver(VideoUploadObserver&& /*observer*/) {}
+
     virtual void ClearVideoTextures(){};
 
     virtual std::uint64_t GetVideoFrameIndex() const { return std::uint64_t(-1); }
 
+    // Decoded frame jitter buffer holds/skips, false if the plugin does not buffer decoded frames.
+    virtual bool GetVideoJitterStats(ALXR::VideoJitterStats& /*stats*/) const { return false; }
+
     virtual void SetEnableLinearizeRGB(const bool /*enable*/) {}
 
     virtual void SetFoveatedDecode(const ALXR::FoveatedDecodeParams* /*fovDecParm*/) {}
 
+    // Per view warps (2) of the video frame for the following RenderVideoView/RenderVideoMultiView calls,
+    // nullptr for none. Returns false if not supported, the video is then drawn unwarped.
+    virtual bool SetVideoReprojection(const ALXR::VideoReprojection* /*reprojections*/) { return false; }
+
     virtual void SetCmdBufferWaitNextFrame(const bool /*enable*/) {}
 
     virtual void SetEnvironmentBlendMode(const XrEnvironmentBlendMode /*newMode*/) {}
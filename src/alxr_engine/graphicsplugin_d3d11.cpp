@@ -24,6 +24,8 @@
 #include "cuda/d3d11cuda_interop.h"
 #endif
 #include "foveation.h"
+#include "plane_copy.h"
+#include "thread_scheduling.h"
 
 using namespace Microsoft::WRL;
 using namespace DirectX;
@@ -292,32 +294,37 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        const std::uint32_t swapchainSlot, uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
-        std::vector<XrSwapchainImageD3D11KHR> swapchainImageBuffer(capacity, {
+        CHECK(swapchainSlot < m_swapchainSlots.size());
+        auto& slot = m_swapchainSlots[swapchainSlot];
+        CHECK(slot.images.empty());
+        slot.images.assign(capacity, {
             .type = XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR,
             .next = nullptr,
             .texture = nullptr
         });
+        // sized up front, the render thread only fills in entries.
+        slot.depthStencilViews.assign(capacity, nullptr);
+
         std::vector<XrSwapchainImageBaseHeader*> swapchainImageBase;
         swapchainImageBase.reserve(capacity);
-        for (XrSwapchainImageD3D11KHR& image : swapchainImageBuffer) {
+        for (XrSwapchainImageD3D11KHR& image : slot.images) {
             swapchainImageBase.push_back(reinterpret_cast<XrSwapchainImageBaseHeader*>(&image));
         }
-
-        // Keep the buffer alive by moving it into the list of buffers.
-        m_swapchainImageBuffers.push_back(std::move(swapchainImageBuffer));
-
         return swapchainImageBase;
     }
 
-    ComPtr<ID3D11DepthStencilView> GetDepthStencilView(ID3D11Texture2D* colorTexture, const D3D11_DSV_DIMENSION viewDimension = D3D11_DSV_DIMENSION_TEXTURE2D) {
+    ComPtr<ID3D11DepthStencilView> GetDepthStencilView(const SwapchainImageRef& swapchainImage, const D3D11_DSV_DIMENSION viewDimension = D3D11_DSV_DIMENSION_TEXTURE2D) {
+        auto& slot = m_swapchainSlots[swapchainImage.slot];
+        assert(swapchainImage.imageIndex < slot.depthStencilViews.size());
         // If a depth-stencil view has already been created for this back-buffer, use it.
-        auto depthBufferIt = m_colorToDepthMap.find(colorTexture);
-        if (depthBufferIt != m_colorToDepthMap.end()) {
-            return depthBufferIt->second;
+        auto& depthStencilView = slot.depthStencilViews[swapchainImage.imageIndex];
+        if (depthStencilView != nullptr) {
+            return depthStencilView;
         }
+        ID3D11Texture2D* const colorTexture = slot.images[swapchainImage.imageIndex].texture;
         assert(colorTexture != nullptr);
 
         // This back-buffer has no corresponding depth-stencil texture, so create one with matching dimensions.
@@ -340,26 +347,36 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
         CHECK_HRCMD(m_device->CreateTexture2D(&depthDesc, nullptr, depthTexture.ReleaseAndGetAddressOf()));
 
         // Create and cache the depth stencil view.
-        ComPtr<ID3D11DepthStencilView> depthStencilView;
         const CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(viewDimension, DXGI_FORMAT_D32_FLOAT);
-        CHECK_HRCMD(m_device->CreateDepthStencilView(depthTexture.Get(), &depthStencilViewDesc, depthStencilView.GetAddressOf()));
-        depthBufferIt = m_colorToDepthMap.insert(std::make_pair(colorTexture, depthStencilView)).first;
+        CHECK_HRCMD(m_device->CreateDepthStencilView(depthTexture.Get(), &depthStencilViewDesc, depthStencilView.ReleaseAndGetAddressOf()));
 
         return depthStencilView;
     }
 
+    virtual void ReleaseSwapchainImageStructs(const std::uint32_t swapchainSlot) override
+    {
+        if (swapchainSlot >= m_swapchainSlots.size())
+            return;
+        // the render thread stopped using the slot before its swapchain set was retired.
+        auto& slot = m_swapchainSlots[swapchainSlot];
+        slot.images.clear();
+        slot.depthStencilViews.clear();
+    }
+
     virtual void ClearSwapchainImageStructs() override
     {
-        m_colorToDepthMap.clear();
-        m_swapchainImageBuffers.clear();
+        for (auto& slot : m_swapchainSlots) {
+            slot.images.clear();
+            slot.depthStencilViews.clear();
+        }
     }
 
     template < typename RenderFun >
-    void RenderMultiViewImpl(const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+    void RenderMultiViewImpl(const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
         int64_t swapchainFormat, const ALXR::CColorType& clearColour, RenderFun&& renderFn) {
         assert(IsMultiViewEnabled());
 
-        ID3D11Texture2D* const colorTexture = reinterpret_cast<const XrSwapchainImageD3D11KHR*>(swapchainImage)->texture;
+        ID3D11Texture2D* const colorTexture = m_swapchainSlots[swapchainImage.slot].images[swapchainImage.imageIndex].texture;
 
         const CD3D11_VIEWPORT viewport((float)layerView.subImage.imageRect.offset.x, (float)layerView.subImage.imageRect.offset.y,
             (float)layerView.subImage.imageRect.extent.width,
@@ -372,7 +389,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
         CHECK_HRCMD(
             m_device->CreateRenderTargetView(colorTexture, &renderTargetViewDesc, renderTargetView.ReleaseAndGetAddressOf()));
 
-        const ComPtr<ID3D11DepthStencilView> depthStencilView = GetDepthStencilView(colorTexture, D3D11_DSV_DIMENSION_TEXTURE2DARRAY);
+        const ComPtr<ID3D11DepthStencilView> depthStencilView = GetDepthStencilView(swapchainImage, D3D11_DSV_DIMENSION_TEXTURE2DARRAY);
 
         // Clear swapchain and depth buffer. NOTE: This will clear the entire render target view, not just the specified view.
         // TODO: Do not clear to a color when using a pass-through view configuration.
@@ -396,7 +413,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     virtual void RenderMultiView
     (
         const std::array<XrCompositionLayerProjectionView, 2>& layerViews,
-        const XrSwapchainImageBaseHeader* swapchainImage,
+        const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode mode,
         const std::vector<Cube>& cubes
     ) override
@@ -440,7 +457,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     virtual void RenderVideoMultiView
     (
         const std::array<XrCompositionLayerProjectionView, 2>& layerViews,
-        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t swapchainFormat,
+        const SwapchainImageRef& swapchainImage, const std::int64_t swapchainFormat,
         const PassthroughMode newMode /*= PassthroughMode::None*/
     ) override
     {
@@ -479,12 +496,12 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     }
 
     template < typename RenderFun >
-    void RenderViewImpl(const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+    void RenderViewImpl(const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
                     int64_t swapchainFormat, const ALXR::CColorType& clearColour, RenderFun&& renderFn) {
         CHECK(layerView.subImage.imageArrayIndex == 0);  // Texture arrays not supported.
         assert(!IsMultiViewEnabled());
 
-        ID3D11Texture2D* const colorTexture = reinterpret_cast<const XrSwapchainImageD3D11KHR*>(swapchainImage)->texture;
+        ID3D11Texture2D* const colorTexture = m_swapchainSlots[swapchainImage.slot].images[swapchainImage.imageIndex].texture;
 
         const CD3D11_VIEWPORT viewport( (float)layerView.subImage.imageRect.offset.x, (float)layerView.subImage.imageRect.offset.y,
                                         (float)layerView.subImage.imageRect.extent.width,
@@ -497,7 +514,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
         CHECK_HRCMD(
             m_device->CreateRenderTargetView(colorTexture, &renderTargetViewDesc, renderTargetView.ReleaseAndGetAddressOf()));
 
-        const ComPtr<ID3D11DepthStencilView> depthStencilView = GetDepthStencilView(colorTexture);
+        const ComPtr<ID3D11DepthStencilView> depthStencilView = GetDepthStencilView(swapchainImage);
 
         // Clear swapchain and depth buffer. NOTE: This will clear the entire render target view, not just the specified view.
         // TODO: Do not clear to a color when using a pass-through view configuration.
@@ -518,7 +535,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
 
     virtual void RenderView
     (
-        const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+        const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode mode,
         const std::vector<Cube>& cubes
     ) override
@@ -773,47 +790,29 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
             }            
             assert(lumaTexture != nullptr && chromaTexture != nullptr);
 
-            constexpr const auto copy2d = []
-            (
-                std::uint8_t* dst, const std::size_t dstPitchInBytes,
-                const std::uint8_t* src, const std::size_t srcPitchInBytes,
-                const std::size_t width, const std::size_t height, const std::size_t formatSize
-            )
-            {
-                if (dstPitchInBytes == srcPitchInBytes) {
-                    std::memcpy(dst, src, dstPitchInBytes * height);
-                    return;
-                }
-                const std::size_t lineDstSize = width * formatSize;
-                for (std::size_t h = 0; h < height; ++h)
-                {
-                    auto lineDstPtr = dst + (dstPitchInBytes * h);
-                    const auto lineSrcPtr = src + (srcPitchInBytes * h);
-                    std::memcpy(lineDstPtr, lineSrcPtr, lineDstSize);
-                    //std::copy_n(par_unseq, src, chromaLineSize, dst);
-                }
-            };
-            const auto mapCopy2d = [&](const TexturePtr& dstTex, const Buffer& srcData)
-            {
+            // all planes are mapped first so m_planeCopyEngine splits their rows in one pass.
+            const std::array<TexturePtr, 3> dstTextures{ lumaTexture, chromaTexture, chromaVTexture };
+            const std::array<const Buffer*, 3> srcBuffers{ &yuvBuffer.luma, &yuvBuffer.chroma, &yuvBuffer.chroma2 };
+            const std::size_t planeCount = (is3PlaneFmt && chromaVTexture != nullptr) ? 3 : 2;
+            std::array<ALXR::PlaneCopy::Plane, 3> planes;
+            for (std::size_t index = 0; index < planeCount; ++index) {
                 D3D11_TEXTURE2D_DESC texDesc{};
-                dstTex->GetDesc(&texDesc);
-                const auto formatSize = SizeOfFmt(texDesc.Format);
+                dstTextures[index]->GetDesc(&texDesc);
                 D3D11_MAPPED_SUBRESOURCE mappedResource{};
-                CHECK_HRCMD(m_uploadContext->Map(dstTex.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource));
-                {
-                    copy2d
-                    (
-                        reinterpret_cast<std::uint8_t*>(mappedResource.pData), (std::size_t)mappedResource.RowPitch,
-                        (const std::uint8_t*)srcData.data, srcData.pitch, (std::size_t)texDesc.Width, srcData.height, formatSize
-                    );
-                }
-                m_uploadContext->Unmap(dstTex.Get(), 0);
-            };
-
-            mapCopy2d(lumaTexture, yuvBuffer.luma);
-            mapCopy2d(chromaTexture, yuvBuffer.chroma);
-            if (is3PlaneFmt && chromaVTexture != nullptr)
-                mapCopy2d(chromaVTexture, yuvBuffer.chroma2);
+                CHECK_HRCMD(m_uploadContext->Map(dstTextures[index].Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource));
+                const Buffer& srcData = *srcBuffers[index];
+                planes[index] = {
+                    .dst = reinterpret_cast<std::uint8_t*>(mappedResource.pData),
+                    .dstPitch = static_cast<std::size_t>(mappedResource.RowPitch),
+                    .src = reinterpret_cast<const std::uint8_t*>(srcData.data),
+                    .srcPitch = srcData.pitch,
+                    .rowSize = static_cast<std::size_t>(texDesc.Width) * SizeOfFmt(texDesc.Format),
+                    .rows = srcData.height
+                };
+            }
+            m_planeCopyEngine.Copy(std::span{ planes.data(), planeCount });
+            for (std::size_t index = 0; index < planeCount; ++index)
+                m_uploadContext->Unmap(dstTextures[index].Get(), 0);
 
             videoTex.frameIndex = yuvBuffer.frameIndex;
 
@@ -962,7 +961,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     virtual void RenderVideoView
     (
         const std::uint32_t viewID, const XrCompositionLayerProjectionView& layerView,
-        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t swapchainFormat,
+        const SwapchainImageRef& swapchainImage, const std::int64_t swapchainFormat,
         const PassthroughMode newMode /*= PassthroughMode::None*/
     ) override
     {
@@ -1046,7 +1045,12 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     ComPtr<ID3D11DeviceContext> m_deviceContext;
     LUID                        m_d3d11DeviceLUID {};
     XrGraphicsBindingD3D11KHR m_graphicsBinding{.type=XR_TYPE_GRAPHICS_BINDING_D3D11_KHR, .next=nullptr};
-    std::list<std::vector<XrSwapchainImageD3D11KHR>> m_swapchainImageBuffers;
+    // Image structs and their depth buffers, by swapchain slot (see IGraphicsPlugin::AllocateSwapchainImageStructs).
+    struct SwapchainSlot {
+        std::vector<XrSwapchainImageD3D11KHR>       images;
+        std::vector<ComPtr<ID3D11DepthStencilView>> depthStencilViews;
+    };
+    std::array<SwapchainSlot, IGraphicsPlugin::MaxSwapchainSlots> m_swapchainSlots;
     CoreShaders m_coreShaders{};
     ComPtr<ID3D11VertexShader> m_vertexShader;
     ComPtr<ID3D11PixelShader> m_pixelShader;
@@ -1084,14 +1088,12 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
         std::uint64_t frameIndex = std::uint64_t(-1);
     };
     std::array<NV12Texture, 2> m_videoTextures{};
+    ALXR::PlaneCopy::CopyEngine m_planeCopyEngine{ 0, [] { ALXR::ThreadScheduling::ApplyToCurrentThread(ALXR::ThreadScheduling::Role::Upload); } };
     std::atomic<std::size_t>   m_currentVideoTex{ (std::size_t)0 }, m_renderTex{ (std::size_t)-1 };
     std::size_t currentTextureIdx = std::size_t(-1);
     //std::mutex                     m_renderMutex{};
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    // Map color buffer to associated depth buffer. This map is populated on demand.
-    std::map<ID3D11Texture2D*, ComPtr<ID3D11DepthStencilView>> m_colorToDepthMap;
-
     static_assert(XR_ENVIRONMENT_BLEND_MODE_OPAQUE == 1);
     std::size_t m_clearColorIndex{ (XR_ENVIRONMENT_BLEND_MODE_OPAQUE - 1) };
 
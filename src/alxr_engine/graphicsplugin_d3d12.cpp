@@ -23,7 +23,10 @@
 #include "d3d_common.h"
 #include "d3d_fence_event.h"
 #include "foveation.h"
+#include "plane_copy.h"
+#include "thread_scheduling.h"
 #include "concurrent_queue.h"
+#include "rcu_ptr.h"
 #include "cuda/WindowsSecurityAttributes.h"
 #ifdef XR_ENABLE_CUDA_INTEROP
 #include "cuda/d3d12cuda_interop.h"
@@ -224,9 +227,9 @@ struct SwapchainImageContext {
         return bases;
     }
 
-    uint32_t ImageIndex(const XrSwapchainImageBaseHeader* swapchainImageHeader) const {
-        const auto p = reinterpret_cast<const XrSwapchainImageD3D12KHR*>(swapchainImageHeader);
-        return (uint32_t)(p - &m_swapchainImages[0]);
+    ID3D12Resource* ColorTexture(const std::uint32_t imageIndex) const {
+        assert(imageIndex < m_swapchainImages.size());
+        return m_swapchainImages[imageIndex].texture;
     }
 
     ID3D12Resource* GetDepthStencilTexture(ID3D12Resource* colorTexture) {
@@ -606,33 +609,53 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        const std::uint32_t swapchainSlot, uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
 
-        m_swapchainImageContexts.emplace_back();
-        SwapchainImageContext& swapchainImageContext = m_swapchainImageContexts.back();
+        const auto swapchainImageContext = std::make_shared<SwapchainImageContext>();
 
-        std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext.Create
+        std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext->Create
         (
             m_device.Get(), capacity, GetViewProjectionBufferSize(), m_fovDecodeParams
         );
 
-        // Map every swapchainImage base pointer to this context
-        for (auto& base : bases) {
-            m_swapchainImageContextMap[base] = &swapchainImageContext;
-        }
+        const SwapchainImageContextSet* const currentSet = m_swapchainImageContexts.load();
+        auto newSet = currentSet ?
+            std::make_unique<SwapchainImageContextSet>(*currentSet) :
+            std::make_unique<SwapchainImageContextSet>();
+        newSet->contexts.push_back(swapchainImageContext);
+        CHECK(newSet->Find(swapchainSlot) == nullptr && swapchainSlot < newSet->slots.size());
+        newSet->slots[swapchainSlot] = swapchainImageContext.get();
+        m_swapchainImageContexts.exchange(std::move(newSet), xrconcurrency::render_rcu_domain());
 
         return bases;
     }
 
+    virtual void ReleaseSwapchainImageStructs(const std::uint32_t swapchainSlot) override
+    {
+        const SwapchainImageContextSet* const currentSet = m_swapchainImageContexts.load();
+        if (currentSet == nullptr)
+            return;
+        SwapchainImageContext* const releasedContext = currentSet->Find(swapchainSlot);
+        if (releasedContext == nullptr)
+            return;
+        auto newSet = std::make_unique<SwapchainImageContextSet>(*currentSet);
+        std::erase_if(newSet->contexts, [&](const auto& context) { return context.get() == releasedContext; });
+        newSet->slots[swapchainSlot] = nullptr;
+        // the released context is destroyed with the set it was last part of, after its last frame completed.
+        const auto oldSet = m_swapchainImageContexts.exchange(std::move(newSet), xrconcurrency::render_rcu_domain());
+        CpuWaitForFence(releasedContext->GetFrameFenceValue());
+    }
+
     virtual void ClearSwapchainImageStructs() override
     {
-        m_swapchainImageContextMap.clear();
-        for (auto& swapchainContext : m_swapchainImageContexts) {
-            CpuWaitForFence(swapchainContext.GetFrameFenceValue());
+        const auto oldSet = m_swapchainImageContexts.exchange(nullptr, xrconcurrency::render_rcu_domain());
+        if (oldSet == nullptr)
+            return;
+        for (const auto& swapchainContext : oldSet->contexts) {
+            CpuWaitForFence(swapchainContext->GetFrameFenceValue());
         }
-        m_swapchainImageContexts.clear();
     }
 
     struct PipelineStateStream
@@ -870,13 +893,17 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     template < typename RenderFun >
     inline void RenderViewImpl
     (
-        const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage, const int64_t swapchainFormat,
+        const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage, const int64_t swapchainFormat,
         RenderFun&& renderFn,
         const RenderPipelineType pt = RenderPipelineType::Default,
         const PassthroughMode newMode = PassthroughMode::None
     )
     {
-        auto& swapchainContext = *m_swapchainImageContextMap[swapchainImage];
+        const SwapchainImageContextSet* const swapchainContexts = m_swapchainImageContexts.load();
+        SwapchainImageContext* const swapchainContextPtr = swapchainContexts ? swapchainContexts->Find(swapchainImage.slot) : nullptr;
+        if (swapchainContextPtr == nullptr)
+            return;
+        auto& swapchainContext = *swapchainContextPtr;
         CpuWaitForFence(swapchainContext.GetFrameFenceValue());
         swapchainContext.ResetCommandAllocator();
 
@@ -889,7 +916,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
         cmdList->SetPipelineState(pipelineState);
         cmdList->SetGraphicsRootSignature(m_rootSignature.Get());
 
-        ID3D12Resource* const colorTexture = reinterpret_cast<const XrSwapchainImageD3D12KHR*>(swapchainImage)->texture;
+        ID3D12Resource* const colorTexture = swapchainContext.ColorTexture(swapchainImage.imageIndex);
         const D3D12_RESOURCE_DESC colorTextureDesc = colorTexture->GetDesc();
 
         const D3D12_VIEWPORT viewport = { (float)layerView.subImage.imageRect.offset.x,
@@ -979,7 +1006,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
 
     virtual void RenderMultiView
     (
-        const std::array<XrCompositionLayerProjectionView,2>& layerViews, const XrSwapchainImageBaseHeader* swapchainImage,
+        const std::array<XrCompositionLayerProjectionView,2>& layerViews, const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode ptMode,
         const std::vector<Cube>& cubes
     ) override
@@ -1025,7 +1052,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
 
     virtual void RenderView
     (
-        const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+        const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode ptMode,
         const std::vector<Cube>& cubes
     ) override
@@ -1410,6 +1437,46 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
         return true;
     }
 
+    // Same as d3dx12's UpdateSubresources but the rows are written into the upload heap by m_planeCopyEngine.
+    template < const UINT MaxSubresources >
+    void UploadSubresources
+    (
+        ID3D12GraphicsCommandList* cmdList, ID3D12Resource* dstTexture, ID3D12Resource* uploadBuffer,
+        const UINT numSubresources, const D3D12_SUBRESOURCE_DATA* srcData
+    )
+    {
+        CHECK(numSubresources <= MaxSubresources);
+        std::array<D3D12_PLACED_SUBRESOURCE_FOOTPRINT, MaxSubresources> layouts;
+        std::array<UINT, MaxSubresources> numRows;
+        std::array<UINT64, MaxSubresources> rowSizes;
+        UINT64 requiredSize = 0;
+        const auto texDesc = dstTexture->GetDesc();
+        m_device->GetCopyableFootprints(&texDesc, 0, numSubresources, 0, layouts.data(), numRows.data(), rowSizes.data(), &requiredSize);
+        CHECK(uploadBuffer->GetDesc().Width >= requiredSize);
+
+        std::uint8_t* mappedData = nullptr;
+        CHECK_HRCMD(uploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
+        std::array<ALXR::PlaneCopy::Plane, MaxSubresources> planes;
+        for (UINT index = 0; index < numSubresources; ++index) {
+            planes[index] = {
+                .dst = mappedData + layouts[index].Offset,
+                .dstPitch = layouts[index].Footprint.RowPitch,
+                .src = reinterpret_cast<const std::uint8_t*>(srcData[index].pData),
+                .srcPitch = static_cast<std::size_t>(srcData[index].RowPitch),
+                .rowSize = static_cast<std::size_t>(rowSizes[index]),
+                .rows = numRows[index]
+            };
+        }
+        m_planeCopyEngine.Copy(std::span{ planes.data(), numSubresources });
+        uploadBuffer->Unmap(0, nullptr);
+
+        for (UINT index = 0; index < numSubresources; ++index) {
+            const CD3DX12_TEXTURE_COPY_LOCATION dst(dstTexture, index);
+            const CD3DX12_TEXTURE_COPY_LOCATION src(uploadBuffer, layouts[index]);
+            cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+        }
+    }
+
     virtual void UpdateVideoTexture(const YUVBuffer& yuvBuffer) override
     {
         CHECK(m_device != nullptr);
@@ -1454,10 +1521,10 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
                     CD3DX12_RESOURCE_BARRIER::Transition(videoTex.texture.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
                 cmdList->ResourceBarrier(1, &resourceBarrier);
 
-                UpdateSubresources
+                UploadSubresources<2>
                 (
                     cmdList.Get(), videoTex.texture.Get(), videoTex.uploadTexture.Get(),
-                    0, 0, (UINT)textureData.size(), textureData.data()
+                    (UINT)textureData.size(), textureData.data()
                 );
 
                 resourceBarrier =
@@ -1471,7 +1538,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
                 CHECK(videoTex.chromaTexture != nullptr);
                 CHECK(videoTex.chromaVTexture != nullptr);
 
-                const auto uploadData = [&cmdList](const TextureRes& tex, const TextureRes& uploadBuff, const Buffer& buf)
+                const auto uploadData = [this, &cmdList](const TextureRes& tex, const TextureRes& uploadBuff, const Buffer& buf)
                 {
                     const auto texDesc = tex->GetDesc();
                     CHECK(buf.height <= texDesc.Height);
@@ -1480,7 +1547,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
                         .RowPitch = static_cast<LONG_PTR>(buf.pitch),
                         .SlicePitch = static_cast<LONG_PTR>(buf.pitch * buf.height)
                     };
-                    UpdateSubresources<1>(cmdList.Get(), tex.Get(), uploadBuff.Get(), 0, 0, 1, &textureData);
+                    UploadSubresources<1>(cmdList.Get(), tex.Get(), uploadBuff.Get(), 1, &textureData);
                 };
 
                 std::array<CD3DX12_RESOURCE_BARRIER, 3> resourceBarriers = {
@@ -1564,7 +1631,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
 
     virtual void RenderVideoMultiView
     (
-        const std::array<XrCompositionLayerProjectionView, 2>& layerViews, const XrSwapchainImageBaseHeader* swapchainImage,
+        const std::array<XrCompositionLayerProjectionView, 2>& layerViews, const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode newMode /*= PassthroughMode::None*/
     ) override
     {
@@ -1605,7 +1672,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
         }, RenderPipelineType::Video, newMode);
     }
 
-    virtual void RenderVideoView(const std::uint32_t viewID, const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+    virtual void RenderVideoView(const std::uint32_t viewID, const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode newMode /*= PassthroughMode::None*/) override
     {
         CHECK(layerView.subImage.imageArrayIndex == 0);
@@ -1675,8 +1742,10 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
             m_VideoPipelineStates.clear();
         }
         if (newFovDecParm) {
-            for (auto& swapchainCtx : m_swapchainImageContexts)
-                swapchainCtx.SetFoveationDecodeData(*newFovDecParm);
+            if (const SwapchainImageContextSet* const swapchainContexts = m_swapchainImageContexts.load()) {
+                for (const auto& swapchainCtx : swapchainContexts->contexts)
+                    swapchainCtx->SetFoveationDecodeData(*newFovDecParm);
+            }
         }
         m_fovDecodeParams = newFovDecParm ?
             std::make_shared<ALXR::FoveatedDecodeParams>(*newFovDecParm) : nullptr;
@@ -1698,8 +1767,17 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     ComPtr<ID3D12Fence> m_fence;
     uint64_t m_fenceValue = 0;
     HANDLE m_fenceEvent = INVALID_HANDLE_VALUE;
-    std::list<SwapchainImageContext> m_swapchainImageContexts;
-    std::map<const XrSwapchainImageBaseHeader*, SwapchainImageContext*> m_swapchainImageContextMap;
+    // Published as a whole, swapchains are (re)created off the render thread while it keeps rendering.
+    struct SwapchainImageContextSet {
+        std::vector<std::shared_ptr<SwapchainImageContext>> contexts;
+        // of contexts, by swapchain slot (see IGraphicsPlugin::AllocateSwapchainImageStructs).
+        std::array<SwapchainImageContext*, IGraphicsPlugin::MaxSwapchainSlots> slots{};
+
+        inline SwapchainImageContext* Find(const std::uint32_t swapchainSlot) const {
+            return swapchainSlot < slots.size() ? slots[swapchainSlot] : nullptr;
+        }
+    };
+    xrconcurrency::rcu_ptr<SwapchainImageContextSet> m_swapchainImageContexts{};
     XrGraphicsBindingD3D12KHR m_graphicsBinding{
         .type = XR_TYPE_GRAPHICS_BINDING_D3D12_KHR,
         .next = nullptr
@@ -1715,6 +1793,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
 
     D3D12FenceEvent                 m_texRendereComplete {};
     D3D12FenceEvent                 m_texCopy {};
+    ALXR::PlaneCopy::CopyEngine     m_planeCopyEngine { 0, [] { ALXR::ThreadScheduling::ApplyToCurrentThread(ALXR::ThreadScheduling::Role::Upload); } };
     constexpr static const std::size_t VideoTexCount = 2;
     struct NV12Texture {
 
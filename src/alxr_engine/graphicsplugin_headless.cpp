@@ -2,11 +2,17 @@
 #include "common.h"
 #include "geometry.h"
 #include "graphicsplugin.h"
+#include "plane_copy.h"
+#include "thread_scheduling.h"
+#include "timing.h"
+
+#include <atomic>
+#include <span>
 
 struct HeadlessGraphicsPlugin final : public IGraphicsPlugin {
 
     HeadlessGraphicsPlugin(const std::shared_ptr<Options>&, std::shared_ptr<IPlatformPlugin>) {};
-    
+
     virtual std::vector<std::string> GetInstanceExtensions() const override { return {}; }
 
     // Create an instance of this graphics api for the provided instance and systemId.
@@ -21,7 +27,7 @@ struct HeadlessGraphicsPlugin final : public IGraphicsPlugin {
     // Allocate space for the swapchain image structures. These are different for each graphics API. The returned
     // pointers are valid for the lifetime of the graphics plugin.
     virtual std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t /*capacity*/, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        const std::uint32_t /*swapchainSlot*/, uint32_t /*capacity*/, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
         return {};
     }
 
@@ -29,13 +35,79 @@ struct HeadlessGraphicsPlugin final : public IGraphicsPlugin {
     virtual void RenderView
     (
         const XrCompositionLayerProjectionView& /*layerView*/,
-        const XrSwapchainImageBaseHeader* /*swapchainImage*/,
+        const SwapchainImageRef& /*swapchainImage*/,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode /*newMode*/,
         const std::vector<Cube>& /*cubes*/
     ) override {
         return ;
     }
+
+    // CPU decoded frames are copied into host memory, standing in for a staging buffer upload
+    // so decode/upload timings can be measured without a GPU (e.g. stream capture replay).
+    virtual void CreateVideoTextures(const std::size_t width, const std::size_t height, const XrPixelFormat pixfmt) override
+    {
+        const bool is16Bit = pixfmt == XrPixelFormat::P010LE || pixfmt == XrPixelFormat::G10X6_B10X6_R10X6_3PLANE_420;
+        m_videoFrameWidth = width;
+        m_videoSampleSize = is16Bit ? 2 : 1;
+        m_videoFrame.resize((width * height + (width * height) / 2) * m_videoSampleSize);
+    }
+
+    virtual void UpdateVideoTexture(const YUVBuffer& yuvBuffer) override
+    {
+        if (m_videoFrame.empty())
+            return;
+        const std::uint64_t uploadStart = GetSteadyTimestampUs();
+
+        using ALXR::PlaneCopy::Plane;
+        const bool has3Planes = yuvBuffer.chroma2.data != nullptr;
+        const std::size_t lumaRowSize = m_videoFrameWidth * m_videoSampleSize;
+        const std::size_t chromaRowSize = has3Planes ? lumaRowSize / 2 : lumaRowSize;
+        const auto makePlane = [](std::uint8_t* dst, const Buffer& src, const std::size_t rowSize) {
+            return Plane {
+                .dst = dst,
+                .dstPitch = rowSize,
+                .src = reinterpret_cast<const std::uint8_t*>(src.data),
+                .srcPitch = src.pitch,
+                .rowSize = rowSize,
+                .rows = src.height
+            };
+        };
+        std::uint8_t* const lumaPtr = m_videoFrame.data();
+        std::uint8_t* const chromaPtr = lumaPtr + lumaRowSize * yuvBuffer.luma.height;
+        std::uint8_t* const chromaVPtr = chromaPtr + chromaRowSize * yuvBuffer.chroma.height;
+        const std::array<Plane, 3> planes {
+            makePlane(lumaPtr, yuvBuffer.luma, lumaRowSize),
+            makePlane(chromaPtr, yuvBuffer.chroma, chromaRowSize),
+            has3Planes ? makePlane(chromaVPtr, yuvBuffer.chroma2, chromaRowSize) : Plane {}
+        };
+        m_planeCopyEngine.Copy(std::span{ planes.data(), has3Planes ? planes.size() : 2 });
+
+        m_videoFrameIndex.store(yuvBuffer.frameIndex);
+        if (m_videoUploadObserver)
+            m_videoUploadObserver(yuvBuffer.frameIndex, GetSteadyTimestampUs() - uploadStart);
+    }
+
+    virtual void ClearVideoTextures() override
+    {
+        m_videoFrame.clear();
+        m_videoFrameIndex.store(std::uint64_t(-1));
+    }
+
+    virtual std::uint64_t GetVideoFrameIndex() const override { return m_videoFrameIndex.load(); }
+
+    virtual void SetVideoUploadObserver(VideoUploadObserver&& observer) override
+    {
+        m_videoUploadObserver = std::move(observer);
+    }
+
+private:
+    std::vector<std::uint8_t>   m_videoFrame{};
+    std::size_t                 m_videoFrameWidth = 0;
+    std::size_t                 m_videoSampleSize = 1;
+    std::atomic<std::uint64_t>  m_videoFrameIndex{ std::uint64_t(-1) };
+    VideoUploadObserver         m_videoUploadObserver{};
+    ALXR::PlaneCopy::CopyEngine m_planeCopyEngine{ 0, [] { ALXR::ThreadScheduling::ApplyToCurrentThread(ALXR::ThreadScheduling::Role::Upload); } };
 };
 
 std::shared_ptr<IGraphicsPlugin> CreateGraphicsPlugin_Headless(const std::shared_ptr<Options>& options,
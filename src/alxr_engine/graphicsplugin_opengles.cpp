@@ -68,10 +68,8 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
             glDeleteBuffers(1, &m_cubeIndexBuffer);
         }
 
-        for (auto& colorToDepth : m_colorToDepthMap) {
-            if (colorToDepth.second != 0) {
-                glDeleteTextures(1, &colorToDepth.second);
-            }
+        for (auto& slot : m_swapchainSlots) {
+            DeleteDepthTextures(slot.depthTextures);
         }
 
         ksGpuWindow_Destroy(&window);
@@ -231,27 +229,50 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        const std::uint32_t swapchainSlot, uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
-        std::vector<XrSwapchainImageOpenGLESKHR> swapchainImageBuffer(capacity, {XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_ES_KHR});
+        CHECK(swapchainSlot < m_swapchainSlots.size());
+        auto& slot = m_swapchainSlots[swapchainSlot];
+        CHECK(slot.images.empty());
+        slot.images.assign(capacity, {XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_ES_KHR});
+        ++slot.generation;
+
         std::vector<XrSwapchainImageBaseHeader*> swapchainImageBase;
-        for (XrSwapchainImageOpenGLESKHR& image : swapchainImageBuffer) {
+        for (XrSwapchainImageOpenGLESKHR& image : slot.images) {
             swapchainImageBase.push_back(reinterpret_cast<XrSwapchainImageBaseHeader*>(&image));
         }
+        return swapchainImageBase;
+    }
 
-        // Keep the buffer alive by moving it into the list of buffers.
-        m_swapchainImageBuffers.push_back(std::move(swapchainImageBuffer));
+    virtual void ReleaseSwapchainImageStructs(const std::uint32_t swapchainSlot) override {
+        // depth textures belong to the GL context, the render thread drops them when the slot is reused.
+        if (swapchainSlot < m_swapchainSlots.size())
+            m_swapchainSlots[swapchainSlot].images.clear();
+    }
 
-        return swapchainImageBase;
+    static void DeleteDepthTextures(std::vector<uint32_t>& depthTextures) {
+        for (auto& depthTexture : depthTextures) {
+            if (depthTexture != 0) {
+                glDeleteTextures(1, &depthTexture);
+            }
+        }
+        depthTextures.clear();
     }
 
-    uint32_t GetDepthTexture(uint32_t colorTexture) {
+    uint32_t GetDepthTexture(const SwapchainImageRef& swapchainImage) {
+        auto& slot = m_swapchainSlots[swapchainImage.slot];
+        if (slot.depthGeneration != slot.generation) {
+            DeleteDepthTextures(slot.depthTextures);
+            slot.depthTextures.resize(slot.images.size(), 0);
+            slot.depthGeneration = slot.generation;
+        }
+        assert(swapchainImage.imageIndex < slot.depthTextures.size());
         // If a depth-stencil view has already been created for this back-buffer, use it.
-        auto depthBufferIt = m_colorToDepthMap.find(colorTexture);
-        if (depthBufferIt != m_colorToDepthMap.end()) {
-            return depthBufferIt->second;
+        if (slot.depthTextures[swapchainImage.imageIndex] != 0) {
+            return slot.depthTextures[swapchainImage.imageIndex];
         }
+        const uint32_t colorTexture = slot.images[swapchainImage.imageIndex].image;
 
         // This back-buffer has no corresponding depth-stencil texture, so create one with matching dimensions.
 
@@ -270,14 +291,14 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
 
-        m_colorToDepthMap.insert(std::make_pair(colorTexture, depthTexture));
+        slot.depthTextures[swapchainImage.imageIndex] = depthTexture;
 
         return depthTexture;
     }
 
     void RenderView
     (
-        const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+        const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode /*newMode*/,
         const std::vector<Cube>& cubes
     ) override {
@@ -286,7 +307,7 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
 
         glBindFramebuffer(GL_FRAMEBUFFER, m_swapchainFramebuffer);
 
-        const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLESKHR*>(swapchainImage)->image;
+        const uint32_t colorTexture = m_swapchainSlots[swapchainImage.slot].images[swapchainImage.imageIndex].image;
 
         glViewport(static_cast<GLint>(layerView.subImage.imageRect.offset.x),
                    static_cast<GLint>(layerView.subImage.imageRect.offset.y),
@@ -298,7 +319,7 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         glEnable(GL_CULL_FACE);
         glEnable(GL_DEPTH_TEST);
 
-        const uint32_t depthTexture = GetDepthTexture(colorTexture);
+        const uint32_t depthTexture = GetDepthTexture(swapchainImage);
 
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
@@ -354,7 +375,6 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     XrGraphicsBindingOpenGLESAndroidKHR m_graphicsBinding{XR_TYPE_GRAPHICS_BINDING_OPENGL_ES_ANDROID_KHR};
 #endif
 
-    std::list<std::vector<XrSwapchainImageOpenGLESKHR>> m_swapchainImageBuffers;
     GLuint m_swapchainFramebuffer{0};
     GLuint m_program{0};
     GLint m_modelViewProjectionUniformLocation{0};
@@ -368,8 +388,15 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     static_assert(XR_ENVIRONMENT_BLEND_MODE_OPAQUE == 1);
     std::size_t m_clearColorIndex{ (XR_ENVIRONMENT_BLEND_MODE_OPAQUE - 1) };
 
-    // Map color buffer to associated depth buffer. This map is populated on demand.
-    std::map<uint32_t, uint32_t> m_colorToDepthMap;
+    // Image structs and their depth buffers, by swapchain slot (see IGraphicsPlugin::AllocateSwapchainImageStructs).
+    struct SwapchainSlot {
+        std::vector<XrSwapchainImageOpenGLESKHR> images;
+        std::uint32_t generation = 0; // bumped on every allocation of the slot.
+        // populated on demand (render thread only).
+        std::vector<uint32_t> depthTextures;
+        std::uint32_t depthGeneration = 0;
+    };
+    std::array<SwapchainSlot, IGraphicsPlugin::MaxSwapchainSlots> m_swapchainSlots;
     const std::array<float, 4> m_clearColor;
 };
 }  // namespace
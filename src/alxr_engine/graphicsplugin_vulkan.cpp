@@ -8,6 +8,8 @@
 #include "geometry.h"
 #include "options.h"
 #include "graphicsplugin.h"
+#include "plane_copy.h"
+#include "thread_scheduling.h"
 
 #ifdef XR_USE_GRAPHICS_API_VULKAN
 
@@ -20,6 +22,8 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <mutex>
 
 #ifdef USE_ONLINE_VULKAN_SHADERC
 #include <shaderc/shaderc.hpp>
@@ -54,8 +58,13 @@
 
 #include <readerwritercircularbuffer.h>
 #include "concurrent_queue.h"
+#include "rcu_ptr.h"
 #include "timing.h"
 #include "foveation.h"
+#include "video_reprojection.h"
+#include "video_jitter_buffer.h"
+#include "pipeline_cache_file.h"
+#include "memory_block_ranges.h"
 
 namespace {
 
@@ -131,34 +140,158 @@ inline VkResult CheckVkResult(VkResult res, const char* originator = nullptr, co
 #define CHECK_VKCMD(cmd) CheckVkResult(cmd, #cmd, FILE_AND_LINE);
 #define CHECK_VKRESULT(res, cmdStr) CheckVkResult(res, cmdStr, FILE_AND_LINE);
 
+// Sub-allocates buffers and images from large VkDeviceMemory blocks, pooled per memory type, instead of a
+// vkAllocateMemory per resource: drivers limit the number of live allocations (maxMemoryAllocationCount,
+// as low as 4096) and allocating is slow. Blocks are kept once allocated, resources re-created with the
+// same sizes (e.g. video textures on a stream reconfiguration) reuse the ranges they freed.
+//
+// Memory which has to be its own allocation (imported/exported memory, resources over half a block) is
+// allocated dedicated. Host visible blocks are mapped once for their lifetime, use Allocation::mapped
+// instead of vkMapMemory. Thread safe.
 struct MemoryAllocator {
+    // Optimal tiling images are pooled apart from buffers and linear images, so neighbours within a block
+    // never have to be padded to bufferImageGranularity.
+    enum class Tiling : std::uint8_t {
+        Linear,  // buffers and linear images
+        Optimal
+    };
+
+    struct Allocation {
+        VkDeviceMemory memory{ VK_NULL_HANDLE };
+        VkDeviceSize   offset{ 0 };
+        VkDeviceSize   size{ 0 };
+        std::uint8_t*  mapped{ nullptr }; // at offset, host visible memory only.
+        std::uint32_t  poolIndex{ DedicatedPool };
+        std::uint32_t  blockIndex{ 0 };
+
+        inline bool IsValid() const { return memory != VK_NULL_HANDLE; }
+    };
+
+    struct Stats {
+        std::uint64_t blocks = 0;
+        std::uint64_t blockBytes = 0;
+        std::uint64_t subAllocations = 0;
+        std::uint64_t subAllocatedBytes = 0;
+        std::uint64_t dedicatedAllocations = 0;
+        std::uint64_t dedicatedBytes = 0;
+        std::uint64_t deviceAllocations = 0; // vkAllocateMemory calls so far
+    };
+
+    static constexpr const VkFlags defaultFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    static constexpr const VkDeviceSize DefaultBlockSize = VkDeviceSize(64) << 20;
+    static constexpr const std::uint32_t DedicatedPool = std::uint32_t(-1);
+
+    MemoryAllocator() = default;
+    ~MemoryAllocator() {
+        Clear();
+    }
+
+    MemoryAllocator(const MemoryAllocator&) = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+    MemoryAllocator(MemoryAllocator&&) = delete;
+    MemoryAllocator& operator=(MemoryAllocator&&) = delete;
+
     void Init(VkPhysicalDevice physicalDevice, VkDevice device) {
-        m_physicalDevice = physicalDevice;
         m_vkDevice = device;
         vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memProps);
+        for (std::uint32_t i = 0; i < m_memProps.memoryTypeCount; ++i) {
+            // small heaps (e.g. the 256MB host visible device local one) get smaller blocks.
+            const VkDeviceSize heapSize = m_memProps.memoryHeaps[m_memProps.memoryTypes[i].heapIndex].size;
+            m_blockSizes[i] = heapSize <= (VkDeviceSize(1) << 30) ? std::min(DefaultBlockSize, heapSize / 8) : DefaultBlockSize;
+        }
     }
 
-    static constexpr const VkFlags defaultFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-    void Allocate(VkMemoryRequirements const& memReqs, VkDeviceMemory* mem, VkFlags flags = defaultFlags,
-                  const void* pNext = nullptr) const {
-        // Search memtypes to find first index with those properties
-        for (uint32_t i = 0; i < m_memProps.memoryTypeCount; ++i) {
-            if ((memReqs.memoryTypeBits & (1 << i)) != 0u) {
-                // Type is available, does it match user properties?
-                if ((m_memProps.memoryTypes[i].propertyFlags & flags) == flags) {
-                    const VkMemoryAllocateInfo memAlloc {
-                        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-                        .pNext = pNext,
-                        .allocationSize = memReqs.size,
-                        .memoryTypeIndex = i,
-                    };
-                    CHECK_VKCMD(vkAllocateMemory(m_vkDevice, &memAlloc, nullptr, mem));
-                    return;
-                }
+    // Frees every block, all allocations must have been freed.
+    void Clear() {
+        std::scoped_lock lock(m_mutex);
+        for (auto& pool : m_pools) {
+            for (auto& block : pool) {
+                assert(block.ranges.IsEmpty());
+                if (m_vkDevice != VK_NULL_HANDLE)
+                    vkFreeMemory(m_vkDevice, block.memory, nullptr);
             }
+            pool.clear();
         }
-        THROW("Memory format not supported");
+        m_stats.blocks = 0;
+        m_stats.blockBytes = 0;
+    }
+
+    Allocation Allocate(VkMemoryRequirements const& memReqs, VkFlags flags = defaultFlags, const Tiling tiling = Tiling::Linear) {
+        const std::uint32_t memTypeIndex = FindMemoryType(memReqs.memoryTypeBits, flags);
+        const VkDeviceSize blockSize = m_blockSizes[memTypeIndex];
+        if (memReqs.size > blockSize / 2)
+            return AllocateDedicated(memReqs, flags);
+
+        const std::uint32_t poolIndex = memTypeIndex * 2 + (tiling == Tiling::Optimal ? 1 : 0);
+        const VkDeviceSize alignment = std::max<VkDeviceSize>(memReqs.alignment, 1);
+        std::scoped_lock lock(m_mutex);
+        auto& pool = m_pools[poolIndex];
+        for (std::uint32_t blockIndex = 0; blockIndex < pool.size(); ++blockIndex) {
+            if (const auto offset = pool[blockIndex].ranges.Allocate(memReqs.size, alignment))
+                return MakeAllocation(poolIndex, blockIndex, *offset, memReqs.size);
+        }
+
+        Block& block = pool.emplace_back(blockSize);
+        block.memory = AllocateMemory(memTypeIndex, blockSize, nullptr);
+        if ((m_memProps.memoryTypes[memTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+            void* data = nullptr;
+            CHECK_VKCMD(vkMapMemory(m_vkDevice, block.memory, 0, VK_WHOLE_SIZE, 0, &data));
+            block.mapped = reinterpret_cast<std::uint8_t*>(data);
+        }
+        ++m_stats.blocks;
+        m_stats.blockBytes += blockSize;
+        const auto offset = block.ranges.Allocate(memReqs.size, alignment);
+        CHECK(offset.has_value());
+        return MakeAllocation(poolIndex, static_cast<std::uint32_t>(pool.size() - 1), *offset, memReqs.size);
+    }
+
+    // A VkDeviceMemory of its own, required for memory chained with pNext (import/export/dedicated info).
+    Allocation AllocateDedicated(VkMemoryRequirements const& memReqs, VkFlags flags = defaultFlags, const void* pNext = nullptr) {
+        const std::uint32_t memTypeIndex = FindMemoryType(memReqs.memoryTypeBits, flags);
+        std::scoped_lock lock(m_mutex);
+        Allocation allocation {
+            .memory = AllocateMemory(memTypeIndex, memReqs.size, pNext),
+            .size = memReqs.size,
+        };
+        if (pNext == nullptr && (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+            void* data = nullptr;
+            CHECK_VKCMD(vkMapMemory(m_vkDevice, allocation.memory, 0, VK_WHOLE_SIZE, 0, &data));
+            allocation.mapped = reinterpret_cast<std::uint8_t*>(data);
+        }
+        ++m_stats.dedicatedAllocations;
+        m_stats.dedicatedBytes += memReqs.size;
+        return allocation;
+    }
+
+    void Free(Allocation& allocation) {
+        if (!allocation.IsValid())
+            return;
+        std::scoped_lock lock(m_mutex);
+        if (allocation.poolIndex == DedicatedPool) {
+            // implicitly unmapped.
+            vkFreeMemory(m_vkDevice, allocation.memory, nullptr);
+            --m_stats.dedicatedAllocations;
+            m_stats.dedicatedBytes -= allocation.size;
+        } else {
+            m_pools[allocation.poolIndex][allocation.blockIndex].ranges.Free(allocation.offset, allocation.size);
+            --m_stats.subAllocations;
+            m_stats.subAllocatedBytes -= allocation.size;
+        }
+        allocation = {};
+    }
+
+    Stats GetStats() const {
+        std::scoped_lock lock(m_mutex);
+        return m_stats;
+    }
+
+    void LogStats() const {
+        const auto stats = GetStats();
+        Log::Write(Log::Level::Info, Fmt("VulkanGraphicsPlugin: device memory: %llu blocks (%.1fMB) holding %llu allocations (%.1fMB), %llu dedicated (%.1fMB), %llu vkAllocateMemory calls",
+            static_cast<unsigned long long>(stats.blocks), stats.blockBytes / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(stats.subAllocations), stats.subAllocatedBytes / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(stats.dedicatedAllocations), stats.dedicatedBytes / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(stats.deviceAllocations)));
     }
 
     std::uint32_t FindMemoryType
@@ -167,23 +300,62 @@ struct MemoryAllocator {
         VkMemoryPropertyFlags properties
     ) const
     {
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
-
-        for (std::uint32_t i = 0; i < memProperties.memoryTypeCount; ++i) {
+        // Search memtypes to find first index with those properties
+        for (std::uint32_t i = 0; i < m_memProps.memoryTypeCount; ++i) {
             if ((typeFilter & (1 << i)) &&
-                (memProperties.memoryTypes[i].propertyFlags & properties) ==
+                (m_memProps.memoryTypes[i].propertyFlags & properties) ==
                 properties) {
                 return i;
             }
         }
-        throw std::runtime_error("failed to find suitable memory type!");
+        THROW("Memory format not supported");
     }
 
    private:
-    VkPhysicalDevice m_physicalDevice{ VK_NULL_HANDLE };
+    struct Block {
+        VkDeviceMemory         memory{ VK_NULL_HANDLE };
+        std::uint8_t*          mapped{ nullptr };
+        ALXR::MemoryBlockRanges ranges;
+
+        explicit Block(const VkDeviceSize size) : ranges(size) {}
+    };
+
+    // m_mutex held.
+    VkDeviceMemory AllocateMemory(const std::uint32_t memTypeIndex, const VkDeviceSize size, const void* pNext) {
+        const VkMemoryAllocateInfo memAlloc {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = pNext,
+            .allocationSize = size,
+            .memoryTypeIndex = memTypeIndex,
+        };
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        CHECK_VKCMD(vkAllocateMemory(m_vkDevice, &memAlloc, nullptr, &memory));
+        ++m_stats.deviceAllocations;
+        return memory;
+    }
+
+    // m_mutex held.
+    Allocation MakeAllocation(const std::uint32_t poolIndex, const std::uint32_t blockIndex, const VkDeviceSize offset, const VkDeviceSize size) {
+        const Block& block = m_pools[poolIndex][blockIndex];
+        ++m_stats.subAllocations;
+        m_stats.subAllocatedBytes += size;
+        return {
+            .memory = block.memory,
+            .offset = offset,
+            .size = size,
+            .mapped = block.mapped != nullptr ? block.mapped + offset : nullptr,
+            .poolIndex = poolIndex,
+            .blockIndex = blockIndex,
+        };
+    }
+
     VkDevice m_vkDevice{VK_NULL_HANDLE};
     VkPhysicalDeviceMemoryProperties m_memProps{};
+    std::array<VkDeviceSize, VK_MAX_MEMORY_TYPES> m_blockSizes{};
+    // [memory type * 2 + Tiling], blocks are only freed by Clear so indices stay valid.
+    std::array<std::vector<Block>, VK_MAX_MEMORY_TYPES * 2> m_pools{};
+    mutable std::mutex m_mutex{};
+    Stats m_stats{};
 };
 
 struct SemaphoreTimeline {
@@ -543,6 +715,48 @@ struct CmdBuffer {
         return Exec<SignalerCount, 0>(queue, signalers, {}, {});
     }
 
+    // Waits on a specific timeline value rather than the waiter's latest (fenceValue), no wait if
+    // waitValue is 0, and signals the signaler's next value. The signaler must only be signalled
+    // from the calling thread.
+    bool ExecWaitValue
+    (
+        VkQueue queue,
+        const SemaphoreTimeline& waiter,
+        const std::uint64_t waitValue,
+        const VkPipelineStageFlags waitStage,
+        SemaphoreTimeline& signaler
+    )
+    {
+        CHECK_CBSTATE(CmdBufferState::Executable);
+
+        const bool hasWait = waitValue != 0;
+        const std::uint64_t signalValue = signaler.fenceValue.load() + 1;
+        const VkTimelineSemaphoreSubmitInfo timelineInfo {
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .pNext = nullptr,
+            .waitSemaphoreValueCount = hasWait ? 1u : 0u,
+            .pWaitSemaphoreValues = hasWait ? &waitValue : nullptr,
+            .signalSemaphoreValueCount = 1,
+            .pSignalSemaphoreValues = &signalValue
+        };
+        const VkSubmitInfo submitInfo {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .pNext = &timelineInfo,
+            .waitSemaphoreCount = hasWait ? 1u : 0u,
+            .pWaitSemaphores = hasWait ? &waiter.fence : nullptr,
+            .pWaitDstStageMask = hasWait ? &waitStage : nullptr,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &buf,
+            .signalSemaphoreCount = 1,
+            .pSignalSemaphores = &signaler.fence
+        };
+        CHECK_VKCMD(vkQueueSubmit(queue, 1, &submitInfo, execFence));
+        signaler.fenceValue.store(signalValue);
+
+        SetState(CmdBufferState::Executing);
+        return true;
+    }
+
     bool Wait() {
         // Waiting on a not-in-flight command buffer is a no-op
         if (state == CmdBufferState::Initialized) {
@@ -666,12 +880,55 @@ struct ShaderProgram {
     }
 };
 
+struct ComputeShader {
+    VkPipelineShaderStageCreateInfo shaderInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+        .module = VK_NULL_HANDLE,
+        .pName = ShaderProgram::EntryPoint,
+        .pSpecializationInfo = nullptr
+    };
+
+    ComputeShader() = default;
+    ~ComputeShader() {
+        if (m_vkDevice != VK_NULL_HANDLE && shaderInfo.module != VK_NULL_HANDLE)
+            vkDestroyShaderModule(m_vkDevice, shaderInfo.module, nullptr);
+        shaderInfo.module = VK_NULL_HANDLE;
+        m_vkDevice = VK_NULL_HANDLE;
+    }
+
+    ComputeShader(const ComputeShader&) = delete;
+    ComputeShader& operator=(const ComputeShader&) = delete;
+    ComputeShader(ComputeShader&&) = delete;
+    ComputeShader& operator=(ComputeShader&&) = delete;
+
+    bool IsNull() const { return shaderInfo.module == VK_NULL_HANDLE; }
+
+    void Load(VkDevice device, const ShaderProgram::CodeBuffer& code) {
+        m_vkDevice = device;
+        const VkShaderModuleCreateInfo modInfo{
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .codeSize = code.size() * sizeof(code[0]),
+            .pCode = code.data(),
+        };
+        CHECK_MSG((modInfo.codeSize > 0) && modInfo.pCode, "Invalid compute shader ");
+        CHECK_VKCMD(vkCreateShaderModule(m_vkDevice, &modInfo, nullptr, &shaderInfo.module));
+        Log::Write(Log::Level::Verbose, "Loaded compute shader");
+    }
+
+   private:
+    VkDevice m_vkDevice{VK_NULL_HANDLE};
+};
+
 // VertexBuffer base class
 struct VertexBufferBase {
     VkBuffer idxBuf{VK_NULL_HANDLE};
-    VkDeviceMemory idxMem{VK_NULL_HANDLE};
+    MemoryAllocator::Allocation idxMem{};
     VkBuffer vtxBuf{VK_NULL_HANDLE};
-    VkDeviceMemory vtxMem{VK_NULL_HANDLE};
+    MemoryAllocator::Allocation vtxMem{};
     VkVertexInputBindingDescription bindDesc{};
     std::vector<VkVertexInputAttributeDescription> attrDesc{};
     struct {
@@ -686,20 +943,14 @@ struct VertexBufferBase {
             if (idxBuf != VK_NULL_HANDLE) {
                 vkDestroyBuffer(m_vkDevice, idxBuf, nullptr);
             }
-            if (idxMem != VK_NULL_HANDLE) {
-                vkFreeMemory(m_vkDevice, idxMem, nullptr);
-            }
             if (vtxBuf != VK_NULL_HANDLE) {
                 vkDestroyBuffer(m_vkDevice, vtxBuf, nullptr);
             }
-            if (vtxMem != VK_NULL_HANDLE) {
-                vkFreeMemory(m_vkDevice, vtxMem, nullptr);
-            }
+            m_memAllocator->Free(idxMem);
+            m_memAllocator->Free(vtxMem);
         }
         idxBuf = VK_NULL_HANDLE;
-        idxMem = VK_NULL_HANDLE;
         vtxBuf = VK_NULL_HANDLE;
-        vtxMem = VK_NULL_HANDLE;
         bindDesc = {};
         attrDesc.clear();
         count = {0, 0};
@@ -710,7 +961,7 @@ struct VertexBufferBase {
     VertexBufferBase& operator=(const VertexBufferBase&) = delete;
     VertexBufferBase(VertexBufferBase&&) = delete;
     VertexBufferBase& operator=(VertexBufferBase&&) = delete;
-    void Init(VkDevice device, const MemoryAllocator* memAllocator, const std::vector<VkVertexInputAttributeDescription>& attr) {
+    void Init(VkDevice device, MemoryAllocator* memAllocator, const std::vector<VkVertexInputAttributeDescription>& attr) {
         m_vkDevice = device;
         m_memAllocator = memAllocator;
         attrDesc = attr;
@@ -718,14 +969,14 @@ struct VertexBufferBase {
 
    protected:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
-    void AllocateBufferMemory(VkBuffer buf, VkDeviceMemory* mem) const {
+    void AllocateBufferMemory(VkBuffer buf, MemoryAllocator::Allocation& mem) const {
         VkMemoryRequirements memReq = {};
         vkGetBufferMemoryRequirements(m_vkDevice, buf, &memReq);
-        m_memAllocator->Allocate(memReq, mem);
+        mem = m_memAllocator->Allocate(memReq);
     }
 
    private:
-    const MemoryAllocator* m_memAllocator{nullptr};
+    MemoryAllocator* m_memAllocator{nullptr};
 };
 
 // VertexBuffer template to wrap the indices and vertices
@@ -739,14 +990,14 @@ struct VertexBuffer final : public VertexBufferBase {
             .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT            
         };
         CHECK_VKCMD(vkCreateBuffer(m_vkDevice, &bufInfo, nullptr, &idxBuf));
-        AllocateBufferMemory(idxBuf, &idxMem);
-        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, idxBuf, idxMem, 0));
+        AllocateBufferMemory(idxBuf, idxMem);
+        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, idxBuf, idxMem.memory, idxMem.offset));
 
         bufInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
         bufInfo.size = sizeof(T) * vtxCount;
         CHECK_VKCMD(vkCreateBuffer(m_vkDevice, &bufInfo, nullptr, &vtxBuf));
-        AllocateBufferMemory(vtxBuf, &vtxMem);
-        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, vtxBuf, vtxMem, 0));
+        AllocateBufferMemory(vtxBuf, vtxMem);
+        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, vtxBuf, vtxMem.memory, vtxMem.offset));
 
         bindDesc = {
             .binding = 0,
@@ -760,25 +1011,22 @@ struct VertexBuffer final : public VertexBufferBase {
     }
 
     inline void UpdateIndices(const std::uint16_t* data, const std::uint32_t size, const std::uint32_t offset = 0) {
-        uint16_t* map = nullptr;
-        CHECK_VKCMD(vkMapMemory(m_vkDevice, idxMem, sizeof(map[0]) * offset, sizeof(map[0]) * size, 0, (void**)&map));
-        std::copy_n(data, size, map);
-        vkUnmapMemory(m_vkDevice, idxMem);
+        CHECK(idxMem.mapped != nullptr);
+        std::copy_n(data, size, reinterpret_cast<std::uint16_t*>(idxMem.mapped) + offset);
     }
 
     inline void UpdateVertices(const T* data, const std::uint32_t size, const std::uint32_t offset = 0) {
-        T* map = nullptr;
-        CHECK_VKCMD(vkMapMemory(m_vkDevice, vtxMem, sizeof(map[0]) * offset, sizeof(map[0]) * size, 0, (void**)&map));
-        std::copy_n(data, size, map);
-        vkUnmapMemory(m_vkDevice, vtxMem);
+        CHECK(vtxMem.mapped != nullptr);
+        std::copy_n(data, size, reinterpret_cast<T*>(vtxMem.mapped) + offset);
     }
 };
 
 struct Texture {
     std::vector<std::size_t> totalImageMemSizes{};
-    std::vector<VkDeviceMemory> texMemory{};// { VK_NULL_HANDLE };
+    std::vector<MemoryAllocator::Allocation> texMemory{};
     VkImage texImage{ VK_NULL_HANDLE };
     VkDevice m_vkDevice{ VK_NULL_HANDLE };
+    MemoryAllocator* m_memAllocator{ nullptr };
     VkImageLayout m_vkLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
     inline bool IsValid() const { return texImage != VK_NULL_HANDLE && totalImageMemSizes.size() > 0; }
@@ -792,15 +1040,14 @@ struct Texture {
             if (texImage != VK_NULL_HANDLE) {
                 vkDestroyImage(m_vkDevice, texImage, nullptr);
             }
-            for (auto tm : texMemory) {
-                if (tm != VK_NULL_HANDLE)
-                    vkFreeMemory(m_vkDevice, tm, nullptr);
-            }
+            for (auto& tm : texMemory)
+                m_memAllocator->Free(tm);
         }
         totalImageMemSizes.clear();
         texMemory.clear();        
         texImage = VK_NULL_HANDLE;
         m_vkDevice = VK_NULL_HANDLE;
+        m_memAllocator = nullptr;
         m_vkLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     }
 
@@ -819,6 +1066,7 @@ struct Texture {
         texMemory = std::move(other.texMemory);
         swap(texImage, other.texImage);
         swap(m_vkDevice, other.m_vkDevice);
+        swap(m_memAllocator, other.m_memAllocator);
         swap(m_vkLayout, other.m_vkLayout);
     }
 
@@ -832,6 +1080,7 @@ struct Texture {
         texMemory = std::move(other.texMemory);
         swap(texImage, other.texImage);
         swap(m_vkDevice, other.m_vkDevice);
+        swap(m_memAllocator, other.m_memAllocator);
         swap(m_vkLayout, other.m_vkLayout);
         return *this;
     }
@@ -845,6 +1094,7 @@ struct Texture {
     )
     {
         m_vkDevice = device;
+        m_memAllocator = memAllocator;
 
         const VkExtent2D size = { width, height };
         const VkImageCreateInfo imageInfo { 
@@ -871,10 +1121,10 @@ struct Texture {
         VkMemoryRequirements memRequirements{};
         vkGetImageMemoryRequirements(device, texImage, &memRequirements);
         totalImageMemSizes.push_back(memRequirements.size);
-        VkDeviceMemory tm = VK_NULL_HANDLE;
-        memAllocator->Allocate(memRequirements, &tm, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        const auto tm = memAllocator->Allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            imageTiling == VK_IMAGE_TILING_OPTIMAL ? MemoryAllocator::Tiling::Optimal : MemoryAllocator::Tiling::Linear);
         texMemory.push_back(tm);
-        CHECK_VKCMD(vkBindImageMemory(device, texImage, tm, 0));
+        CHECK_VKCMD(vkBindImageMemory(device, texImage, tm.memory, tm.offset));
     }
 
     void CreateExported
@@ -888,6 +1138,7 @@ struct Texture {
     )
     {
         m_vkDevice = device;
+        m_memAllocator = memAllocator;
         assert(m_vkDevice != VK_NULL_HANDLE);
 
         constexpr const VkExternalMemoryImageCreateInfo vkExternalMemImageCreateInfo {
@@ -953,15 +1204,14 @@ struct Texture {
             vkGetImageMemoryRequirements(device, texImage, &vkMemoryRequirements);
             totalImageMemSizes.push_back(vkMemoryRequirements.size);
 
-            VkDeviceMemory tm = VK_NULL_HANDLE;
-            memAllocator->Allocate(memRequirements, &tm, properties, &vulkanExportMemoryAllocateInfoKHR);
-            CHECK_VKCMD(vkBindImageMemory(device, texImage, tm, 0));
+            const auto tm = memAllocator->AllocateDedicated(memRequirements, properties, &vulkanExportMemoryAllocateInfoKHR);
+            CHECK_VKCMD(vkBindImageMemory(device, texImage, tm.memory, 0));
 
             texMemory.push_back(tm);
         }
         else
         {
-            const auto AllocateDisjointed = [&](const VkImageAspectFlagBits aspectPlane, std::size_t& totalImageMemSize) -> VkDeviceMemory
+            const auto AllocateDisjointed = [&](const VkImageAspectFlagBits aspectPlane, std::size_t& totalImageMemSize) -> MemoryAllocator::Allocation
             {
                 VkImagePlaneMemoryRequirementsInfo imagePlaneMemoryRequirementsInfo {
                     .sType = VK_STRUCTURE_TYPE_IMAGE_PLANE_MEMORY_REQUIREMENTS_INFO,
@@ -1004,21 +1254,18 @@ struct Texture {
                 };
                 totalImageMemSize = memoryRequirements2.memoryRequirements.size;
 
-                VkDeviceMemory disjointMemoryPlane = VK_NULL_HANDLE;
-                memAllocator->Allocate(memoryRequirements2.memoryRequirements, &disjointMemoryPlane, properties, &vulkanExportMemoryAllocateInfoKHR);
-
-                return disjointMemoryPlane;
+                return memAllocator->AllocateDedicated(memoryRequirements2.memoryRequirements, properties, &vulkanExportMemoryAllocateInfoKHR);
             };
 
             std::size_t totalImageMemSize = 0;
             auto disjointMemoryPlane = AllocateDisjointed(VK_IMAGE_ASPECT_PLANE_0_BIT, totalImageMemSize);
-            CHECK(disjointMemoryPlane);
+            CHECK(disjointMemoryPlane.IsValid());
             texMemory.push_back(disjointMemoryPlane);
             totalImageMemSizes.push_back(totalImageMemSize);
 
             totalImageMemSize = 0;
             disjointMemoryPlane = AllocateDisjointed(VK_IMAGE_ASPECT_PLANE_1_BIT, totalImageMemSize);
-            CHECK(disjointMemoryPlane);
+            CHECK(disjointMemoryPlane.IsValid());
             texMemory.push_back(disjointMemoryPlane);
             totalImageMemSizes.push_back(totalImageMemSize);
 
@@ -1039,14 +1286,14 @@ struct Texture {
                     .sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO,
                     .pNext = &bindImagePlaneMemoryInfo[0],
                     .image = texImage,
-                    .memory = texMemory[0],
+                    .memory = texMemory[0].memory,
                     .memoryOffset = 0
                 },
                 VkBindImageMemoryInfo {
                     .sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO,
                     .pNext = &bindImagePlaneMemoryInfo[1],
                     .image = texImage,
-                    .memory = texMemory[1],
+                    .memory = texMemory[1].memory,
                     .memoryOffset = 0
                 },
             };
@@ -1069,6 +1316,7 @@ struct Texture {
     )
     {
         m_vkDevice = vkDevice;
+        m_memAllocator = memAllocator;
 
         formatInfo = {
             .sType = VK_STRUCTURE_TYPE_ANDROID_HARDWARE_BUFFER_FORMAT_PROPERTIES_ANDROID,
@@ -1133,15 +1381,14 @@ struct Texture {
             .memoryTypeBits = properties.memoryTypeBits            
         };
         totalImageMemSizes.push_back(memRequirements.size);
-        VkDeviceMemory tm = VK_NULL_HANDLE;
-        memAllocator->Allocate(memRequirements, &tm, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &memoryAllocateInfo);
+        const auto tm = memAllocator->AllocateDedicated(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &memoryAllocateInfo);
         texMemory.push_back(tm);
 
         const VkBindImageMemoryInfo bindImageInfo {
             .sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO,
             .pNext = nullptr,
             .image = texImage,
-            .memory = tm,
+            .memory = tm.memory,
             .memoryOffset = 0,
         };
         CHECK_VKCMD(vkBindImageMemory2(vkDevice, 1, &bindImageInfo));
@@ -1173,6 +1420,7 @@ struct Texture {
     )
     {
         m_vkDevice = device;
+        m_memAllocator = memAllocator;
 
         constexpr const VkPhysicalDeviceExternalImageFormatInfo physicalDeviceExternalImageFormatInfo {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_IMAGE_FORMAT_INFO,
@@ -1261,15 +1509,14 @@ struct Texture {
                 .handle = d3d11Tex,
                 .name = nullptr
             };
-            VkDeviceMemory ImageMemory = VK_NULL_HANDLE;
-            memAllocator->Allocate(MemoryRequirements, &ImageMemory, properties, &ImportMemoryWin32HandleInfo);
-            CHECK(ImageMemory != VK_NULL_HANDLE);
+            const auto ImageMemory = memAllocator->AllocateDedicated(MemoryRequirements, properties, &ImportMemoryWin32HandleInfo);
+            CHECK(ImageMemory.IsValid());
 
             const VkBindImageMemoryInfo bindImageMemoryInfo{
                 .sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO,
                 .pNext = nullptr,
                 .image = texImage,
-                .memory = ImageMemory,
+                .memory = ImageMemory.memory,
                 .memoryOffset = 0
             };
             CHECK_VKCMD(vkBindImageMemory2(device, 1, &bindImageMemoryInfo));
@@ -1279,7 +1526,7 @@ struct Texture {
         }
         else
         {
-            const auto AllocateDisjointed = [&](const VkImageAspectFlagBits aspectPlane, std::size_t& totalImageMemSize) -> VkDeviceMemory
+            const auto AllocateDisjointed = [&](const VkImageAspectFlagBits aspectPlane, std::size_t& totalImageMemSize) -> MemoryAllocator::Allocation
             {
                 const VkImagePlaneMemoryRequirementsInfo imagePlaneMemoryRequirementsInfo{
                     .sType = VK_STRUCTURE_TYPE_IMAGE_PLANE_MEMORY_REQUIREMENTS_INFO,
@@ -1316,22 +1563,21 @@ struct Texture {
                     .handle = d3d11Tex,
                     .name = nullptr
                 };
-                VkDeviceMemory ImageMemory = VK_NULL_HANDLE;
-                memAllocator->Allocate(MemoryRequirements, &ImageMemory, properties, &ImportMemoryWin32HandleInfo);
-                CHECK(ImageMemory != VK_NULL_HANDLE);
+                const auto ImageMemory = memAllocator->AllocateDedicated(MemoryRequirements, properties, &ImportMemoryWin32HandleInfo);
+                CHECK(ImageMemory.IsValid());
 
                 return ImageMemory;
             };
 
             std::size_t totalImageMemSize = 0;
             auto disjointMemoryPlane = AllocateDisjointed(VK_IMAGE_ASPECT_PLANE_0_BIT, totalImageMemSize);
-            CHECK(disjointMemoryPlane);
+            CHECK(disjointMemoryPlane.IsValid());
             texMemory.push_back(disjointMemoryPlane);
             totalImageMemSizes.push_back(totalImageMemSize);
 
             totalImageMemSize = 0;
             disjointMemoryPlane = AllocateDisjointed(VK_IMAGE_ASPECT_PLANE_1_BIT, totalImageMemSize);
-            CHECK(disjointMemoryPlane);
+            CHECK(disjointMemoryPlane.IsValid());
             texMemory.push_back(disjointMemoryPlane);
             totalImageMemSizes.push_back(totalImageMemSize);
 
@@ -1352,14 +1598,14 @@ struct Texture {
                     .sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO,
                     .pNext = &bindImagePlaneMemoryInfo[0],
                     .image = texImage,
-                    .memory = texMemory[0],
+                    .memory = texMemory[0].memory,
                     .memoryOffset = 0
                 },
                 VkBindImageMemoryInfo {
                     .sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO,
                     .pNext = &bindImagePlaneMemoryInfo[1],
                     .image = texImage,
-                    .memory = texMemory[1],
+                    .memory = texMemory[1].memory,
                     .memoryOffset = 0
                 },
             };
@@ -1405,7 +1651,7 @@ struct Texture {
             barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
             sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
         }
         else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
             newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
@@ -1641,9 +1887,16 @@ struct RenderTarget {
 
         // Create color image view
         if (colorImage != VK_NULL_HANDLE) {
+            // swapchains may also have storage usage (see SwapchainImageContext::storageTarget) which sRGB
+            // formats do not support, the attachment view is only used as such.
+            constexpr const VkImageViewUsageCreateInfo colorViewUsage {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+                .pNext = nullptr,
+                .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+            };
             const VkImageViewCreateInfo colorViewInfo {
                 .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-                .pNext = nullptr,
+                .pNext = &colorViewUsage,
                 .flags = 0,
                 .image = colorImage,
                 .viewType = viewType,
@@ -1723,6 +1976,14 @@ struct alignas(16) MultiViewProjectionUniform {
 };
 
 // Simple vertex MVP xform & color fragment shader layout
+// push_constant block of videoStream_vert.glsl (std140).
+struct alignas(16) VideoStreamPushConstants {
+    std::array<ALXR::VideoReprojection, 2> videoReprojection;
+    std::uint32_t viewID;
+};
+constexpr const std::uint32_t VideoStreamPushConstantsSize =
+    static_cast<std::uint32_t>(offsetof(VideoStreamPushConstants, viewID) + sizeof(std::uint32_t));
+
 struct PipelineLayout {
     VkPipelineLayout layout{VK_NULL_HANDLE};
 
@@ -1800,7 +2061,7 @@ struct PipelineLayout {
     void CreateVideoStreamLayout
     (
         const VkSamplerYcbcrConversionCreateInfo& conversionInfo,
-        VkDevice device, VkInstance vkinstance, const bool isMultiview
+        VkDevice device, VkInstance vkinstance, const bool /*isMultiview*/
     )
     {
         CHECK(device != VK_NULL_HANDLE && vkinstance != VK_NULL_HANDLE);
@@ -1853,7 +2114,7 @@ struct PipelineLayout {
                 .binding = 0,
                 .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                 .descriptorCount = 1,
-                .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
                 .pImmutableSamplers = &textureSampler,
             }
         };
@@ -1865,19 +2126,20 @@ struct PipelineLayout {
         };
         CHECK_VKCMD(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout));
 
+        // the view index is only read without multiview, the reprojections are used by both.
         constexpr const VkPushConstantRange pcr {
             .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
             .offset = 0,
-            .size = (std::uint32_t)sizeof(std::uint32_t),
+            .size = VideoStreamPushConstantsSize,
         };
-        CHECK(pcr.size <= 128);
+        static_assert(pcr.size <= 128);
         const VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
             .pNext = nullptr,
             .setLayoutCount = 1,
             .pSetLayouts = &descriptorSetLayout,
-            .pushConstantRangeCount = isMultiview ? 0u : 1u,
-            .pPushConstantRanges = isMultiview ? nullptr : &pcr,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pcr,
         };
         CHECK_VKCMD(vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCreateInfo, nullptr, &layout));
     }
@@ -1894,6 +2156,90 @@ struct PipelineLayout {
     VkInstance m_vkinstance{VK_NULL_HANDLE};
 };
 
+// VkPipelineCache kept on disk across runs (see pipeline_cache_file.h), pipelines created from it skip
+// the driver's shader compilation when they were built by an earlier run on the same device and driver.
+struct PipelineCache {
+    VkPipelineCache handle{VK_NULL_HANDLE};
+
+    PipelineCache() = default;
+    ~PipelineCache() { Clear(); }
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    PipelineCache(PipelineCache&&) = delete;
+    PipelineCache& operator=(PipelineCache&&) = delete;
+
+    // An empty cacheDir keeps the cache in memory only.
+    void Create(VkDevice device, VkPhysicalDevice physicalDevice, const std::array<std::uint8_t, VK_UUID_SIZE>& deviceUUID,
+                const std::string& cacheDir) {
+        m_vkDevice = device;
+
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        m_key.deviceUUID = deviceUUID;
+        std::memcpy(m_key.pipelineCacheUUID.data(), props.pipelineCacheUUID, VK_UUID_SIZE);
+        m_key.vendorID = props.vendorID;
+        m_key.deviceID = props.deviceID;
+        m_key.driverVersion = props.driverVersion;
+        m_path = ALXR::PipelineCachePath(cacheDir, m_key);
+
+        const std::vector<std::uint8_t> initialData = m_path.empty() ?
+            std::vector<std::uint8_t>{} : ALXR::LoadPipelineCache(m_path, m_key);
+        VkPipelineCacheCreateInfo cacheInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .initialDataSize = initialData.size(),
+            .pInitialData = initialData.empty() ? nullptr : initialData.data()
+        };
+        if (vkCreatePipelineCache(m_vkDevice, &cacheInfo, nullptr, &handle) != VK_SUCCESS && !initialData.empty()) {
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+            CHECK_VKCMD(vkCreatePipelineCache(m_vkDevice, &cacheInfo, nullptr, &handle));
+        }
+        m_savedSize = initialData.size();
+        Log::Write(Log::Level::Info, Fmt("Vulkan pipeline cache: %s, loaded %zu bytes",
+            m_path.empty() ? "not persisted" : m_path.c_str(), initialData.size()));
+    }
+
+    // Writes the cache to disk if pipelines were added to it since it was loaded or last saved, the data
+    // only grows as pipelines are added. Called after creating pipelines, from any thread.
+    void Save() {
+        if (handle == VK_NULL_HANDLE || m_path.empty())
+            return;
+        std::scoped_lock lock(m_saveMutex);
+        std::size_t size = 0;
+        if (vkGetPipelineCacheData(m_vkDevice, handle, &size, nullptr) != VK_SUCCESS || size == m_savedSize)
+            return;
+        std::vector<std::uint8_t> data(size);
+        const VkResult res = vkGetPipelineCacheData(m_vkDevice, handle, &size, data.data());
+        if ((res != VK_SUCCESS && res != VK_INCOMPLETE) || size == 0)
+            return;
+        if (!ALXR::SavePipelineCache(m_path, m_key, data.data(), size)) {
+            Log::Write(Log::Level::Warning, Fmt("Vulkan pipeline cache: failed to write %s", m_path.c_str()));
+            return;
+        }
+        m_savedSize = size;
+        Log::Write(Log::Level::Verbose, Fmt("Vulkan pipeline cache: saved %zu bytes", size));
+    }
+
+    void Clear() {
+        if (m_vkDevice != VK_NULL_HANDLE && handle != VK_NULL_HANDLE) {
+            Save();
+            vkDestroyPipelineCache(m_vkDevice, handle, nullptr);
+        }
+        handle = VK_NULL_HANDLE;
+        m_vkDevice = VK_NULL_HANDLE;
+    }
+
+   private:
+    VkDevice m_vkDevice{VK_NULL_HANDLE};
+    ALXR::PipelineCacheKey m_key{};
+    std::string m_path{};
+    std::size_t m_savedSize = 0;
+    std::mutex m_saveMutex{};
+};
+
 // Pipeline wrapper for rendering pipeline state
 struct Pipeline {
     VkPipeline pipe{VK_NULL_HANDLE};
@@ -1905,8 +2251,8 @@ struct Pipeline {
 
     //void Dynamic(VkDynamicState state) { dynamicStateEnables.emplace_back(state); }
 
-    void Create(VkDevice device, VkExtent2D size, const PipelineLayout& layout, const RenderPass& rp, const ShaderProgram& sp,
-                const VertexBufferBase* vb = nullptr) {
+    void Create(VkDevice device, VkPipelineCache pipelineCache, VkExtent2D size, const PipelineLayout& layout,
+                const RenderPass& rp, const ShaderProgram& sp, const VertexBufferBase* vb = nullptr) {
         m_vkDevice = device;
 
         const VkPipelineDynamicStateCreateInfo dynamicState {
@@ -2028,7 +2374,7 @@ struct Pipeline {
             .renderPass = rp.pass,
             .subpass = 0,
         };
-        CHECK_VKCMD(vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &pipe));
+        CHECK_VKCMD(vkCreateGraphicsPipelines(m_vkDevice, pipelineCache, 1, &pipeInfo, nullptr, &pipe));
     }
 
     void Clear() {
@@ -2046,8 +2392,103 @@ private:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
 };
 
+// Set 1 of the video compute pass, the swapchain image written as a storage image. Swapchain image contexts
+// allocate their sets with their own identically defined layout, which is compatible with the pipeline's.
+inline VkDescriptorSetLayout CreateStorageImageSetLayout(VkDevice device) {
+    constexpr const VkDescriptorSetLayoutBinding binding {
+        .binding = 0,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .descriptorCount = 1,
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .pImmutableSamplers = nullptr,
+    };
+    const VkDescriptorSetLayoutCreateInfo layoutInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = nullptr,
+        .bindingCount = 1,
+        .pBindings = &binding
+    };
+    VkDescriptorSetLayout setLayout{ VK_NULL_HANDLE };
+    CHECK_VKCMD(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout));
+    return setLayout;
+}
+
+// Video compute pass: samples the video frame (set 0, the video stream layout's) and writes the swapchain
+// image (set 1, see CreateStorageImageSetLayout), reprojections and view index are push constants.
+struct ComputePipeline {
+    VkPipeline pipe{VK_NULL_HANDLE};
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    VkDescriptorSetLayout storageSetLayout{VK_NULL_HANDLE};
+    bool sRGBSwapchain = false; // specialized for swapchains of sRGB formats (written through UNORM views).
+
+    ComputePipeline() = default;
+    ~ComputePipeline() { Clear(); }
+
+    ComputePipeline(const ComputePipeline&) = delete;
+    ComputePipeline& operator=(const ComputePipeline&) = delete;
+    ComputePipeline(ComputePipeline&&) = delete;
+    ComputePipeline& operator=(ComputePipeline&&) = delete;
+
+    bool IsNull() const { return pipe == VK_NULL_HANDLE; }
+
+    void Create(VkDevice device, VkPipelineCache pipelineCache, VkDescriptorSetLayout videoSetLayout,
+                const VkPipelineShaderStageCreateInfo& shaderInfo, const bool isSRGBSwapchain) {
+        CHECK(device != VK_NULL_HANDLE && videoSetLayout != VK_NULL_HANDLE);
+        Clear();
+        m_vkDevice = device;
+        sRGBSwapchain = isSRGBSwapchain;
+
+        storageSetLayout = CreateStorageImageSetLayout(m_vkDevice);
+        const std::array<const VkDescriptorSetLayout, 2> setLayouts{ videoSetLayout, storageSetLayout };
+        constexpr const VkPushConstantRange pcr {
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .offset = 0,
+            .size = VideoStreamPushConstantsSize,
+        };
+        const VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .pNext = nullptr,
+            .setLayoutCount = static_cast<std::uint32_t>(setLayouts.size()),
+            .pSetLayouts = setLayouts.data(),
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pcr,
+        };
+        CHECK_VKCMD(vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCreateInfo, nullptr, &layout));
+
+        const VkComputePipelineCreateInfo pipeInfo {
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .stage = shaderInfo,
+            .layout = layout,
+            .basePipelineHandle = VK_NULL_HANDLE,
+            .basePipelineIndex = -1
+        };
+        CHECK_VKCMD(vkCreateComputePipelines(m_vkDevice, pipelineCache, 1, &pipeInfo, nullptr, &pipe));
+    }
+
+    void Clear() {
+        if (m_vkDevice != VK_NULL_HANDLE) {
+            if (pipe != VK_NULL_HANDLE)
+                vkDestroyPipeline(m_vkDevice, pipe, nullptr);
+            if (layout != VK_NULL_HANDLE)
+                vkDestroyPipelineLayout(m_vkDevice, layout, nullptr);
+            if (storageSetLayout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_vkDevice, storageSetLayout, nullptr);
+        }
+        pipe = VK_NULL_HANDLE;
+        layout = VK_NULL_HANDLE;
+        storageSetLayout = VK_NULL_HANDLE;
+        sRGBSwapchain = false;
+        m_vkDevice = VK_NULL_HANDLE;
+    }
+
+private:
+    VkDevice m_vkDevice{VK_NULL_HANDLE};
+};
+
 struct DepthBuffer {
-    VkDeviceMemory depthMemory{VK_NULL_HANDLE};
+    MemoryAllocator::Allocation depthMemory{};
     VkImage depthImage{VK_NULL_HANDLE};
 
     DepthBuffer() = default;
@@ -2057,13 +2498,11 @@ struct DepthBuffer {
             if (depthImage != VK_NULL_HANDLE) {
                 vkDestroyImage(m_vkDevice, depthImage, nullptr);
             }
-            if (depthMemory != VK_NULL_HANDLE) {
-                vkFreeMemory(m_vkDevice, depthMemory, nullptr);
-            }
+            m_memAllocator->Free(depthMemory);
         }
         depthImage = VK_NULL_HANDLE;
-        depthMemory = VK_NULL_HANDLE;
         m_vkDevice = VK_NULL_HANDLE;
+        m_memAllocator = nullptr;
         m_vkLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     }
 
@@ -2073,6 +2512,7 @@ struct DepthBuffer {
         swap(depthImage, other.depthImage);
         swap(depthMemory, other.depthMemory);
         swap(m_vkDevice, other.m_vkDevice);
+        swap(m_memAllocator, other.m_memAllocator);
         swap(m_vkLayout, other.m_vkLayout);
     }
     DepthBuffer& operator=(DepthBuffer&& other) noexcept {
@@ -2086,6 +2526,7 @@ struct DepthBuffer {
         swap(depthImage, other.depthImage);
         swap(depthMemory, other.depthMemory);
         swap(m_vkDevice, other.m_vkDevice);
+        swap(m_memAllocator, other.m_memAllocator);
         swap(m_vkLayout, other.m_vkLayout);
         return *this;
     }
@@ -2093,6 +2534,7 @@ struct DepthBuffer {
     void Create(VkDevice device, MemoryAllocator* memAllocator, VkFormat depthFormat,
                 const XrSwapchainCreateInfo& swapchainCreateInfo) {
         m_vkDevice = device;
+        m_memAllocator = memAllocator;
         assert(swapchainCreateInfo.arraySize > 0);
         const VkExtent2D size = {swapchainCreateInfo.width, swapchainCreateInfo.height};
         // Create a D32 depthbuffer
@@ -2119,8 +2561,8 @@ struct DepthBuffer {
 
         VkMemoryRequirements memRequirements{};
         vkGetImageMemoryRequirements(device, depthImage, &memRequirements);
-        memAllocator->Allocate(memRequirements, &depthMemory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        CHECK_VKCMD(vkBindImageMemory(device, depthImage, depthMemory, 0));
+        depthMemory = memAllocator->Allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryAllocator::Tiling::Optimal);
+        CHECK_VKCMD(vkBindImageMemory(device, depthImage, depthMemory.memory, depthMemory.offset));
     }
 
     void TransitionLayout(CmdBuffer* cmdBuffer, VkImageLayout newLayout) {
@@ -2147,9 +2589,153 @@ struct DepthBuffer {
 
    private:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
+    MemoryAllocator* m_memAllocator{nullptr};
     VkImageLayout m_vkLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 };
 
+// Storage images can't have sRGB formats, swapchains of sRGB formats are written through views of the
+// UNORM format (they must be created with mutable format usage).
+constexpr inline VkFormat StorageViewFormat(const VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_B8G8R8A8_SRGB: return VK_FORMAT_B8G8R8A8_UNORM;
+    case VK_FORMAT_R8G8B8A8_SRGB: return VK_FORMAT_R8G8B8A8_UNORM;
+    default: return format;
+    }
+}
+
+constexpr inline bool IsSRGBFormat(const VkFormat format) {
+    return StorageViewFormat(format) != format;
+}
+
+// The swapchain images bound as storage images for the video compute pass, views and descriptor sets are
+// created on first use like the render targets.
+struct StorageTargetSet {
+    VkFormat format{VK_FORMAT_UNDEFINED}; // undefined if the swapchain has no storage usage.
+
+    StorageTargetSet() = default;
+    ~StorageTargetSet() { Clear(); }
+
+    StorageTargetSet(const StorageTargetSet&) = delete;
+    StorageTargetSet& operator=(const StorageTargetSet&) = delete;
+    StorageTargetSet(StorageTargetSet&&) = delete;
+    StorageTargetSet& operator=(StorageTargetSet&&) = delete;
+
+    bool IsNull() const { return format == VK_FORMAT_UNDEFINED; }
+
+    void Create(VkDevice device, const VkFormat storageFormat, const std::uint32_t capacity) {
+        Clear();
+        m_vkDevice = device;
+        format = storageFormat;
+        m_setLayout = CreateStorageImageSetLayout(m_vkDevice);
+
+        const VkDescriptorPoolSize poolSize {
+            .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = capacity,
+        };
+        const VkDescriptorPoolCreateInfo poolInfo {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .maxSets = capacity,
+            .poolSizeCount = 1,
+            .pPoolSizes = &poolSize
+        };
+        CHECK_VKCMD(vkCreateDescriptorPool(m_vkDevice, &poolInfo, nullptr, &m_descriptorPool));
+        m_views.resize(capacity, VK_NULL_HANDLE);
+        m_sets.resize(capacity, VK_NULL_HANDLE);
+    }
+
+    VkDescriptorSet Bind(const std::uint32_t index, VkImage image, const std::uint32_t arraySize) {
+        assert(!IsNull() && index < m_sets.size());
+        if (m_sets[index] != VK_NULL_HANDLE)
+            return m_sets[index];
+
+        constexpr const VkImageViewUsageCreateInfo viewUsage {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+            .pNext = nullptr,
+            .usage = VK_IMAGE_USAGE_STORAGE_BIT
+        };
+        const VkImageViewCreateInfo viewInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = &viewUsage,
+            .flags = 0,
+            .image = image,
+            .viewType = arraySize > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+            .format = format,
+            .components {
+                .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                .a = VK_COMPONENT_SWIZZLE_IDENTITY
+            },
+            .subresourceRange {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = arraySize
+            }
+        };
+        CHECK_VKCMD(vkCreateImageView(m_vkDevice, &viewInfo, nullptr, &m_views[index]));
+
+        const VkDescriptorSetAllocateInfo allocInfo {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .descriptorPool = m_descriptorPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &m_setLayout
+        };
+        CHECK_VKCMD(vkAllocateDescriptorSets(m_vkDevice, &allocInfo, &m_sets[index]));
+
+        const VkDescriptorImageInfo imageInfo {
+            .sampler = VK_NULL_HANDLE,
+            .imageView = m_views[index],
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL
+        };
+        const VkWriteDescriptorSet descriptorWrite {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext = nullptr,
+            .dstSet = m_sets[index],
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = &imageInfo,
+            .pBufferInfo = nullptr,
+            .pTexelBufferView = nullptr
+        };
+        vkUpdateDescriptorSets(m_vkDevice, 1, &descriptorWrite, 0, nullptr);
+        return m_sets[index];
+    }
+
+    void Clear() {
+        if (m_vkDevice != VK_NULL_HANDLE) {
+            for (const VkImageView view : m_views) {
+                if (view != VK_NULL_HANDLE)
+                    vkDestroyImageView(m_vkDevice, view, nullptr);
+            }
+            // frees the sets.
+            if (m_descriptorPool != VK_NULL_HANDLE)
+                vkDestroyDescriptorPool(m_vkDevice, m_descriptorPool, nullptr);
+            if (m_setLayout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_vkDevice, m_setLayout, nullptr);
+        }
+        m_views.clear();
+        m_sets.clear();
+        m_descriptorPool = VK_NULL_HANDLE;
+        m_setLayout = VK_NULL_HANDLE;
+        format = VK_FORMAT_UNDEFINED;
+        m_vkDevice = VK_NULL_HANDLE;
+    }
+
+   private:
+    VkDevice m_vkDevice{VK_NULL_HANDLE};
+    VkDescriptorSetLayout m_setLayout{VK_NULL_HANDLE};
+    VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+    std::vector<VkImageView> m_views{};
+    std::vector<VkDescriptorSet> m_sets{};
+};
+
 struct SwapchainImageContext {
     SwapchainImageContext(XrStructureType _swapchainImageType) : swapchainImageType(_swapchainImageType) {}
 
@@ -2160,14 +2746,16 @@ struct SwapchainImageContext {
     DepthBuffer depthBuffer{};
     RenderPass rp{};
     Pipeline pipe{};
+    StorageTargetSet storageTarget{};
     XrStructureType swapchainImageType;
+    VkFormat format{VK_FORMAT_UNDEFINED};
     std::uint32_t arraySize = 0;
 
     SwapchainImageContext() = default;
 
     std::vector<XrSwapchainImageBaseHeader*> Create
     (
-        VkDevice device, MemoryAllocator* memAllocator, uint32_t capacity,
+        VkDevice device, MemoryAllocator* memAllocator, VkPipelineCache pipelineCache, uint32_t capacity,
         const XrSwapchainCreateInfo& swapchainCreateInfo, const PipelineLayout& layout,
         const ShaderProgram& sp, const VertexBuffer<Geometry::Vertex>& vb
     )
@@ -2180,10 +2768,14 @@ struct SwapchainImageContext {
         const VkFormat colorFormat = static_cast<VkFormat>(swapchainCreateInfo.format);
         const VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
         // XXX handle swapchainCreateInfo.sampleCount
+        format = colorFormat;
         
         depthBuffer.Create(m_vkDevice, memAllocator, depthFormat, swapchainCreateInfo);
         rp.Create(m_vkDevice, colorFormat, depthFormat, arraySize);
-        pipe.Create(m_vkDevice, size, layout, rp, sp, &vb);
+        pipe.Create(m_vkDevice, pipelineCache, size, layout, rp, sp, &vb);
+        // created with the usage flags of VulkanGraphicsPlugin::GetExtraSwapchainUsageFlags.
+        if ((swapchainCreateInfo.usageFlags & XR_SWAPCHAIN_USAGE_UNORDERED_ACCESS_BIT) != 0)
+            storageTarget.Create(m_vkDevice, StorageViewFormat(colorFormat), capacity);
 
         swapchainImages.resize(capacity);
         renderTarget.resize(capacity);
@@ -2200,11 +2792,6 @@ struct SwapchainImageContext {
         return bases;
     }
 
-    uint32_t ImageIndex(const XrSwapchainImageBaseHeader* swapchainImageHeader) const {
-        const auto p = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImageHeader);
-        return (uint32_t)(p - &swapchainImages[0]);
-    }
-
     inline void BindRenderTarget(const std::uint32_t index, VkRenderPassBeginInfo& renderPassBeginInfo) {
         if (renderTarget[index].fb == VK_NULL_HANDLE) {
             renderTarget[index].Create(m_vkDevice, swapchainImages[index].image, depthBuffer.depthImage, size, rp);
@@ -2215,6 +2802,10 @@ struct SwapchainImageContext {
         renderPassBeginInfo.renderArea.extent = size;
     }
 
+    inline VkDescriptorSet BindStorageTarget(const std::uint32_t index) {
+        return storageTarget.Bind(index, swapchainImages[index].image, arraySize);
+    }
+
    private:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
 };
@@ -2464,7 +3055,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         if (options) {
             m_noServerFramerateLock = options->NoServerFramerateLock;
             m_noFrameSkip = options->NoFrameSkip;
+            m_videoJitterDepth = std::min(options->VideoJitterBufferDepth, VideoJitterBuffer::MaxDepth);
+            m_pipelineCacheDir = options->PipelineCacheDir;
+            m_videoComputeRequested = options->VideoComputePass;
         }
+        if (m_pipelineCacheDir.empty())
+            m_pipelineCacheDir = ALXR::DefaultPipelineCacheDir();
+        m_videoJitterBuffer.Reset({ .depth = m_videoJitterDepth, .noSkip = m_noFrameSkip });
     };
 
     std::vector<std::string> GetInstanceExtensions() const override { return { XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME }; }
@@ -2794,6 +3391,19 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         VkPhysicalDeviceFeatures features{};
         // features.samplerAnisotropy = VK_TRUE;
+#ifdef ALXR_VIDEO_COMPUTE_SHADERS
+        if (m_videoComputeRequested) {
+            // the compute pass writes storage images without a format qualifier, swapchain formats vary.
+            VkPhysicalDeviceFeatures supportedFeatures{};
+            vkGetPhysicalDeviceFeatures(m_vkPhysicalDevice, &supportedFeatures);
+            m_isVideoComputeSupported = supportedFeatures.shaderStorageImageWriteWithoutFormat == VK_TRUE;
+            features.shaderStorageImageWriteWithoutFormat = supportedFeatures.shaderStorageImageWriteWithoutFormat;
+        }
+#endif
+        if (m_videoComputeRequested) {
+            Log::Write(Log::Level::Info, Fmt("VulkanGraphicsPlugin: video compute pass %s",
+                m_isVideoComputeSupported ? "enabled" : "not supported, using the render pass"));
+        }
         VkPhysicalDeviceVulkan11Features features11 {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
             .pNext = nullptr,
@@ -2833,6 +3443,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         CHECK(m_VideoCpyQueue != VK_NULL_HANDLE);
 
         m_memAllocator.Init(m_vkPhysicalDevice, m_vkDevice);
+        m_pipelineCache.Create(m_vkDevice, m_vkPhysicalDevice, m_vkDeviceUUID, m_pipelineCacheDir);
 
         InitializeResources();
 
@@ -3024,8 +3635,40 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 vidShader.LoadFragmentShader(fragShader);
             }
         }
+#ifdef ALXR_VIDEO_COMPUTE_SHADERS
+        if (m_isVideoComputeSupported) {
+            std::array<CodeBuffer, VideoFragShaderType::TypeCount> computeShaders;
+            if (IsMultiViewEnabled()) {
+                computeShaders = {{
+                    SPV_PREFIX
+                        #include "shaders/multiview/videoStream_comp.spv"
+                    SPV_SUFFIX,
+                    SPV_PREFIX
+                        #include "shaders/multiview/fovDecode/videoStream_comp.spv"
+                    SPV_SUFFIX
+                }};
+            }
+            else {
+                computeShaders = {{
+                    SPV_PREFIX
+                        #include "shaders/videoStream_comp.spv"
+                    SPV_SUFFIX,
+                    SPV_PREFIX
+                        #include "shaders/fovDecode/videoStream_comp.spv"
+                    SPV_SUFFIX
+                }};
+            }
+            for (const auto shaderType : { VideoFragShaderType::Normal,
+                                           VideoFragShaderType::FoveatedDecode }) {
+                m_videoComputeShaders[shaderType].Load(m_vkDevice, computeShaders[shaderType]);
+            }
+        }
+#endif
 
         if (!m_videoCpyCmdBuffer.Init(m_vkDevice, m_queueFamilyIndexVideoCpy)) THROW("Failed to create command buffer");
+        for (auto& stagingSlot : m_videoStagingRing) {
+            if (!stagingSlot.cmdBuffer.Init(m_vkDevice, m_queueFamilyIndexVideoCpy)) THROW("Failed to create command buffer");
+        }
     }
 
     using CodeBuffer = ShaderProgram::CodeBuffer;
@@ -3062,6 +3705,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         m_shaderProgram.LoadFragmentShader(fragmentSPIRV);
 
         if (!m_cmdBuffer.Init(m_vkDevice, m_queueFamilyIndex)) THROW("Failed to create command buffer");
+        for (auto& frameCommands : m_frameCommands) {
+            if (!frameCommands.cmdBuffer.Init(m_vkDevice, m_queueFamilyIndex)) THROW("Failed to create frame command buffer");
+        }
 
         m_pipelineLayout.Create(m_vkDevice, m_vkInstance, m_isMultiViewSupported);
 
@@ -3104,33 +3750,66 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         return *swapchainFormatIt;
     }
 
+    XrSwapchainUsageFlags GetExtraSwapchainUsageFlags(const std::int64_t swapchainFormat) const override {
+        if (!m_isVideoComputeSupported)
+            return 0;
+        const VkFormat storageFormat = StorageViewFormat(static_cast<VkFormat>(swapchainFormat));
+        VkFormatProperties formatProps{};
+        vkGetPhysicalDeviceFormatProperties(m_vkPhysicalDevice, storageFormat, &formatProps);
+        if ((formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) == 0)
+            return 0;
+        return XR_SWAPCHAIN_USAGE_UNORDERED_ACCESS_BIT |
+            (IsSRGBFormat(static_cast<VkFormat>(swapchainFormat)) ? XR_SWAPCHAIN_USAGE_MUTABLE_FORMAT_BIT : 0);
+    }
+
     const XrBaseInStructure* GetGraphicsBinding() const override {
         return reinterpret_cast<const XrBaseInStructure*>(&m_graphicsBinding);
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo) override {
+        const std::uint32_t swapchainSlot, uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
-        // Keep the buffer alive by adding it into the list of buffers.
-        m_swapchainImageContexts.emplace_back(GetSwapchainImageType());
-        SwapchainImageContext& swapchainImageContext = m_swapchainImageContexts.back();
-
-        std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext.Create(
-            m_vkDevice, &m_memAllocator, capacity, swapchainCreateInfo, m_pipelineLayout, m_shaderProgram, m_drawBuffer);
-
-        // Map every swapchainImage base pointer to this context
-        for (auto& base : bases) {
-            m_swapchainImageContextMap[base] = &swapchainImageContext;
-        }
+        // Keep the buffer alive by adding it into the published set of contexts.
+        const auto swapchainImageContext = std::make_shared<SwapchainImageContext>(GetSwapchainImageType());
+
+        std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext->Create(
+            m_vkDevice, &m_memAllocator, m_pipelineCache.handle, capacity, swapchainCreateInfo, m_pipelineLayout, m_shaderProgram, m_drawBuffer);
+        m_pipelineCache.Save();
+
+        const SwapchainImageContextSet* const currentSet = m_swapchainImageContexts.load();
+        auto newSet = currentSet ?
+            std::make_unique<SwapchainImageContextSet>(*currentSet) :
+            std::make_unique<SwapchainImageContextSet>();
+        newSet->contexts.push_back(swapchainImageContext);
+        CHECK(newSet->Find(swapchainSlot) == nullptr && swapchainSlot < newSet->slots.size());
+        newSet->slots[swapchainSlot] = swapchainImageContext.get();
+        m_swapchainImageContexts.exchange(std::move(newSet), xrconcurrency::render_rcu_domain());
 
         return bases;
     }
 
+    virtual void ReleaseSwapchainImageStructs(const std::uint32_t swapchainSlot) override
+    {
+        const SwapchainImageContextSet* const currentSet = m_swapchainImageContexts.load();
+        if (currentSet == nullptr)
+            return;
+        const SwapchainImageContext* const releasedContext = currentSet->Find(swapchainSlot);
+        if (releasedContext == nullptr)
+            return;
+        auto newSet = std::make_unique<SwapchainImageContextSet>(*currentSet);
+        std::erase_if(newSet->contexts, [&](const auto& context) { return context.get() == releasedContext; });
+        newSet->slots[swapchainSlot] = nullptr;
+        // the released context is destroyed with the set it was last part of, after its last frame completed.
+        const auto oldSet = m_swapchainImageContexts.exchange(std::move(newSet), xrconcurrency::render_rcu_domain());
+        WaitForFramesInFlight();
+    }
+
     virtual void ClearSwapchainImageStructs() override
     {
-        m_swapchainImageContextMap.clear();
-        m_swapchainImageContexts.clear();
+        const auto oldSet = m_swapchainImageContexts.exchange(nullptr, xrconcurrency::render_rcu_domain());
+        if (oldSet != nullptr)
+            WaitForFramesInFlight();
     }
 
     static inline void MakeViewProjMatrix(XrMatrix4x4f& vp, const XrCompositionLayerProjectionView& layerView) {
@@ -3146,43 +3825,90 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         XrMatrix4x4f_Multiply(&vp, &proj, &view);
     }
 
-    template < typename RenderFunc >
-    inline void RenderViewImpl(const XrSwapchainImageBaseHeader* swapchainImage, RenderFunc&& renderFun) {
-
-        const auto swapchainContextPtr = m_swapchainImageContextMap[swapchainImage];
-        assert(swapchainContextPtr != nullptr);
-        const std::uint32_t imageIndex = swapchainContextPtr->ImageIndex(swapchainImage);
-
-        if (m_cmdBufferWaitNextFrame) {
-            m_cmdBuffer.Wait();
-        }
-        m_cmdBuffer.Reset();
+    // Frames in flight: the views of a frame are recorded into the command buffer of the next frame slot
+    // and submitted together by SubmitViews, the CPU only waits on a slot's fence when it is about to reuse
+    // it, by then the GPU has usually finished the frame. Returns the slot's command buffer, recording.
+    CmdBuffer& BeginFrameCommands() {
+        std::scoped_lock frameLock(m_frameCommandsMutex);
+        FrameCommands& frameCommands = m_frameCommands[m_frameCommandsIndex];
+        if (frameCommands.cmdBuffer.state == CmdBuffer::CmdBufferState::Recording)
+            return frameCommands.cmdBuffer;
+        if (frameCommands.cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+            frameCommands.cmdBuffer.Wait();
 #ifdef XR_USE_PLATFORM_ANDROID
-        m_videoTextures[VidTextureIndex::DeferredDelete].Clear();
+        frameCommands.retiredVideoTextures.clear();
 #endif
-        m_cmdBuffer.Begin();
-
-        // Ensure depth is in the right layout
-        swapchainContextPtr->depthBuffer.TransitionLayout(&m_cmdBuffer, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-
-        renderFun(imageIndex, *swapchainContextPtr);
+        frameCommands.cmdBuffer.Reset();
+        frameCommands.cmdBuffer.Begin();
+        frameCommands.videoCopyValue = 0;
+        frameCommands.videoTexIndex = std::size_t(-1);
+        return frameCommands.cmdBuffer;
+    }
 
-        m_cmdBuffer.End();
-#if 1 //#ifdef XR_USE_PLATFORM_ANDROID
-        m_cmdBuffer.Exec(m_vkQueue);
+    virtual void SubmitViews() override {
+        std::scoped_lock frameLock(m_frameCommandsMutex);
+        FrameCommands& frameCommands = m_frameCommands[m_frameCommandsIndex];
+        if (frameCommands.cmdBuffer.state != CmdBuffer::CmdBufferState::Recording)
+            return;
+        frameCommands.cmdBuffer.End();
+#ifdef XR_USE_PLATFORM_ANDROID
+        frameCommands.cmdBuffer.Exec(m_vkQueue);
 #else
-        m_cmdBuffer.Exec<1, 1>(m_vkQueue, { &m_texRendereComplete }, { &m_texCopy }, { VK_PIPELINE_STAGE_ALL_COMMANDS_BIT });
+        // video uploads are not waited on by the decoder thread, only wait for the upload of the bound video texture.
+        // Every frame signals m_texRendereComplete, the next upload to the texture it sampled waits for that value.
+        frameCommands.cmdBuffer.ExecWaitValue(m_vkQueue, m_texCopy, frameCommands.videoCopyValue,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, m_texRendereComplete);
+        if (frameCommands.videoTexIndex != std::size_t(-1))
+            m_videoTexRenderValues[frameCommands.videoTexIndex].store(m_texRendereComplete.fenceValue.load());
 #endif
         if (!m_cmdBufferWaitNextFrame) {
-            m_cmdBuffer.Wait();
+            frameCommands.cmdBuffer.Wait();
         }
+        m_frameCommandsIndex = (m_frameCommandsIndex + 1) % FramesInFlight;
 
 #if defined(USE_MIRROR_WINDOW)
-        // Cycle the window's swapchain on the last view rendered
-        if (swapchainContext == &m_swapchainImageContexts.back()) {
-            m_swapchain.Acquire();
-            m_swapchain.Present(m_vkQueue);
+        // Cycle the window's swapchain once per frame
+        m_swapchain.Acquire();
+        m_swapchain.Present(m_vkQueue);
+#endif
+    }
+
+    // Host threads: blocks until every frame submitted so far has completed, before freeing resources
+    // (swapchain image contexts, video textures) which were only unpublished from the render thread.
+    void WaitForFramesInFlight() {
+        std::scoped_lock frameLock(m_frameCommandsMutex);
+        for (auto& frameCommands : m_frameCommands) {
+            if (frameCommands.cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+                frameCommands.cmdBuffer.Wait();
+        }
+    }
+
+    template < typename RenderFunc >
+    // Lobby views do not touch video state, it may be cleared (see ClearVideoTextures) while they render.
+    inline void RenderViewImpl(const SwapchainImageRef& swapchainImage, const bool isVideoView, RenderFunc&& renderFun) {
+
+        const SwapchainImageContextSet* const swapchainContexts = m_swapchainImageContexts.load();
+        SwapchainImageContext* const swapchainContextPtr = swapchainContexts ? swapchainContexts->Find(swapchainImage.slot) : nullptr;
+        if (swapchainContextPtr == nullptr)
+            return;
+        const std::uint32_t imageIndex = swapchainImage.imageIndex;
+        assert(imageIndex < swapchainContextPtr->swapchainImages.size());
+
+        CmdBuffer& cmdBuffer = BeginFrameCommands();
+
+        // Ensure depth is in the right layout
+        swapchainContextPtr->depthBuffer.TransitionLayout(&cmdBuffer, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+        renderFun(imageIndex, *swapchainContextPtr, cmdBuffer);
+
+#ifndef XR_USE_PLATFORM_ANDROID
+        if (isVideoView) {
+            auto& frameCommands = m_frameCommands[m_frameCommandsIndex];
+            frameCommands.videoCopyValue = std::max(frameCommands.videoCopyValue, BoundVideoTextureCopyValue());
+            frameCommands.videoTexIndex = textureIdx;
         }
+#else
+        (void)isVideoView;
 #endif
     }
 
@@ -3249,13 +3975,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     void RenderMultiView
     (
         const std::array<XrCompositionLayerProjectionView, 2>& layerViews,
-        const XrSwapchainImageBaseHeader* swapchainImage,
+        const SwapchainImageRef& swapchainImage,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode newMode,
         const std::vector<Cube>& cubes
     ) override {
         assert(m_isMultiViewSupported);
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, false, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = ConstClearValues[ClearValueIndex(newMode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -3267,14 +3993,14 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             // Bind and clear eye render target
             swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
 
             // Bind index and vertex buffers
-            vkCmdBindIndexBuffer(m_cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
             constexpr const VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(m_cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
+            vkCmdBindVertexBuffers(cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
 
             // Compute the view-projection transform.
             // Note all matrixes (including OpenXR's) are column-major, right-handed.
@@ -3292,24 +4018,24 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                     XrMatrix4x4f_CreateTranslationRotationScale(&model, &cube.Pose.position, &cube.Pose.orientation, &cube.Scale);
                     XrMatrix4x4f_Multiply(&mvps.mvp[viewIndex], &vps[viewIndex], &model);
                 }
-                vkCmdPushConstants(m_cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MultiViewProjectionUniform), &mvps);
+                vkCmdPushConstants(cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MultiViewProjectionUniform), &mvps);
 
                 // Draw the cube.
-                vkCmdDrawIndexed(m_cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
+                vkCmdDrawIndexed(cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
             }
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
     void RenderView
     (
-        const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
+        const XrCompositionLayerProjectionView& layerView, const SwapchainImageRef& swapchainImage,
         const std::int64_t /*swapchainFormat*/, const PassthroughMode newMode,
         const std::vector<Cube>& cubes
     ) override {
         assert(layerView.subImage.imageArrayIndex == 0);  // Texture arrays not supported.
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, false, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = ConstClearValues[ClearValueIndex(newMode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -3321,13 +4047,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             // Bind and clear eye render target
             swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
 
             // Bind index and vertex buffers
-            vkCmdBindIndexBuffer(m_cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
             constexpr const VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(m_cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
+            vkCmdBindVertexBuffers(cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
 
             // Compute the view-projection transform.
             // Note all matrixes (including OpenXR's) are column-major, right-handed.
@@ -3341,13 +4067,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 XrMatrix4x4f_CreateTranslationRotationScale(&model, &cube.Pose.position, &cube.Pose.orientation, &cube.Scale);
                 XrMatrix4x4f mvp;
                 XrMatrix4x4f_Multiply(&mvp, &vp, &model);
-                vkCmdPushConstants(m_cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mvp.m), &mvp.m[0]);
+                vkCmdPushConstants(cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mvp.m), &mvp.m[0]);
 
                 // Draw the cube.
-                vkCmdDrawIndexed(m_cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
+                vkCmdDrawIndexed(cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
             }
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
@@ -3422,7 +4148,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         return (w * h * LumaSize(format)) + (((w * h) / 2) * ChromaSize(format));
     }
 
-    VkDeviceSize createStaggingBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+    VkDeviceSize createStaggingBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, MemoryAllocator::Allocation& bufferMemory)
     {
         const VkBufferCreateInfo bufferInfo {
             .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -3434,9 +4160,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         VkMemoryRequirements memRequirements{};
         vkGetBufferMemoryRequirements(m_vkDevice, buffer, &memRequirements);
-        m_memAllocator.Allocate(memRequirements, &bufferMemory, properties);
+        bufferMemory = m_memAllocator.Allocate(memRequirements, properties);
 
-        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, buffer, bufferMemory, 0));
+        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, buffer, bufferMemory.memory, bufferMemory.offset));
 
         return memRequirements.size;
     }
@@ -3461,7 +4187,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         if (m_descriptorPool != VK_NULL_HANDLE ||
             m_vkDevice == VK_NULL_HANDLE)
             return;
-        const std::uint32_t swapChainCount = static_cast<uint32_t>(m_swapchainImageContexts.back().swapchainImages.size());
+        const std::uint32_t swapChainCount = static_cast<uint32_t>(m_swapchainImageContexts.load()->Last().swapchainImages.size());
         
         const std::array<const VkDescriptorPoolSize, 1> poolSizes{
             VkDescriptorPoolSize {
@@ -3495,6 +4221,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         VkBool32 enableSRGBLinearize;
         float alphaValue;     // Blend or Mask mode.
         XrVector3f keyColour; // Mask Mode only.
+        VkBool32 sRGBSwapchain; // compute pass only, constant_id 9 (passthrough modes are not computed).
     };
     using SpecializationMap = std::vector<VkSpecializationMapEntry>;
     SpecializationMap MakeSpecializationMap
@@ -3584,8 +4311,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             VideoFragShaderType::FoveatedDecode :
             VideoFragShaderType::Normal;
 
-        CHECK(m_swapchainImageContexts.size() > 0);
-        const auto& swapChainInfo = m_swapchainImageContexts.back();
+        const SwapchainImageContextSet* const swapchainContexts = m_swapchainImageContexts.load();
+        CHECK(swapchainContexts != nullptr && swapchainContexts->contexts.size() > 0);
+        const auto& swapChainInfo = swapchainContexts->Last();
         std::size_t pipelineIdx = 0;
         auto& shaderList = m_videoShaders[shaderType];
         assert(shaderList.size() <= m_videoStreamPipelines.size());
@@ -3614,6 +4342,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             m_videoStreamPipelines[pipelineIdx++].Create
             (
                 m_vkDevice,
+                m_pipelineCache.handle,
                 swapChainInfo.size,
                 m_videoStreamLayout,
                 swapChainInfo.rp,
@@ -3622,9 +4351,113 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             // null-out pSpecializationInfo as it refers to local stack vars.
             fragShaderInfo.pSpecializationInfo = nullptr;
         }
+        CreateVideoComputePipeline(shaderType, IsSRGBFormat(swapChainInfo.format));
+        m_pipelineCache.Save();
         CreateImageDescriptorSetLayouts();
     }
 
+    void CreateVideoComputePipeline(const VideoFragShaderType shaderType, const bool isSRGBSwapchain)
+    {
+        const auto& computeShader = m_videoComputeShaders[shaderType];
+        if (computeShader.IsNull())
+            return;
+        const auto fovDecodeParamPtr = m_fovDecodeParams;
+        const SpecializationData specializationConst{
+            .fdParams = fovDecodeParamPtr ? *fovDecodeParamPtr : ALXR::FoveatedDecodeParams{},
+            .enableSRGBLinearize = m_enableSRGBLinearize,
+            .alphaValue = 0.0f,
+            .keyColour = {},
+            .sRGBSwapchain = isSRGBSwapchain ? VK_TRUE : VK_FALSE
+        };
+        auto specializationMap = MakeSpecializationMap(fovDecodeParamPtr != nullptr, PassthroughMode::None);
+        specializationMap.push_back({
+            .constantID = 9,
+            .offset = offsetof(SpecializationData, sRGBSwapchain),
+            .size = sizeof(VkBool32)
+        });
+        const VkSpecializationInfo specializationInfo{
+            .mapEntryCount = (std::uint32_t)specializationMap.size(),
+            .pMapEntries = specializationMap.data(),
+            .dataSize = sizeof(specializationConst),
+            .pData = &specializationConst
+        };
+        VkPipelineShaderStageCreateInfo shaderInfo = computeShader.shaderInfo;
+        shaderInfo.pSpecializationInfo = &specializationInfo;
+        m_videoComputePipeline.Create(m_vkDevice, m_pipelineCache.handle, m_videoStreamLayout.descriptorSetLayout,
+                                      shaderInfo, isSRGBSwapchain);
+    }
+
+    // Swapchains created with storage usage get the video written by one compute dispatch (per view without
+    // multiview), skipping the render pass, clear and depth buffer. Passthrough modes use the render pass.
+    inline bool UseVideoComputePass(const SwapchainImageContext& swapchainContext, const PassthroughMode mode) const {
+        return mode == PassthroughMode::None &&
+            !m_videoComputePipeline.IsNull() &&
+            !swapchainContext.storageTarget.IsNull() &&
+            m_videoComputePipeline.sRGBSwapchain == IsSRGBFormat(swapchainContext.format);
+    }
+
+    void RecordVideoComputePass
+    (
+        CmdBuffer& cmdBuffer, const std::uint32_t imageIndex,
+        SwapchainImageContext& swapchainContext, const std::uint32_t viewID
+    )
+    {
+        const VkDescriptorSet storageSet = swapchainContext.BindStorageTarget(imageIndex);
+        const VkImage image = swapchainContext.swapchainImages[imageIndex].image;
+        const VkImageSubresourceRange subresourceRange {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = swapchainContext.arraySize
+        };
+        // every pixel is written, the previous contents are discarded.
+        const VkImageMemoryBarrier toGeneral {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = subresourceRange
+        };
+        vkCmdPipelineBarrier(cmdBuffer.buf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &toGeneral);
+
+        const std::array<const VkDescriptorSet, 2> descriptorSets{ m_descriptorSets[0], storageSet };
+        vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_COMPUTE, m_videoComputePipeline.pipe);
+        vkCmdBindDescriptorSets(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_COMPUTE, m_videoComputePipeline.layout, 0,
+                                (std::uint32_t)descriptorSets.size(), descriptorSets.data(), 0, nullptr);
+
+        const VideoStreamPushConstants pushConstants{ .videoReprojection = m_videoReprojection, .viewID = viewID };
+        vkCmdPushConstants(cmdBuffer.buf, m_videoComputePipeline.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, VideoStreamPushConstantsSize, &pushConstants);
+        // local size of videoStream_comp.glsl, with multiview z is the view.
+        constexpr const std::uint32_t GroupSize = 8;
+        vkCmdDispatch(cmdBuffer.buf,
+            (swapchainContext.size.width  + GroupSize - 1) / GroupSize,
+            (swapchainContext.size.height + GroupSize - 1) / GroupSize,
+            swapchainContext.arraySize);
+
+        // the layout the render pass leaves swapchain images in, what the runtime expects on release.
+        const VkImageMemoryBarrier toColorAttachment {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = 0,
+            .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+            .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image,
+            .subresourceRange = subresourceRange
+        };
+        vkCmdPipelineBarrier(cmdBuffer.buf, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &toColorAttachment);
+    }
+
     void CreateVideoStreamPipeline(const VkFormat pixFmt)
     {
         CHECK(pixFmt != VkFormat::VK_FORMAT_UNDEFINED);
@@ -3657,6 +4490,14 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             std::make_shared<ALXR::FoveatedDecodeParams>(*fovDecParm) : nullptr;
     }
 
+    virtual bool SetVideoReprojection(const ALXR::VideoReprojection* reprojections) override {
+        for (std::uint32_t viewIndex = 0; viewIndex < m_videoReprojection.size(); ++viewIndex) {
+            m_videoReprojection[viewIndex] = reprojections ?
+                reprojections[viewIndex] : ALXR::MakeIdentityVideoReprojection(viewIndex);
+        }
+        return true;
+    }
+
     virtual void SetCmdBufferWaitNextFrame(const bool enable) override {
         m_cmdBufferWaitNextFrame = enable;
     }
@@ -3679,25 +4520,41 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
     constexpr static const std::size_t VideoQueueSize = 2;
 
+    // The decoder thread (the only uploader) must have been stopped first, the upload state below is
+    // reset without synchronizing with it.
     virtual void ClearVideoTextures() override
     {
 #ifdef XR_ENABLE_CUDA_INTEROP
         ClearVideoTexturesCUDA();
 #endif
-        m_renderTex = std::size_t(-1);
-        m_currentVideoTex = 0;
-        
-        //m_texRendereComplete.WaitForGpu();
-        m_videoTextures = { VideoTexture {}, VideoTexture {} };
+        // frames still executing may sample the video textures destroyed below.
+        WaitForFramesInFlight();
+        WaitForVideoUploads();
+        m_videoDecoderTex = 0;
+        m_videoMailbox = 1;
+        m_videoFrontTex = 2;
+        LogVideoUploadStats();
+        LogVideoJitterStats();
+        m_memAllocator.LogStats();
+        for (auto& stagingSlot : m_videoStagingRing)
+            stagingSlot.Clear();
+        m_videoStagingIndex = 0;
+        m_videoJitterBuffer.Reset({ .depth = m_videoJitterDepth, .noSkip = m_noFrameSkip });
+        m_videoDisplayTimeNs = 0;
+        m_videoTextures = {};
+        for (auto& copyValue : m_videoTexCopyValues)
+            copyValue.store(0);
+        for (auto& renderValue : m_videoTexRenderValues)
+            renderValue.store(0);
 #ifdef XR_USE_PLATFORM_ANDROID
         m_videoTexQueue = VideoTextureQueue(VideoQueueSize);
-#else
+#endif
         m_lastTexIndex = std::size_t(-1);
         textureIdx = std::size_t(-1);
-#endif
         ClearImageDescriptorSetLayouts();
         for (auto& pipeline : m_videoStreamPipelines)
             pipeline.Clear();
+        m_videoComputePipeline.Clear();
         m_videoStreamLayout.Clear();
     }
 
@@ -3707,19 +4564,31 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         CreateVideoStreamPipeline(pixelFmt);
 
         const VkDeviceSize texSize = StagingBufferSize(width, height, pixelFmt);
-        for (auto& vidTex : m_videoTextures)
+        for (auto& stagingSlot : m_videoStagingRing)
         {
-            vidTex.width = width;
-            vidTex.height = height;
-            vidTex.format = pixelFmt;
-            vidTex.stagingBufferSize = createStaggingBuffer
+            stagingSlot.device = m_vkDevice;
+            stagingSlot.memAllocator = &m_memAllocator;
+            stagingSlot.size = createStaggingBuffer
             (
                 texSize,
                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                vidTex.stagingBuffer,
-                vidTex.stagingBufferMemory
+                stagingSlot.buffer,
+                stagingSlot.memory
             );
+            // host visible memory is kept mapped by the allocator.
+            stagingSlot.mapped = stagingSlot.memory.mapped;
+            CHECK(stagingSlot.mapped != nullptr);
+        }
+        m_videoStagingIndex = 0;
+        m_videoUploadStats = {};
+
+        for (std::size_t texIndex = 0; texIndex < VideoTexSlotCount(); ++texIndex)
+        {
+            auto& vidTex = m_videoTextures[texIndex];
+            vidTex.width = width;
+            vidTex.height = height;
+            vidTex.format = pixelFmt;
             vidTex.texture.Create
             (
                 m_vkDevice, &m_memAllocator,
@@ -3822,8 +4691,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             CHECK(sharedHandle != 0);
             return sharedHandle;
         };
-        for (auto& vidTex : m_videoTextures)
+        for (std::size_t texIndex = 0; texIndex < VideoTexSlotCount(); ++texIndex)
         {
+            auto& vidTex = m_videoTextures[texIndex];
             const D3D11_TEXTURE2D_DESC descDepth {
                 .Width = static_cast<UINT> (width),
                 .Height = static_cast<UINT>(height),
@@ -3888,17 +4758,29 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
     bool WaitForAvailableBuffer()
     {
-        //m_texRendereComplete.WaitForGpu();
-        //Log::Write(Log::Level::Info, Fmt("render idx: %d, copy idx: %d", m_renderTex.load(), m_currentVideoTex.load()));
         //CHECK_HRCMD(m_texRendereComplete.Wait(m_videoTexCmdCpyQueue));
         return true;
     }
 
     virtual void UpdateVideoTexture(const YUVBuffer& yuvBuffer) override
     {
-        const std::size_t freeIndex = m_currentVideoTex.load();
+        const std::size_t freeIndex = AcquireVideoTexture();
         auto& videoTex = m_videoTextures[freeIndex];
 
+        // Only blocks if the GPU has not finished with the oldest staging buffer in the ring.
+        auto& stagingSlot = m_videoStagingRing[m_videoStagingIndex];
+        m_videoStagingIndex = (m_videoStagingIndex + 1) % m_videoStagingRing.size();
+        std::uint64_t blockedUs = 0;
+        if (stagingSlot.cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+        {
+            const auto waitStart = std::chrono::steady_clock::now();
+            stagingSlot.cmdBuffer.Wait();
+            blockedUs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>
+                (std::chrono::steady_clock::now() - waitStart).count());
+        }
+        m_videoUploadStats.Add(blockedUs);
+        CHECK(stagingSlot.mapped != nullptr);
+
         const bool has3Planes = yuvBuffer.chroma2.data != nullptr;
         const std::size_t lumaSize    = LumaSize(videoTex.format);
         const std::size_t chromaSize  = ChromaSize(videoTex.format);
@@ -3909,64 +4791,41 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const VkDeviceSize uPlaneOffset = textureSize * lumaSize;
         const VkDeviceSize vPlaneOffset = has3Planes ? uPlaneOffset + ((textureSize / 2) * chromaUSize) : 0;
 
-        void* data = nullptr;
-        vkMapMemory(m_vkDevice, videoTex.stagingBufferMemory, 0, videoTex.stagingBufferSize, 0, &data);
         {
-            constexpr const auto copy2d = []
+            using ALXR::PlaneCopy::Plane;
+            constexpr const auto makePlane = []
             (
-                std::uint8_t* dst, const std::uint8_t* src,
-                const std::size_t pitchInBytes, const std::size_t width, const std::size_t height, const std::size_t formatSize
+                std::uint8_t* dst, const Buffer& src,
+                const std::size_t width, const std::size_t formatSize
             )
             {
                 const std::size_t lineDstSize = width * formatSize;
-                if (lineDstSize == pitchInBytes) {
-                    //using namespace std::execution;
-                    //std::uninitialized_copy_n(par_unseq, src, lineDstSize * height, dst);
-                    std::memcpy(dst, src, lineDstSize * height);
-                    return;
-                }
-                for (std::size_t h = 0; h < height; ++h)
-                {
-                    auto lineDstPtr = dst + (lineDstSize * h);
-                    const auto lineSrcPtr = src + (pitchInBytes * h);
-                    std::memcpy(lineDstPtr, lineSrcPtr, lineDstSize);
-                    //std::copy_n(par_unseq, src, chromaLineSize, dst);
-                }
+                return Plane {
+                    .dst = dst,
+                    .dstPitch = lineDstSize,
+                    .src = reinterpret_cast<const std::uint8_t*>(src.data),
+                    .srcPitch = src.pitch,
+                    .rowSize = lineDstSize,
+                    .rows = src.height
+                };
             };
 
-            const auto& luma = yuvBuffer.luma;
-            const auto yPlanePtr = reinterpret_cast<std::uint8_t*>(data);               
-            copy2d
-            (
-                yPlanePtr, reinterpret_cast<const std::uint8_t*>(luma.data),
-                luma.pitch, videoTex.width, luma.height, lumaSize
-            );
-
-            const auto& chroma = yuvBuffer.chroma;
-            const auto uPlanePtr = yPlanePtr + uPlaneOffset;
-            copy2d
-            (
-                uPlanePtr, reinterpret_cast<const std::uint8_t*>(chroma.data),
-                chroma.pitch, videoTex.width / 2, chroma.height, chromaUSize
-            );
-
-            if (has3Planes)
-            {
-                const auto& chromaV = yuvBuffer.chroma2;
-                const auto vPlanePtr = yPlanePtr + vPlaneOffset;
-                copy2d
-                (
-                    vPlanePtr, reinterpret_cast<const std::uint8_t*>(chromaV.data),
-                    chromaV.pitch, videoTex.width / 2, chromaV.height, chromaVSize
-                );
-            }
+            const auto yPlanePtr = stagingSlot.mapped;
+            const std::array<Plane, 3> planes {
+                makePlane(yPlanePtr, yuvBuffer.luma, videoTex.width, lumaSize),
+                makePlane(yPlanePtr + uPlaneOffset, yuvBuffer.chroma, videoTex.width / 2, chromaUSize),
+                has3Planes ?
+                    makePlane(yPlanePtr + vPlaneOffset, yuvBuffer.chroma2, videoTex.width / 2, chromaVSize) :
+                    Plane {}
+            };
+            m_planeCopyEngine.Copy(std::span{ planes.data(), has3Planes ? planes.size() : 2 });
         }
-        vkUnmapMemory(m_vkDevice, videoTex.stagingBufferMemory);
 
-        m_videoCpyCmdBuffer.Reset();
-        m_videoCpyCmdBuffer.Begin();
+        auto& cmdBuffer = stagingSlot.cmdBuffer;
+        cmdBuffer.Reset();
+        cmdBuffer.Begin();
 
-        videoTex.texture.TransitionLayout(m_videoCpyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        videoTex.texture.TransitionLayout(cmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
         {
             const VkBufferImageCopy buffImgCopy{
                 .bufferOffset = 0,
@@ -3998,21 +4857,44 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             region[2].imageSubresource.aspectMask = VK_IMAGE_ASPECT_PLANE_2_BIT;
             const auto regionCount = static_cast<std::uint32_t>(has3Planes ? region.size() : 2);
             const auto texImage = videoTex.texture.texImage;
-            vkCmdCopyBufferToImage(m_videoCpyCmdBuffer.buf, videoTex.stagingBuffer, texImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, region.data());
+            vkCmdCopyBufferToImage(cmdBuffer.buf, stagingSlot.buffer, texImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, region.data());
         }
-        videoTex.texture.TransitionLayout(m_videoCpyCmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        videoTex.texture.TransitionLayout(cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-        m_videoCpyCmdBuffer.End();
-        m_videoCpyCmdBuffer.Exec(m_VideoCpyQueue);//ExecSignalers<1>(m_VideoCpyQueue, { &m_texCopy }); //Exec(m_VideoCpyQueue);
-        m_videoCpyCmdBuffer.Wait();
+        cmdBuffer.End();
+#ifdef XR_USE_PLATFORM_ANDROID
+        // no timeline semaphores on this path, keep the upload synchronous.
+        cmdBuffer.Exec(m_VideoCpyQueue);
+        cmdBuffer.Wait();
+#else
+        // the copy overwrites the texture, it must not start before the last frame sampling it has completed.
+        // m_texCopy is only signalled from this (decoder) thread, fenceValue is the value just submitted.
+        cmdBuffer.ExecWaitValue(m_VideoCpyQueue, m_texRendereComplete, m_videoTexRenderValues[freeIndex].load(),
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_texCopy);
+        m_videoTexCopyValues[freeIndex].store(m_texCopy.fenceValue.load());
+#endif
         
         videoTex.frameIndex = yuvBuffer.frameIndex;
-        m_currentVideoTex.store((freeIndex + 1) % VideoTexCount);
-        m_renderTex.store(freeIndex);
+        PublishVideoTexture(freeIndex);
+    }
+
+    virtual void SetVideoDisplayTime(const std::uint64_t displayTimeNs) override
+    {
+        m_videoDisplayTimeNs = displayTimeNs;
     }
 
     virtual void BeginVideoView() override
     {
+        // textures replaced from here on were last used by the previous frames, the GPU is done with any before.
+        BeginFrameCommands();
+        if (m_videoJitterBuffer.IsEnabled()) {
+            textureIdx = m_videoJitterBuffer.Select(m_videoDisplayTimeNs, GetSteadyTimestampNs());
+            if (textureIdx == std::size_t(-1) || textureIdx == m_lastTexIndex)
+                return;
+            UpdateVideoTextureBinding(textureIdx);
+            m_lastTexIndex = textureIdx;
+            return;
+        }
 #ifdef XR_USE_PLATFORM_ANDROID
         VideoTexture newVideoTex{};
 
@@ -4033,12 +4915,17 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         if (newVideoTex.IsValid()) {
             auto& newCurrentTexture = m_videoTextures[VidTextureIndex::Current];
-            m_videoTextures[VidTextureIndex::DeferredDelete] = std::move(newCurrentTexture);
+            RetireVideoTexture(std::move(newCurrentTexture));
             newCurrentTexture = std::move(newVideoTex);
             UpdateVideoTextureBinding(newCurrentTexture);
         }
 #else
-        textureIdx = m_renderTex.load();
+        // the previous front texture goes back to the decoder thread, its m_videoTexRenderValues entry was
+        // stored by the last SubmitViews which sampled it, the next upload to it waits for that value.
+        if (m_videoMailbox.load(std::memory_order_acquire) & VideoMailboxFreshBit) {
+            m_videoFrontTex = m_videoMailbox.exchange(m_videoFrontTex, std::memory_order_acq_rel) & ~VideoMailboxFreshBit;
+            textureIdx = m_videoFrontTex;
+        }
         if (textureIdx == std::size_t(-1) || textureIdx == m_lastTexIndex)
             return;
         UpdateVideoTextureBinding(textureIdx);
@@ -4054,13 +4941,18 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     }
     
     virtual std::uint64_t GetVideoFrameIndex() const override {
-#ifdef XR_USE_PLATFORM_ANDROID
-        return m_videoTextures[VidTextureIndex::Current].frameIndex;
-#else
-        return textureIdx == std::uint64_t(-1) ?
-            textureIdx :
-            m_videoTextures[textureIdx].frameIndex;
-#endif
+        const std::size_t currentTexIdx = CurrentVideoTextureIndex();
+        return currentTexIdx == std::size_t(-1) ?
+            std::uint64_t(-1) :
+            m_videoTextures[currentTexIdx].frameIndex;
+    }
+
+    virtual bool GetVideoJitterStats(ALXR::VideoJitterStats& stats) const override
+    {
+        if (!m_videoJitterBuffer.IsEnabled())
+            return false;
+        stats = m_videoJitterBuffer.GetStats();
+        return true;
     }
 
 #ifdef XR_USE_PLATFORM_ANDROID
@@ -4205,6 +5097,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         };
         CHECK_VKCMD(vkCreateImageView(m_vkDevice, &viewInfo, nullptr, &newVideoTex.imageView));
 
+        if (m_videoJitterBuffer.IsEnabled()) {
+            const std::size_t freeIndex = AcquireVideoTexture();
+            m_videoTextures[freeIndex] = std::move(newVideoTex);
+            PublishVideoTexture(freeIndex);
+            return;
+        }
+
         using namespace std::literals::chrono_literals;
         constexpr static const auto QueueTextureWaitTime = 100ms;
         if (!m_videoTexQueue.wait_enqueue_timed(std::move(newVideoTex), QueueTextureWaitTime)) {
@@ -4216,7 +5115,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     virtual void UpdateVideoTextureD3D11VA(const YUVBuffer& yuvBuffer) override
     {
 #if defined(XR_USE_GRAPHICS_API_D3D11)
-        const std::size_t freeIndex = m_currentVideoTex.load();
+        const std::size_t freeIndex = AcquireVideoTexture();
         {
             /*const*/ auto& videoTex = m_videoTextures[freeIndex];
             videoTex.frameIndex = yuvBuffer.frameIndex;
@@ -4255,10 +5154,10 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
             m_videoCpyCmdBuffer.End();
             m_videoCpyCmdBuffer.ExecSignalers<1>(m_VideoCpyQueue, { &m_texCopy });//Exec(m_VideoCpyQueue);//ExecSignalers<1>(m_VideoCpyQueue, { &m_texCopy }); //Exec(m_VideoCpyQueue);
+            m_videoTexCopyValues[freeIndex].store(m_texCopy.fenceValue.load());
         }
 
-        m_currentVideoTex.store((freeIndex + 1) % m_videoTextures.size());
-        m_renderTex.store(freeIndex);
+        PublishVideoTexture(freeIndex);
 #else
         (void)yuvBuffer;
 #endif
@@ -4267,12 +5166,12 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     virtual void RenderVideoMultiView
     (
         const std::array<XrCompositionLayerProjectionView, 2>& /*layerViews*/,
-        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t /*swapchainFormat*/,
+        const SwapchainImageRef& swapchainImage, const std::int64_t /*swapchainFormat*/,
         const PassthroughMode newMode /*= PassthroughMode::None*/
     ) override
     {
         assert(m_isMultiViewSupported);
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, true, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = VideoClearValues[ClearValueIndex(newMode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -4285,33 +5184,39 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
 #ifdef XR_USE_PLATFORM_ANDROID
-            auto& currentTexture = m_videoTextures[VidTextureIndex::Current];
-            if (currentTexture.texture.texImage == VK_NULL_HANDLE)
+            const std::size_t currentTexIdx = CurrentVideoTextureIndex();
+            if (currentTexIdx == std::size_t(-1) || m_videoTextures[currentTexIdx].texture.texImage == VK_NULL_HANDLE)
                 return;
-            currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            m_videoTextures[currentTexIdx].texture.TransitionLayout(cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 #else
             if (textureIdx == std::size_t(-1))
                 return;
 #endif
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            if (UseVideoComputePass(swapchainContext, newMode)) {
+                RecordVideoComputePass(cmdBuffer, imageIndex, swapchainContext, 0);
+                return;
+            }
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(newMode)].pipe);
-            vkCmdBindDescriptorSets(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, m_descriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(newMode)].pipe);
+            vkCmdBindDescriptorSets(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, m_descriptorSets.data(), 0, nullptr);
 
-            vkCmdDraw(m_cmdBuffer.buf, 3, 1, 0, 0);
+            const VideoStreamPushConstants pushConstants{ .videoReprojection = m_videoReprojection, .viewID = 0 };
+            vkCmdPushConstants(cmdBuffer.buf, m_videoStreamLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, VideoStreamPushConstantsSize, &pushConstants);
+            vkCmdDraw(cmdBuffer.buf, 3, 1, 0, 0);
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
     virtual void RenderVideoView
     (
         const std::uint32_t viewID, const XrCompositionLayerProjectionView& /*layerView*/,
-        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t /*swapchainFormat*/,
+        const SwapchainImageRef& swapchainImage, const std::int64_t /*swapchainFormat*/,
         const PassthroughMode mode /*= PassthroughMode::None*/
     ) override
     {
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, true, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = VideoClearValues[ClearValueIndex(mode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -4324,23 +5229,28 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
 #ifdef XR_USE_PLATFORM_ANDROID
-            auto& currentTexture = m_videoTextures[VidTextureIndex::Current];
-            if (currentTexture.texture.texImage == VK_NULL_HANDLE)
+            const std::size_t currentTexIdx = CurrentVideoTextureIndex();
+            if (currentTexIdx == std::size_t(-1) || m_videoTextures[currentTexIdx].texture.texImage == VK_NULL_HANDLE)
                 return;
-            currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            m_videoTextures[currentTexIdx].texture.TransitionLayout(cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 #else
             if (textureIdx == std::size_t(-1))
                 return;
 #endif
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            if (UseVideoComputePass(swapchainContext, mode)) {
+                RecordVideoComputePass(cmdBuffer, imageIndex, swapchainContext, viewID);
+                return;
+            }
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(mode)].pipe);
-            vkCmdBindDescriptorSets(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, m_descriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(mode)].pipe);
+            vkCmdBindDescriptorSets(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, m_descriptorSets.data(), 0, nullptr);
 
-            vkCmdPushConstants(m_cmdBuffer.buf, m_videoStreamLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(std::uint32_t), &viewID);
-            vkCmdDraw(m_cmdBuffer.buf, 3, 1, 0, 0);
+            const VideoStreamPushConstants pushConstants{ .videoReprojection = m_videoReprojection, .viewID = viewID };
+            vkCmdPushConstants(cmdBuffer.buf, m_videoStreamLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, VideoStreamPushConstantsSize, &pushConstants);
+            vkCmdDraw(cmdBuffer.buf, 3, 1, 0, 0);
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
@@ -4355,10 +5265,23 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     }
     
     virtual ~VulkanGraphicsPlugin() override {
+        for (auto& frameCommands : m_frameCommands) {
+            if (frameCommands.cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+                frameCommands.cmdBuffer.Wait();
+        }
+        WaitForVideoUploads();
         ClearImageDescriptorSetLayouts();
         Log::Write(Log::Level::Verbose, "VulkanGraphicsPlugin destroyed.");
     }
 
+#ifdef XR_USE_PLATFORM_ANDROID
+    // each slot may hold one of the MediaCodec image reader's 5 images, the jitter buffer is at most 2 deep.
+    constexpr static const std::size_t VideoTexCount = 5;
+#else
+    // the jitter buffer is at most 4 deep, only VideoTexSlotCount() textures are created.
+    constexpr static const std::size_t VideoTexCount = 7;
+#endif
+
 #include "cuda/vulkancuda_interop.inl"
 
    protected:
@@ -4371,8 +5294,24 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         .queueFamilyIndex = 0,
         .queueIndex = 0,
     };
-    std::list<SwapchainImageContext> m_swapchainImageContexts;
-    std::map<const XrSwapchainImageBaseHeader*, SwapchainImageContext*> m_swapchainImageContextMap;
+    // Declared before anything holding device memory so it is destroyed last.
+    MemoryAllocator m_memAllocator{};
+
+    // Published as a whole: swapchains are (re)created off the render thread while it keeps rendering, the
+    // render thread loads the set once per view. Other threads only use it while no swapchains are being
+    // created (the decoder thread is stopped during reconfiguration).
+    struct SwapchainImageContextSet {
+        std::vector<std::shared_ptr<SwapchainImageContext>> contexts;
+        // of contexts, by swapchain slot (see IGraphicsPlugin::AllocateSwapchainImageStructs).
+        std::array<SwapchainImageContext*, IGraphicsPlugin::MaxSwapchainSlots> slots{};
+
+        inline SwapchainImageContext* Find(const std::uint32_t swapchainSlot) const {
+            return swapchainSlot < slots.size() ? slots[swapchainSlot] : nullptr;
+        }
+        // the most recently created.
+        inline SwapchainImageContext& Last() const { return *contexts.back(); }
+    };
+    xrconcurrency::rcu_ptr<SwapchainImageContextSet> m_swapchainImageContexts{};
 
     VkInstance m_vkInstance{VK_NULL_HANDLE};
     VkPhysicalDevice m_vkPhysicalDevice{VK_NULL_HANDLE};
@@ -4380,9 +5319,10 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     uint32_t m_queueFamilyIndex = 0;
     VkQueue m_vkQueue{VK_NULL_HANDLE};
     
-    MemoryAllocator m_memAllocator{};
+    PipelineCache m_pipelineCache{};
+    std::string m_pipelineCacheDir{};
     ShaderProgram m_shaderProgram{};
-    CmdBuffer m_cmdBuffer{};
+    CmdBuffer m_cmdBuffer{}; // one-off setup commands, frames are recorded into m_frameCommands.
     PipelineLayout m_pipelineLayout{};
     VertexBuffer<Geometry::Vertex> m_drawBuffer{};
     bool m_isMultiViewSupported = false;
@@ -4411,19 +5351,26 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     PipelineLayout m_videoStreamLayout{};
     using PipelineList = std::array<Pipeline, size_t(PassthroughMode::TypeCount)>;
     PipelineList m_videoStreamPipelines{};
+    std::array<ComputeShader, size_t(VideoFragShaderType::TypeCount)> m_videoComputeShaders{};
+    ComputePipeline m_videoComputePipeline{};
+    bool m_videoComputeRequested = false;
+    bool m_isVideoComputeSupported = false;
     bool m_enableSRGBLinearize = true;
 
     using FoveatedDecodeParamsPtr = std::shared_ptr<ALXR::FoveatedDecodeParams>;
     FoveatedDecodeParamsPtr m_fovDecodeParams{};
 
+    std::array<ALXR::VideoReprojection, 2> m_videoReprojection {
+        ALXR::MakeIdentityVideoReprojection(0),
+        ALXR::MakeIdentityVideoReprojection(1)
+    };
+
     XrVector3f m_maskModeKeyColor = { 0.01f, 0.01f, 0.01f };
     float      m_maskModeAlpha = 0.3f;
     float      m_blendModeAlpha = 0.6f;
 
     bool m_cmdBufferWaitNextFrame = true;
 
-    constexpr static const std::size_t VideoTexCount = 2;
-
 #ifndef XR_USE_PLATFORM_ANDROID
     SemaphoreTimeline m_texRendereComplete{};
     SemaphoreTimeline m_texCopy{};
@@ -4437,10 +5384,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         Texture texture{};
 
-        VkBuffer stagingBuffer{ VK_NULL_HANDLE };
-        VkDeviceMemory stagingBufferMemory{ VK_NULL_HANDLE };
-        VkDeviceSize stagingBufferSize {0};
-
         VkImageView imageView{ VK_NULL_HANDLE };
 
 #if defined(XR_USE_GRAPHICS_API_D3D11)
@@ -4465,9 +5408,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         : VideoTexture()
         {
             texture = std::move(other.texture);
-            std::swap(stagingBuffer, other.stagingBuffer);
-            std::swap(stagingBufferMemory, other.stagingBufferMemory);
-            std::swap(stagingBufferSize, other.stagingBufferSize);
             std::swap(imageView, other.imageView);
             std::swap(frameIndex, other.frameIndex);
             std::swap(width, other.width);
@@ -4488,9 +5428,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 return *this;
             Clear();
             texture = std::move(other.texture);
-            std::swap(stagingBuffer, other.stagingBuffer);
-            std::swap(stagingBufferMemory, other.stagingBufferMemory);
-            std::swap(stagingBufferSize, other.stagingBufferSize);
             std::swap(imageView, other.imageView);
             std::swap(frameIndex, other.frameIndex);
             std::swap(width, other.width);
@@ -4518,19 +5455,10 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             const auto vkDevice = texture.m_vkDevice;
             if (vkDevice != VK_NULL_HANDLE)
             {
-                if (stagingBuffer != VK_NULL_HANDLE) {
-                    vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
-                }
-                if (stagingBufferMemory != VK_NULL_HANDLE) {
-                    vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
-                }
                 if (imageView != VK_NULL_HANDLE) {
                     vkDestroyImageView(vkDevice, imageView, nullptr);
                 }
             }
-            stagingBuffer = VK_NULL_HANDLE;
-            stagingBufferMemory = VK_NULL_HANDLE;
-            stagingBufferSize = 0;
             imageView = VK_NULL_HANDLE;
             texture.Clear();
             frameIndex = std::uint64_t(-1);
@@ -4560,7 +5488,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     {
         CHECK(m_videoStreamLayout.textureSampler != VK_NULL_HANDLE);
         CHECK(vidTexture.imageView != VK_NULL_HANDLE);
-        const auto swapChainCount = static_cast<std::uint32_t>(m_swapchainImageContexts.back().swapchainImages.size());
+        const auto swapChainCount = static_cast<std::uint32_t>(m_swapchainImageContexts.load()->Last().swapchainImages.size());
         for (size_t i = 0; i < m_descriptorSets.size(); ++i)
         {
             const VkDescriptorImageInfo imageInfo{
@@ -4591,19 +5519,201 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         UpdateVideoTextureBinding(m_videoTextures[vidTexIndex]);
     }
 
-    static_assert(VideoTexCount >= 2);
+    static_assert(VideoTexCount >= 3);
     std::array<VideoTexture, VideoTexCount>  m_videoTextures{};
-    std::atomic<std::size_t>            m_currentVideoTex{ 0 },
-                                        m_renderTex{ std::size_t(-1) };
+    // Non jitter buffer hand-off, a triple buffer: the decoder thread writes m_videoDecoderTex, the render thread
+    // samples m_videoFrontTex and the last published texture waits in m_videoMailbox, tagged with
+    // VideoMailboxFreshBit until the render thread takes it. Neither side ever gets the other's texture.
+    constexpr static const std::size_t VideoMailboxFreshBit = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+    std::size_t                         m_videoDecoderTex = 0;
+    std::atomic<std::size_t>            m_videoMailbox{ 1 };
+    std::size_t                         m_videoFrontTex = 2;
+    // m_texCopy timeline value signalled by the last upload to each video texture, 0 if none.
+    std::array<std::atomic<std::uint64_t>, VideoTexCount> m_videoTexCopyValues{};
+    // m_texRendereComplete value signalled by the last frame which sampled each video texture, 0 if none.
+    std::array<std::atomic<std::uint64_t>, VideoTexCount> m_videoTexRenderValues{};
+
+    // Recorded by the render thread, see BeginFrameCommands. Two slots: a frame is recorded while the previous one
+    // executes, video textures the jitter buffer retires are released one frame after they were last bound.
+    // Command buffer state/fences are guarded by m_frameCommandsMutex, host threads wait on them (WaitForFramesInFlight).
+    constexpr static const std::size_t FramesInFlight = 2;
+    struct FrameCommands {
+        CmdBuffer cmdBuffer{};
+        // m_texCopy value the frame's video views wait for, 0 if none.
+        std::uint64_t videoCopyValue = 0;
+        // video texture the frame samples, -1 if none.
+        std::size_t videoTexIndex = std::size_t(-1);
+#ifdef XR_USE_PLATFORM_ANDROID
+        // replaced while the frame may still read them, released once it has completed.
+        std::vector<VideoTexture> retiredVideoTextures{};
+#endif
+    };
+    std::array<FrameCommands, FramesInFlight> m_frameCommands{};
+    std::size_t m_frameCommandsIndex = 0;
+    std::mutex  m_frameCommandsMutex{};
+
+    // Persistently mapped staging buffer + command buffer used for one CPU->GPU video upload,
+    // slots are reused round-robin so the decoder thread only waits on the GPU when the ring is full.
+    struct VideoStagingSlot {
+        VkDevice                    device{ VK_NULL_HANDLE };
+        MemoryAllocator*            memAllocator{ nullptr };
+        VkBuffer                    buffer{ VK_NULL_HANDLE };
+        MemoryAllocator::Allocation memory{};
+        VkDeviceSize                size{ 0 };
+        std::uint8_t*               mapped{ nullptr };
+        CmdBuffer                   cmdBuffer{};
+
+        inline VideoStagingSlot() noexcept = default;
+        inline ~VideoStagingSlot() noexcept {
+            Clear();
+        }
+
+        VideoStagingSlot(const VideoStagingSlot&) = delete;
+        VideoStagingSlot& operator=(const VideoStagingSlot&) = delete;
+
+        void Clear()
+        {
+            if (device != VK_NULL_HANDLE)
+            {
+                if (buffer != VK_NULL_HANDLE) {
+                    vkDestroyBuffer(device, buffer, nullptr);
+                }
+                if (memAllocator != nullptr) {
+                    memAllocator->Free(memory);
+                }
+            }
+            mapped = nullptr;
+            buffer = VK_NULL_HANDLE;
+            size = 0;
+        }
+    };
+    constexpr static const std::size_t VideoStagingRingSize = 3;
+    std::array<VideoStagingSlot, VideoStagingRingSize> m_videoStagingRing{};
+    std::size_t m_videoStagingIndex = 0;
+
+    struct VideoUploadStats {
+        std::uint64_t uploads = 0;
+        std::uint64_t blockedUploads = 0; // uploads which had to wait for a staging slot.
+        std::uint64_t totalBlockedUs = 0;
+        std::uint64_t maxBlockedUs = 0;
+
+        inline void Add(const std::uint64_t blockedUs) {
+            ++uploads;
+            if (blockedUs == 0)
+                return;
+            ++blockedUploads;
+            totalBlockedUs += blockedUs;
+            maxBlockedUs = std::max(maxBlockedUs, blockedUs);
+        }
+    };
+    VideoUploadStats m_videoUploadStats{};
+    // splits CPU decoded frame copies into the staging buffers across a few threads.
+    ALXR::PlaneCopy::CopyEngine m_planeCopyEngine{ 0, [] { ALXR::ThreadScheduling::ApplyToCurrentThread(ALXR::ThreadScheduling::Role::Upload); } };
+
+    void WaitForVideoUploads()
+    {
+        for (auto& stagingSlot : m_videoStagingRing) {
+            auto& cmdBuffer = stagingSlot.cmdBuffer;
+            if (cmdBuffer.state != CmdBuffer::CmdBufferState::Executing)
+                continue;
+            cmdBuffer.Wait();
+            cmdBuffer.Reset();
+        }
+    }
+
+    void LogVideoUploadStats() const
+    {
+        const auto& stats = m_videoUploadStats;
+        if (stats.uploads == 0)
+            return;
+        Log::Write(Log::Level::Info, Fmt("VulkanGraphicsPlugin: video uploads: %llu, decoder thread blocked: %llu times, total: %.3fms, avg: %.3fms, max: %.3fms",
+            static_cast<unsigned long long>(stats.uploads),
+            static_cast<unsigned long long>(stats.blockedUploads),
+            stats.totalBlockedUs / 1000.0,
+            (stats.totalBlockedUs / 1000.0) / stats.uploads,
+            stats.maxBlockedUs / 1000.0));
+    }
 
-#ifndef XR_USE_PLATFORM_ANDROID
     std::size_t m_lastTexIndex = std::size_t(-1);
     std::size_t textureIdx = std::size_t(-1);
+
+    using VideoJitterBuffer = ALXR::VideoJitterBuffer<VideoTexCount>;
+    VideoJitterBuffer m_videoJitterBuffer {
+#ifdef XR_USE_PLATFORM_ANDROID
+        // hands the slot's image back to the image reader, the GPU is done with retired and never bound frames.
+        [this](const std::size_t slot) { m_videoTextures[slot].Clear(); }
+#endif
+    };
+    std::uint32_t m_videoJitterDepth = 0;
+    // steady clock display time of the next BeginVideoView, render thread only.
+    std::uint64_t m_videoDisplayTimeNs = 0;
+
+    // textures in use, all slots of the jitter buffer or the 3 of the mailbox.
+    inline std::size_t VideoTexSlotCount() const {
+        return m_videoJitterDepth > 0 ? m_videoJitterDepth + 3 : 3;
+    }
+
+    // Decoder thread: texture to write the next decoded frame to.
+    inline std::size_t AcquireVideoTexture() {
+        if (!m_videoJitterBuffer.IsEnabled())
+            return m_videoDecoderTex;
+        const std::size_t freeIndex = m_videoJitterBuffer.AcquireWriteSlot();
+        CHECK(freeIndex != VideoJitterBuffer::InvalidSlot);
+        return freeIndex;
+    }
+
+    // Decoder thread: hands the texture written by the decoder thread over to the render thread.
+    inline void PublishVideoTexture(const std::size_t texIndex) {
+        if (m_videoJitterBuffer.IsEnabled()) {
+            m_videoJitterBuffer.Push(texIndex, m_videoTextures[texIndex].frameIndex, GetSteadyTimestampNs());
+            return;
+        }
+        m_videoDecoderTex = m_videoMailbox.exchange(texIndex | VideoMailboxFreshBit, std::memory_order_acq_rel) & ~VideoMailboxFreshBit;
+    }
+
+    // Render thread: texture bound by the last BeginVideoView, -1 if none.
+    inline std::size_t CurrentVideoTextureIndex() const {
+#ifdef XR_USE_PLATFORM_ANDROID
+        if (!m_videoJitterBuffer.IsEnabled())
+            return VidTextureIndex::Current;
+#endif
+        return textureIdx;
+    }
+
+    void LogVideoJitterStats() const
+    {
+        if (!m_videoJitterBuffer.IsEnabled())
+            return;
+        const auto stats = m_videoJitterBuffer.GetStats();
+        if (stats.pushed == 0)
+            return;
+        Log::Write(Log::Level::Info, Fmt("VulkanGraphicsPlugin: video jitter buffer: frames: %llu, presented: %llu, holds: %llu, skips: %llu (late: %llu), target delay: %.3fms",
+            static_cast<unsigned long long>(stats.pushed),
+            static_cast<unsigned long long>(stats.presented),
+            static_cast<unsigned long long>(stats.holds),
+            static_cast<unsigned long long>(stats.skips),
+            static_cast<unsigned long long>(stats.lateFrames),
+            stats.targetDelayUs / 1000.0));
+    }
+
+#ifndef XR_USE_PLATFORM_ANDROID
+    inline std::uint64_t BoundVideoTextureCopyValue() const {
+        return textureIdx == std::size_t(-1) ? 0 : m_videoTexCopyValues[textureIdx].load();
+    }
 #else
     enum VidTextureIndex : std::size_t {
-        Current,
-        DeferredDelete
+        Current
     };
+
+    // Frees the texture once the last submitted frame, which may still read it, has completed.
+    inline void RetireVideoTexture(VideoTexture&& videoTexture) {
+        std::scoped_lock frameLock(m_frameCommandsMutex);
+        auto& lastFrame = m_frameCommands[(m_frameCommandsIndex + FramesInFlight - 1) % FramesInFlight];
+        if (lastFrame.cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+            lastFrame.retiredVideoTextures.push_back(std::move(videoTexture));
+        else
+            videoTexture.Clear();
+    }
     using VideoTextureQueue = moodycamel::BlockingReaderWriterCircularBuffer<VideoTexture>; //atomic_queue::AtomicQueue2<VideoTexture, 2>;// moodycamel::BlockingReaderWriterCircularBuffer<VideoTexture>; // xrconcurrency::concurrent_queue<VideoTexture>; //
     VideoTextureQueue m_videoTexQueue{ VideoQueueSize };
 #endif
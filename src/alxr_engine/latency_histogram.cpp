@@ -0,0 +1,68 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+
+namespace ALXR {
+namespace {
+
+    using Counts = std::array<std::uint64_t, LatencyHistogram::BucketCount>;
+
+    LatencyHistogram::Percentiles ComputePercentiles(const Counts& counts, const std::uint64_t exactMax) {
+        LatencyHistogram::Percentiles result{};
+        for (const auto count : counts)
+            result.count += count;
+        if (result.count == 0)
+            return result;
+
+        // ranks are 1-based, p99 of 100 samples is the 99th smallest.
+        const auto rankOf = [total = result.count](const std::uint64_t percent) {
+            return std::max<std::uint64_t>(1, (total * percent + 99) / 100);
+        };
+        const std::array<std::uint64_t, 3> ranks{ rankOf(50), rankOf(90), rankOf(99) };
+        std::array<std::uint64_t, 3> values{};
+        std::size_t rankIdx = 0;
+        std::uint64_t seen = 0;
+        std::size_t lastBucket = 0;
+        for (std::size_t bucket = 0; bucket < counts.size(); ++bucket) {
+            if (counts[bucket] == 0)
+                continue;
+            seen += counts[bucket];
+            lastBucket = bucket;
+            while (rankIdx < ranks.size() && seen >= ranks[rankIdx])
+                values[rankIdx++] = LatencyHistogram::HighestEquivalentValue(bucket);
+        }
+        // never report past the largest value actually recorded.
+        const std::uint64_t max = std::min(LatencyHistogram::HighestEquivalentValue(lastBucket), exactMax);
+        result.p50 = std::min(values[0], max);
+        result.p90 = std::min(values[1], max);
+        result.p99 = std::min(values[2], max);
+        result.max = max;
+        return result;
+    }
+}
+
+LatencyHistogram::Percentiles LatencyHistogram::Collect() const {
+    Counts counts{};
+    for (std::size_t bucket = 0; bucket < BucketCount; ++bucket)
+        counts[bucket] = m_counts[bucket].load(std::memory_order_relaxed);
+    return ComputePercentiles(counts, m_max.load(std::memory_order_relaxed));
+}
+
+LatencyHistogram::Percentiles LatencyHistogram::Collect(Window& window) const {
+    Counts counts{};
+    for (std::size_t bucket = 0; bucket < BucketCount; ++bucket) {
+        const std::uint64_t count = m_counts[bucket].load(std::memory_order_relaxed);
+        // a Reset in between leaves counts below the window.
+        counts[bucket] = count >= window.counts[bucket] ? count - window.counts[bucket] : count;
+        window.counts[bucket] = count;
+    }
+    // the exact max is only known since Reset, the window's is bounded by its highest bucket.
+    return ComputePercentiles(counts, m_max.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : m_counts)
+        count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef ALXR_LATENCY_HISTOGRAM_H
+#define ALXR_LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <bit>
+
+namespace ALXR {
+
+// Constant memory log-linear (HdrHistogram style) histogram of microsecond latencies.
+// Values below 64us are exact, above that each power of two is split into 32 sub-buckets (~3% precision)
+// up to ~67s, larger values are clamped. Record is wait-free and may be called from any thread.
+class LatencyHistogram {
+public:
+    constexpr static const std::size_t LinearBits = 6;
+    constexpr static const std::size_t LinearCount = std::size_t(1) << LinearBits;
+    constexpr static const std::size_t SubBucketCount = LinearCount / 2;
+    constexpr static const std::size_t MaxValueBits = 26;
+    constexpr static const std::size_t BucketCount = LinearCount + (MaxValueBits - LinearBits) * SubBucketCount;
+
+    struct Percentiles {
+        std::uint64_t p50;
+        std::uint64_t p90;
+        std::uint64_t p99;
+        std::uint64_t max;
+        std::uint64_t count;
+    };
+
+    // Bucket counts at the last Collect, for percentiles over a window instead of since Reset.
+    struct Window {
+        std::array<std::uint64_t, BucketCount> counts{};
+    };
+
+    inline void Record(const std::uint64_t valueUs) {
+        m_counts[ToBucket(valueUs)].fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (valueUs > max && !m_max.compare_exchange_weak(max, valueUs, std::memory_order_relaxed)) {}
+    }
+
+    // Percentiles since Reset, values are the highest value equivalent to the bucket they fall in.
+    Percentiles Collect() const;
+    // Percentiles of the values recorded since window was last collected, window is advanced to now.
+    Percentiles Collect(Window& window) const;
+
+    // Not synchronized with concurrent Record calls, values recorded during a reset may be lost.
+    void Reset();
+
+    constexpr static std::size_t ToBucket(const std::uint64_t valueUs) {
+        if (valueUs < LinearCount)
+            return static_cast<std::size_t>(valueUs);
+        const std::size_t shift = static_cast<std::size_t>(std::bit_width(valueUs)) - LinearBits;
+        if (shift >= MaxValueBits - LinearBits + 1)
+            return BucketCount - 1;
+        return LinearCount + (shift - 1) * SubBucketCount + static_cast<std::size_t>((valueUs >> shift) - SubBucketCount);
+    }
+
+    constexpr static std::uint64_t HighestEquivalentValue(const std::size_t bucket) {
+        if (bucket < LinearCount)
+            return bucket;
+        const std::size_t shift = (bucket - LinearCount) / SubBucketCount + 1;
+        const std::uint64_t subBucket = (bucket - LinearCount) % SubBucketCount + SubBucketCount;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, BucketCount> m_counts{};
+    std::atomic<std::uint64_t> m_max{ 0 };
+};
+}
+#endif
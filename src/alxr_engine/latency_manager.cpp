@@ -3,8 +3,10 @@
 #include "latency_manager.h"
 #include <cstdlib>
 #include <chrono>
+#include <algorithm>
 #include "timing.h"
 #include "packet_types.h"
+#include "frame_trace.h"
 
 LatencyManager LatencyManager::m_instance{};
 
@@ -13,10 +15,12 @@ void LatencyManager::OnTimeSyncRecieved(const TimeSync& timeSync)
     if (timeSync.mode == 1) {
         LatencyCollector::Instance().setTotalLatency(timeSync.serverTotalLatency);
         const std::uint64_t Current = GetSystemTimestampUs();
-        const std::uint64_t RTT = Current - timeSync.clientTime;
-        m_rt_state.timeDiff =
-            ((std::int64_t)timeSync.serverTime + (std::int64_t)RTT / 2) - (std::int64_t)Current;
-        //LOG("TimeSync: server - client = %ld us RTT = %lu us", m_rt_state.timeDiff, RTT);
+        {
+            std::scoped_lock lk(m_clockSyncMutex);
+            const auto result = m_clockSync.AddSample(timeSync.clientTime, timeSync.serverTime, Current);
+            if (result == ALXR::ClockOffsetEstimator::SampleResult::Restarted)
+                Log::Write(Log::Level::Info, "TimeSync: clock offset changed, restarting offset estimation.");
+        }
         if (m_callbackCtx.timeSyncSendFn) {
             TimeSync sendBuf = timeSync;
             sendBuf.mode = 2;
@@ -28,18 +32,40 @@ void LatencyManager::OnTimeSyncRecieved(const TimeSync& timeSync)
         LatencyCollector::Instance().received(timeSync.trackingRecvFrameIndex);
 }
 
-void LatencyManager::OnPreVideoPacketRecieved(const VideoFrame& header)
+std::int64_t LatencyManager::ServerClockOffset(const std::uint64_t clientTimeUs) const
+{
+    std::scoped_lock lk(m_clockSyncMutex);
+    return m_clockSync.OffsetAt(clientTimeUs);
+}
+
+LatencyManager::ClockSyncStats LatencyManager::GetClockSyncStats() const
+{
+    const std::uint64_t now = GetSystemTimestampUs();
+    std::scoped_lock lk(m_clockSyncMutex);
+    return {
+        .estimate = m_clockSync.GetEstimate(now),
+        .rejectedSamples = m_clockSync.RejectedCount()
+    };
+}
+
+void LatencyManager::OnVideoPacketArrived(const VideoFrame& header, const std::uint64_t arrivalSteadyUs, const std::uint64_t arrivalSystemUs)
 {
     if (m_rt_state.lastFrameIndex != header.trackingFrameIndex) {
         LatencyCollector::Instance().receivedFirst(header.trackingFrameIndex);
-        const std::int64_t timeDiff = m_rt_state.timeDiff.load();
+        OnFrameStage(ALXR::FrameTrace::Stage::ReceivedFirst, header.trackingFrameIndex, arrivalSteadyUs);
+        const std::uint64_t now = arrivalSystemUs;
+        const std::int64_t timeDiff = ServerClockOffset(now);
         const auto diff = static_cast<std::int64_t>(header.sentTime) - timeDiff;
-        const auto timeStamp = static_cast<std::int64_t>(GetSystemTimestampUs());
+        const auto timeStamp = static_cast<std::int64_t>(now);
         const auto offset = diff > timeStamp ?
             0 : ((std::int64_t)header.sentTime - timeDiff - timeStamp);
         LatencyCollector::Instance().estimatedSent(header.trackingFrameIndex, offset);
         m_rt_state.lastFrameIndex = header.trackingFrameIndex;
     }
+}
+
+void LatencyManager::OnPreVideoPacketRecieved(const VideoFrame& header)
+{
     if (const auto lostCount = ProcessVideoSeq(header))
         LatencyCollector::Instance().packetLoss(lostCount);
 }
@@ -50,14 +76,158 @@ void LatencyManager::OnPostVideoPacketRecieved
     const LatencyManager::PacketRecievedStatus& status
 )
 {
-    if (status.complete)
+    if (status.complete) {
+        m_rt_state.isFecFailed = false;
         LatencyCollector::Instance().receivedLast(header.trackingFrameIndex);
+        OnFrameStage(ALXR::FrameTrace::Stage::ReceivedLast, header.trackingFrameIndex);
+    }
     if (status.fecFailed) {
+        m_rt_state.isFecFailed = true;
         LatencyCollector::Instance().fecFailure();
         SendPacketLossReport(0, 0);
     }
 }
 
+void LatencyManager::OnReassemblyStage
+(
+    const std::size_t queueDepth,
+    const std::uint64_t queueWaitUs,
+    const std::uint64_t fecTimeUs,
+    const std::uint64_t decoderQueueTimeUs
+)
+{
+    auto& w = m_reassemblyWindow;
+    const std::uint64_t now = GetSteadyTimestampUs();
+    if (w.windowStartUs == 0)
+        w.windowStartUs = now;
+
+    ++w.samples;
+    w.queueDepthSum += queueDepth;
+    w.queueWaitSum += queueWaitUs;
+    w.fecTimeSum += fecTimeUs;
+    w.decoderQueueTimeSum += decoderQueueTimeUs;
+    w.maxQueueDepth = std::max(w.maxQueueDepth, static_cast<std::uint32_t>(queueDepth));
+    w.maxQueueWait  = std::max(w.maxQueueWait, static_cast<std::uint32_t>(queueWaitUs));
+    w.maxFecTime    = std::max(w.maxFecTime, static_cast<std::uint32_t>(fecTimeUs));
+
+    constexpr const std::uint64_t WindowUs = 1000000;
+    if (now - w.windowStartUs < WindowUs)
+        return;
+
+    const ReassemblyStats stats {
+        .maxQueueDepth = w.maxQueueDepth,
+        .avgQueueDepth = static_cast<std::uint32_t>(w.queueDepthSum / w.samples),
+        .avgQueueWait  = static_cast<std::uint32_t>(w.queueWaitSum / w.samples),
+        .maxQueueWait  = w.maxQueueWait,
+        .avgFecTime    = static_cast<std::uint32_t>(w.fecTimeSum / w.samples),
+        .maxFecTime    = w.maxFecTime,
+        .avgDecoderQueueTime = static_cast<std::uint32_t>(w.decoderQueueTimeSum / w.samples),
+        .droppedShards = w.droppedShards.exchange(0)
+    };
+    {
+        std::scoped_lock lk(m_reassemblyStatsMutex);
+        m_reassemblyStats = stats;
+    }
+    w.Reset(now);
+
+    Log::Write(Log::Level::Verbose, Fmt("Reassembly stage: queue-depth avg=%u max=%u, queue-wait avg=%uus max=%uus, "
+        "fec avg=%uus max=%uus, decoder-queue avg=%uus, dropped-shards=%u",
+        stats.avgQueueDepth, stats.maxQueueDepth, stats.avgQueueWait, stats.maxQueueWait,
+        stats.avgFecTime, stats.maxFecTime, stats.avgDecoderQueueTime, stats.droppedShards));
+}
+
+LatencyManager::ReassemblyStats LatencyManager::GetReassemblyStats() const
+{
+    std::scoped_lock lk(m_reassemblyStatsMutex);
+    return m_reassemblyStats;
+}
+
+void LatencyManager::OnFrameStage(const ALXR::FrameTrace::Stage stage, const std::uint64_t frameIndex, const std::uint64_t timeUs)
+{
+    using Stage = ALXR::FrameTrace::Stage;
+    const std::uint64_t nowUs = timeUs != 0 ? timeUs : GetSteadyTimestampUs();
+    ALXR::FrameTrace::Record(stage, frameIndex, nowUs);
+
+    auto& frame = m_frameStageTimes[frameIndex % m_frameStageTimes.size()];
+    if (stage == Stage::ReceivedFirst) {
+        frame.frameIndex.store(std::uint64_t(-1), std::memory_order_relaxed);
+        for (auto& timeUs : frame.timesUs)
+            timeUs.store(0, std::memory_order_relaxed);
+        frame.timesUs[static_cast<std::size_t>(stage)].store(nowUs, std::memory_order_relaxed);
+        frame.frameIndex.store(frameIndex, std::memory_order_release);
+        return;
+    }
+    if (frame.frameIndex.load(std::memory_order_acquire) != frameIndex)
+        return;
+    std::uint64_t expected = 0;
+    if (!frame.timesUs[static_cast<std::size_t>(stage)].compare_exchange_strong(expected, nowUs, std::memory_order_relaxed))
+        return;
+
+    const auto recordSince = [&](const LatencyStage latencyStage, const Stage from) {
+        const std::uint64_t fromUs = frame.timesUs[static_cast<std::size_t>(from)].load(std::memory_order_relaxed);
+        if (fromUs != 0 && nowUs >= fromUs)
+            m_latencyHistograms[static_cast<std::size_t>(latencyStage)].Record(nowUs - fromUs);
+    };
+    switch (stage) {
+    case Stage::ReceivedLast:  recordSince(LatencyStage::Network, Stage::ReceivedFirst); break;
+    case Stage::DecoderOutput: recordSince(LatencyStage::Decode, Stage::DecoderInput); break;
+    case Stage::UploadDone:    recordSince(LatencyStage::Upload, Stage::DecoderOutput); break;
+    case Stage::Submitted:
+        recordSince(LatencyStage::Render, Stage::UploadDone);
+        recordSince(LatencyStage::Total, Stage::ReceivedFirst);
+        UpdateLatencyWindow(nowUs);
+        break;
+    default: break;
+    }
+}
+
+void LatencyManager::UpdateLatencyWindow(const std::uint64_t nowUs)
+{
+    constexpr const std::uint64_t WindowUs = 1000000;
+    if (m_latencyResetRequested.exchange(false, std::memory_order_acquire))
+        ResetLatencyHistograms();
+    if (m_latencyWindowStartUs == 0)
+        m_latencyWindowStartUs = nowUs;
+    if (nowUs - m_latencyWindowStartUs < WindowUs)
+        return;
+    m_latencyWindowStartUs = nowUs;
+
+    LatencyPercentiles lastSecond{};
+    for (std::size_t idx = 0; idx < LatencyStageCount; ++idx)
+        lastSecond[idx] = m_latencyHistograms[idx].Collect(m_latencyWindows[idx]);
+    {
+        std::scoped_lock lk(m_latencyReportMutex);
+        m_lastSecondPercentiles = lastSecond;
+    }
+    const auto& total = lastSecond[static_cast<std::size_t>(LatencyStage::Total)];
+    const auto& decode = lastSecond[static_cast<std::size_t>(LatencyStage::Decode)];
+    Log::Write(Log::Level::Verbose, Fmt("Frame latency: total p50=%lluus p99=%lluus max=%lluus, decode p50=%lluus p99=%lluus max=%lluus",
+        total.p50, total.p99, total.max, decode.p50, decode.p99, decode.max));
+}
+
+LatencyManager::LatencyReport LatencyManager::GetLatencyReport() const
+{
+    LatencyReport report{};
+    {
+        std::scoped_lock lk(m_latencyReportMutex);
+        report.lastSecond = m_lastSecondPercentiles;
+    }
+    for (std::size_t idx = 0; idx < LatencyStageCount; ++idx)
+        report.sinceReset[idx] = m_latencyHistograms[idx].Collect();
+    return report;
+}
+
+void LatencyManager::ResetLatencyHistograms()
+{
+    for (auto& histogram : m_latencyHistograms)
+        histogram.Reset();
+    for (auto& window : m_latencyWindows)
+        window = {};
+    m_latencyWindowStartUs = 0;
+    std::scoped_lock lk(m_latencyReportMutex);
+    m_lastSecondPercentiles = {};
+}
+
 std::int64_t LatencyManager::ProcessVideoSeq(const VideoFrame& header)
 {
     const auto nextSeq = m_rt_state.prevVideoSequence + 1;
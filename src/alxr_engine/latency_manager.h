@@ -3,7 +3,11 @@
 #define ALXR_LATENCY_MANAGER_H
 
 #include "latency_collector.h"
+#include "frame_trace.h"
+#include "latency_histogram.h"
+#include "clock_sync.h"
 #include <cstdint>
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <shared_mutex>
@@ -14,6 +18,10 @@ struct TrackingInfo;
 
 struct LatencyManager
 {
+	// Called from the reassembly stage for every video shard with the times it arrived on the network
+	// thread, which never takes the clock sync lock itself.
+	void OnVideoPacketArrived(const VideoFrame& header, const std::uint64_t arrivalSteadyUs, const std::uint64_t arrivalSystemUs);
+	// Called from the reassembly stage, before FEC.
 	void OnPreVideoPacketRecieved(const VideoFrame& header);
 
 	struct PacketRecievedStatus
@@ -28,6 +36,60 @@ struct LatencyManager
 	);
 	void OnTimeSyncRecieved(const TimeSync& timeSync);
 
+	struct ClockSyncStats
+	{
+		ALXR::ClockOffsetEstimator::Estimate estimate;
+		std::uint64_t rejectedSamples;
+	};
+	ClockSyncStats GetClockSyncStats() const;
+
+	// Per-second summary of the network -> reassembly -> decoder hand-off,
+	// queue depths are in shards, times are in microseconds.
+	struct ReassemblyStats
+	{
+		std::uint32_t maxQueueDepth;
+		std::uint32_t avgQueueDepth;
+		std::uint32_t avgQueueWait;
+		std::uint32_t maxQueueWait;
+		std::uint32_t avgFecTime;
+		std::uint32_t maxFecTime;
+		std::uint32_t avgDecoderQueueTime;
+		std::uint32_t droppedShards;
+	};
+	void OnReassemblyStage
+	(
+		const std::size_t queueDepth,
+		const std::uint64_t queueWaitUs,
+		const std::uint64_t fecTimeUs,
+		const std::uint64_t decoderQueueTimeUs
+	);
+	inline void OnShardDropped() { ++m_reassemblyWindow.droppedShards; }
+	ReassemblyStats GetReassemblyStats() const;
+
+	// Per frame pipeline timestamps, feeds the frame trace and the stage latency histograms.
+	// May be called from any thread, only the first occurrence of a stage per frame is kept.
+	// timeUs is the steady clock time the stage was reached, 0 for now.
+	void OnFrameStage(const ALXR::FrameTrace::Stage stage, const std::uint64_t frameIndex, const std::uint64_t timeUs = 0);
+
+	// Matches ALXRLatencyStage.
+	enum class LatencyStage : std::uint32_t
+	{
+		Network, // first shard received -> frame complete.
+		Decode,  // decoder input -> decoder output.
+		Upload,  // decoder output -> video texture updated.
+		Render,  // video texture updated -> xrEndFrame.
+		Total,   // first shard received -> xrEndFrame.
+		Count
+	};
+	constexpr static const std::size_t LatencyStageCount = static_cast<std::size_t>(LatencyStage::Count);
+	using LatencyPercentiles = std::array<ALXR::LatencyHistogram::Percentiles, LatencyStageCount>;
+	struct LatencyReport
+	{
+		LatencyPercentiles lastSecond;
+		LatencyPercentiles sinceReset;
+	};
+	LatencyReport GetLatencyReport() const;
+
 	inline void SubmitAndSync(const std::uint64_t frameIndex, const bool reRenderOnly = false)
 	{
 		if (frameIndex == std::uint64_t(-1))
@@ -35,15 +97,32 @@ struct LatencyManager
 		LatencyCollector::Instance().submit(frameIndex);
 		if (reRenderOnly)
 			SendFrameReRenderTimeSync();
-		else
+		else {
+			OnFrameStage(ALXR::FrameTrace::Stage::Submitted, frameIndex);
 			SendTimeSync();
+		}
 	}
 
 	inline void ResetAll() {
+		m_reassemblyWindow.Reset(0);
+		m_reassemblyWindow.droppedShards = 0;
+		{
+			std::scoped_lock lk(m_reassemblyStatsMutex);
+			m_reassemblyStats = {};
+		}
+		// the histogram windows belong to the render thread, it resets them on its next submit.
+		m_latencyResetRequested.store(true, std::memory_order_release);
+		{
+			std::scoped_lock lk(m_latencyReportMutex);
+			m_lastSecondPercentiles = {};
+		}
 		m_rt_state.isFecFailed = false;
 		m_rt_state.prevVideoSequence = 0;
 		m_rt_state.lastFrameIndex = 0;
-		m_rt_state.timeDiff = 0;
+		{
+			std::scoped_lock lk(m_clockSyncMutex);
+			m_clockSync.Reset();
+		}
 		m_timeSyncSequence = uint64_t(-1);
 		LatencyCollector::Instance().resetAll();
 	}
@@ -72,6 +151,11 @@ private:
 	);
 	void SendTimeSync();
 	void SendFrameReRenderTimeSync();
+	// server - client system clock offset at clientTimeUs.
+	std::int64_t ServerClockOffset(const std::uint64_t clientTimeUs) const;
+	void UpdateLatencyWindow(const std::uint64_t nowUs);
+	// render thread only, see m_latencyResetRequested.
+	void ResetLatencyHistograms();
 
 	CallbackCtx m_callbackCtx {
 		.sendFn = nullptr,
@@ -81,13 +165,55 @@ private:
 	std::uint64_t m_timeSyncSequence = uint64_t(-1);
 	struct RecieveThreadState
 	{
-		std::atomic<std::int64_t>  timeDiff{ 0 };
 		std::uint64_t lastFrameIndex = 0;
 		std::uint32_t prevVideoSequence = 0;
 		std::atomic<bool> isFecFailed{ false };
 	};
 	RecieveThreadState m_rt_state{};
 
+	ALXR::ClockOffsetEstimator m_clockSync{};
+	mutable std::mutex m_clockSyncMutex{};
+
+	struct ReassemblyWindow
+	{
+		std::uint64_t windowStartUs = 0;
+		std::uint64_t samples = 0;
+		std::uint64_t queueDepthSum = 0;
+		std::uint64_t queueWaitSum = 0;
+		std::uint64_t fecTimeSum = 0;
+		std::uint64_t decoderQueueTimeSum = 0;
+		std::uint32_t maxQueueDepth = 0;
+		std::uint32_t maxQueueWait = 0;
+		std::uint32_t maxFecTime = 0;
+		// incremented by the network thread, taken with exchange so no drop is lost between windows.
+		std::atomic<std::uint32_t> droppedShards{ 0 };
+
+		inline void Reset(const std::uint64_t nowUs) {
+			windowStartUs = nowUs;
+			samples = queueDepthSum = queueWaitSum = fecTimeSum = decoderQueueTimeSum = 0;
+			maxQueueDepth = maxQueueWait = maxFecTime = 0;
+		}
+	};
+	ReassemblyWindow m_reassemblyWindow{};
+	ReassemblyStats m_reassemblyStats{};
+	mutable std::mutex m_reassemblyStatsMutex{};
+
+	// Direct mapped by frame index, large enough for every frame in flight.
+	struct FrameStageTimes
+	{
+		std::atomic<std::uint64_t> frameIndex{ std::uint64_t(-1) };
+		std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(ALXR::FrameTrace::Stage::Count)> timesUs{};
+	};
+	std::array<FrameStageTimes, 64> m_frameStageTimes{};
+	std::array<ALXR::LatencyHistogram, LatencyStageCount> m_latencyHistograms{};
+	// only touched by the render thread (UpdateLatencyWindow).
+	std::array<ALXR::LatencyHistogram::Window, LatencyStageCount> m_latencyWindows{};
+	std::uint64_t m_latencyWindowStartUs = 0;
+	// set by ResetAll (any thread), consumed by UpdateLatencyWindow.
+	std::atomic<bool> m_latencyResetRequested{ false };
+	LatencyPercentiles m_lastSecondPercentiles{};
+	mutable std::mutex m_latencyReportMutex{};
+
 	static LatencyManager m_instance;
 };
 #endif //ALXR_LATENCY_MANAGER_H
@@ -0,0 +1,62 @@
+#include "memory_block_ranges.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace ALXR {
+
+MemoryBlockRanges::MemoryBlockRanges(const std::uint64_t size)
+: m_freeRanges{ Range{ 0, size } },
+  m_size(size),
+  m_freeBytes(size)
+{}
+
+std::optional<std::uint64_t> MemoryBlockRanges::Allocate(const std::uint64_t size, const std::uint64_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    if (size == 0 || size > m_freeBytes)
+        return std::nullopt;
+    for (auto itr = m_freeRanges.begin(); itr != m_freeRanges.end(); ++itr) {
+        const std::uint64_t offset = (itr->offset + alignment - 1) & ~(alignment - 1);
+        const std::uint64_t rangeEnd = itr->offset + itr->size;
+        if (offset > rangeEnd || rangeEnd - offset < size)
+            continue;
+
+        const std::uint64_t head = offset - itr->offset;
+        const std::uint64_t tail = rangeEnd - (offset + size);
+        if (head == 0 && tail == 0)
+            m_freeRanges.erase(itr);
+        else if (head == 0)
+            *itr = { offset + size, tail };
+        else {
+            itr->size = head;
+            if (tail != 0)
+                m_freeRanges.insert(itr + 1, Range{ offset + size, tail });
+        }
+        m_freeBytes -= size;
+        return offset;
+    }
+    return std::nullopt;
+}
+
+void MemoryBlockRanges::Free(const std::uint64_t offset, const std::uint64_t size)
+{
+    assert(size != 0 && offset + size <= m_size);
+    const auto next = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), offset,
+        [](const Range& range, const std::uint64_t value) { return range.offset < value; });
+    assert(next == m_freeRanges.end() || offset + size <= next->offset);
+
+    const bool mergePrev = next != m_freeRanges.begin() && std::prev(next)->offset + std::prev(next)->size == offset;
+    const bool mergeNext = next != m_freeRanges.end() && offset + size == next->offset;
+    if (mergePrev && mergeNext) {
+        std::prev(next)->size += size + next->size;
+        m_freeRanges.erase(next);
+    } else if (mergePrev)
+        std::prev(next)->size += size;
+    else if (mergeNext)
+        *next = { offset, size + next->size };
+    else
+        m_freeRanges.insert(next, Range{ offset, size });
+    m_freeBytes += size;
+}
+}
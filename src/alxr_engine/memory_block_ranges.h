@@ -0,0 +1,41 @@
+#pragma once
+#ifndef ALXR_MEMORY_BLOCK_RANGES_H
+#define ALXR_MEMORY_BLOCK_RANGES_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace ALXR {
+
+    // Free ranges of one device memory block which resources are sub-allocated from.
+    //
+    // First fit over a free list sorted by offset: the head of a range skipped to reach the alignment stays
+    // free, so an allocation is returned with exactly the size and offset it was made with, and freed ranges
+    // are merged with their neighbours. Blocks hold a handful of resources, a linear scan is cheaper than
+    // any tree for that.
+    class MemoryBlockRanges {
+    public:
+        explicit MemoryBlockRanges(const std::uint64_t size);
+
+        // Offset of size bytes aligned to alignment (a power of two), nullopt if no free range fits.
+        std::optional<std::uint64_t> Allocate(const std::uint64_t size, const std::uint64_t alignment);
+
+        // Returns a range made by Allocate.
+        void Free(const std::uint64_t offset, const std::uint64_t size);
+
+        inline std::uint64_t Size() const { return m_size; }
+        inline std::uint64_t FreeBytes() const { return m_freeBytes; }
+        inline bool IsEmpty() const { return m_freeBytes == m_size; }
+
+    private:
+        struct Range {
+            std::uint64_t offset;
+            std::uint64_t size;
+        };
+        std::vector<Range> m_freeRanges;
+        std::uint64_t      m_size;
+        std::uint64_t      m_freeBytes;
+    };
+}
+#endif
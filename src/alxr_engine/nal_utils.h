@@ -50,6 +50,20 @@ constexpr inline bool is_idr(const ConstPacketType& packet, const ALVR_CODEC cod
     return is_idr(get_nal_type(packet, codec), codec);
 }
 
+// Returns the offset of the first Annex-B start code (00 00 01 or 00 00 00 01) at or after `from`,
+// the offset points at the first zero byte of the code. packet.size() if there is none.
+constexpr inline std::size_t find_start_code(const ConstPacketType& packet, const std::size_t from = 0)
+{
+    for (std::size_t i = from; i + 2 < packet.size(); ++i)
+    {
+        if (packet[i + 2] > 1)
+            i += 2;
+        else if (packet[i] == 0 && packet[i + 1] == 0 && packet[i + 2] == 1)
+            return (i > from && packet[i - 1] == 0) ? i - 1 : i;
+    }
+    return packet.size();
+}
+
 // This frame contains (VPS + )SPS + PPS + IDR on NVENC H.264 (H.265) stream.
  // (VPS + )SPS + PPS has short size (8bytes + 28bytes in some environment), so we can assume SPS + PPS is contained in first fragment.
 inline ConstPacketType find_vpssps(const ConstPacketType& packet, const ALVR_CODEC codec)
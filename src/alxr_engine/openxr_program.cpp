@@ -39,6 +39,12 @@
 
 #include "xr_utils.h"
 #include "concurrent_queue.h"
+#include "seqlock_ring.h"
+#include "rcu_ptr.h"
+#include "frame_pipeline.h"
+#include "video_reprojection.h"
+#include "thread_scheduling.h"
+#include "deadline_pacer.h"
 //#include "alxr_engine.h"
 #include "alxr_ctypes.h"
 #include "alxr_facial_eye_tracking_packet.h"
@@ -404,6 +410,7 @@ struct OpenXrProgram final : IOpenXrProgram {
     virtual ~OpenXrProgram() override {
         Log::Write(Log::Level::Verbose, "Destroying OpenXrProgram");
         
+        StopFramePipeline();
         if (IsSessionRunning()) {
             xrEndSession(m_session);
             m_sessionRunning.store(false);
@@ -2127,24 +2134,79 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
     }
 
+    // Replaced as a whole on reconfiguration, the render thread loads it once per frame.
+    struct SwapchainSet {
+        std::vector<Swapchain> swapchains;
+        std::vector<std::uint32_t> slots; // IGraphicsPlugin swapchain slot of swapchains[i].
+        std::int64_t colorFormat{-1};
+    };
+
+    // A graphics plugin swapchain slot no swapchain of the current set (or one being built) holds.
+    std::uint32_t AcquireSwapchainSlot()
+    {
+        for (std::uint32_t slot = 0; slot < IGraphicsPlugin::MaxSwapchainSlots; ++slot) {
+            const std::uint32_t slotBit = 1u << slot;
+            if ((m_usedSwapchainSlots & slotBit) == 0) {
+                m_usedSwapchainSlots |= slotBit;
+                return slot;
+            }
+        }
+        CHECK_MSG(false, "No free swapchain slot");
+        return 0;
+    }
+
+    // With the graphics plugin's extra usage flags for the format, without them if the runtime rejects them.
+    XrSwapchain CreateColorSwapchain(XrSwapchainCreateInfo& swapchainCreateInfo)
+    {
+        XrSwapchain handle = XR_NULL_HANDLE;
+        const XrSwapchainUsageFlags extraUsageFlags = m_graphicsPlugin->GetExtraSwapchainUsageFlags(swapchainCreateInfo.format);
+        if (extraUsageFlags != 0) {
+            swapchainCreateInfo.usageFlags |= extraUsageFlags;
+            const XrResult result = xrCreateSwapchain(m_session, &swapchainCreateInfo, &handle);
+            if (XR_SUCCEEDED(result))
+                return handle;
+            Log::Write(Log::Level::Warning, Fmt("Failed to create swapchain with usage flags 0x%llx, error-code: %d, creating it without them",
+                static_cast<unsigned long long>(extraUsageFlags), result));
+            swapchainCreateInfo.usageFlags &= ~extraUsageFlags;
+        }
+        CHECK_XRCMD(xrCreateSwapchain(m_session, &swapchainCreateInfo, &handle));
+        return handle;
+    }
+
+    // Also takes partially built sets, the last swapchain may not have a slot yet.
+    void DestroySwapchainSet(std::unique_ptr<SwapchainSet> swapchainSet)
+    {
+        if (swapchainSet == nullptr)
+            return;
+        for (std::size_t swapchainIndex = 0; swapchainIndex < swapchainSet->swapchains.size(); ++swapchainIndex) {
+            if (swapchainIndex < swapchainSet->slots.size()) {
+                const std::uint32_t slot = swapchainSet->slots[swapchainIndex];
+                if (const auto graphicsPlugin = m_graphicsPlugin)
+                    graphicsPlugin->ReleaseSwapchainImageStructs(slot);
+                m_usedSwapchainSlots &= ~(1u << slot);
+            }
+            xrDestroySwapchain(swapchainSet->swapchains[swapchainIndex].handle);
+        }
+    }
+
     void ClearSwapchains()
     {
-        m_swapchainImages.clear();
+        DestroySwapchainSet(m_swapchainSet.exchange(nullptr, xrconcurrency::render_rcu_domain()));
         if (const auto graphicsPlugin = m_graphicsPlugin) {
             graphicsPlugin->ClearSwapchainImageStructs();
         }
-        for (const auto& swapchain : m_swapchains)
-            xrDestroySwapchain(swapchain.handle);
-        m_swapchains.clear();
         m_configViews.clear();
     }
 
     void CreateSwapchains(const std::uint32_t eyeWidth /*= 0*/, const std::uint32_t eyeHeight /*= 0*/) override {
         CHECK(m_session != XR_NULL_HANDLE);
 
-        if (m_swapchains.size() > 0)
+        // Swapchains are built off the render thread, published as a whole and the previous ones
+        // destroyed once the render thread finished any frame still using them.
+        const SwapchainSet* const currentSet = m_swapchainSet.load();
+        if (currentSet != nullptr)
         {
-            CHECK(m_configViews.size() > 0 && m_swapchainImages.size() > 0);
+            CHECK(m_configViews.size() > 0 && currentSet->swapchains.size() > 0);
             if (eyeWidth == 0 || eyeHeight == 0)
                 return;
             const bool isSameSize = std::all_of(m_configViews.begin(), m_configViews.end(), [&](const auto& vp)
@@ -2155,13 +2217,8 @@ struct OpenXrProgram final : IOpenXrProgram {
             });
             if (isSameSize)
                 return;
-            Log::Write(Log::Level::Info, "Clearing current swapchains...");
-            ClearSwapchains();
             Log::Write(Log::Level::Info, "Creating new swapchains...");
         }
-        CHECK(m_swapchainImages.empty());
-        CHECK(m_swapchains.empty());
-        //CHECK(m_configViews.empty());
 
         // Read graphics properties for preferred swapchain length and logging.
         XrSystemProperties systemProperties{
@@ -2206,7 +2263,8 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
 
         // Create and cache view buffer for xrLocateViews later.
-        m_views.resize(viewCount, IdentityView);
+        if (m_views.size() != viewCount)
+            m_views.resize(viewCount, IdentityView);
         if (viewCount < 2)
             return;
 
@@ -2222,13 +2280,16 @@ struct OpenXrProgram final : IOpenXrProgram {
         CHECK_XRCMD(xrEnumerateSwapchainFormats(m_session, (uint32_t)swapchainFormats.size(), &swapchainFormatCount,
                                                 swapchainFormats.data()));
         CHECK(swapchainFormatCount == swapchainFormats.size());
-        m_colorSwapchainFormat = m_graphicsPlugin->SelectColorSwapchainFormat(swapchainFormats);
+        auto newSet = std::make_unique<SwapchainSet>();
+        // a failed CHECK below hands back the swapchains and slots built so far, newSet is null once published.
+        const auto newSetGuard = MakeScopeGuard([&] { DestroySwapchainSet(std::move(newSet)); });
+        newSet->colorFormat = m_graphicsPlugin->SelectColorSwapchainFormat(swapchainFormats);
 
         // Print swapchain formats and the selected one.
         {
             std::string swapchainFormatsString;
             for (int64_t format : swapchainFormats) {
-                const bool selected = format == m_colorSwapchainFormat;
+                const bool selected = format == newSet->colorFormat;
                 swapchainFormatsString += " ";
                 if (selected) {
                     swapchainFormatsString += "[";
@@ -2261,12 +2322,12 @@ struct OpenXrProgram final : IOpenXrProgram {
 
             const auto& vp = m_configViews[0];
             // Create the swapchain.
-            const XrSwapchainCreateInfo swapchainCreateInfo{
+            XrSwapchainCreateInfo swapchainCreateInfo{
                 .type = XR_TYPE_SWAPCHAIN_CREATE_INFO,
                 .next = nullptr,
                 .createFlags = 0,
                 .usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT,
-                .format = m_colorSwapchainFormat,
+                .format = newSet->colorFormat,
                 .sampleCount = m_graphicsPlugin->GetSupportedSwapchainSampleCount(vp),
                 .width = vp.recommendedImageRectWidth,
                 .height = vp.recommendedImageRectHeight,
@@ -2275,23 +2336,23 @@ struct OpenXrProgram final : IOpenXrProgram {
                 .mipCount = 1,
             };
             Swapchain swapchain{
-                .handle = XR_NULL_HANDLE,
+                .handle = CreateColorSwapchain(swapchainCreateInfo),
                 .width = static_cast<std::int32_t>(swapchainCreateInfo.width),
                 .height = static_cast<std::int32_t>(swapchainCreateInfo.height)
             };
-            CHECK_XRCMD(xrCreateSwapchain(m_session, &swapchainCreateInfo, &swapchain.handle));
             CHECK(swapchain.handle != XR_NULL_HANDLE);
 
-            m_swapchains.push_back(swapchain);
+            newSet->swapchains.push_back(swapchain);
+
+            const std::uint32_t slot = AcquireSwapchainSlot();
+            newSet->slots.push_back(slot);
 
             uint32_t imageCount = 0;
             CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, 0, &imageCount, nullptr));
             // XXX This should really just return XrSwapchainImageBaseHeader*
-            std::vector<XrSwapchainImageBaseHeader*> swapchainImages =
-                m_graphicsPlugin->AllocateSwapchainImageStructs(imageCount, swapchainCreateInfo);
+            const std::vector<XrSwapchainImageBaseHeader*> swapchainImages =
+                m_graphicsPlugin->AllocateSwapchainImageStructs(slot, imageCount, swapchainCreateInfo);
             CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, imageCount, &imageCount, swapchainImages[0]));
-
-            m_swapchainImages.insert(std::make_pair(swapchain.handle, std::move(swapchainImages)));
         }
         else
         {
@@ -2303,11 +2364,11 @@ struct OpenXrProgram final : IOpenXrProgram {
                         vp.recommendedImageRectWidth, vp.recommendedImageRectHeight, vp.recommendedSwapchainSampleCount));
 
                 // Create the swapchain.
-                const XrSwapchainCreateInfo swapchainCreateInfo{
+                XrSwapchainCreateInfo swapchainCreateInfo{
                     .type = XR_TYPE_SWAPCHAIN_CREATE_INFO,
                     .next = nullptr,
                     .usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT,
-                    .format = m_colorSwapchainFormat,
+                    .format = newSet->colorFormat,
                     .sampleCount = m_graphicsPlugin->GetSupportedSwapchainSampleCount(vp),
                     .width = vp.recommendedImageRectWidth,
                     .height = vp.recommendedImageRectHeight,
@@ -2316,25 +2377,27 @@ struct OpenXrProgram final : IOpenXrProgram {
                     .mipCount = 1,
                 };
                 Swapchain swapchain{
-                    .handle = XR_NULL_HANDLE,
+                    .handle = CreateColorSwapchain(swapchainCreateInfo),
                     .width = static_cast<std::int32_t>(swapchainCreateInfo.width),
                     .height = static_cast<std::int32_t>(swapchainCreateInfo.height)
                 };
-                CHECK_XRCMD(xrCreateSwapchain(m_session, &swapchainCreateInfo, &swapchain.handle));
                 CHECK(swapchain.handle != XR_NULL_HANDLE);
 
-                m_swapchains.push_back(swapchain);
+                newSet->swapchains.push_back(swapchain);
+
+                const std::uint32_t slot = AcquireSwapchainSlot();
+                newSet->slots.push_back(slot);
 
                 uint32_t imageCount = 0;
                 CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, 0, &imageCount, nullptr));
                 // XXX This should really just return XrSwapchainImageBaseHeader*
-                std::vector<XrSwapchainImageBaseHeader*> swapchainImages =
-                    m_graphicsPlugin->AllocateSwapchainImageStructs(imageCount, swapchainCreateInfo);
+                const std::vector<XrSwapchainImageBaseHeader*> swapchainImages =
+                    m_graphicsPlugin->AllocateSwapchainImageStructs(slot, imageCount, swapchainCreateInfo);
                 CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, imageCount, &imageCount, swapchainImages[0]));
-
-                m_swapchainImages.insert(std::make_pair(swapchain.handle, std::move(swapchainImages)));
             }
         }
+
+        DestroySwapchainSet(m_swapchainSet.exchange(std::move(newSet), xrconcurrency::render_rcu_domain()));
     }
 
     // Return event if one is available, otherwise return null.
@@ -2459,6 +2522,7 @@ struct OpenXrProgram final : IOpenXrProgram {
             case XR_SESSION_STATE_STOPPING: {
                 CHECK(m_session != XR_NULL_HANDLE);
                 StopPassthroughMode();
+                StopFramePipeline();
                 CHECK_XRCMD(xrEndSession(m_session))
                 m_sessionRunning = false;
                 break;
@@ -2700,53 +2764,104 @@ struct OpenXrProgram final : IOpenXrProgram {
         };
     }
 
-    XrSteadyClock::time_point lastFrameTime = XrSteadyClock::now();
+    // HeadlessFrameRate when set (e.g. 500-1000Hz tracking only sessions), otherwise the stream's refresh rate.
+    float HeadlessFrameRate() const {
+        if (m_options && m_options->HeadlessFrameRate > 0.0f)
+            return m_options->HeadlessFrameRate;
+        return m_streamConfig.renderConfig.refreshRate;
+    }
 
-    void HeadlessWaitFrame() {
+    std::uint64_t HeadlessWaitFrame() {
         assert(IsHeadlessSession());
-        static_assert(XrSteadyClock::is_steady);
-        using millisecondsf = std::chrono::duration<float, std::chrono::milliseconds::period>;
-        const auto targetFrameTime = millisecondsf((1.0f / m_streamConfig.renderConfig.refreshRate) * 1000.0f);
-        const auto currTime = XrSteadyClock::now();
-        const auto elapsed = std::chrono::duration_cast<millisecondsf>(currTime - lastFrameTime);
-        if (elapsed > targetFrameTime) {
-            lastFrameTime = currTime;
-            return;
-        }
-        const auto sleepTime = targetFrameTime - elapsed;
-        std::this_thread::sleep_for(sleepTime);
-        lastFrameTime = XrSteadyClock::now();
+        const std::uint64_t waitStartUs = GetSteadyTimestampUs();
+        const float frameRate = HeadlessFrameRate();
+        m_headlessPacer.SetRate(frameRate > 0.0f ? frameRate : 90.0f);
+        m_headlessPacer.Wait();
+        return GetSteadyTimestampUs() - waitStartUs;
     }
 
     void RenderFrame() override {
         if (IsHeadlessSession()) {
-            HeadlessWaitFrame();
+            const std::uint64_t frameWaitUs = HeadlessWaitFrame();
             const auto [displayTime,ignore] = XrTimeNow();
+            const XrDuration displayPeriod = std::chrono::duration_cast<std::chrono::nanoseconds>(m_headlessPacer.Period()).count();
+            m_displayPeriod.store(displayPeriod);
             m_lastPredicatedDisplayTime.store(displayTime);
             PollFaceEyeTracking(displayTime);
+            m_framePacing.OnFrame(frameWaitUs, displayTime, displayPeriod, GetSteadyTimestampUs());
             return;
         }
         RenderFrameImpl();
     }
 
-    void RenderFrameImpl() {
-        CHECK(m_session != XR_NULL_HANDLE);
+    bool WaitFrame(XrFrameState& frameState) const {
         constexpr const XrFrameWaitInfo frameWaitInfo{
             .type = XR_TYPE_FRAME_WAIT_INFO,
             .next = nullptr
         };
-        XrFrameState frameState{
+        frameState = {
             .type = XR_TYPE_FRAME_STATE,
             .next = nullptr
         };
-        if (XR_FAILED(xrWaitFrame(m_session, &frameWaitInfo, &frameState))) {
+        return XR_SUCCEEDED(xrWaitFrame(m_session, &frameWaitInfo, &frameState));
+    }
+
+    // Next frame waited on by the frame pacing thread, started on first use.
+    bool AcquirePipelinedFrame(XrFrameState& frameState) {
+        using namespace std::literals::chrono_literals;
+        if (!m_framePipeline.IsRunning()) {
+            Log::Write(Log::Level::Info, "Starting frame pacing thread, pipelined frames enabled.");
+            m_framePipeline.Start
+            (
+                [this](XrFrameState& waitedState) {
+                    ALXR::ThreadScheduling::RefreshCurrentThread();
+                    return IsSessionRunning() && WaitFrame(waitedState);
+                },
+                []() { ALXR::ThreadScheduling::ApplyRole(ALXR::ThreadScheduling::Role::FramePacing); }
+            );
+        }
+        return m_framePipeline.Acquire(frameState, 100ms);
+    }
+
+    // Begins/ends waited frames which will not be rendered so that the runtime's wait/begin pairing stays balanced.
+    void StopFramePipeline() {
+        if (!m_framePipeline.IsRunning())
+            return;
+        m_framePipeline.Stop([this](const XrFrameState& frameState) {
+            constexpr const XrFrameBeginInfo frameBeginInfo{
+                .type = XR_TYPE_FRAME_BEGIN_INFO,
+                .next = nullptr
+            };
+            if (XR_FAILED(xrBeginFrame(m_session, &frameBeginInfo)))
+                return;
+            const XrFrameEndInfo frameEndInfo{
+                .type = XR_TYPE_FRAME_END_INFO,
+                .next = nullptr,
+                .displayTime = frameState.predictedDisplayTime,
+                .environmentBlendMode = m_environmentBlendMode.load(),
+                .layerCount = 0,
+                .layers = nullptr
+            };
+            xrEndFrame(m_session, &frameEndInfo);
+        });
+        Log::Write(Log::Level::Info, "Frame pacing thread stopped.");
+    }
+
+    void RenderFrameImpl() {
+        CHECK(m_session != XR_NULL_HANDLE);
+        const bool isPipelined = m_options && m_options->PipelinedFrames;
+        const std::uint64_t waitStartUs = GetSteadyTimestampUs();
+        XrFrameState frameState;
+        if (!(isPipelined ? AcquirePipelinedFrame(frameState) : WaitFrame(frameState))) {
             if (m_renderMode.load() == RenderMode::VideoStream) {
                 m_graphicsPlugin->BeginVideoView();
                 m_graphicsPlugin->EndVideoView();
             }
             return;
         }
+        const std::uint64_t frameWaitUs = GetSteadyTimestampUs() - waitStartUs;
         m_PredicatedLatencyOffset.store(frameState.predictedDisplayPeriod);
+        m_displayPeriod.store(frameState.predictedDisplayPeriod);
         m_lastPredicatedDisplayTime.store(frameState.predictedDisplayTime);
 
         PollFaceEyeTracking(frameState.predictedDisplayTime);
@@ -2755,6 +2870,10 @@ struct OpenXrProgram final : IOpenXrProgram {
         const bool isVideoStream = renderMode == RenderMode::VideoStream;
         std::uint64_t videoFrameDisplayTime = std::uint64_t(-1);
         if (isVideoStream) {
+            // video frame indices are predicted display times on the steady clock.
+            const auto [xrTimeNow, timeNowNs] = XrTimeNow();
+            const XrTime displayTimeNs = timeNowNs + (frameState.predictedDisplayTime - xrTimeNow);
+            m_graphicsPlugin->SetVideoDisplayTime(displayTimeNs > 0 ? static_cast<std::uint64_t>(displayTimeNs) : 0);
             m_graphicsPlugin->BeginVideoView();
             videoFrameDisplayTime = m_graphicsPlugin->GetVideoFrameIndex();
         }
@@ -2763,7 +2882,11 @@ struct OpenXrProgram final : IOpenXrProgram {
         m_lastVideoFrameIndex = videoFrameDisplayTime;
         
         XrTime predictedDisplayTime;
-        const auto predictedViews = GetPredicatedViews(frameState, renderMode, videoFrameDisplayTime, /*out*/ predictedDisplayTime);
+        auto predictedViews = GetPredicatedViews(frameState, renderMode, videoFrameDisplayTime, /*out*/ predictedDisplayTime);
+        if (isVideoStream && ReprojectVideoFrame(frameState.predictedDisplayTime, predictedViews)) {
+            // the layer is submitted with the views the video frame was warped to.
+            predictedDisplayTime = frameState.predictedDisplayTime;
+        }
 
         constexpr const XrFrameBeginInfo frameBeginInfo{
             .type = XR_TYPE_FRAME_BEGIN_INFO,
@@ -2808,8 +2931,10 @@ struct OpenXrProgram final : IOpenXrProgram {
             }
         }
 
-        if (timeRender)
+        if (timeRender) {
             LatencyCollector::Instance().rendered2(videoFrameDisplayTime);
+            LatencyManager::Instance().OnFrameStage(ALXR::FrameTrace::Stage::Rendered, videoFrameDisplayTime);
+        }
 
 #ifdef XR_USE_OXR_PICO_V4
         const XrFrameEndInfoEXT xrFrameEndInfoEXT {
@@ -2837,6 +2962,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (XR_FAILED(xrEndFrame(m_session, &frameEndInfo))) {
             Log::Write(Log::Level::Verbose, "xrEndFrame failed!");
         }
+        m_framePacing.OnFrame(frameWaitUs, frameState.predictedDisplayTime, frameState.predictedDisplayPeriod, GetSteadyTimestampUs());
 
         LatencyManager::Instance().SubmitAndSync(videoFrameDisplayTime, !timeRender);
         if (isVideoStream)
@@ -2886,7 +3012,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         CHECK(viewCountOutput == viewCapacityInput);
 #if 0
         CHECK(viewCountOutput == m_configViews.size());
-        CHECK(viewCountOutput == m_swapchains.size());
+        CHECK(viewCountOutput == m_swapchainSet.load()->swapchains.size());
 #endif
         return true;
     }
@@ -2989,16 +3115,20 @@ struct OpenXrProgram final : IOpenXrProgram {
         XrCompositionLayerProjection& layer,
         const ALXR::PassthroughMode mode
     ) {
+        // valid until the end of the frame (the render thread's read section).
+        const SwapchainSet* const swapchainSet = m_swapchainSet.load();
+        if (swapchainSet == nullptr || swapchainSet->swapchains.empty())
+            return false;
         if (m_isMultiViewEnabled)
             return RenderLayerMultiView
             (
-                predictedDisplayTime, views, projectionLayerViews,
+                *swapchainSet, predictedDisplayTime, views, projectionLayerViews,
                 layer, mode
             );
         else
             return RenderLayerSeperateViews
             (
-                predictedDisplayTime, views, projectionLayerViews,
+                *swapchainSet, predictedDisplayTime, views, projectionLayerViews,
                 layer, mode
             );
     }
@@ -3024,12 +3154,18 @@ struct OpenXrProgram final : IOpenXrProgram {
         return swapchainImageIndex;
     }
 
+    constexpr static const XrSwapchainImageReleaseInfo SwapchainImageReleaseInfo{
+        .type = XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO,
+        .next = nullptr
+    };
+
     constexpr static const XrCompositionLayerFlags RenderLayerFlags =
         XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT |
         XR_COMPOSITION_LAYER_CORRECT_CHROMATIC_ABERRATION_BIT;
 
     bool RenderLayerMultiView
     (
+        const SwapchainSet& swapchainSet,
         const XrTime predictedDisplayTime,
         const std::span<const XrView>& views,
         std::array<XrCompositionLayerProjectionView, 2>& projectionLayerViews,
@@ -3037,7 +3173,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         const ALXR::PassthroughMode mode
     )
     {
-        assert(!m_swapchains.empty());
+        assert(!swapchainSet.swapchains.empty());
         assert(projectionLayerViews.size() == views.size());
         assert(m_isMultiViewEnabled);        
 
@@ -3045,7 +3181,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         const auto vizCubes = isVideoStream ? VizCubeList{} : GetVisualizedCubes(predictedDisplayTime);
         const auto ptMode = static_cast<const ::PassthroughMode>(mode);
 
-        const Swapchain& viewSwapchain = m_swapchains[0];
+        const Swapchain& viewSwapchain = swapchainSet.swapchains[0];
         const XrRect2Di imageRect {
             .offset = {0, 0},
             .extent = {viewSwapchain.width, viewSwapchain.height}
@@ -3070,17 +3206,15 @@ struct OpenXrProgram final : IOpenXrProgram {
             };
         }
 
-        const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[viewSwapchain.handle][swapchainImageIndex];
+        const SwapchainImageRef swapchainImage{ swapchainSet.slots[0], swapchainImageIndex };
         if (isVideoStream)
-            m_graphicsPlugin->RenderVideoMultiView(projectionLayerViews, swapchainImage, m_colorSwapchainFormat, ptMode);
+            m_graphicsPlugin->RenderVideoMultiView(projectionLayerViews, swapchainImage, swapchainSet.colorFormat, ptMode);
         else
-            m_graphicsPlugin->RenderMultiView(projectionLayerViews, swapchainImage, m_colorSwapchainFormat, ptMode, vizCubes);
+            m_graphicsPlugin->RenderMultiView(projectionLayerViews, swapchainImage, swapchainSet.colorFormat, ptMode, vizCubes);
+        // the image's rendering must be submitted before it is released.
+        m_graphicsPlugin->SubmitViews();
 
-        constexpr const XrSwapchainImageReleaseInfo releaseInfo{
-            .type = XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO,
-            .next = nullptr
-        };
-        if (XR_FAILED(xrReleaseSwapchainImage(viewSwapchain.handle, &releaseInfo)))
+        if (XR_FAILED(xrReleaseSwapchainImage(viewSwapchain.handle, &SwapchainImageReleaseInfo)))
             return false;
 
         layer = XrCompositionLayerProjection{
@@ -3096,6 +3230,7 @@ struct OpenXrProgram final : IOpenXrProgram {
 
     bool RenderLayerSeperateViews
     (
+        const SwapchainSet& swapchainSet,
         const XrTime predictedDisplayTime,
         const std::span<const XrView>& views,
         std::array<XrCompositionLayerProjectionView,2>& projectionLayerViews,
@@ -3108,14 +3243,21 @@ struct OpenXrProgram final : IOpenXrProgram {
         const bool isVideoStream = m_renderMode == RenderMode::VideoStream;
         const auto vizCubes = isVideoStream ? VizCubeList{} : GetVisualizedCubes(predictedDisplayTime);
         const auto ptMode = static_cast<const ::PassthroughMode>(mode);
-        // Render view to the appropriate part of the swapchain image.
+        // Each view has a separate swapchain, all are acquired first so that the views can be recorded
+        // and submitted together (see IGraphicsPlugin::SubmitViews) before being released.
+        std::array<std::uint32_t, 2> swapchainImageIndices{};
         for (std::uint32_t i = 0; i < views.size(); ++i) {
-            // Each view has a separate swapchain which is acquired, rendered to, and released.
-            const Swapchain& viewSwapchain = m_swapchains[i];
-            const std::uint32_t swapchainImageIndex = AcquireAndWaitForSwapchainImage(viewSwapchain);
-            if (swapchainImageIndex == static_cast<const std::uint32_t>(-1))
+            swapchainImageIndices[i] = AcquireAndWaitForSwapchainImage(swapchainSet.swapchains[i]);
+            if (swapchainImageIndices[i] == static_cast<const std::uint32_t>(-1)) {
+                for (std::uint32_t acquiredIndex = 0; acquiredIndex < i; ++acquiredIndex)
+                    xrReleaseSwapchainImage(swapchainSet.swapchains[acquiredIndex].handle, &SwapchainImageReleaseInfo);
                 return false;
+            }
+        }
 
+        // Render view to the appropriate part of the swapchain image.
+        for (std::uint32_t i = 0; i < views.size(); ++i) {
+            const Swapchain& viewSwapchain = swapchainSet.swapchains[i];
             const auto& view = views[i];
             projectionLayerViews[i] = {
                 .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
@@ -3131,19 +3273,21 @@ struct OpenXrProgram final : IOpenXrProgram {
                     .imageArrayIndex = 0
                 }
             };
-            const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[viewSwapchain.handle][swapchainImageIndex];
+            const SwapchainImageRef swapchainImage{ swapchainSet.slots[i], swapchainImageIndices[i] };
             if (isVideoStream)
-                m_graphicsPlugin->RenderVideoView(i, projectionLayerViews[i], swapchainImage, m_colorSwapchainFormat, ptMode);
+                m_graphicsPlugin->RenderVideoView(i, projectionLayerViews[i], swapchainImage, swapchainSet.colorFormat, ptMode);
             else
-                m_graphicsPlugin->RenderView(projectionLayerViews[i], swapchainImage, m_colorSwapchainFormat, ptMode, vizCubes);
-            
-            constexpr const XrSwapchainImageReleaseInfo releaseInfo{
-                .type = XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO,
-                .next = nullptr
-            };
-            if (XR_FAILED(xrReleaseSwapchainImage(viewSwapchain.handle, &releaseInfo)))
-                return false;
+                m_graphicsPlugin->RenderView(projectionLayerViews[i], swapchainImage, swapchainSet.colorFormat, ptMode, vizCubes);
+        }
+        m_graphicsPlugin->SubmitViews();
+
+        bool isReleased = true;
+        for (std::uint32_t i = 0; i < views.size(); ++i) {
+            if (XR_FAILED(xrReleaseSwapchainImage(swapchainSet.swapchains[i].handle, &SwapchainImageReleaseInfo)))
+                isReleased = false;
         }
+        if (!isReleased)
+            return false;
 
         layer = XrCompositionLayerProjection {
             .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION,
@@ -3344,20 +3488,36 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (renderMode == RenderMode::Lobby)
             return GetDefaultViews();
 
-        std::shared_lock<std::shared_mutex> l(m_trackingFrameMapMutex);
-        if (videoTimeStampNs != std::uint64_t(-1))
-        {
-            const auto trackingFrameItr = m_trackingFrameMap.find(videoTimeStampNs);
-            if (trackingFrameItr != m_trackingFrameMap.cend()) {
-                predicateDisplayTime = trackingFrameItr->second.displayTime;
-                return trackingFrameItr->second.views;
-            }
-        }
-        const auto result = m_trackingFrameMap.rbegin();
-        if (result == m_trackingFrameMap.rend())
+        TrackingFrame trackingFrame;
+        const bool hasTrackingFrame = videoTimeStampNs != std::uint64_t(-1) ?
+            // the exact frame may have been evicted, the closest pose is still a better match than the newest.
+            m_trackingFrames.find(videoTimeStampNs, trackingFrame) || m_trackingFrames.find_nearest(videoTimeStampNs, trackingFrame) :
+            m_trackingFrames.latest(trackingFrame);
+        if (!hasTrackingFrame)
             return GetDefaultViews();
-        predicateDisplayTime = result->second.displayTime;
-        return result->second.views;
+        predicateDisplayTime = trackingFrame.displayTime;
+        return trackingFrame.views;
+    }
+
+    // Warps the video frame from the views it was rendered with by the server (views) to views located at
+    // displayTime, views are replaced by the latter. The same frame is re-warped if no new frame arrived.
+    bool ReprojectVideoFrame(const XrTime displayTime, std::array<XrView, 2>& views)
+    {
+        const auto mode = m_options ? m_options->VideoReprojection : ALXRVideoReprojectionMode::None;
+        if (mode == ALXRVideoReprojectionMode::None)
+            return false;
+        if (m_views.size() != views.size() || !LocateViews(displayTime, (uint32_t)m_views.size(), m_views.data())) {
+            // don't leave the previous frame's warp applied to these views.
+            m_graphicsPlugin->SetVideoReprojection(nullptr);
+            return false;
+        }
+        std::array<ALXR::VideoReprojection, 2> reprojections;
+        for (std::uint32_t viewIndex = 0; viewIndex < views.size(); ++viewIndex)
+            reprojections[viewIndex] = ALXR::MakeVideoReprojection(viewIndex, views[viewIndex], m_views[viewIndex], mode);
+        if (!m_graphicsPlugin->SetVideoReprojection(reprojections.data()))
+            return false;
+        views = { m_views[0], m_views[1] };
+        return true;
     }
 
     static inline ALXREyeInfo GetEyeInfo(const XrView& left_view, const XrView& right_view)
@@ -3403,6 +3563,19 @@ struct OpenXrProgram final : IOpenXrProgram {
         return GetEyeInfo(eyeInfo, m_lastPredicatedDisplayTime);
     }
 
+    virtual bool GetDisplayTiming(XrTime& lastPredictedDisplayTime, XrDuration& displayPeriod) const override
+    {
+        lastPredictedDisplayTime = m_lastPredicatedDisplayTime.load();
+        displayPeriod = m_displayPeriod.load();
+        return lastPredictedDisplayTime > 0 && displayPeriod > 0;
+    }
+
+    virtual bool GetFramePacingStats(ALXR::FramePacingStats& stats) const override
+    {
+        stats = m_framePacing.Collect(m_framePipeline.IsRunning());
+        return stats.frames > 0;
+    }
+
     virtual bool GetTrackingInfo(TrackingInfo& info, const bool clientPredict) /*const*/ override
     {
         info = {
@@ -3423,15 +3596,10 @@ struct OpenXrProgram final : IOpenXrProgram {
 
         std::array<XrView, 2> newViews { IdentityView, IdentityView };
         LocateViews(predicatedDisplayTimeXR, (const std::uint32_t)newViews.size(), newViews.data());
-        {
-            std::unique_lock<std::shared_mutex> lock(m_trackingFrameMapMutex);
-            m_trackingFrameMap[predicatedDisplayTimeNs] = {
-                .views       = newViews,
-                .displayTime = predicatedDisplayTimeXR
-            };
-            if (m_trackingFrameMap.size() > MaxTrackingFrameCount)
-                m_trackingFrameMap.erase(m_trackingFrameMap.begin());
-        }
+        m_trackingFrames.insert(predicatedDisplayTimeNs, {
+            .views       = newViews,
+            .displayTime = predicatedDisplayTimeXR
+        });
         info.targetTimestampNs = predicatedDisplayTimeNs;
         
         const auto hmdSpaceLoc = GetSpaceLocation(m_viewSpace, predicatedDisplayTimeXR);
@@ -3814,10 +3982,9 @@ struct OpenXrProgram final : IOpenXrProgram {
     XrSystemId m_systemId{XR_NULL_SYSTEM_ID};
 
     std::vector<XrViewConfigurationView> m_configViews;
-    std::vector<Swapchain> m_swapchains;
-    std::map<XrSwapchain, std::vector<XrSwapchainImageBaseHeader*>> m_swapchainImages;
+    xrconcurrency::rcu_ptr<SwapchainSet> m_swapchainSet{}; // loaded once per frame by the render thread.
+    std::uint32_t m_usedSwapchainSlots = 0; // bit per slot, swapchain (re)creation/destruction only.
     std::vector<XrView> m_views;
-    std::int64_t m_colorSwapchainFormat{-1};
     std::atomic<RenderMode> m_renderMode{ RenderMode::Lobby };
 
     std::vector<XrSpace> m_visualizedSpaces;
@@ -3915,18 +4082,23 @@ struct OpenXrProgram final : IOpenXrProgram {
     const XrLocalDimmingFrameEndInfoMETA xrLocalDimmingFrameEndInfoMETA;
 
     std::atomic<XrTime>      m_lastPredicatedDisplayTime{ 0 };
+    std::atomic<XrDuration>  m_displayPeriod{ 0 };
+
+    ALXR::FramePipeline<XrFrameState> m_framePipeline{};
+    ALXR::FramePacingMonitor          m_framePacing{};
+    ALXR::DeadlinePacer               m_headlessPacer{};
 
 /// Tracking Thread State ////////////////////////////////////////////////////////
     struct TrackingFrame {
         std::array<XrView, 2> views;
         XrTime                displayTime;
     };
-    using TrackingFrameMap = std::map<std::uint64_t, TrackingFrame>;
-    mutable std::shared_mutex m_trackingFrameMapMutex;        
-    TrackingFrameMap          m_trackingFrameMap{};
+    // ~3 seconds of tracking frames at 360Hz, written by the tracking thread, read by the render thread.
+    static constexpr const std::size_t MaxTrackingFrameCount = 2048;
+    using TrackingFrameRing = xrconcurrency::seqlock_ring<TrackingFrame, MaxTrackingFrameCount>;
+    TrackingFrameRing         m_trackingFrames{};
     std::atomic<XrDuration>   m_PredicatedLatencyOffset{ 0 };
     std::uint64_t             m_lastVideoFrameIndex = std::uint64_t(-1);
-    static constexpr const std::size_t MaxTrackingFrameCount = 360 * 3;
 /// End Tracking Thread State ////////////////////////////////////////////////////
 
     std::vector<float> m_displayRefreshRates;
@@ -18,6 +18,7 @@ struct TrackingInfo;
 namespace ALXR {;
 struct ALXRPaths;
 struct HapticsFeedback;
+struct FramePacingStats;
 }
 
 enum class AndroidThreadType : std::int32_t {
@@ -113,6 +114,12 @@ struct IOpenXrProgram {
 
     virtual bool GetTrackingInfo(TrackingInfo& info, const bool clientPredict) /*const*/ = 0;
 
+    // Predicted display time & period of the last frame, false until the first frame has been waited on.
+    virtual bool GetDisplayTiming(XrTime& lastPredictedDisplayTime, XrDuration& displayPeriod) const = 0;
+
+    // Render loop wait/interval statistics, false until the first frame has been submitted.
+    virtual bool GetFramePacingStats(ALXR::FramePacingStats& stats) const = 0;
+
     virtual void ApplyHapticFeedback(const ALXR::HapticsFeedback&) = 0;
 
     virtual void SetStreamConfig(const ALXRStreamConfig& config) = 0;
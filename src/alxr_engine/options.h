@@ -120,17 +120,23 @@ struct Options {
     FirmwareVersion firmwareVersion{};
 
     ALXRPassthroughMode PassthroughMode = ALXRPassthroughMode::None;
+    ALXRVideoReprojectionMode VideoReprojection = ALXRVideoReprojectionMode::None;
 
     ALXRFacialExpressionType FacialTracking = ALXRFacialExpressionType::Auto;
     ALXREyeTrackingType      EyeTracking = ALXREyeTrackingType::Auto;
 
     std::uint16_t TrackingServerPortNo = 49192;
+    std::uint32_t VideoJitterBufferDepth = 0;
+    float         HeadlessFrameRate = 0.0f; // 0 uses the stream's refresh rate.
+    std::string   PipelineCacheDir{};       // empty uses the default (see ALXR::DefaultPipelineCacheDir).
 
     XrColorSpaceFB DisplayColorSpace = XR_COLOR_SPACE_QUEST_FB;
     bool DisableLinearizeSrgb=false;
     bool DisableSuggestedBindings = false;
     bool NoServerFramerateLock = false;
     bool NoFrameSkip = false;
+    bool PipelinedFrames = false;
+    bool VideoComputePass = false;
     bool DisableLocalDimming = false;
     bool HeadlessSession = false;
     bool NoFTServer = false;
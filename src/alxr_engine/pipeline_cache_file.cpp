@@ -0,0 +1,170 @@
+#include "pipeline_cache_file.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+namespace ALXR {
+namespace {
+
+    constexpr const char FileMagic[8] = { 'A', 'L', 'X', 'R', 'V', 'K', 'P', 'C' };
+    constexpr const std::uint32_t FileVersion = 1;
+
+    struct FileHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t vendorID;
+        std::uint32_t deviceID;
+        std::uint32_t driverVersion;
+        std::uint8_t  deviceUUID[16];
+        std::uint8_t  pipelineCacheUUID[16];
+        std::uint64_t dataSize;
+        std::uint64_t dataHash;
+    };
+    static_assert(sizeof(FileHeader) == 72, "FileHeader must not be padded");
+
+    // VkPipelineCacheHeaderVersionOne, the start of any driver's cache data.
+    struct VkCacheHeader {
+        std::uint32_t headerSize;
+        std::uint32_t headerVersion; // VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        std::uint32_t vendorID;
+        std::uint32_t deviceID;
+        std::uint8_t  pipelineCacheUUID[16];
+    };
+    static_assert(sizeof(VkCacheHeader) == 32);
+
+    // FNV-1a, catches truncated and corrupted files, the driver validates the data itself as well.
+    std::uint64_t HashData(const std::uint8_t* data, const std::size_t size) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            hash ^= data[idx];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    FileHeader MakeHeader(const PipelineCacheKey& key, const std::uint8_t* data, const std::size_t size) {
+        FileHeader header{};
+        std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+        header.version = FileVersion;
+        header.vendorID = key.vendorID;
+        header.deviceID = key.deviceID;
+        header.driverVersion = key.driverVersion;
+        std::memcpy(header.deviceUUID, key.deviceUUID.data(), sizeof(header.deviceUUID));
+        std::memcpy(header.pipelineCacheUUID, key.pipelineCacheUUID.data(), sizeof(header.pipelineCacheUUID));
+        header.dataSize = size;
+        header.dataHash = HashData(data, size);
+        return header;
+    }
+
+    bool IsValidVkCacheHeader(const std::vector<std::uint8_t>& data, const PipelineCacheKey& key) {
+        if (data.size() < sizeof(VkCacheHeader))
+            return false;
+        VkCacheHeader vkHeader;
+        std::memcpy(&vkHeader, data.data(), sizeof(vkHeader));
+        return vkHeader.headerSize >= sizeof(VkCacheHeader) && vkHeader.headerSize <= data.size() &&
+               vkHeader.headerVersion == 1 &&
+               vkHeader.vendorID == key.vendorID && vkHeader.deviceID == key.deviceID &&
+               std::memcmp(vkHeader.pipelineCacheUUID, key.pipelineCacheUUID.data(), sizeof(vkHeader.pipelineCacheUUID)) == 0;
+    }
+
+    // the size of the data a driver writes is bounded, anything bigger is not one of our files.
+    constexpr const std::uint64_t MaxDataSize = 256ull << 20;
+}
+
+std::vector<std::uint8_t> LoadPipelineCache(const std::string& path, const PipelineCacheKey& key)
+{
+    std::FILE* const file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return {};
+    std::vector<std::uint8_t> data;
+    FileHeader header{};
+    const FileHeader expected = MakeHeader(key, nullptr, 0);
+    if (std::fread(&header, sizeof(header), 1, file) == 1 &&
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 &&
+        header.version == expected.version &&
+        header.vendorID == expected.vendorID && header.deviceID == expected.deviceID &&
+        header.driverVersion == expected.driverVersion &&
+        std::memcmp(header.deviceUUID, expected.deviceUUID, sizeof(header.deviceUUID)) == 0 &&
+        std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, sizeof(header.pipelineCacheUUID)) == 0 &&
+        header.dataSize > 0 && header.dataSize <= MaxDataSize) {
+        data.resize(static_cast<std::size_t>(header.dataSize));
+        if (std::fread(data.data(), 1, data.size(), file) != data.size() ||
+            HashData(data.data(), data.size()) != header.dataHash ||
+            !IsValidVkCacheHeader(data, key))
+            data.clear();
+    }
+    std::fclose(file);
+    return data;
+}
+
+bool SavePipelineCache(const std::string& path, const PipelineCacheKey& key, const std::uint8_t* data, const std::size_t size)
+{
+    if (path.empty() || data == nullptr || size == 0)
+        return false;
+    std::error_code ec;
+    const std::filesystem::path filePath{ path };
+    if (filePath.has_parent_path())
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+    const std::string tmpPath = path + ".tmp";
+    std::FILE* const file = std::fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+    const FileHeader header = MakeHeader(key, data, size);
+    bool isWritten = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                     std::fwrite(data, 1, size, file) == size &&
+                     std::fflush(file) == 0;
+#ifndef _WIN32
+    // the rename must not become durable before the data.
+    isWritten = isWritten && fsync(fileno(file)) == 0;
+#endif
+    isWritten = (std::fclose(file) == 0) && isWritten;
+    if (isWritten)
+        std::filesystem::rename(tmpPath, filePath, ec);
+    if (!isWritten || ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::string PipelineCachePath(const std::string& dir, const PipelineCacheKey& key)
+{
+    if (dir.empty())
+        return {};
+    std::string name = "vk_pipeline_cache_";
+    constexpr const char HexDigits[] = "0123456789abcdef";
+    for (const std::uint8_t byte : key.deviceUUID) {
+        name += HexDigits[byte >> 4];
+        name += HexDigits[byte & 0xF];
+    }
+    name += ".bin";
+    return (std::filesystem::path{ dir } / name).string();
+}
+
+std::string DefaultPipelineCacheDir()
+{
+#if defined(XR_USE_PLATFORM_ANDROID) || defined(__ANDROID__)
+    return {};
+#elif defined(_WIN32)
+    const char* const localAppData = std::getenv("LOCALAPPDATA");
+    if (localAppData == nullptr || *localAppData == '\0')
+        return {};
+    return (std::filesystem::path{ localAppData } / "alxr").string();
+#else
+    if (const char* const xdgCacheHome = std::getenv("XDG_CACHE_HOME"); xdgCacheHome != nullptr && *xdgCacheHome == '/')
+        return (std::filesystem::path{ xdgCacheHome } / "alxr").string();
+    const char* const home = std::getenv("HOME");
+    if (home == nullptr || *home == '\0')
+        return {};
+    return (std::filesystem::path{ home } / ".cache" / "alxr").string();
+#endif
+}
+}
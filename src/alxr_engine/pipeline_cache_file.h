@@ -0,0 +1,40 @@
+#pragma once
+#ifndef ALXR_PIPELINE_CACHE_FILE_H
+#define ALXR_PIPELINE_CACHE_FILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace ALXR {
+
+    // The device and driver build a serialized pipeline cache (vkGetPipelineCacheData) was created by,
+    // the data is only handed back to the exact same one.
+    struct PipelineCacheKey {
+        std::array<std::uint8_t, 16> deviceUUID;        // VkPhysicalDeviceIDProperties::deviceUUID
+        std::array<std::uint8_t, 16> pipelineCacheUUID; // VkPhysicalDeviceProperties::pipelineCacheUUID
+        std::uint32_t vendorID;
+        std::uint32_t deviceID;
+        std::uint32_t driverVersion;
+    };
+
+    // Pipeline cache files are the cache data prefixed with a header holding the key and a hash of the data.
+    //
+    // Returns the data stored in path, empty if there is none or it does not belong to key (another device
+    // or driver version), is truncated or corrupted. Also checks the Vulkan header at the start of the data.
+    std::vector<std::uint8_t> LoadPipelineCache(const std::string& path, const PipelineCacheKey& key);
+
+    // Writes to a temporary file next to path and renames it over path, so a crash or a concurrent load
+    // never sees a partially written cache. Creates the directory if needed.
+    bool SavePipelineCache(const std::string& path, const PipelineCacheKey& key, const std::uint8_t* data, const std::size_t size);
+
+    // dir/vk_pipeline_cache_<deviceUUID>.bin, one file per device.
+    std::string PipelineCachePath(const std::string& dir, const PipelineCacheKey& key);
+
+    // The user's cache directory (%LOCALAPPDATA%, $XDG_CACHE_HOME or ~/.cache) + "/alxr", empty if there
+    // is none, e.g. on Android where the app has to pass its cache directory.
+    std::string DefaultPipelineCacheDir();
+}
+#endif
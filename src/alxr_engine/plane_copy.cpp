@@ -0,0 +1,331 @@
+#include "plane_copy.h"
+
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define ALXR_PLANE_COPY_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define ALXR_TARGET_SSE2
+        #define ALXR_TARGET_AVX2
+    #else
+        #define ALXR_TARGET_SSE2 __attribute__((target("sse2")))
+        #define ALXR_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define ALXR_PLANE_COPY_NEON
+    #include <arm_neon.h>
+    #if defined(__has_builtin)
+        #if __has_builtin(__builtin_nontemporal_store)
+            #define ALXR_HAS_NONTEMPORAL_STORE_BUILTIN
+        #endif
+    #endif
+#endif
+
+namespace ALXR::PlaneCopy {
+namespace {
+
+// Below this the cost of waking the workers outweighs splitting the copy.
+constexpr const std::size_t MinParallelBytes = 512 * 1024;
+
+inline std::size_t AlignHead(const std::uint8_t* dst, const std::size_t alignment, const std::size_t size) {
+    const std::size_t misalign = reinterpret_cast<std::uintptr_t>(dst) & (alignment - 1);
+    return std::min(size, misalign == 0 ? 0 : alignment - misalign);
+}
+
+void CopyLineMemcpy(std::uint8_t* dst, const std::uint8_t* src, const std::size_t size) {
+    std::memcpy(dst, src, size);
+}
+
+#ifdef ALXR_PLANE_COPY_X86
+ALXR_TARGET_SSE2 void CopyLineSSE2(std::uint8_t* dst, const std::uint8_t* src, const std::size_t size) {
+    std::size_t i = AlignHead(dst, 16, size);
+    std::memcpy(dst, src, i);
+    for (; i + 64 <= size; i += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), d);
+    }
+    for (; i + 16 <= size; i += 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    }
+    std::memcpy(dst + i, src + i, size - i);
+}
+
+ALXR_TARGET_AVX2 void CopyLineAVX2(std::uint8_t* dst, const std::uint8_t* src, const std::size_t size) {
+    std::size_t i = AlignHead(dst, 32, size);
+    std::memcpy(dst, src, i);
+    for (; i + 128 <= size; i += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 96), d);
+    }
+    for (; i + 32 <= size; i += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    }
+    std::memcpy(dst + i, src + i, size - i);
+}
+
+ALXR_TARGET_SSE2 void StoreFence() {
+    // streaming stores are weakly ordered, make them visible before the GPU copy is submitted.
+    _mm_sfence();
+}
+
+bool CpuSupports(const KernelType kt) {
+#if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    switch (kt) {
+    case KernelType::Memcpy: return true;
+    case KernelType::SSE2:   return sse2;
+    case KernelType::AVX2:   return avx2;
+    default: return false;
+    }
+}
+#endif
+
+#ifdef ALXR_PLANE_COPY_NEON
+inline void StreamStore(std::uint8_t* dst, const uint8x16_t v) {
+#ifdef ALXR_HAS_NONTEMPORAL_STORE_BUILTIN
+    __builtin_nontemporal_store(v, reinterpret_cast<uint8x16_t*>(dst));
+#else
+    vst1q_u8(dst, v);
+#endif
+}
+
+void CopyLineNEON(std::uint8_t* dst, const std::uint8_t* src, const std::size_t size) {
+    std::size_t i = AlignHead(dst, 16, size);
+    std::memcpy(dst, src, i);
+    for (; i + 64 <= size; i += 64) {
+        const uint8x16_t a = vld1q_u8(src + i);
+        const uint8x16_t b = vld1q_u8(src + i + 16);
+        const uint8x16_t c = vld1q_u8(src + i + 32);
+        const uint8x16_t d = vld1q_u8(src + i + 48);
+        StreamStore(dst + i, a);
+        StreamStore(dst + i + 16, b);
+        StreamStore(dst + i + 32, c);
+        StreamStore(dst + i + 48, d);
+    }
+    for (; i + 16 <= size; i += 16) {
+        StreamStore(dst + i, vld1q_u8(src + i));
+    }
+    std::memcpy(dst + i, src + i, size - i);
+}
+
+constexpr inline bool CpuSupports(const KernelType kt) {
+    return kt == KernelType::Memcpy || kt == KernelType::NEON;
+}
+#endif
+
+#if !defined(ALXR_PLANE_COPY_X86) && !defined(ALXR_PLANE_COPY_NEON)
+constexpr inline bool CpuSupports(const KernelType kt) {
+    return kt == KernelType::Memcpy;
+}
+#endif
+
+inline void NoFence() {}
+
+using CopyLineFn = void (*)(std::uint8_t*, const std::uint8_t*, const std::size_t);
+using FenceFn    = void (*)();
+struct Kernel {
+    KernelType type;
+    CopyLineFn copyLine;
+    FenceFn    fence;
+};
+
+constexpr inline Kernel MakeKernel(const KernelType kt) {
+    switch (kt) {
+#ifdef ALXR_PLANE_COPY_X86
+    case KernelType::SSE2: return { kt, &CopyLineSSE2, &StoreFence };
+    case KernelType::AVX2: return { kt, &CopyLineAVX2, &StoreFence };
+#endif
+#ifdef ALXR_PLANE_COPY_NEON
+    case KernelType::NEON: return { kt, &CopyLineNEON, &NoFence };
+#endif
+    default: return { KernelType::Memcpy, &CopyLineMemcpy, &NoFence };
+    }
+}
+
+Kernel SelectBestKernel() {
+    constexpr const KernelType Preferred[] = {
+        KernelType::AVX2, KernelType::SSE2, KernelType::NEON
+    };
+    for (const auto kt : Preferred) {
+        if (CpuSupports(kt))
+            return MakeKernel(kt);
+    }
+    return MakeKernel(KernelType::Memcpy);
+}
+
+std::atomic<const Kernel*> gActiveKernel{ nullptr };
+
+const Kernel& GetKernel() {
+    if (const auto k = gActiveKernel.load(std::memory_order_acquire))
+        return *k;
+    static const Kernel best = SelectBestKernel();
+    gActiveKernel.store(&best, std::memory_order_release);
+    return best;
+}
+} // namespace
+
+void CopyRows(const Plane& plane, const std::size_t firstRow, const std::size_t rowCount) {
+    if (rowCount == 0 || plane.rowSize == 0)
+        return;
+    const auto& kernel = GetKernel();
+    std::uint8_t* dst = plane.dst + firstRow * plane.dstPitch;
+    const std::uint8_t* src = plane.src + firstRow * plane.srcPitch;
+    if (plane.dstPitch == plane.rowSize && plane.srcPitch == plane.rowSize) {
+        kernel.copyLine(dst, src, plane.rowSize * rowCount);
+    } else {
+        for (std::size_t row = 0; row < rowCount; ++row) {
+            kernel.copyLine(dst, src, plane.rowSize);
+            dst += plane.dstPitch;
+            src += plane.srcPitch;
+        }
+    }
+    kernel.fence();
+}
+
+KernelType ActiveKernel() {
+    return GetKernel().type;
+}
+
+bool IsSupported(const KernelType kt) {
+    return CpuSupports(kt);
+}
+
+bool SetActiveKernel(const KernelType kt) {
+    if (!CpuSupports(kt))
+        return false;
+    static std::array<Kernel, std::size_t(KernelType::TypeCount)> kernels{};
+    auto& k = kernels[std::size_t(kt)];
+    k = MakeKernel(kt);
+    gActiveKernel.store(&k, std::memory_order_release);
+    return true;
+}
+
+std::size_t CopyEngine::DefaultThreadCount() {
+    const std::size_t hwThreads = std::thread::hardware_concurrency();
+    return std::clamp<std::size_t>(hwThreads / 4, 1, 4);
+}
+
+CopyEngine::CopyEngine(const std::size_t threadCount, const WorkerInitFn& workerInit) {
+    const std::size_t totalThreads = threadCount == 0 ? DefaultThreadCount() : threadCount;
+    m_workers.reserve(totalThreads - 1);
+    // part 0 is always copied by the calling thread.
+    for (std::size_t partIndex = 1; partIndex < totalThreads; ++partIndex) {
+        m_workers.emplace_back([this, partIndex, workerInit]() {
+            if (workerInit)
+                workerInit();
+            WorkerLoop(partIndex);
+        });
+    }
+}
+
+CopyEngine::~CopyEngine() {
+    {
+        std::scoped_lock lk(m_mutex);
+        m_isRunning = false;
+    }
+    m_jobReady.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+void CopyEngine::CopyPart(const Job& job, const std::size_t partIndex) {
+    const std::size_t partBegin = job.totalRows * partIndex / job.partCount;
+    const std::size_t partEnd   = job.totalRows * (partIndex + 1) / job.partCount;
+    // rows of all planes are treated as one contiguous range.
+    std::size_t planeBegin = 0;
+    for (const auto& plane : job.planes) {
+        const std::size_t planeEnd = planeBegin + plane.rows;
+        const std::size_t first = std::max(partBegin, planeBegin);
+        const std::size_t last  = std::min(partEnd, planeEnd);
+        if (first < last)
+            CopyRows(plane, first - planeBegin, last - first);
+        planeBegin = planeEnd;
+        if (planeBegin >= partEnd)
+            break;
+    }
+}
+
+void CopyEngine::WorkerLoop(const std::size_t partIndex) {
+    std::uint64_t lastGeneration = 0;
+    std::unique_lock lk(m_mutex);
+    for (;;) {
+        m_jobReady.wait(lk, [&]() { return !m_isRunning || m_generation != lastGeneration; });
+        if (!m_isRunning)
+            return;
+        lastGeneration = m_generation;
+        const Job job = m_job;
+        lk.unlock();
+
+        CopyPart(job, partIndex);
+
+        lk.lock();
+        if (--m_pendingWorkers == 0)
+            m_jobDone.notify_one();
+    }
+}
+
+void CopyEngine::Copy(const std::span<const Plane> planes) {
+    std::size_t totalRows = 0, totalBytes = 0;
+    for (const auto& plane : planes) {
+        totalRows  += plane.rows;
+        totalBytes += plane.rows * plane.rowSize;
+    }
+    if (m_workers.empty() || totalBytes < MinParallelBytes) {
+        for (const auto& plane : planes)
+            PlaneCopy::Copy(plane);
+        return;
+    }
+
+    const Job job{
+        .planes = planes,
+        .totalRows = totalRows,
+        .partCount = ThreadCount()
+    };
+    {
+        std::scoped_lock lk(m_mutex);
+        m_job = job;
+        m_pendingWorkers = m_workers.size();
+        ++m_generation;
+    }
+    m_jobReady.notify_all();
+
+    CopyPart(job, 0);
+
+    std::unique_lock lk(m_mutex);
+    m_jobDone.wait(lk, [this]() { return m_pendingWorkers == 0; });
+}
+} // namespace ALXR::PlaneCopy
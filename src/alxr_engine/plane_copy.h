@@ -0,0 +1,97 @@
+#pragma once
+#ifndef ALXR_PLANE_COPY_H
+#define ALXR_PLANE_COPY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Row based copies of decoded image planes into (mapped) GPU upload memory.
+// Destination writes use streaming (non-temporal) stores, upload memory is usually
+// write-combined / uncached so there is no point pulling it into the CPU caches.
+namespace ALXR::PlaneCopy {
+
+    enum class KernelType : std::uint32_t {
+        Memcpy,
+        SSE2,
+        AVX2,
+        NEON,
+        TypeCount
+    };
+
+    constexpr inline const char* ToString(const KernelType kt) {
+        switch (kt) {
+        case KernelType::Memcpy: return "Memcpy";
+        case KernelType::SSE2:   return "SSE2";
+        case KernelType::AVX2:   return "AVX2";
+        case KernelType::NEON:   return "NEON";
+        default: return "Unknown";
+        }
+    }
+
+    struct Plane {
+        std::uint8_t*       dst = nullptr;
+        std::size_t         dstPitch = 0;
+        const std::uint8_t* src = nullptr;
+        std::size_t         srcPitch = 0;
+        std::size_t         rowSize = 0; // bytes copied per row.
+        std::size_t         rows = 0;
+    };
+
+    // Copies rows [firstRow, firstRow + rowCount) of plane with the active kernel on the calling thread.
+    void CopyRows(const Plane& plane, const std::size_t firstRow, const std::size_t rowCount);
+    inline void Copy(const Plane& plane) { CopyRows(plane, 0, plane.rows); }
+
+    // Best kernel supported by the running CPU, selected once on first use.
+    KernelType ActiveKernel();
+    bool IsSupported(const KernelType kt);
+    // Overrides the runtime selection (e.g. for benchmarking), fails if not supported by the CPU.
+    bool SetActiveKernel(const KernelType kt);
+
+    // Splits the rows of a set of planes across a small pool of worker threads,
+    // the calling thread takes a share of the rows and Copy returns once all rows are written.
+    // Copy must only be called from one thread at a time.
+    class CopyEngine
+    {
+    public:
+        // Runs first on every worker thread, e.g. to apply thread scheduling.
+        using WorkerInitFn = std::function<void()>;
+
+        // threadCount includes the calling thread, 0 selects DefaultThreadCount().
+        explicit CopyEngine(const std::size_t threadCount = 0, const WorkerInitFn& workerInit = {});
+        ~CopyEngine();
+
+        CopyEngine(const CopyEngine&) = delete;
+        CopyEngine& operator=(const CopyEngine&) = delete;
+
+        void Copy(const std::span<const Plane> planes);
+
+        inline std::size_t ThreadCount() const { return m_workers.size() + 1; }
+
+        static std::size_t DefaultThreadCount();
+
+    private:
+        struct Job {
+            std::span<const Plane> planes{};
+            std::size_t totalRows = 0;
+            std::size_t partCount = 1;
+        };
+        void WorkerLoop(const std::size_t partIndex);
+        static void CopyPart(const Job& job, const std::size_t partIndex);
+
+        std::vector<std::thread> m_workers{};
+        std::mutex               m_mutex{};
+        std::condition_variable  m_jobReady{};
+        std::condition_variable  m_jobDone{};
+        Job                      m_job{};
+        std::uint64_t            m_generation = 0;
+        std::size_t              m_pendingWorkers = 0;
+        bool                     m_isRunning = true;
+    };
+}
+#endif
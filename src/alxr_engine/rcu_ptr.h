@@ -0,0 +1,110 @@
+#pragma once
+#ifndef ALXR_RCU_PTR_H
+#define ALXR_RCU_PTR_H
+
+#include <cstdint>
+#include <cassert>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace xrconcurrency
+{
+	// Quiescent state based reclamation for state read by a single thread, e.g. the render thread.
+	//
+	// The reader brackets every pass over the shared state (a frame) with read_lock/read_unlock, two
+	// atomic increments, it never waits. Writers publish replacement state (see rcu_ptr) and call
+	// synchronize before destroying what they replaced: it returns once the reader has left the read
+	// section it was in, if any, after which the reader can only see the new state. The reader being
+	// outside of a read section (between frames, not rendering at all) is a quiescent state.
+	class rcu_domain
+	{
+	public:
+		constexpr rcu_domain() noexcept = default;
+		rcu_domain(const rcu_domain&) = delete;
+		rcu_domain& operator=(const rcu_domain&) = delete;
+
+		inline void read_lock() noexcept
+		{
+			[[maybe_unused]] const std::uint64_t seq = m_readerSeq.fetch_add(1, std::memory_order_seq_cst);
+			assert((seq & 1) == 0); // read sections do not nest.
+		}
+
+		inline void read_unlock() noexcept
+		{
+			m_readerSeq.fetch_add(1, std::memory_order_release);
+		}
+
+		// Writer: waits until the reader has passed a quiescent point, never call from within a read section.
+		void synchronize() const
+		{
+			const std::uint64_t seq = m_readerSeq.load(std::memory_order_seq_cst);
+			if ((seq & 1) == 0)
+				return;
+			for (std::uint32_t spinCount = 0; m_readerSeq.load(std::memory_order_acquire) == seq; ++spinCount) {
+				if (spinCount < 64)
+					std::this_thread::yield();
+				else
+					std::this_thread::sleep_for(std::chrono::microseconds(250));
+			}
+		}
+
+	private:
+		// odd while the reader is in a read section.
+		std::atomic<std::uint64_t> m_readerSeq{ 0 };
+	};
+
+	class rcu_read_guard
+	{
+	public:
+		explicit rcu_read_guard(rcu_domain& domain) noexcept
+		: m_domain(domain) { m_domain.read_lock(); }
+		~rcu_read_guard() noexcept { m_domain.read_unlock(); }
+		rcu_read_guard(const rcu_read_guard&) = delete;
+		rcu_read_guard& operator=(const rcu_read_guard&) = delete;
+	private:
+		rcu_domain& m_domain;
+	};
+
+	// Owning pointer to immutable-once-published state of an rcu_domain.
+	//
+	// The reader loads it once per read section and may use the object until read_unlock. Writers build
+	// a new object off to the side and exchange it in, the previous object is handed back once no reader
+	// can still be using it. Writers must be serialized by the caller.
+	template < typename Tp >
+	class rcu_ptr
+	{
+	public:
+		constexpr rcu_ptr() noexcept = default;
+		rcu_ptr(const rcu_ptr&) = delete;
+		rcu_ptr& operator=(const rcu_ptr&) = delete;
+		~rcu_ptr() { delete m_ptr.load(std::memory_order_relaxed); }
+
+		// Reader (within a read section) or writer.
+		inline Tp* load() const noexcept
+		{
+			return m_ptr.load(std::memory_order_seq_cst);
+		}
+
+		// Writer: publishes newValue and returns the previous value after a grace period.
+		std::unique_ptr<Tp> exchange(std::unique_ptr<Tp> newValue, const rcu_domain& domain)
+		{
+			Tp* const oldValue = m_ptr.exchange(newValue.release(), std::memory_order_seq_cst);
+			if (oldValue != nullptr)
+				domain.synchronize();
+			return std::unique_ptr<Tp>(oldValue);
+		}
+
+	private:
+		std::atomic<Tp*> m_ptr{ nullptr };
+	};
+
+	// The render thread's domain, each frame it renders is one read section (see alxr_process_frame).
+	inline rcu_domain& render_rcu_domain() noexcept
+	{
+		static rcu_domain domain{};
+		return domain;
+	}
+}
+#endif
@@ -0,0 +1,194 @@
+#pragma once
+#ifndef ALXR_SEQLOCK_RING_H
+#define ALXR_SEQLOCK_RING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+namespace xrconcurrency
+{
+	// Fixed capacity single-writer/multi-reader map of timestamp -> Tp, for per-frame state which is
+	// written by one thread and looked up by timestamp from others (e.g. tracking poses by display time).
+	//
+	// Slots are found by hashing the timestamp, probing a few neighbours, a new timestamp replaces
+	// the oldest entry among them. Every slot is guarded by its own sequence counter: the writer never
+	// waits and readers never block it, a reader which overlaps a write of the same slot simply retries.
+	// Values are copied in/out as atomic words so that torn reads are detected instead of being UB.
+	// No allocations, Tp must be trivially copyable.
+	template < typename Tp, const std::size_t Capacity >
+	class seqlock_ring
+	{
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+		static_assert(std::is_trivially_copyable_v<Tp>);
+
+		constexpr static const std::size_t ProbeCount = 4;
+		constexpr static const std::size_t Mask = Capacity - 1;
+		constexpr static const std::size_t WordCount = (sizeof(Tp) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+		using Words = std::array<std::uint64_t, WordCount>;
+
+		struct Slot
+		{
+			std::atomic<std::uint64_t> seq{ 0 };   // 0 = empty, odd while being written.
+			std::atomic<std::uint64_t> key{ 0 };
+			std::atomic<std::uint64_t> order{ 0 }; // insertion counter, lowest is evicted first.
+			std::array<std::atomic<std::uint64_t>, WordCount> value{};
+		};
+		std::array<Slot, Capacity> m_slots{};
+		std::uint64_t m_insertCount = 0; // writer only.
+		std::atomic<std::size_t> m_latest{ Capacity }; // slot of the last insert, Capacity = none.
+
+		static inline std::size_t hash(const std::uint64_t key)
+		{
+			// fibonacci hashing, timestamps are clustered in their low bits.
+			return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
+		}
+
+		// consistent (seq, key) pair of a slot, false if empty.
+		static inline bool read_key(const Slot& slot, std::uint64_t& key)
+		{
+			for (;;) {
+				const std::uint64_t seq = slot.seq.load(std::memory_order_acquire);
+				if (seq == 0)
+					return false;
+				if (seq & 1)
+					continue;
+				key = slot.key.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.seq.load(std::memory_order_relaxed) == seq)
+					return true;
+			}
+		}
+
+		// copies a slot's value if it (still) holds key.
+		static inline bool read_value(const Slot& slot, const std::uint64_t key, Tp& value)
+		{
+			for (;;) {
+				const std::uint64_t seq = slot.seq.load(std::memory_order_acquire);
+				if (seq == 0)
+					return false;
+				if (seq & 1)
+					continue;
+				if (slot.key.load(std::memory_order_relaxed) != key)
+					return false;
+				Words words;
+				for (std::size_t idx = 0; idx < WordCount; ++idx)
+					words[idx] = slot.value[idx].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.seq.load(std::memory_order_relaxed) != seq)
+					continue;
+				std::memcpy(&value, words.data(), sizeof(Tp));
+				return true;
+			}
+		}
+
+	public:
+		seqlock_ring() = default;
+		seqlock_ring(const seqlock_ring&) = delete;
+		seqlock_ring(seqlock_ring&&) = delete;
+		seqlock_ring& operator=(const seqlock_ring&) = delete;
+		seqlock_ring& operator=(seqlock_ring&&) = delete;
+
+		constexpr inline std::size_t capacity() const { return Capacity; }
+
+		// Writer: inserts or replaces the value for key.
+		inline void insert(const std::uint64_t key, const Tp& value)
+		{
+			const std::size_t home = hash(key);
+			std::size_t target = home & Mask;
+			std::uint64_t targetOrder = std::uint64_t(-1);
+			for (std::size_t probe = 0; probe < ProbeCount; ++probe) {
+				const std::size_t slotIdx = (home + probe) & Mask;
+				const Slot& slot = m_slots[slotIdx];
+				// only this thread writes, plain loads are consistent.
+				if (slot.seq.load(std::memory_order_relaxed) == 0) {
+					target = slotIdx;
+					break;
+				}
+				if (slot.key.load(std::memory_order_relaxed) == key) {
+					target = slotIdx;
+					break;
+				}
+				const std::uint64_t order = slot.order.load(std::memory_order_relaxed);
+				if (order < targetOrder) {
+					targetOrder = order;
+					target = slotIdx;
+				}
+			}
+
+			Words words{};
+			std::memcpy(words.data(), &value, sizeof(Tp));
+			Slot& slot = m_slots[target];
+			const std::uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+			slot.seq.store(seq + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.key.store(key, std::memory_order_relaxed);
+			slot.order.store(++m_insertCount, std::memory_order_relaxed);
+			for (std::size_t idx = 0; idx < WordCount; ++idx)
+				slot.value[idx].store(words[idx], std::memory_order_relaxed);
+			slot.seq.store(seq + 2, std::memory_order_release);
+			m_latest.store(target, std::memory_order_release);
+		}
+
+		// Readers: all lookups are wait-free with respect to the writer.
+		inline bool find(const std::uint64_t key, Tp& value) const
+		{
+			const std::size_t home = hash(key);
+			for (std::size_t probe = 0; probe < ProbeCount; ++probe) {
+				if (read_value(m_slots[(home + probe) & Mask], key, value))
+					return true;
+			}
+			return false;
+		}
+
+		// Value with the timestamp closest to key, scans the whole ring.
+		inline bool find_nearest(const std::uint64_t key, Tp& value, std::uint64_t* foundKey = nullptr) const
+		{
+			constexpr const std::size_t MaxAttempts = 4;
+			for (std::size_t attempt = 0; attempt < MaxAttempts; ++attempt) {
+				std::size_t bestIdx = Capacity;
+				std::uint64_t bestKey = 0, bestDist = std::uint64_t(-1);
+				for (std::size_t slotIdx = 0; slotIdx < Capacity; ++slotIdx) {
+					std::uint64_t slotKey = 0;
+					if (!read_key(m_slots[slotIdx], slotKey))
+						continue;
+					const std::uint64_t dist = slotKey > key ? slotKey - key : key - slotKey;
+					if (dist < bestDist) {
+						bestDist = dist;
+						bestKey = slotKey;
+						bestIdx = slotIdx;
+					}
+				}
+				if (bestIdx == Capacity)
+					return false;
+				// the entry may have been replaced since the scan.
+				if (read_value(m_slots[bestIdx], bestKey, value)) {
+					if (foundKey)
+						*foundKey = bestKey;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Most recently inserted value.
+		inline bool latest(Tp& value, std::uint64_t* foundKey = nullptr) const
+		{
+			for (;;) {
+				const std::size_t slotIdx = m_latest.load(std::memory_order_acquire);
+				if (slotIdx >= Capacity)
+					return false;
+				std::uint64_t key = 0;
+				if (read_key(m_slots[slotIdx], key) && read_value(m_slots[slotIdx], key, value)) {
+					if (foundKey)
+						*foundKey = key;
+					return true;
+				}
+			}
+		}
+	};
+}
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+#ifndef ALXR_SLICE_STREAMER_H
+#define ALXR_SLICE_STREAMER_H
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <span>
+
+#include "ALVR-common/packet_types.h"
+#include "nal_utils.h"
+
+// Forwards each NAL unit (slice) of a video frame to the decoder as soon as all of the
+// data packets covering it have arrived in order, instead of waiting for FEC to report the
+// whole frame complete. Data packets are laid out the same way as in FECQueue, packet N
+// holds frame bytes [N * ALVR_MAX_VIDEO_BUFFER_SIZE, (N + 1) * ALVR_MAX_VIDEO_BUFFER_SIZE),
+// parity packets (past frameByteSize) are ignored here and left to FECQueue.
+// A frame which is abandoned (the next frame starts before FEC completed it) after some of its
+// NALs were already forwarded is reported as broken, the decoder holds a truncated access unit.
+//
+// Only used from the reassembly thread.
+class SliceStreamer
+{
+    std::vector<std::uint8_t> m_frameBuffer;
+    std::vector<bool>         m_receivedPackets;
+    std::uint64_t m_videoFrameIndex = std::uint64_t(-1);
+    std::uint64_t m_trackingFrameIndex = std::uint64_t(-1);
+    std::size_t   m_frameByteSize  = 0;
+    std::size_t   m_contiguousEnd  = 0; // bytes [0, m_contiguousEnd) have all arrived.
+    std::size_t   m_nextPacket     = 0; // first data packet not yet counted in m_contiguousEnd.
+    std::size_t   m_forwardedEnd   = 0; // bytes [0, m_forwardedEnd) were sent to the decoder.
+
+    constexpr static const std::size_t PacketStride = ALVR_MAX_VIDEO_BUFFER_SIZE;
+
+    // a much older index is taken as the server restarting its frame count, not a late packet.
+    inline bool IsOlderFrame(const VideoFrame& header) const
+    {
+        constexpr const std::uint64_t MaxLateFrames = 8;
+        return m_videoFrameIndex != std::uint64_t(-1) && header.videoFrameIndex < m_videoFrameIndex &&
+               m_videoFrameIndex - header.videoFrameIndex <= MaxLateFrames;
+    }
+
+    template < typename BrokenFrameFn >
+    inline void BeginFrame(const VideoFrame& header, BrokenFrameFn&& onBrokenFrame)
+    {
+        if (m_forwardedEnd > 0 && m_forwardedEnd < m_frameByteSize)
+            onBrokenFrame(m_trackingFrameIndex);
+        m_videoFrameIndex = header.videoFrameIndex;
+        m_trackingFrameIndex = header.trackingFrameIndex;
+        m_frameByteSize = header.frameByteSize;
+        // both only ever grow, keeps steady-state allocation free.
+        if (m_frameBuffer.size() < m_frameByteSize)
+            m_frameBuffer.resize(m_frameByteSize);
+        const std::size_t dataPackets = (m_frameByteSize + PacketStride - 1) / PacketStride;
+        m_receivedPackets.assign(dataPackets, false);
+        m_contiguousEnd = m_nextPacket = m_forwardedEnd = 0;
+    }
+
+    template < typename ForwardFn >
+    inline void ForwardCompleteNals(ForwardFn&& forward, const std::uint64_t trackingFrameIndex)
+    {
+        const ConstPacketType available{ m_frameBuffer.data(), m_contiguousEnd };
+        const bool isFrameComplete = m_contiguousEnd == m_frameByteSize;
+        while (m_forwardedEnd < m_contiguousEnd) {
+            // skip over the current NAL's start code before searching for the next one.
+            const std::size_t nextNal = find_start_code(available, m_forwardedEnd + 3);
+            if (nextNal == available.size() && !isFrameComplete)
+                return; // NAL may continue into packets that have not arrived yet.
+            forward(available.subspan(m_forwardedEnd, nextNal - m_forwardedEnd), trackingFrameIndex);
+            m_forwardedEnd = nextNal;
+        }
+    }
+
+public:
+    inline std::size_t ForwardedBytes() const { return m_forwardedEnd; }
+
+    // forward: void(const ConstPacketType& nal, const std::uint64_t trackingFrameIndex)
+    // onBrokenFrame: void(const std::uint64_t trackingFrameIndex), a partially forwarded frame was abandoned.
+    template < typename ForwardFn, typename BrokenFrameFn >
+    void AddPacket(const VideoFrame& header, const ConstPacketType& payload, ForwardFn&& forward, BrokenFrameFn&& onBrokenFrame)
+    {
+        // late packets of a frame already moved past, its NALs must not be sent again.
+        if (IsOlderFrame(header))
+            return;
+        if (header.videoFrameIndex != m_videoFrameIndex)
+            BeginFrame(header, onBrokenFrame);
+
+        const std::size_t packetIndex = header.fecIndex;
+        if (packetIndex >= m_receivedPackets.size() || m_receivedPackets[packetIndex])
+            return;
+        const std::size_t offset = packetIndex * PacketStride;
+        const std::size_t size = std::min(payload.size(), m_frameByteSize - offset);
+        std::memcpy(m_frameBuffer.data() + offset, payload.data(), size);
+        m_receivedPackets[packetIndex] = true;
+
+        if (packetIndex != m_nextPacket)
+            return; // out of order or a gap, wait for the missing packet or FEC.
+        while (m_nextPacket < m_receivedPackets.size() && m_receivedPackets[m_nextPacket])
+            ++m_nextPacket;
+        m_contiguousEnd = std::min(m_nextPacket * PacketStride, m_frameByteSize);
+        ForwardCompleteNals(forward, header.trackingFrameIndex);
+    }
+
+    // Called once FEC has the whole frame, forwards whatever has not been sent yet.
+    template < typename ForwardFn, typename BrokenFrameFn >
+    void CompleteFrame(const VideoFrame& header, const ConstPacketType& frame, ForwardFn&& forward, BrokenFrameFn&& onBrokenFrame)
+    {
+        if (IsOlderFrame(header))
+            return;
+        if (header.videoFrameIndex != m_videoFrameIndex) {
+            BeginFrame(header, onBrokenFrame);
+        }
+        const std::size_t frameSize = std::min(frame.size(), m_frameByteSize);
+        if (m_forwardedEnd < frameSize)
+            forward(frame.subspan(m_forwardedEnd, frameSize - m_forwardedEnd), header.trackingFrameIndex);
+        m_forwardedEnd = m_contiguousEnd = frameSize;
+        m_nextPacket = m_receivedPackets.size();
+    }
+};
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef ALXR_SPSC_RING_H
+#define ALXR_SPSC_RING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <atomicops.h>
+
+namespace xrconcurrency
+{
+	constexpr inline const std::size_t CacheLineSize = 64;
+
+	// Fixed capacity single-producer/single-consumer ring of pre-constructed slots.
+	// Slots are written/read in-place and never destroyed until the ring is, so element types
+	// which own memory (e.g. std::vector) keep their capacity and steady-state use is allocation free.
+	// The consumer can block on an empty ring, the producer never blocks.
+	template < typename Tp >
+	class spsc_ring
+	{
+		using Semaphore = moodycamel::spsc_sema::LightweightSemaphore;
+
+		std::vector<Tp>  m_slots;
+		const std::size_t m_mask;
+		alignas(CacheLineSize) std::atomic<std::size_t> m_head{ 0 }; // written by producer.
+		alignas(CacheLineSize) std::atomic<std::size_t> m_tail{ 0 }; // written by consumer.
+		Semaphore m_itemsAvailable{};
+
+		static constexpr inline std::size_t next_pow2(std::size_t n)
+		{
+			std::size_t p = 1;
+			while (p < n) p <<= 1;
+			return p;
+		}
+
+	public:
+		explicit spsc_ring(const std::size_t capacity)
+		: m_slots(next_pow2(capacity)),
+		  m_mask(next_pow2(capacity) - 1) {}
+
+		spsc_ring(const spsc_ring&) = delete;
+		spsc_ring(spsc_ring&&) = delete;
+		spsc_ring& operator=(const spsc_ring&) = delete;
+		spsc_ring& operator=(spsc_ring&&) = delete;
+
+		inline std::size_t capacity() const { return m_slots.size(); }
+
+		inline std::size_t size_approx() const
+		{
+			return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+		}
+
+		// Producer: returns the next free slot or nullptr if the ring is full,
+		// the slot is only made visible to the consumer after commit_push.
+		inline Tp* begin_push()
+		{
+			const std::size_t head = m_head.load(std::memory_order_relaxed);
+			if (head - m_tail.load(std::memory_order_acquire) >= m_slots.size())
+				return nullptr;
+			return &m_slots[head & m_mask];
+		}
+
+		inline void commit_push()
+		{
+			m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			m_itemsAvailable.signal();
+		}
+
+		// Consumer: waits up-to timeout for the oldest slot, nullptr on timeout.
+		// The slot stays owned by the consumer until commit_pop.
+		template < typename Rep, typename Period >
+		inline Tp* wait_front(const std::chrono::duration<Rep, Period>& timeout)
+		{
+			using namespace std::chrono;
+			if (!m_itemsAvailable.wait(duration_cast<microseconds>(timeout).count()))
+				return nullptr;
+			const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+			assert(tail != m_head.load(std::memory_order_acquire));
+			return &m_slots[tail & m_mask];
+		}
+
+		inline void commit_pop()
+		{
+			m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+	};
+}
+#endif
@@ -0,0 +1,249 @@
+#include "stream_capture.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+	#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "logger.h"
+#include "timing.h"
+
+namespace ALXR::StreamCapture {
+namespace {
+	template < typename Tp >
+	inline std::span<const std::uint8_t> AsBytes(const Tp& value) {
+		return { reinterpret_cast<const std::uint8_t*>(&value), sizeof(Tp) };
+	}
+}
+
+bool Writer::Open(const std::string& path)
+{
+	std::scoped_lock controlLock(m_controlMutex);
+	if (m_writerThread.joinable())
+		return false;
+	m_file = std::fopen(path.c_str(), "wb");
+	if (m_file == nullptr) {
+		Log::Write(Log::Level::Error, Fmt("Failed to open stream capture file: %s", path.c_str()));
+		return false;
+	}
+
+	m_startTimeUs = GetSteadyTimestampUs();
+	FileHeader header{
+		.magic = {},
+		.version = Version,
+		.videoFrameSize = sizeof(VideoFrame),
+		.timeSyncSize = sizeof(TimeSync),
+		.reserved = 0,
+		.startTimeUs = m_startTimeUs
+	};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	std::fwrite(&header, sizeof(header), 1, m_file);
+	m_bytesWritten = sizeof(header);
+	{
+		std::scoped_lock lk(m_mutex);
+		m_pending.clear();
+		// video shards arrive in bursts, start with enough room for a few frames.
+		m_pending.reserve(4 * 1024 * 1024);
+		m_recordsDropped = 0;
+		m_isClosing = false;
+	}
+	m_writerThread = std::thread([this]() { WriterThread(); });
+	m_isOpen.store(true, std::memory_order_release);
+	Log::Write(Log::Level::Info, Fmt("Stream capture started: %s", path.c_str()));
+	return true;
+}
+
+void Writer::Close()
+{
+	std::scoped_lock controlLock(m_controlMutex);
+	if (!m_writerThread.joinable())
+		return;
+	m_isOpen.store(false, std::memory_order_release);
+	{
+		std::scoped_lock lk(m_mutex);
+		m_isClosing = true;
+	}
+	m_pendingCV.notify_one();
+	m_writerThread.join();
+	std::fclose(m_file);
+	m_file = nullptr;
+	Log::Write(Log::Level::Info, Fmt("Stream capture finished, %llu bytes written, %llu records dropped.",
+		static_cast<unsigned long long>(m_bytesWritten), static_cast<unsigned long long>(m_recordsDropped)));
+}
+
+void Writer::WriterThread()
+{
+	Buffer writing{};
+	writing.reserve(m_pending.capacity());
+	for (;;) {
+		{
+			std::unique_lock lk(m_mutex);
+			m_pendingCV.wait(lk, [this]() { return !m_pending.empty() || m_isClosing; });
+			// closing, everything queued before Close has been written.
+			if (m_pending.empty())
+				break;
+			writing.swap(m_pending);
+		}
+		std::fwrite(writing.data(), 1, writing.size(), m_file);
+		m_bytesWritten += writing.size();
+		writing.clear();
+	}
+}
+
+void Writer::WriteRecord(const RecordType type, const std::uint64_t timestampUs, const std::span<const std::uint8_t> first, const std::span<const std::uint8_t> second)
+{
+	const std::uint64_t nowUs = GetSteadyTimestampUs();
+	const std::size_t payloadSize = first.size() + second.size();
+	const std::size_t recordSize = sizeof(RecordHeader) + AlignRecord(payloadSize);
+	{
+		std::scoped_lock lk(m_mutex);
+		if (!IsOpen() || m_isClosing)
+			return;
+		if (m_pending.size() + recordSize > MaxPendingBytes) {
+			++m_recordsDropped;
+			return;
+		}
+		const RecordHeader recordHeader{
+			.type = type,
+			.size = static_cast<std::uint32_t>(payloadSize),
+			.timestampUs = timestampUs == ArrivalTime ? nowUs - m_startTimeUs : timestampUs
+		};
+		const std::size_t offset = m_pending.size();
+		// zero filled, covers the padding.
+		m_pending.resize(offset + recordSize);
+		std::uint8_t* dst = m_pending.data() + offset;
+		std::memcpy(dst, &recordHeader, sizeof(recordHeader));
+		dst += sizeof(recordHeader);
+		std::memcpy(dst, first.data(), first.size());
+		if (!second.empty())
+			std::memcpy(dst + first.size(), second.data(), second.size());
+	}
+	m_pendingCV.notify_one();
+}
+
+void Writer::WriteDecoderConfig(const ALXRDecoderConfig& config, const std::uint64_t timestampUs)
+{
+	WriteRecord(RecordType::DecoderConfig, timestampUs, AsBytes(config));
+}
+
+void Writer::WriteVideoPacket(const VideoFrame& header, const std::span<const std::uint8_t> packet, const std::uint64_t timestampUs)
+{
+	WriteRecord(RecordType::VideoPacket, timestampUs, AsBytes(header), packet);
+}
+
+void Writer::WriteTimeSync(const TimeSync& timeSync, const std::uint64_t timestampUs)
+{
+	WriteRecord(RecordType::TimeSync, timestampUs, AsBytes(timeSync));
+}
+
+bool Reader::Open(const std::string& path)
+{
+	Close();
+#ifdef _WIN32
+	const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		Log::Write(Log::Level::Error, Fmt("Failed to open stream capture file: %s", path.c_str()));
+		return false;
+	}
+	m_fileHandle = file;
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < LONGLONG(sizeof(FileHeader))) {
+		Close();
+		return false;
+	}
+	m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mappingHandle == nullptr) {
+		Close();
+		return false;
+	}
+	m_data = reinterpret_cast<const std::uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		Log::Write(Log::Level::Error, Fmt("Failed to open stream capture file: %s", path.c_str()));
+		return false;
+	}
+	struct stat fileStat {};
+	if (::fstat(fd, &fileStat) != 0 || fileStat.st_size < off_t(sizeof(FileHeader))) {
+		::close(fd);
+		return false;
+	}
+	void* const mapped = ::mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		Log::Write(Log::Level::Error, Fmt("Failed to map stream capture file: %s", path.c_str()));
+		return false;
+	}
+	::madvise(mapped, static_cast<std::size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+	m_data = reinterpret_cast<const std::uint8_t*>(mapped);
+	m_size = static_cast<std::size_t>(fileStat.st_size);
+#endif
+	if (m_data == nullptr) {
+		Close();
+		return false;
+	}
+
+	const auto& header = Header();
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) {
+		Log::Write(Log::Level::Error, Fmt("%s is not a (version %u) stream capture file.", path.c_str(), Version));
+		Close();
+		return false;
+	}
+	if (header.videoFrameSize != sizeof(VideoFrame) || header.timeSyncSize != sizeof(TimeSync)) {
+		Log::Write(Log::Level::Error, "Stream capture was recorded with incompatible packet types.");
+		Close();
+		return false;
+	}
+	Rewind();
+	return true;
+}
+
+void Reader::Close()
+{
+#ifdef _WIN32
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mappingHandle != nullptr)
+		CloseHandle(m_mappingHandle);
+	if (m_fileHandle != nullptr)
+		CloseHandle(m_fileHandle);
+	m_mappingHandle = m_fileHandle = nullptr;
+#else
+	if (m_data != nullptr)
+		::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_offset = sizeof(FileHeader);
+}
+
+bool Reader::Next(Record& record)
+{
+	if (m_data == nullptr || m_offset + sizeof(RecordHeader) > m_size)
+		return false;
+	const auto& recordHeader = *reinterpret_cast<const RecordHeader*>(m_data + m_offset);
+	const std::size_t payloadOffset = m_offset + sizeof(RecordHeader);
+	if (payloadOffset + recordHeader.size > m_size)
+		return false;
+	record = {
+		.type = recordHeader.type,
+		.timestampUs = recordHeader.timestampUs,
+		.payload = { m_data + payloadOffset, recordHeader.size }
+	};
+	m_offset = payloadOffset + AlignRecord(recordHeader.size);
+	return true;
+}
+}
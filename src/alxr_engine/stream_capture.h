@@ -0,0 +1,136 @@
+#pragma once
+#ifndef ALXR_STREAM_CAPTURE_H
+#define ALXR_STREAM_CAPTURE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string>
+#include <vector>
+
+#include "alxr_ctypes.h"
+#include "ALVR-common/packet_types.h"
+
+// Append-only capture of the stream as seen by the client, for offline replay.
+//
+// Layout: FileHeader followed by records, every record starts on an 8 byte boundary
+// so a memory mapped file can be walked in place:
+//   RecordHeader | payload (RecordHeader::size bytes) | padding to 8 bytes
+// Payloads are the raw in-memory structs (ALXRDecoderConfig, VideoFrame + shard bytes, TimeSync),
+// captures are only meant to be replayed by a build of the same architecture.
+namespace ALXR::StreamCapture {
+
+	constexpr inline const char Magic[8] = { 'A','L','X','R','C','A','P','\0' };
+	constexpr inline const std::uint32_t Version = 1;
+
+	struct FileHeader {
+		char          magic[8];
+		std::uint32_t version;
+		std::uint32_t videoFrameSize; // sizeof(VideoFrame) of the recording build.
+		std::uint32_t timeSyncSize;   // sizeof(TimeSync) of the recording build.
+		std::uint32_t reserved;
+		std::uint64_t startTimeUs;    // steady clock time the capture was opened.
+	};
+	static_assert(sizeof(FileHeader) % 8 == 0);
+
+	enum class RecordType : std::uint32_t {
+		DecoderConfig,
+		VideoPacket,
+		TimeSync
+	};
+
+	struct RecordHeader {
+		RecordType    type;
+		std::uint32_t size;        // payload size in bytes, excluding padding.
+		std::uint64_t timestampUs; // arrival time relative to FileHeader::startTimeUs.
+	};
+	static_assert(sizeof(RecordHeader) % 8 == 0);
+
+	constexpr inline std::size_t AlignRecord(const std::size_t size) {
+		return (size + 7) & ~std::size_t(7);
+	}
+
+	// Thread-safe, records may come from the network and time sync threads.
+	// Records are only copied into a pending buffer by the calling thread,
+	// a dedicated writer thread does the disk I/O.
+	class Writer {
+		using Buffer = std::vector<std::uint8_t>;
+		// bounds the memory held while the disk falls behind, records past this are dropped.
+		constexpr static const std::size_t MaxPendingBytes = 64 * 1024 * 1024;
+
+		std::FILE*              m_file = nullptr; // owned by the writer thread while open.
+		std::thread             m_writerThread{};
+		std::mutex              m_controlMutex{};
+		std::mutex              m_mutex{};
+		std::condition_variable m_pendingCV{};
+		Buffer                  m_pending{};
+		std::uint64_t           m_startTimeUs = 0;
+		std::uint64_t           m_bytesWritten = 0;
+		std::uint64_t           m_recordsDropped = 0;
+		std::atomic<bool>       m_isOpen{ false };
+		bool                    m_isClosing = false;
+
+		void WriteRecord(const RecordType type, const std::uint64_t timestampUs, const std::span<const std::uint8_t> first, const std::span<const std::uint8_t> second = {});
+		void WriterThread();
+
+	public:
+		// Records are stamped with their arrival time unless a timestamp (relative to the capture start) is given,
+		// e.g. for synthesized streams.
+		constexpr static const std::uint64_t ArrivalTime = std::uint64_t(-1);
+
+		Writer() = default;
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+		inline ~Writer() { Close(); }
+
+		bool Open(const std::string& path);
+		// Flushes every pending record and joins the writer thread.
+		void Close();
+		inline bool IsOpen() const { return m_isOpen.load(std::memory_order_acquire); }
+
+		void WriteDecoderConfig(const ALXRDecoderConfig& config, const std::uint64_t timestampUs = ArrivalTime);
+		void WriteVideoPacket(const VideoFrame& header, const std::span<const std::uint8_t> packet, const std::uint64_t timestampUs = ArrivalTime);
+		void WriteTimeSync(const TimeSync& timeSync, const std::uint64_t timestampUs = ArrivalTime);
+	};
+
+	struct Record {
+		RecordType    type;
+		std::uint64_t timestampUs;
+		std::span<const std::uint8_t> payload;
+
+		// Payloads come from a file, check Holds before As.
+		template < typename Tp >
+		inline bool Holds() const { return payload.size() >= sizeof(Tp); }
+		template < typename Tp >
+		inline const Tp& As() const { return *reinterpret_cast<const Tp*>(payload.data()); }
+	};
+
+	// Read-only memory mapped view of a capture file.
+	class Reader {
+		const std::uint8_t* m_data = nullptr;
+		std::size_t         m_size = 0;
+		std::size_t         m_offset = sizeof(FileHeader);
+#ifdef _WIN32
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+#endif
+	public:
+		Reader() = default;
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+		inline ~Reader() { Close(); }
+
+		bool Open(const std::string& path);
+		void Close();
+
+		inline const FileHeader& Header() const { return *reinterpret_cast<const FileHeader*>(m_data); }
+		inline void Rewind() { m_offset = sizeof(FileHeader); }
+		// false at the end of the capture, a truncated trailing record is treated as the end.
+		bool Next(Record& record);
+	};
+}
+#endif
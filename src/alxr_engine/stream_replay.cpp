@@ -0,0 +1,274 @@
+#include "pch.h"
+#include "common.h"
+#include "options.h"
+#include "graphicsplugin.h"
+#include "openxr_program.h"
+#include "alxr_engine.h"
+#include "decoder_thread.h"
+#include "latency_manager.h"
+#include "stream_capture.h"
+#include "thread_scheduling.h"
+#include "timing.h"
+
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#ifndef XR_DISABLE_DECODER_THREAD
+namespace {
+
+// Just enough of an IOpenXrProgram for the decoder plugins, video frames go to the headless graphics plugin.
+struct ReplayProgram final : IOpenXrProgram {
+
+    ReplayProgram(const std::shared_ptr<IGraphicsPlugin>& graphicsPlugin, const ALXRDecoderConfig& decoderConfig)
+    : m_graphicsPlugin(graphicsPlugin) {
+        m_streamConfig.decoderConfig = decoderConfig;
+    }
+
+    virtual void CreateInstance() override {}
+    virtual void InitializeSystem(const ALXR::ALXRPaths&) override {}
+    virtual void InitializeSession() override {}
+    virtual void CreateSwapchains(const std::uint32_t, const std::uint32_t) override {}
+    virtual void PollEvents(bool* exitRenderLoop, bool* requestRestart) override {
+        *exitRenderLoop = *requestRestart = false;
+    }
+    virtual bool IsSessionRunning() const override { return true; }
+    virtual bool IsSessionFocused() const override { return true; }
+    virtual void PollActions() override {}
+    virtual void PollFaceEyeTracking(ALXRFacialEyePacket&) override {}
+    virtual void PollHandTracking(ALXRHandTracking&) override {}
+    virtual void RenderFrame() override {}
+
+    virtual void SetRenderMode(const RenderMode newMode) override { m_renderMode = newMode; }
+    virtual RenderMode GetRenderMode() const override { return m_renderMode; }
+
+    virtual bool GetSystemProperties(ALXRSystemProperties&) const override { return false; }
+    virtual bool GetTrackingInfo(TrackingInfo&, const bool) override { return false; }
+    virtual bool GetDisplayTiming(XrTime&, XrDuration&) const override { return false; }
+    virtual bool GetFramePacingStats(ALXR::FramePacingStats&) const override { return false; }
+    virtual void ApplyHapticFeedback(const ALXR::HapticsFeedback&) override {}
+
+    virtual void SetStreamConfig(const ALXRStreamConfig& config) override { m_streamConfig = config; }
+    virtual bool GetStreamConfig(ALXRStreamConfig& config) const override {
+        config = m_streamConfig;
+        return true;
+    }
+
+    virtual void RequestExitSession() override {}
+    virtual bool GetGuardianData(ALXRGuardianData&) override { return false; }
+    virtual bool GetEyeInfo(ALXREyeInfo&, const XrTime&) const override { return false; }
+    virtual bool GetEyeInfo(ALXREyeInfo&) const override { return false; }
+
+    virtual std::shared_ptr<const IGraphicsPlugin> GetGraphicsPlugin() const override { return m_graphicsPlugin; }
+    virtual std::shared_ptr<IGraphicsPlugin> GetGraphicsPlugin() override { return m_graphicsPlugin; }
+
+    virtual std::tuple<XrTime, std::int64_t> XrTimeNow() const override { return { 0, 0 }; }
+
+    virtual void Pause() override {}
+    virtual void Resume() override {}
+
+    virtual bool IsHeadlessSession() const override { return true; }
+    virtual bool IsHandTrackingEnabled() const override { return false; }
+    virtual bool IsFacialTrackingEnabled() const override { return false; }
+    virtual bool IsEyeTrackingEnabled() const override { return false; }
+
+private:
+    std::shared_ptr<IGraphicsPlugin> m_graphicsPlugin;
+    ALXRStreamConfig                 m_streamConfig{};
+    std::atomic<RenderMode>          m_renderMode{ RenderMode::Lobby };
+};
+
+ALXRReplayStageTimes MakeStageTimes(std::vector<std::uint64_t>& samples) {
+    if (samples.empty())
+        return { 0, 0, 0, 0 };
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](const double p) {
+        return samples[std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()))];
+    };
+    return { percentile(0.50), percentile(0.99), percentile(0.999), samples.back() };
+}
+
+// Per-frame timestamps shared between the replay, reassembly and decoder threads.
+struct ReplayTimings {
+    std::mutex mutex{};
+    std::unordered_map<std::uint64_t, std::uint64_t> reassembledTimeUs{};
+    std::vector<std::uint64_t> fecTimes{};
+    std::vector<std::uint64_t> decodeTimes{};
+    std::vector<std::uint64_t> uploadTimes{};
+    std::uint64_t framesUploaded = 0;
+
+    void OnReassembled(const VideoFrame& header, const std::uint64_t fecTimeUs) {
+        const std::uint64_t nowUs = GetSteadyTimestampUs();
+        std::scoped_lock lk(mutex);
+        fecTimes.push_back(fecTimeUs);
+        reassembledTimeUs[header.trackingFrameIndex] = nowUs;
+    }
+
+    void OnUploaded(const std::uint64_t frameIndex, const std::uint64_t uploadTimeUs) {
+        const std::uint64_t uploadStartUs = GetSteadyTimestampUs() - uploadTimeUs;
+        std::scoped_lock lk(mutex);
+        ++framesUploaded;
+        uploadTimes.push_back(uploadTimeUs);
+        const auto itr = reassembledTimeUs.find(frameIndex);
+        if (itr == reassembledTimeUs.end())
+            return;
+        if (uploadStartUs > itr->second)
+            decodeTimes.push_back(uploadStartUs - itr->second);
+        reassembledTimeUs.erase(itr);
+    }
+
+    std::uint64_t FramesUploaded() {
+        std::scoped_lock lk(mutex);
+        return framesUploaded;
+    }
+};
+
+void ReplayNoopSetWaitingNextIDR(const bool) {}
+void ReplayNoopRequestIDR() {}
+} // namespace
+
+bool alxr_replay_stream_capture(const ALXRReplayOptions* replayOptions, ALXRReplayStats* stats)
+{
+    using namespace std::literals::chrono_literals;
+    if (replayOptions == nullptr || replayOptions->capturePath == nullptr || stats == nullptr)
+        return false;
+    *stats = {};
+
+    ALXR::ThreadScheduling::SetLogOutput([](const char* message) { Log::Write(Log::Level::Info, message); });
+    ALXR::StreamCapture::Reader reader{};
+    if (!reader.Open(replayOptions->capturePath))
+        return false;
+
+    using ALXR::StreamCapture::Record;
+    using ALXR::StreamCapture::RecordType;
+    Record record{};
+    const ALXRDecoderConfig* decoderConfig = nullptr;
+    while (decoderConfig == nullptr && reader.Next(record)) {
+        if (record.type == RecordType::DecoderConfig && record.Holds<ALXRDecoderConfig>())
+            decoderConfig = &record.As<ALXRDecoderConfig>();
+    }
+    if (decoderConfig == nullptr) {
+        Log::Write(Log::Level::Error, "Stream capture has no decoder config record.");
+        return false;
+    }
+    reader.Rewind();
+
+    std::shared_ptr<IGraphicsPlugin> graphicsPlugin{ nullptr };
+    try {
+        auto options = std::make_shared<Options>();
+        options->GraphicsPlugin = "Headless";
+        graphicsPlugin = CreateGraphicsPlugin(options, nullptr);
+    } catch (const std::exception& ex) {
+        Log::Write(Log::Level::Error, Fmt("Failed to create replay graphics plugin: %s", ex.what()));
+        return false;
+    }
+
+    auto timings = std::make_shared<ReplayTimings>();
+    graphicsPlugin->SetVideoUploadObserver([timings](const std::uint64_t frameIndex, const std::uint64_t uploadTimeUs) {
+        timings->OnUploaded(frameIndex, uploadTimeUs);
+    });
+    const auto programPtr = std::make_shared<ReplayProgram>(graphicsPlugin, *decoderConfig);
+
+    const auto clientCtx = std::make_shared<ALXRClientCtx>();
+    clientCtx->setWaitingNextIDR = &ReplayNoopSetWaitingNextIDR;
+    clientCtx->requestIDR = &ReplayNoopRequestIDR;
+    clientCtx->decoderType = replayOptions->decoderType;
+
+    XrDecoderThread decoderThread{};
+    decoderThread.Start({
+        .decoderConfig = *decoderConfig,
+        .programPtr = programPtr,
+        .clientCtx = clientCtx,
+        .reassemblyObserver = [timings](const VideoFrame& header, const std::uint64_t fecTimeUs) {
+            timings->OnReassembled(header, fecTimeUs);
+        }
+    });
+    Log::Write(Log::Level::Info, Fmt("Replaying %s at %s speed.", replayOptions->capturePath, replayOptions->maxSpeed ? "max" : "original"));
+
+    const auto replayStart = XrSteadyClock::now();
+    std::uint64_t lastFrameIndex = std::uint64_t(-1);
+    std::uint64_t shortRecords = 0;
+    while (reader.Next(record)) {
+        if (!replayOptions->maxSpeed)
+            std::this_thread::sleep_until(replayStart + std::chrono::microseconds(record.timestampUs));
+
+        switch (record.type) {
+        case RecordType::VideoPacket: {
+            if (!record.Holds<VideoFrame>()) {
+                ++shortRecords;
+                break;
+            }
+            const auto& header = record.As<VideoFrame>();
+            const auto payload = record.payload.subspan(sizeof(VideoFrame));
+            if (header.trackingFrameIndex != lastFrameIndex) {
+                lastFrameIndex = header.trackingFrameIndex;
+                ++stats->framesInCapture;
+            }
+            // at max speed apply back-pressure instead of overflowing the shard ring,
+            // so the replay measures pipeline throughput rather than drops.
+            if (replayOptions->maxSpeed) {
+                const std::size_t capacity = decoderThread.ReassemblyQueueCapacity();
+                while (decoderThread.ReassemblyQueueDepth() >= capacity / 2)
+                    std::this_thread::sleep_for(100us);
+            }
+            if (!decoderThread.QueuePacket(header, XrDecoderThread::VideoPacket{ payload.data(), payload.size() }))
+                ++stats->shardsDropped;
+            ++stats->packetsReplayed;
+        } break;
+        case RecordType::TimeSync:
+            if (!record.Holds<TimeSync>()) {
+                ++shortRecords;
+                break;
+            }
+            // mode 1 is a round trip with the recording's server, its client/server timestamps are not on the
+            // replay clock and would only pollute the live clock offset estimate (and send a reply to nowhere).
+            if (record.As<TimeSync>().mode != 1)
+                LatencyManager::Instance().OnTimeSyncRecieved(record.As<TimeSync>());
+            break;
+        case RecordType::DecoderConfig:
+            // mid-stream reconfiguration is not replayed, the first config applies to the whole capture.
+            break;
+        }
+    }
+    if (shortRecords > 0)
+        Log::Write(Log::Level::Warning, Fmt("Skipped %llu stream capture records too short for their type.", static_cast<unsigned long long>(shortRecords)));
+
+    // let the decoder drain, a frame still in flight shows up as an upload within this window.
+    constexpr static const auto DrainIdleTimeout = 500ms;
+    std::uint64_t lastUploaded = timings->FramesUploaded();
+    auto lastProgress = XrSteadyClock::now();
+    while (XrSteadyClock::now() - lastProgress < DrainIdleTimeout) {
+        std::this_thread::sleep_for(10ms);
+        const std::uint64_t uploaded = timings->FramesUploaded();
+        if (uploaded != lastUploaded || decoderThread.ReassemblyQueueDepth() > 0) {
+            lastUploaded = uploaded;
+            lastProgress = XrSteadyClock::now();
+        }
+    }
+    stats->durationUs = std::chrono::duration_cast<std::chrono::microseconds>(XrSteadyClock::now() - replayStart - DrainIdleTimeout).count();
+
+    decoderThread.GetPacketStats(stats->decoderStats);
+    decoderThread.Stop();
+    graphicsPlugin->SetVideoUploadObserver({});
+
+    std::scoped_lock lk(timings->mutex);
+    stats->framesUploaded = timings->framesUploaded;
+    stats->framesDropped = stats->framesInCapture > stats->framesUploaded ?
+        stats->framesInCapture - stats->framesUploaded : 0;
+    stats->fec = MakeStageTimes(timings->fecTimes);
+    stats->decode = MakeStageTimes(timings->decodeTimes);
+    stats->upload = MakeStageTimes(timings->uploadTimes);
+    return true;
+}
+#else
+bool alxr_replay_stream_capture(const ALXRReplayOptions*, ALXRReplayStats*)
+{
+    Log::Write(Log::Level::Error, "Stream capture replay requires the decoder thread.");
+    return false;
+}
+#endif
@@ -0,0 +1,329 @@
+#include "thread_scheduling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace ALXR::ThreadScheduling {
+namespace {
+
+    // used when a realtime policy is not permitted.
+    constexpr const std::int32_t FallbackNiceness = -10;
+
+    std::mutex gMutex{};
+    Config     gConfig{};
+    bool       gRealtimeDefaults = false;
+    std::array<Params, RoleCount> gGranted{};
+    std::array<bool, RoleCount>   gHasGrant{};
+    std::atomic<LogFn>            gLogFn{ nullptr };
+    // bumped when the effective params may have changed.
+    std::atomic<std::uint32_t>    gGeneration{ 1 };
+    thread_local std::uint32_t    tlsAppliedGeneration = 0;
+    thread_local Role             tlsRole = Role::Count;
+    thread_local const char*      tlsThreadName = nullptr;
+    // set while the calling thread runs with a policy/affinity this module changed, so that Default and
+    // cpuMask 0 restore the OS defaults for those threads but leave threads it never touched alone.
+    thread_local bool             tlsPolicyChanged = false;
+    thread_local bool             tlsAffinityChanged = false;
+
+    inline std::size_t ToIndex(const Role role) { return static_cast<std::size_t>(role); }
+
+    std::uint64_t AllCpusMask() {
+        const std::size_t cpuCount = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 64);
+        return cpuCount == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << cpuCount) - 1;
+    }
+
+    std::uint64_t ProcessCpuMask();
+
+    Params EffectiveParams(const Role role, const Config& config, const bool realtimeDefaults) {
+        Params params = config[ToIndex(role)];
+        if (params.policy == Policy::Default && realtimeDefaults) {
+            const Params rtParams = RealtimeDefaults(role);
+            params.policy   = rtParams.policy;
+            params.priority = rtParams.priority;
+        }
+        if (params.cpuMask == 0) {
+            std::uint64_t reservedCpus = 0;
+            for (std::size_t idx = 0; idx < RoleCount; ++idx) {
+                if (idx != ToIndex(role) && config[idx].exclusiveCpus)
+                    reservedCpus |= config[idx].cpuMask;
+            }
+            const std::uint64_t freeCpus = ProcessCpuMask() & ~reservedCpus;
+            if (reservedCpus != 0 && freeCpus != 0)
+                params.cpuMask = freeCpus;
+        }
+        return params;
+    }
+
+#ifdef _WIN32
+    int ToWin32Priority(const Params& params) {
+        switch (params.policy) {
+        case Policy::Fifo:
+        case Policy::RoundRobin:
+            return params.priority >= 50 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+        case Policy::Nice:
+            if (params.priority <= -10) return THREAD_PRIORITY_HIGHEST;
+            if (params.priority < 0)    return THREAD_PRIORITY_ABOVE_NORMAL;
+            if (params.priority > 0)    return THREAD_PRIORITY_BELOW_NORMAL;
+            return THREAD_PRIORITY_NORMAL;
+        default: return THREAD_PRIORITY_NORMAL;
+        }
+    }
+
+    // Policy::Default maps to THREAD_PRIORITY_NORMAL, which undoes an earlier role's priority.
+    bool ApplyPolicy(const Params& params) {
+        return SetThreadPriority(GetCurrentThread(), ToWin32Priority(params)) != 0;
+    }
+
+    std::uint64_t ProcessCpuMask() {
+        static const std::uint64_t processMask = [] {
+            DWORD_PTR processAffinity = 0, systemAffinity = 0;
+            if (GetProcessAffinityMask(GetCurrentProcess(), &processAffinity, &systemAffinity) && processAffinity != 0)
+                return static_cast<std::uint64_t>(processAffinity);
+            return AllCpusMask();
+        }();
+        return processMask;
+    }
+
+    // 0 restores the process' affinity.
+    bool ApplyAffinity(const std::uint64_t cpuMask) {
+        const std::uint64_t mask = cpuMask != 0 ? cpuMask : ProcessCpuMask();
+        return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(mask)) != 0;
+    }
+#else
+    inline pid_t CurrentTid() { return static_cast<pid_t>(::syscall(SYS_gettid)); }
+
+    bool SetNiceness(const std::int32_t niceness) {
+        // SCHED_OTHER first in case a realtime policy was applied before.
+        const sched_param sp{ .sched_priority = 0 };
+        pthread_setschedparam(pthread_self(), SCHED_OTHER, &sp);
+        return ::setpriority(PRIO_PROCESS, static_cast<id_t>(CurrentTid()), std::clamp(niceness, -20, 19)) == 0;
+    }
+
+    bool SetRealtime(const int policy, const std::int32_t priority) {
+        const sched_param sp{
+            .sched_priority = std::clamp<int>(priority, sched_get_priority_min(policy), sched_get_priority_max(policy))
+        };
+        return pthread_setschedparam(pthread_self(), policy, &sp) == 0;
+    }
+
+    bool ApplyPolicy(const Params& params) {
+        switch (params.policy) {
+        case Policy::Fifo:
+        case Policy::RoundRobin:
+            if (SetRealtime(params.policy == Policy::Fifo ? SCHED_FIFO : SCHED_RR, params.priority))
+                return true;
+            // typically EPERM without CAP_SYS_NICE / RLIMIT_RTPRIO.
+            return SetNiceness(FallbackNiceness);
+        case Policy::Nice:
+            return SetNiceness(params.priority);
+        // back to SCHED_OTHER / nice 0, undoes an earlier role or the realtime defaults.
+        default: return SetNiceness(0);
+        }
+    }
+
+    // CPUs the process may run on, taken before any role changed a thread's affinity
+    // (the process id's affinity is the main thread's, which can take a role itself).
+    const cpu_set_t& ProcessCpuSet() {
+        static const cpu_set_t processCpuSet = [] {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            if (::sched_getaffinity(::getpid(), sizeof(cpuSet), &cpuSet) != 0 || CPU_COUNT(&cpuSet) == 0) {
+                for (std::size_t cpu = 0; cpu < std::min<std::size_t>(CPU_SETSIZE, std::thread::hardware_concurrency()); ++cpu)
+                    CPU_SET(cpu, &cpuSet);
+            }
+            return cpuSet;
+        }();
+        return processCpuSet;
+    }
+
+    std::uint64_t ProcessCpuMask() {
+        const cpu_set_t& cpuSet = ProcessCpuSet();
+        std::uint64_t mask = 0;
+        for (std::size_t cpu = 0; cpu < 64; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet))
+                mask |= std::uint64_t(1) << cpu;
+        }
+        return mask != 0 ? mask : AllCpusMask();
+    }
+
+    // 0 restores the process' affinity, including CPUs past the first 64.
+    bool ApplyAffinity(const std::uint64_t cpuMask) {
+        if (cpuMask == 0)
+            return ::sched_setaffinity(0, sizeof(cpu_set_t), &ProcessCpuSet()) == 0;
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (std::size_t cpu = 0; cpu < 64; ++cpu) {
+            if (cpuMask & (std::uint64_t(1) << cpu))
+                CPU_SET(cpu, &cpuSet);
+        }
+        // pid 0 is the calling thread.
+        return ::sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+    }
+#endif
+}
+
+Params RealtimeDefaults(const Role role) {
+    switch (role) {
+    case Role::Network:    return { .policy = Policy::Fifo,       .priority = 3 };
+    case Role::Reassembly: return { .policy = Policy::Fifo,       .priority = 2 };
+    case Role::Render:     return { .policy = Policy::Fifo,       .priority = 2 };
+    // wakes up from xrWaitFrame and hands the frame to the render thread.
+    case Role::FramePacing: return { .policy = Policy::Fifo,      .priority = 2 };
+    // short periodic bursts, pose age depends on waking up on time.
+    case Role::Tracking:   return { .policy = Policy::Fifo,       .priority = 3 };
+    // decoders/copy engines run several worker threads which inherit the policy, let them time slice.
+    case Role::Decode:     return { .policy = Policy::RoundRobin, .priority = 1 };
+    case Role::Upload:     return { .policy = Policy::RoundRobin, .priority = 1 };
+    default: return {};
+    }
+}
+
+void SetConfig(const Config& config) {
+    std::scoped_lock lk(gMutex);
+    if (gConfig == config)
+        return;
+    gConfig = config;
+    ++gGeneration;
+}
+
+Config GetConfig() {
+    std::scoped_lock lk(gMutex);
+    return gConfig;
+}
+
+void SetRealtimeDefaults(const bool enable) {
+    std::scoped_lock lk(gMutex);
+    if (gRealtimeDefaults == enable)
+        return;
+    gRealtimeDefaults = enable;
+    ++gGeneration;
+}
+
+Params QueryCurrentThread() {
+    Params params{};
+#ifdef _WIN32
+    switch (GetThreadPriority(GetCurrentThread())) {
+    case THREAD_PRIORITY_TIME_CRITICAL: params = { .policy = Policy::Fifo, .priority = 50 };  break;
+    case THREAD_PRIORITY_HIGHEST:       params = { .policy = Policy::Fifo, .priority = 1 };   break;
+    case THREAD_PRIORITY_ABOVE_NORMAL:  params = { .policy = Policy::Nice, .priority = -5 };  break;
+    case THREAD_PRIORITY_BELOW_NORMAL:  params = { .policy = Policy::Nice, .priority = 5 };   break;
+    default: break;
+    }
+#else
+    int policy = SCHED_OTHER;
+    sched_param sp{};
+    if (pthread_getschedparam(pthread_self(), &policy, &sp) == 0 && (policy == SCHED_FIFO || policy == SCHED_RR)) {
+        params.policy = policy == SCHED_FIFO ? Policy::Fifo : Policy::RoundRobin;
+        params.priority = sp.sched_priority;
+    } else {
+        errno = 0;
+        const int niceness = ::getpriority(PRIO_PROCESS, static_cast<id_t>(CurrentTid()));
+        if (errno == 0 && niceness != 0) {
+            params.policy = Policy::Nice;
+            params.priority = niceness;
+        }
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (::sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (std::size_t cpu = 0; cpu < 64; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet))
+                params.cpuMask |= std::uint64_t(1) << cpu;
+        }
+    }
+#endif
+    return params;
+}
+
+Params ApplyToCurrentThread(const Role role) {
+    Params requested{};
+    {
+        std::scoped_lock lk(gMutex);
+        requested = EffectiveParams(role, gConfig, gRealtimeDefaults);
+    }
+    if (requested.policy != Policy::Default || tlsPolicyChanged) {
+        ApplyPolicy(requested);
+        tlsPolicyChanged = requested.policy != Policy::Default;
+    }
+    bool affinitySet = false;
+    if (requested.cpuMask != 0 || tlsAffinityChanged) {
+        affinitySet = ApplyAffinity(requested.cpuMask);
+        tlsAffinityChanged = requested.cpuMask != 0;
+    }
+
+    Params granted = QueryCurrentThread();
+    granted.exclusiveCpus = requested.exclusiveCpus;
+#ifdef _WIN32
+    granted.cpuMask = affinitySet ? requested.cpuMask : 0;
+#else
+    (void)affinitySet;
+#endif
+    {
+        std::scoped_lock lk(gMutex);
+        gGranted[ToIndex(role)] = granted;
+        gHasGrant[ToIndex(role)] = true;
+    }
+    return granted;
+}
+
+void SetLogOutput(const LogFn logFn) {
+    gLogFn.store(logFn, std::memory_order_release);
+}
+
+Params ApplyRole(const Role role, const char* threadName) {
+    // taken before the config is read, a concurrent change is picked up by the next RefreshCurrentThread.
+    tlsAppliedGeneration = gGeneration.load(std::memory_order_acquire);
+    tlsRole = role;
+    tlsThreadName = threadName;
+    const Params granted = ApplyToCurrentThread(role);
+    if (const LogFn logFn = gLogFn.load(std::memory_order_acquire)) {
+        char message[128];
+        std::snprintf(message, sizeof(message), "%s thread scheduling: %s",
+            threadName != nullptr ? threadName : ToString(role), ToString(granted).c_str());
+        logFn(message);
+    }
+    return granted;
+}
+
+bool RefreshCurrentThread() {
+    if (tlsRole == Role::Count || tlsAppliedGeneration == gGeneration.load(std::memory_order_relaxed))
+        return false;
+    ApplyRole(tlsRole, tlsThreadName);
+    return true;
+}
+
+bool GetGranted(const Role role, Params& granted) {
+    std::scoped_lock lk(gMutex);
+    if (!gHasGrant[ToIndex(role)])
+        return false;
+    granted = gGranted[ToIndex(role)];
+    return true;
+}
+
+std::string ToString(const Params& params) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%s/%d cpus=0x%llx%s", ToString(params.policy), params.priority,
+        static_cast<unsigned long long>(params.cpuMask), params.exclusiveCpus ? " (exclusive)" : "");
+    return buffer;
+}
+}
@@ -0,0 +1,105 @@
+#pragma once
+#ifndef ALXR_THREAD_SCHEDULING_H
+#define ALXR_THREAD_SCHEDULING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <string>
+
+// Per-role scheduling policy, priority and CPU affinity for the engine's latency critical threads.
+//
+// Requests degrade gracefully: a realtime policy the process is not permitted to use (no CAP_SYS_NICE /
+// RLIMIT_RTPRIO) falls back to a niceness bump, which falls back to the default policy. What was actually
+// granted is read back from the OS and kept per role.
+namespace ALXR::ThreadScheduling {
+
+    // Matches ALXRThreadRole.
+    enum class Role : std::uint32_t {
+        Network,
+        Reassembly,
+        Decode,
+        Upload,
+        Render,
+        Tracking,
+        FramePacing,
+        Count
+    };
+    constexpr inline const std::size_t RoleCount = static_cast<std::size_t>(Role::Count);
+
+    // Matches ALXRSchedPolicy.
+    enum class Policy : std::uint32_t {
+        Default,
+        Nice,
+        Fifo,
+        RoundRobin
+    };
+
+    constexpr inline const char* ToString(const Role role) {
+        switch (role) {
+        case Role::Network:    return "network";
+        case Role::Reassembly: return "reassembly";
+        case Role::Decode:     return "decode";
+        case Role::Upload:     return "upload";
+        case Role::Render:     return "render";
+        case Role::Tracking:   return "tracking";
+        case Role::FramePacing: return "frame pacing";
+        default: return "unknown";
+        }
+    }
+
+    constexpr inline const char* ToString(const Policy policy) {
+        switch (policy) {
+        case Policy::Default:    return "default";
+        case Policy::Nice:       return "nice";
+        case Policy::Fifo:       return "fifo";
+        case Policy::RoundRobin: return "rr";
+        default: return "unknown";
+        }
+    }
+
+    struct Params {
+        Policy        policy = Policy::Default;
+        // realtime priority (1-99) for Fifo/RoundRobin, niceness (-20..19) for Nice.
+        std::int32_t  priority = 0;
+        // 0 leaves the affinity untouched (or restores the process' CPUs if a previous apply pinned the thread),
+        // otherwise bit N allows CPU N (first 64 CPUs only).
+        std::uint64_t cpuMask = 0;
+        // cpuMask is reserved for this role, other roles without an explicit mask avoid those CPUs.
+        bool          exclusiveCpus = false;
+
+        bool operator==(const Params&) const = default;
+    };
+
+    using Config = std::array<Params, RoleCount>;
+
+    // Profile used by ALXRDecoderConfig::realtimePriority for roles left at Policy::Default,
+    // the pipeline stages closest to the network get the higher priorities.
+    Params RealtimeDefaults(const Role role);
+
+    void SetConfig(const Config& config);
+    Config GetConfig();
+    // Enables/disables RealtimeDefaults for roles which have no explicit policy.
+    void SetRealtimeDefaults(const bool enable);
+
+    // Applies the role's (effective) params to the calling thread and returns what the OS granted.
+    // Policy::Default / cpuMask 0 undo what an earlier apply on the same thread changed.
+    Params ApplyToCurrentThread(const Role role);
+
+    // Optional sink for ApplyRole's grant messages, this module does not depend on the engine's logger.
+    using LogFn = void (*)(const char* message);
+    void SetLogOutput(const LogFn logFn);
+    // ApplyToCurrentThread + logs the grant, threadName defaults to the role name.
+    Params ApplyRole(const Role role, const char* threadName = nullptr);
+    // Re-applies the calling thread's last ApplyRole if SetConfig/SetRealtimeDefaults changed the effective
+    // params since, no-op for threads without a role. Cheap enough for once per loop iteration.
+    bool RefreshCurrentThread();
+    // Last grant for role, false if no thread has been assigned the role yet.
+    bool GetGranted(const Role role, Params& granted);
+
+    // Current policy/priority/affinity of the calling thread.
+    Params QueryCurrentThread();
+
+    std::string ToString(const Params& params);
+}
+#endif
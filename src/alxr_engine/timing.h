@@ -34,6 +34,14 @@ inline std::uint64_t GetTimestampUs()
     return duration_cast<microsecondsU64>(ClockType::now().time_since_epoch()).count();
 }
 
+template < typename ClockType >
+inline std::uint64_t GetTimestampNs()
+{
+    using namespace std::chrono;
+    using nanosecondsU64 = duration<std::uint64_t, nanoseconds::period>;
+    return duration_cast<nanosecondsU64>(ClockType::now().time_since_epoch()).count();
+}
+
 template < typename ClockType >
 inline std::uint64_t GetTimestampMs()
 {
@@ -49,6 +57,12 @@ inline std::uint64_t GetSteadyTimestampUs()
     return GetTimestampUs<XrSteadyClock>();
 }
 
+inline std::uint64_t GetSteadyTimestampNs()
+{
+    static_assert(XrSteadyClock::is_steady);
+    return GetTimestampNs<XrSteadyClock>();
+}
+
 inline std::uint64_t GetSteadyTimestampMs()
 {
     static_assert(XrSteadyClock::is_steady);
@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "common.h"
+#include "tracking_sampler.h"
+#include "logger.h"
+#include "openxr_program.h"
+#include "timing.h"
+#include "thread_scheduling.h"
+
+#include <algorithm>
+#include <chrono>
+
+void XrTrackingSampler::Start(const XrTrackingSampler::StartCtx& ctx)
+{
+	if (m_isRunning || ctx.programPtr == nullptr || !ctx.sampleFn)
+		return;
+	m_samples = 0;
+	m_targetIntervalUs = 0;
+	m_intervals.Reset();
+	m_jitter.Reset();
+
+	StartCtx startCtx = ctx;
+	startCtx.samplesPerFrame = std::clamp<std::uint32_t>(ctx.samplesPerFrame, 1, 8);
+	Log::Write(Log::Level::Info, Fmt("Starting tracking sampler thread, %u samples per display frame.", startCtx.samplesPerFrame));
+	m_isRunning = true;
+	m_thread = std::thread{ [this, startCtx]() { Run(startCtx); } };
+}
+
+void XrTrackingSampler::Stop()
+{
+	if (!m_isRunning.exchange(false))
+		return;
+	if (m_thread.joinable())
+		m_thread.join();
+	const auto stats = GetStats();
+	Log::Write(Log::Level::Info, Fmt("Tracking sampler stopped, samples=%llu interval p50=%lluus p99=%lluus max=%lluus, jitter p99=%lluus",
+		stats.samples, stats.interval.p50, stats.interval.p99, stats.interval.max, stats.jitter.p99));
+}
+
+void XrTrackingSampler::Run(const StartCtx ctx)
+{
+	using namespace std::chrono;
+	using namespace std::literals::chrono_literals;
+	ALXR::ThreadScheduling::ApplyRole(ALXR::ThreadScheduling::Role::Tracking);
+
+	const auto& program = *ctx.programPtr;
+	const std::int64_t samplesPerFrame = ctx.samplesPerFrame;
+	std::uint64_t lastSampleUs = 0;
+	XrTime lastTickTime = 0;
+	while (m_isRunning.load(std::memory_order_relaxed)) {
+		// the sampler may start before the stream config enables the realtime defaults.
+		ALXR::ThreadScheduling::RefreshCurrentThread();
+		XrTime displayTime = 0;
+		XrDuration displayPeriod = 0;
+		if (!program.IsSessionRunning() || !program.GetDisplayTiming(displayTime, displayPeriod)) {
+			lastSampleUs = 0;
+			std::this_thread::sleep_for(10ms);
+			continue;
+		}
+
+		// ticks are on the grid displayTime + k * tickPeriod, so every sample has the same phase
+		// relative to the display refresh whatever the host or render loop timing is.
+		const XrDuration tickPeriod = std::max<XrDuration>(displayPeriod / samplesPerFrame, 1);
+		const auto [now, ignore] = program.XrTimeNow();
+		const XrDuration sinceDisplay = now - displayTime;
+		std::int64_t tick = sinceDisplay / tickPeriod;
+		if (sinceDisplay < 0 && sinceDisplay % tickPeriod != 0)
+			--tick; // floor for display times ahead of now.
+		++tick;
+		// the runtime and steady clocks may disagree by a little, never sample the same tick twice.
+		if (displayTime + tick * tickPeriod < lastTickTime + tickPeriod / 2)
+			++tick;
+		const XrTime nextTick = displayTime + tick * tickPeriod;
+		lastTickTime = nextTick;
+		std::this_thread::sleep_until(steady_clock::now() + nanoseconds(nextTick - now));
+		if (!m_isRunning.load(std::memory_order_relaxed))
+			break;
+
+		const bool isFrameStart = ((tick % samplesPerFrame) + samplesPerFrame) % samplesPerFrame == 0;
+		ctx.sampleFn(isFrameStart);
+
+		const std::uint64_t nowUs = GetSteadyTimestampUs();
+		const std::uint64_t targetUs = static_cast<std::uint64_t>(tickPeriod / 1000);
+		m_targetIntervalUs.store(targetUs, std::memory_order_relaxed);
+		if (lastSampleUs != 0) {
+			const std::uint64_t intervalUs = nowUs - lastSampleUs;
+			m_intervals.Record(intervalUs);
+			m_jitter.Record(intervalUs > targetUs ? intervalUs - targetUs : targetUs - intervalUs);
+		}
+		lastSampleUs = nowUs;
+		m_samples.fetch_add(1, std::memory_order_relaxed);
+	}
+	Log::Write(Log::Level::Info, "Tracking sampler thread exiting.");
+}
+
+XrTrackingSampler::Stats XrTrackingSampler::GetStats() const
+{
+	return {
+		.samples = m_samples.load(std::memory_order_relaxed),
+		.targetIntervalUs = m_targetIntervalUs.load(std::memory_order_relaxed),
+		.interval = m_intervals.Collect(),
+		.jitter = m_jitter.Collect()
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef ALXR_TRACKING_SAMPLER_H
+#define ALXR_TRACKING_SAMPLER_H
+
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+#include "latency_histogram.h"
+
+struct IOpenXrProgram;
+
+// Engine owned tracking thread, samples at samplesPerFrame x the display rate on a grid phase-locked
+// to the predicted display times of the render loop, instead of whenever the host calls alxr_on_tracking_update.
+class XrTrackingSampler {
+public:
+	// Called on the sampler thread for every tick, isFrameStart is set on the first tick of each
+	// display period for work which only needs to run once per frame.
+	using SampleFn = std::function<void(const bool /*isFrameStart*/)>;
+
+	struct StartCtx {
+		std::shared_ptr<IOpenXrProgram> programPtr;
+		SampleFn      sampleFn;
+		std::uint32_t samplesPerFrame;
+	};
+	void Start(const StartCtx& ctx);
+	void Stop();
+	inline bool IsRunning() const { return m_isRunning.load(std::memory_order_relaxed); }
+
+	struct Stats {
+		std::uint64_t samples;
+		std::uint64_t targetIntervalUs;
+		// time between consecutive samples and its deviation from the target interval.
+		ALXR::LatencyHistogram::Percentiles interval;
+		ALXR::LatencyHistogram::Percentiles jitter;
+	};
+	Stats GetStats() const;
+
+	inline XrTrackingSampler() = default;
+	inline XrTrackingSampler(const XrTrackingSampler&) = delete;
+	inline XrTrackingSampler& operator=(const XrTrackingSampler&) = delete;
+	inline ~XrTrackingSampler() { Stop(); }
+
+private:
+	void Run(const StartCtx ctx);
+
+	std::atomic<bool> m_isRunning{ false };
+	std::thread       m_thread;
+	std::atomic<std::uint64_t> m_samples{ 0 };
+	std::atomic<std::uint64_t> m_targetIntervalUs{ 0 };
+	ALXR::LatencyHistogram m_intervals{};
+	ALXR::LatencyHistogram m_jitter{};
+};
+#endif
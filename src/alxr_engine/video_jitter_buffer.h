@@ -0,0 +1,283 @@
+#pragma once
+#ifndef ALXR_VIDEO_JITTER_BUFFER_H
+#define ALXR_VIDEO_JITTER_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <mutex>
+#include <algorithm>
+#include <functional>
+
+namespace ALXR
+{
+	struct VideoJitterStats {
+		std::uint64_t pushed;        // decoded frames handed to the buffer.
+		std::uint64_t presented;     // frames selected for display.
+		std::uint64_t holds;         // display frames which repeated the previously presented frame.
+		std::uint64_t skips;         // frames dropped without ever being presented, late frames included.
+		std::uint64_t lateFrames;    // frames no newer than the presented frame by the time they arrived.
+		std::uint64_t targetDelayUs; // current buffering delay.
+		std::uint32_t depth;         // frames queued after the last selection.
+		std::uint32_t maxDepth;
+	};
+
+	// Decoded video frame jitter buffer over a fixed set of video texture slots (0 - SlotCount-1).
+	//
+	// Frames are stamped with the steady clock display time they were rendered for, the tracking frame's
+	// predicted display time (the video frame index). For each display frame the render thread selects the
+	// queued frame which best matches displayTime - targetDelay. The target delay follows how late frames
+	// arrive relative to their stamp (the part of the pipeline latency the tracking prediction missed) so the
+	// matching frame has most likely arrived when it is needed even with network/decoder jitter. Frames are
+	// presented one per matching display frame rather than whatever arrived last, a burst of arrivals does
+	// not turn into skipped frames followed by holds.
+	//
+	// A slot is free, written by the decoder thread, queued, presented or retiring (the previously presented
+	// frame, the GPU may still read it), so a buffer depth frames deep only ever uses slots 0 - depth+2.
+	template < std::size_t SlotCount >
+	class VideoJitterBuffer
+	{
+		static_assert(SlotCount >= 4);
+	public:
+		constexpr static const std::size_t   InvalidSlot = std::size_t(-1);
+		constexpr static const std::uint32_t MaxDepth = static_cast<std::uint32_t>(SlotCount - 3);
+
+		// Called with the lock held for every slot which becomes free, e.g. to release per frame resources.
+		using ReleaseFn = std::function<void(const std::size_t /*slot*/)>;
+
+		struct Config {
+			std::uint32_t depth;  // max queued frames, 0 disables the buffer.
+			bool          noSkip; // present every queued frame in order, at most one new frame per display frame.
+		};
+
+		explicit VideoJitterBuffer(ReleaseFn releaseFn = {})
+		: m_releaseFn(std::move(releaseFn)) {}
+		VideoJitterBuffer(const VideoJitterBuffer&) = delete;
+		VideoJitterBuffer& operator=(const VideoJitterBuffer&) = delete;
+
+		// No other thread may use the buffer, every slot becomes free without being released.
+		void Reset(const Config& config)
+		{
+			std::scoped_lock lock(m_mutex);
+			m_config = { .depth = std::min(config.depth, MaxDepth), .noSkip = config.noSkip };
+			m_slots = {};
+			m_presented = m_retiring = InvalidSlot;
+			m_lateness = {};
+			m_latenessCount = 0;
+			m_lastPushedTimeNs = 0;
+			m_frameIntervalNs = 0;
+			m_renderLeadNs = 0;
+			m_targetDelayNs = 0;
+			m_stats = {};
+		}
+
+		inline bool IsEnabled() const { return m_config.depth > 0; }
+
+		// Decoder thread: a slot which is neither queued, presented nor retiring to write the next frame to.
+		std::size_t AcquireWriteSlot()
+		{
+			std::scoped_lock lock(m_mutex);
+			std::size_t slot = FindFreeSlot();
+			if (slot == InvalidSlot) {
+				// only when frames are pushed faster than the queue depth allows, drop the oldest.
+				slot = OldestQueued();
+				if (slot == InvalidSlot)
+					return InvalidSlot;
+				Drop(slot);
+			}
+			m_slots[slot].state = SlotState::Writing;
+			return slot;
+		}
+
+		// Decoder thread: queues the frame written to slot, frameTimeNs is the frame index, arrivalNs steady clock now.
+		void Push(const std::size_t slot, const std::uint64_t frameTimeNs, const std::uint64_t arrivalNs)
+		{
+			std::scoped_lock lock(m_mutex);
+			auto& entry = m_slots[slot];
+			++m_stats.pushed;
+			if (m_presented != InvalidSlot && frameTimeNs <= m_slots[m_presented].frameTimeNs) {
+				++m_stats.lateFrames;
+				Drop(slot);
+				return;
+			}
+			if (m_lastPushedTimeNs != 0 && frameTimeNs > m_lastPushedTimeNs) {
+				const std::int64_t intervalNs = static_cast<std::int64_t>(frameTimeNs - m_lastPushedTimeNs);
+				m_frameIntervalNs = m_frameIntervalNs == 0 ?
+					intervalNs : m_frameIntervalNs + (intervalNs - m_frameIntervalNs) / 16;
+			}
+			m_lastPushedTimeNs = std::max(m_lastPushedTimeNs, frameTimeNs);
+			m_lateness[m_latenessCount++ % m_lateness.size()] =
+				static_cast<std::int64_t>(arrivalNs) - static_cast<std::int64_t>(frameTimeNs);
+
+			entry = { .frameTimeNs = frameTimeNs, .state = SlotState::Queued };
+			if (QueuedCount() > m_config.depth)
+				Drop(OldestQueued());
+			UpdateTargetDelay();
+		}
+
+		// Render thread: slot to display at displayTimeNs (steady clock, 0 for the newest frame), either a newly
+		// selected frame or the one already presented (a hold), InvalidSlot until the first frame arrived.
+		std::size_t Select(const std::uint64_t displayTimeNs, const std::uint64_t nowNs)
+		{
+			std::scoped_lock lock(m_mutex);
+			if (displayTimeNs > nowNs) {
+				const std::int64_t leadNs = static_cast<std::int64_t>(displayTimeNs - nowNs);
+				m_renderLeadNs = m_renderLeadNs == 0 ? leadNs : m_renderLeadNs + (leadNs - m_renderLeadNs) / 8;
+			}
+
+			std::size_t selected = InvalidSlot;
+			if (displayTimeNs == 0) {
+				selected = m_config.noSkip ? OldestQueued() : NewestQueued();
+			} else {
+				// frames stamped later than this belong to a following display frame.
+				const std::int64_t latestNs = static_cast<std::int64_t>(displayTimeNs) - m_targetDelayNs + m_frameIntervalNs / 2;
+				for (std::size_t slot = 0; slot < SlotCount; ++slot) {
+					const auto& entry = m_slots[slot];
+					if (entry.state != SlotState::Queued || static_cast<std::int64_t>(entry.frameTimeNs) > latestNs)
+						continue;
+					if (selected == InvalidSlot ||
+						(m_config.noSkip ?
+							entry.frameTimeNs < m_slots[selected].frameTimeNs :
+							entry.frameTimeNs > m_slots[selected].frameTimeNs))
+						selected = slot;
+				}
+				// nothing shown yet, or frames queue up faster than they match display frames: catch up.
+				if (selected == InvalidSlot && (m_presented == InvalidSlot || QueuedCount() >= m_config.depth))
+					selected = OldestQueued();
+			}
+
+			if (selected == InvalidSlot) {
+				if (m_presented != InvalidSlot)
+					++m_stats.holds;
+				return m_presented;
+			}
+
+			// queued frames older than the selected one missed their display frame.
+			const std::uint64_t selectedTimeNs = m_slots[selected].frameTimeNs;
+			for (std::size_t slot = 0; slot < SlotCount; ++slot) {
+				if (m_slots[slot].state == SlotState::Queued && m_slots[slot].frameTimeNs < selectedTimeNs)
+					Drop(slot);
+			}
+			if (m_retiring != InvalidSlot)
+				Release(m_retiring);
+			m_retiring = m_presented;
+			if (m_retiring != InvalidSlot)
+				m_slots[m_retiring].state = SlotState::Retiring;
+			m_presented = selected;
+			m_slots[m_presented].state = SlotState::Presented;
+			++m_stats.presented;
+			return m_presented;
+		}
+
+		VideoJitterStats GetStats() const
+		{
+			std::scoped_lock lock(m_mutex);
+			VideoJitterStats stats = m_stats;
+			stats.targetDelayUs = static_cast<std::uint64_t>(m_targetDelayNs / 1000);
+			stats.depth = QueuedCount();
+			stats.maxDepth = m_config.depth;
+			return stats;
+		}
+
+	private:
+		enum class SlotState : std::uint8_t {
+			Free,
+			Writing,
+			Queued,
+			Presented,
+			Retiring
+		};
+		struct Slot {
+			std::uint64_t frameTimeNs = 0;
+			SlotState     state = SlotState::Free;
+		};
+
+		inline std::size_t FindFreeSlot() const
+		{
+			const std::size_t slotsInUse = std::min<std::size_t>(m_config.depth + 3, SlotCount);
+			for (std::size_t slot = 0; slot < slotsInUse; ++slot) {
+				if (m_slots[slot].state == SlotState::Free)
+					return slot;
+			}
+			return InvalidSlot;
+		}
+
+		inline std::uint32_t QueuedCount() const
+		{
+			return static_cast<std::uint32_t>(std::count_if(m_slots.begin(), m_slots.end(),
+				[](const Slot& entry) { return entry.state == SlotState::Queued; }));
+		}
+
+		inline std::size_t OldestQueued() const
+		{
+			std::size_t oldest = InvalidSlot;
+			for (std::size_t slot = 0; slot < SlotCount; ++slot) {
+				if (m_slots[slot].state == SlotState::Queued &&
+					(oldest == InvalidSlot || m_slots[slot].frameTimeNs < m_slots[oldest].frameTimeNs))
+					oldest = slot;
+			}
+			return oldest;
+		}
+
+		inline std::size_t NewestQueued() const
+		{
+			std::size_t newest = InvalidSlot;
+			for (std::size_t slot = 0; slot < SlotCount; ++slot) {
+				if (m_slots[slot].state == SlotState::Queued &&
+					(newest == InvalidSlot || m_slots[slot].frameTimeNs > m_slots[newest].frameTimeNs))
+					newest = slot;
+			}
+			return newest;
+		}
+
+		inline void Release(const std::size_t slot)
+		{
+			m_slots[slot] = {};
+			if (m_releaseFn)
+				m_releaseFn(slot);
+		}
+
+		inline void Drop(const std::size_t slot)
+		{
+			++m_stats.skips;
+			Release(slot);
+		}
+
+		// Frames must have arrived by the time the display frame they match is rendered, m_renderLeadNs ahead
+		// of its display time, so the delay covers the 95th percentile of the recent arrival lateness plus the lead.
+		void UpdateTargetDelay()
+		{
+			const std::size_t count = std::min(m_latenessCount, m_lateness.size());
+			std::array<std::int64_t, LatenessWindow> window{};
+			std::copy_n(m_lateness.begin(), count, window.begin());
+			const auto p95 = window.begin() + (count * 95) / 100;
+			std::nth_element(window.begin(), p95, window.begin() + count);
+
+			const std::int64_t maxDelayNs = m_frameIntervalNs * static_cast<std::int64_t>(m_config.depth);
+			const std::int64_t targetNs = std::clamp<std::int64_t>(*p95 + m_renderLeadNs, 0, std::max<std::int64_t>(maxDelayNs, 0));
+			// grow at once (a late frame is a visible hold), shrink slowly to win back latency.
+			if (targetNs > m_targetDelayNs)
+				m_targetDelayNs = targetNs;
+			else
+				m_targetDelayNs -= (m_targetDelayNs - targetNs) / 32;
+		}
+
+		constexpr static const std::size_t LatenessWindow = 64;
+
+		mutable std::mutex m_mutex{};
+		ReleaseFn          m_releaseFn;
+		Config             m_config{ .depth = 0, .noSkip = false };
+		std::array<Slot, SlotCount> m_slots{};
+		std::size_t        m_presented = InvalidSlot;
+		std::size_t        m_retiring = InvalidSlot;
+		// arrival - frame time of the last LatenessWindow frames.
+		std::array<std::int64_t, LatenessWindow> m_lateness{};
+		std::size_t        m_latenessCount = 0;
+		std::uint64_t      m_lastPushedTimeNs = 0;
+		std::int64_t       m_frameIntervalNs = 0;
+		std::int64_t       m_renderLeadNs = 0;
+		std::int64_t       m_targetDelayNs = 0;
+		VideoJitterStats   m_stats{};
+	};
+}
+#endif
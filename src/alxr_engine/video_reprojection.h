@@ -0,0 +1,134 @@
+#pragma once
+#ifndef ALXR_VIDEO_REPROJECTION_H
+#define ALXR_VIDEO_REPROJECTION_H
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <type_traits>
+#include "alxr_ctypes.h"
+
+namespace ALXR {
+    // Homography for the video shaders, a std140 mat3 (3 columns padded to vec4).
+    // Maps eye local coordinates of the displayed view (u right, v up, both 0-1) to homogeneous
+    // texture coordinates of the side-by-side video frame, divided by z per fragment.
+    struct alignas(16) VideoReprojection {
+        std::array<float, 12> columns;
+    };
+    static_assert(std::is_standard_layout<VideoReprojection>());
+    static_assert(sizeof(VideoReprojection) == 48);
+
+    namespace VideoReprojectionMath {
+        using Mat3 = std::array<std::array<float, 3>, 3>; // row major.
+        using Vec3 = std::array<float, 3>;
+
+        inline Mat3 Multiply(const Mat3& a, const Mat3& b) {
+            Mat3 result{};
+            for (std::size_t row = 0; row < 3; ++row)
+                for (std::size_t col = 0; col < 3; ++col)
+                    for (std::size_t k = 0; k < 3; ++k)
+                        result[row][col] += a[row][k] * b[k][col];
+            return result;
+        }
+
+        inline Mat3 Transpose(const Mat3& m) {
+            return {{
+                { m[0][0], m[1][0], m[2][0] },
+                { m[0][1], m[1][1], m[2][1] },
+                { m[0][2], m[1][2], m[2][2] }
+            }};
+        }
+
+        // view local -> reference space rotation.
+        inline Mat3 FromQuaternion(const XrQuaternionf& q) {
+            const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+            const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+            const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+            return {{
+                { 1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz),        2.0f * (xz + wy)        },
+                { 2.0f * (xy + wz),        1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx)        },
+                { 2.0f * (xz - wy),        2.0f * (yz + wx),        1.0f - 2.0f * (xx + yy) }
+            }};
+        }
+
+        // eye local (u, v, 1) -> view space ray (tan x, tan y, -1).
+        inline Mat3 EyeToRay(const XrFovf& fov) {
+            const float tanLeft = std::tan(fov.angleLeft), tanRight = std::tan(fov.angleRight);
+            const float tanDown = std::tan(fov.angleDown), tanUp    = std::tan(fov.angleUp);
+            return {{
+                { tanRight - tanLeft, 0.0f,          tanLeft },
+                { 0.0f,               tanUp - tanDown, tanDown },
+                { 0.0f,               0.0f,          -1.0f   }
+            }};
+        }
+
+        // view space ray -> homogeneous eye local (u, v, 1).
+        inline Mat3 RayToEye(const XrFovf& fov) {
+            const float tanLeft = std::tan(fov.angleLeft), tanRight = std::tan(fov.angleRight);
+            const float tanDown = std::tan(fov.angleDown), tanUp    = std::tan(fov.angleUp);
+            const float invWidth = 1.0f / (tanRight - tanLeft), invHeight = 1.0f / (tanUp - tanDown);
+            return {{
+                { invWidth, 0.0f,      tanLeft * invWidth  },
+                { 0.0f,     invHeight, tanDown * invHeight },
+                { 0.0f,     0.0f,      -1.0f               }
+            }};
+        }
+
+        // eye local (u, v up) -> texture coordinates of the eye's half of the video frame (v down).
+        inline Mat3 EyeToTexture(const std::uint32_t eyeIndex) {
+            return {{
+                { 0.5f, 0.0f,  0.5f * static_cast<float>(eyeIndex) },
+                { 0.0f, -1.0f, 1.0f },
+                { 0.0f, 0.0f,  1.0f }
+            }};
+        }
+
+        inline VideoReprojection ToStd140(const Mat3& m) {
+            VideoReprojection result{};
+            for (std::size_t col = 0; col < 3; ++col)
+                for (std::size_t row = 0; row < 3; ++row)
+                    result.columns[col * 4 + row] = m[row][col];
+            return result;
+        }
+    }
+
+    // No warp, the video frame is sampled exactly as without reprojection.
+    inline VideoReprojection MakeIdentityVideoReprojection(const std::uint32_t eyeIndex) {
+        using namespace VideoReprojectionMath;
+        return ToStd140(EyeToTexture(eyeIndex));
+    }
+
+    // Warp for a video frame rendered by the server with videoView, displayed with displayView
+    // (both in the same reference space). planeDepth is the assumed scene distance in meters for Positional.
+    inline VideoReprojection MakeVideoReprojection
+    (
+        const std::uint32_t eyeIndex,
+        const XrView& videoView,
+        const XrView& displayView,
+        const ALXRVideoReprojectionMode mode,
+        const float planeDepth = 2.0f
+    )
+    {
+        using namespace VideoReprojectionMath;
+        if (mode == ALXRVideoReprojectionMode::None)
+            return MakeIdentityVideoReprojection(eyeIndex);
+
+        const Mat3 videoRotationT = Transpose(FromQuaternion(videoView.pose.orientation));
+        // display view space -> video view space.
+        Mat3 displayToVideo = Multiply(videoRotationT, FromQuaternion(displayView.pose.orientation));
+        if (mode == ALXRVideoReprojectionMode::Positional && planeDepth > 0.0f) {
+            // plane induced homography, points on the plane -z = planeDepth move by the eye translation.
+            const Vec3 delta {
+                displayView.pose.position.x - videoView.pose.position.x,
+                displayView.pose.position.y - videoView.pose.position.y,
+                displayView.pose.position.z - videoView.pose.position.z
+            };
+            for (std::size_t row = 0; row < 3; ++row) {
+                const float translation = videoRotationT[row][0] * delta[0] + videoRotationT[row][1] * delta[1] + videoRotationT[row][2] * delta[2];
+                displayToVideo[row][2] -= translation / planeDepth;
+            }
+        }
+        const Mat3 eyeToEye = Multiply(RayToEye(videoView.fov), Multiply(displayToVideo, EyeToRay(displayView.fov)));
+        return ToStd140(Multiply(EyeToTexture(eyeIndex), eyeToEye));
+    }
+}
+#endif
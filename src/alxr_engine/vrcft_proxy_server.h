@@ -12,6 +12,7 @@
 #include <deque>
 
 #include "alxr_facial_eye_tracking_packet.h"
+#include "thread_scheduling.h"
 
 namespace ALXR::VRCFT {
 
@@ -99,7 +100,10 @@ namespace ALXR::VRCFT {
         {
             m_acceptor.set_option(socket_base::reuse_address{true});
             AsyncAccept();
-            m_ioCtxThread = std::thread([this]() { m_ioContext.run(); });
+            m_ioCtxThread = std::thread([this]() {
+                ALXR::ThreadScheduling::ApplyToCurrentThread(ALXR::ThreadScheduling::Role::Network);
+                m_ioContext.run();
+            });
         }
 
         inline Server(const Server&) = delete;
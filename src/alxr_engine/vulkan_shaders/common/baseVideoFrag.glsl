@@ -22,23 +22,30 @@ layout(constant_id = 8) const bool EnableSRGBLinearize = true;
 
 layout(binding = 0) uniform sampler2D tex_sampler;
 layout(location = 0) in vec2 UV;
+layout(location = 1) in vec3 ReprojectedUV;
+
+#ifdef ENABLE_MULTIVEW_EXT
+    #define FS_GET_VIEW_INDEX() float(gl_ViewIndex)
+#else
+    #define FS_GET_VIEW_INDEX() float(UV.x > 0.5)
+#endif
+
+// reprojected texture coordinates, clamped to the eye's half of the video frame.
+vec2 GetVideoUV(const float rightEye) {
+    vec2 uv = ReprojectedUV.xy / max(ReprojectedUV.z, 1e-6f);
+    float minX = rightEye * 0.5f;
+    return vec2(clamp(uv.x, minX, minX + 0.5f), clamp(uv.y, 0.0f, 1.0f));
+}
 
 vec4 SampleVideoTexture() {
+    float rightEye = FS_GET_VIEW_INDEX();
     vec4 result = texture
     (
         tex_sampler,
 #ifdef ENABLE_FOVEATION_DECODE
-        DecodeFoveationUV
-        (
-            UV,
-#ifdef ENABLE_MULTIVEW_EXT
-            float(gl_ViewIndex)
-#else
-            float(UV.x > 0.5)
-#endif
-        )
+        DecodeFoveationUV(GetVideoUV(rightEye), rightEye)
 #else
-        UV
+        GetVideoUV(rightEye)
 #endif
     );
     return EnableSRGBLinearize ?
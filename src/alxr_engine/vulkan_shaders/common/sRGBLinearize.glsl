@@ -14,3 +14,12 @@ vec4 sRGBToLinearRGB(vec4 srgba)
     const vec3 upper = pow((srgb + offset3) * alpha3, gamma3);
     return vec4(mix(lower, upper, greaterThan(srgb, theta3)), srgba.a);
 }
+
+// inverse of sRGBToLinearRGB, for targets written without sRGB encoding by the hardware.
+vec4 linearRGBToSRGB(vec4 rgba)
+{
+    const vec3 rgb = rgba.rgb;
+    const vec3 lower = rgb * 12.92;
+    const vec3 upper = pow(rgb, 1.0 / gamma3) * 1.055 - offset3;
+    return vec4(mix(lower, upper, greaterThan(rgb, theta3 * delta3)), rgba.a);
+}
@@ -0,0 +1,85 @@
+#version 460
+#ifdef ENABLE_ARB_INCLUDE_EXT
+    #extension GL_ARB_shading_language_include : require
+#else
+    // required by glslangValidator
+    #extension GL_GOOGLE_include_directive : require
+#endif
+#pragma compute
+
+// Compute counterpart of videoStream_vert/frag.glsl: one invocation per swapchain pixel samples the video
+// frame and writes it straight into the swapchain image, no render pass or depth buffer.
+// With multiview one dispatch writes both eye layers (z is the view index).
+
+precision highp float;
+
+#include "common/sRGBLinearize.glsl"
+#ifdef ENABLE_FOVEATION_DECODE
+    #include "common/decodeFoveation.glsl"
+#endif
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout (std140, push_constant) uniform buf
+{
+    // per view homography, eye local position (v up) -> homogeneous video texture coordinates.
+    mat3 VideoReprojection[2];
+    uint ViewID;
+} ubuf;
+
+layout(constant_id = 8) const bool EnableSRGBLinearize = true;
+// the swapchain has an sRGB format written through a UNORM view (storage images are never sRGB),
+// values are stored encoded as the raster path's colour attachment would.
+layout(constant_id = 9) const bool SRGBSwapchain = true;
+
+layout(set = 0, binding = 0) uniform sampler2D tex_sampler;
+
+#ifdef ENABLE_MULTIVEW_EXT
+    layout(set = 1, binding = 0) uniform writeonly image2DArray OutputImage;
+    #define CS_GET_VIEW_INDEX() gl_GlobalInvocationID.z
+    #define CS_OUTPUT_SIZE() imageSize(OutputImage).xy
+    #define CS_OUTPUT_COORD(pixel, viewIndex) ivec3(pixel, viewIndex)
+#else
+    layout(set = 1, binding = 0) uniform writeonly image2D OutputImage;
+    #define CS_GET_VIEW_INDEX() ubuf.ViewID
+    #define CS_OUTPUT_SIZE() imageSize(OutputImage)
+    #define CS_OUTPUT_COORD(pixel, viewIndex) pixel
+#endif
+
+void main()
+{
+    const ivec2 size = CS_OUTPUT_SIZE();
+    const ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, size)))
+        return;
+    const uint viewIndex = CS_GET_VIEW_INDEX();
+
+    // eye local position of the pixel centre, what the vertex shader's EyePositions interpolate to.
+    const vec2 pixelUV = (vec2(pixel) + 0.5f) / vec2(size);
+    const vec3 reprojectedUV = ubuf.VideoReprojection[viewIndex] * vec3(pixelUV.x, 1.0f - pixelUV.y, 1.0f);
+
+    // reprojected texture coordinates, clamped to the eye's half of the video frame.
+    const float rightEye = float(viewIndex);
+    const vec2 uv = reprojectedUV.xy / max(reprojectedUV.z, 1e-6f);
+    const float minX = rightEye * 0.5f;
+    const vec2 videoUV = vec2(clamp(uv.x, minX, minX + 0.5f), clamp(uv.y, 0.0f, 1.0f));
+
+    vec4 result = textureLod
+    (
+        tex_sampler,
+#ifdef ENABLE_FOVEATION_DECODE
+        DecodeFoveationUV(videoUV, rightEye),
+#else
+        videoUV,
+#endif
+        0.0f
+    );
+    if (SRGBSwapchain) {
+        // the raster path linearizes and the attachment encodes again.
+        if (!EnableSRGBLinearize)
+            result = linearRGBToSRGB(result);
+    } else if (EnableSRGBLinearize) {
+        result = sRGBToLinearRGB(result);
+    }
+    imageStore(OutputImage, CS_OUTPUT_COORD(pixel, viewIndex), result);
+}
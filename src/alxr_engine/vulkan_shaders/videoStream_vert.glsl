@@ -6,12 +6,12 @@
 #endif
 #pragma vertex
 
-#ifndef ENABLE_MULTIVEW_EXT
 layout (std140, push_constant) uniform buf
 {
+    // per view homography, eye local position (v up) -> homogeneous video texture coordinates.
+    mat3 VideoReprojection[2];
     uint ViewID;
 } ubuf;
-#endif
 
 #ifdef ENABLE_MULTIVEW_EXT
     #define VS_GET_VIEW_INDEX() gl_ViewIndex
@@ -39,7 +39,15 @@ const vec2 UVs[2][3] = vec2[][](
     )
 );
 
-layout (location = 0) out vec2 outUV;            
+// eye local positions of TrianglePositions.
+const vec2 EyePositions[3] = vec2[](
+    vec2(0.0f, 1.0f),
+    vec2(2.0f, 1.0f),
+    vec2(0.0f, -1.0f)
+);
+
+layout (location = 0) out vec2 outUV;
+layout (location = 1) out vec3 outReprojectedUV;
 out gl_PerVertex
 {
     vec4 gl_Position;
@@ -48,5 +56,7 @@ out gl_PerVertex
 void main()
 {
     outUV = UVs[VS_GET_VIEW_INDEX()][gl_VertexIndex];
+    // linear in screen space, so it interpolates exactly and is only divided per fragment.
+    outReprojectedUV = ubuf.VideoReprojection[VS_GET_VIEW_INDEX()] * vec3(EyePositions[gl_VertexIndex], 1.0f);
     gl_Position = vec4(TrianglePositions[gl_VertexIndex], 0.0, 1.0);
 }